@@ -167,6 +167,10 @@ int main(int argc,char *argv[]){
     //Timestep of all k dependent Green's functions in array
     cntr::distributed_timestep_array<double> gk_all_timesteps(Nk,Nt,Ntau,Norb,FERMION,true);
     cntr::distributed_timestep_array<double> wk_all_timesteps(Nk,Nt,Ntau,Norb,BOSON,true);
+    // self-energy and polarization on the k-points of each rank, evaluated by FFT over the BZ
+    cntr::distributed_timestep_array<double> sk_all_timesteps(Nk,Nt,Ntau,Norb,FERMION,true);
+    cntr::distributed_timestep_array<double> pk_all_timesteps(Nk,Nt,Ntau,Norb,BOSON,true);
+    cntr::lattice_convolution<double> conv(std::vector<int>(1,Nk),std::vector<int>(1,lattice.G_));
 
     tid_map=gk_all_timesteps.data().tid_map();
     assert(tid==gk_all_timesteps.tid());
@@ -177,10 +181,9 @@ int main(int argc,char *argv[]){
     std::vector<int> kindex_rank;kindex_rank.resize(Nk_rank);
     // Momentum depedent correlators on one rank
     std::vector<gw::kpoint> corrK_rank;corrK_rank.resize(Nk_rank);
-    if(tid==tid_root){
-      Gloc=GREEN(Nt,Ntau,Norb,FERMION);
-      Wloc=GREEN(Nt,Ntau,Norb,BOSON);
-    }
+    // local propagators are accumulated on all ranks (see diag::get_loc)
+    Gloc=GREEN(Nt,Ntau,Norb,FERMION);
+    Wloc=GREEN(Nt,Ntau,Norb,BOSON);
     int iq=0;
     for(int k=0;k<Nk;k++){
       vertex[k]=CFUNC(Nt,Norb);
@@ -206,9 +209,7 @@ int main(int argc,char *argv[]){
       diag::gather_gk_timestep(-1,Nk_rank,gk_all_timesteps,corrK_rank,kindex_rank);
       // diag::gather_wk_timestep(-1,Nk_rank,wk_all_timesteps,corrK_rank,kindex_rank);
       diag::set_density_k(-1,Norb,gk_all_timesteps,lattice,density_k,kindex_rank,rho_loc);
-      if(tid==tid_root){
-        diag::get_loc(-1,Ntau,Norb,lattice,Gloc,gk_all_timesteps);
-      }
+      diag::get_loc(-1,Ntau,Norb,lattice,Gloc,gk_all_timesteps,kindex_rank);
     }
     
     { // begin Matsubara Dyson iteration
@@ -225,31 +226,27 @@ int main(int argc,char *argv[]){
         diag::gather_gk_timestep(tstp,Nk_rank,gk_all_timesteps,corrK_rank,kindex_rank);
         diag::gather_wk_timestep(tstp,Nk_rank,wk_all_timesteps,corrK_rank,kindex_rank);
         diag::set_density_k(-1,Norb,gk_all_timesteps,lattice,density_k,kindex_rank,rho_loc);
-        if(tid==tid_root){
-          diag::get_loc(-1,Ntau,Norb,lattice,Gloc,gk_all_timesteps);
-          diag::get_loc(-1,Ntau,Norb,lattice,Wloc,wk_all_timesteps);
-        }
+        diag::get_loc(-1,Ntau,Norb,lattice,Gloc,gk_all_timesteps,kindex_rank);
+        diag::get_loc(-1,Ntau,Norb,lattice,Wloc,wk_all_timesteps,kindex_rank);
         // update mean field and self-energy
         for(int k=0;k<Nk_rank;k++){
             diag::sigma_Hartree(-1,Norb,corrK_rank[k].SHartree_,lattice,density_k,vertex,Ut);
             diag::sigma_Fock(-1,Norb,kindex_rank[k],corrK_rank[k].SFock_,lattice,density_k,vertex,Ut);
-            diag::sigma_GW(-1,kindex_rank[k],corrK_rank[k].Sigma_,gk_all_timesteps,wk_all_timesteps,lattice,Ntau,Norb);
         }
+        diag::sigma_GW(-1,conv,sk_all_timesteps,gk_all_timesteps,wk_all_timesteps,corrK_rank,kindex_rank);
         // solve Dyson equation
         double err_ele=0.0,err_bos=0.0;
+        diag::get_Polarization_Bubble(tstp,conv,pk_all_timesteps,gk_all_timesteps,corrK_rank,kindex_rank);
         for(int k=0;k<Nk_rank;k++){
           err_ele += corrK_rank[k].step_dyson_with_error(tstp,iter,SolverOrder,lattice);
-          diag::get_Polarization_Bubble(tstp,Norb,Ntau,kindex_rank[k],corrK_rank[k].P_,gk_all_timesteps,lattice);
           err_bos += corrK_rank[k].step_W_with_error(tstp,iter,SolverOrder,lattice);
         }
         MPI_Allreduce(MPI_IN_PLACE,&err_ele,1,MPI_DOUBLE_PRECISION,MPI_SUM,MPI_COMM_WORLD);
         MPI_Allreduce(MPI_IN_PLACE,&err_bos,1,MPI_DOUBLE_PRECISION,MPI_SUM,MPI_COMM_WORLD);
 
         diag::set_density_k(-1,Norb,gk_all_timesteps,lattice,density_k,kindex_rank,rho_loc);
-        if(tid==tid_root){
-          diag::get_loc(-1,Ntau,Norb,lattice,Gloc,gk_all_timesteps);
-          diag::get_loc(-1,Ntau,Norb,lattice,Wloc,wk_all_timesteps);
-        }
+        diag::get_loc(-1,Ntau,Norb,lattice,Gloc,gk_all_timesteps,kindex_rank);
+        diag::get_loc(-1,Ntau,Norb,lattice,Wloc,wk_all_timesteps,kindex_rank);
         if(tid==tid_root){
           cdmatrix tmp;
           rho_loc.get_value(tstp,tmp);
@@ -312,22 +309,20 @@ int main(int argc,char *argv[]){
 
             
             diag::set_density_k(n,Norb,gk_all_timesteps,lattice,density_k,kindex_rank,rho_loc);          
-            if(tid==tid_root){
-              diag::get_loc(n,Ntau,Norb,lattice,Gloc,gk_all_timesteps);
-              diag::get_loc(n,Ntau,Norb,lattice,Wloc,wk_all_timesteps);
-    	      }
+            diag::get_loc(n,Ntau,Norb,lattice,Gloc,gk_all_timesteps,kindex_rank);
+            diag::get_loc(n,Ntau,Norb,lattice,Wloc,wk_all_timesteps,kindex_rank);
             // update mean field and self-energy
             for(int k=0;k<Nk_rank;k++){
               diag::sigma_Hartree(n,Norb,corrK_rank[k].SHartree_,lattice,density_k,vertex,Ut);
               diag::sigma_Fock(n,Norb,kindex_rank[k],corrK_rank[k].SFock_,lattice,density_k,vertex,Ut);
-              diag::sigma_GW(n,kindex_rank[k],corrK_rank[k].Sigma_,gk_all_timesteps,wk_all_timesteps,lattice,Ntau,Norb);
             }
+            diag::sigma_GW(n,conv,sk_all_timesteps,gk_all_timesteps,wk_all_timesteps,corrK_rank,kindex_rank);
 
             err_ele=0.0,err_bos=0.0;
+            diag::get_Polarization_Bubble(n,conv,pk_all_timesteps,gk_all_timesteps,corrK_rank,kindex_rank);
             for(int k=0;k<Nk_rank;k++){
     	        // solve Dyson equation
               err_ele += corrK_rank[k].step_dyson_with_error(n,iter,SolverOrder,lattice);
-              diag::get_Polarization_Bubble(n,Norb,Ntau,kindex_rank[k],corrK_rank[k].P_,gk_all_timesteps,lattice);
               err_bos += corrK_rank[k].step_W_with_error(n,iter,SolverOrder,lattice);
               
             }
@@ -337,10 +332,8 @@ int main(int argc,char *argv[]){
             // diag::gather_gk_timestep(n,Nk_rank,gk_all_timesteps,corrK_rank,kindex_rank);
             // diag::gather_wk_timestep(n,Nk_rank,wk_all_timesteps,corrK_rank,kindex_rank);
             diag::set_density_k(n,Norb,gk_all_timesteps,lattice,density_k,kindex_rank,rho_loc);
-            if(tid==tid_root){
-              diag::get_loc(n,Ntau,Norb,lattice,Gloc,gk_all_timesteps);
-              diag::get_loc(n,Ntau,Norb,lattice,Wloc,wk_all_timesteps);
-            }
+            diag::get_loc(n,Ntau,Norb,lattice,Gloc,gk_all_timesteps,kindex_rank);
+            diag::get_loc(n,Ntau,Norb,lattice,Wloc,wk_all_timesteps,kindex_rank);
           }
           if(tid==tid_root){
             cdmatrix tmp;
@@ -395,21 +388,19 @@ int main(int argc,char *argv[]){
           diag::gather_wk_timestep(tstp,Nk_rank,wk_all_timesteps,corrK_rank,kindex_rank);
 
           diag::set_density_k(tstp,Norb,gk_all_timesteps,lattice,density_k,kindex_rank,rho_loc);          
-          if(tid==tid_root){
-            diag::get_loc(tstp,Ntau,Norb,lattice,Gloc,gk_all_timesteps);
-            diag::get_loc(tstp,Ntau,Norb,lattice,Wloc,wk_all_timesteps);
-          }
+          diag::get_loc(tstp,Ntau,Norb,lattice,Gloc,gk_all_timesteps,kindex_rank);
+          diag::get_loc(tstp,Ntau,Norb,lattice,Wloc,wk_all_timesteps,kindex_rank);
 	        // update mean field and SigmaGW
           for(int k=0;k<Nk_rank;k++){
             diag::sigma_Hartree(tstp,Norb,corrK_rank[k].SHartree_,lattice,density_k,vertex,Ut);
             diag::sigma_Fock(tstp,Norb,kindex_rank[k],corrK_rank[k].SFock_,lattice,density_k,vertex,Ut);
-            diag::sigma_GW(tstp,kindex_rank[k],corrK_rank[k].Sigma_,gk_all_timesteps,wk_all_timesteps,lattice,Ntau,Norb);
           }
+          diag::sigma_GW(tstp,conv,sk_all_timesteps,gk_all_timesteps,wk_all_timesteps,corrK_rank,kindex_rank);
           // Solve dyson, update polarization and solve two particle self-consistency
           double err_ele=0.0,err_bos=0.0;
+          diag::get_Polarization_Bubble(tstp,conv,pk_all_timesteps,gk_all_timesteps,corrK_rank,kindex_rank);
           for(int k=0;k<Nk_rank;k++){
             err_ele += corrK_rank[k].step_dyson_with_error(tstp,iter,SolverOrder,lattice);
-            diag::get_Polarization_Bubble(tstp,Norb,Ntau,kindex_rank[k],corrK_rank[k].P_,gk_all_timesteps,lattice);
             err_bos += corrK_rank[k].step_W_with_error(tstp,iter,SolverOrder,lattice);
 
           }
@@ -417,10 +408,8 @@ int main(int argc,char *argv[]){
           MPI_Allreduce(MPI_IN_PLACE,&err_bos,1,MPI_DOUBLE_PRECISION,MPI_SUM,MPI_COMM_WORLD);
     
           diag::set_density_k(tstp,Norb,gk_all_timesteps,lattice,density_k,kindex_rank,rho_loc);
-          if(tid==tid_root){
-            diag::get_loc(tstp,Ntau,Norb,lattice,Gloc,gk_all_timesteps);
-            diag::get_loc(tstp,Ntau,Norb,lattice,Wloc,wk_all_timesteps);
-          }
+          diag::get_loc(tstp,Ntau,Norb,lattice,Gloc,gk_all_timesteps,kindex_rank);
+          diag::get_loc(tstp,Ntau,Norb,lattice,Wloc,wk_all_timesteps,kindex_rank);
           if(tid==tid_root){
             cdmatrix tmp;
             rho_loc.get_value(tstp,tmp);
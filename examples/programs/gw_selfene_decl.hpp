@@ -21,11 +21,13 @@ namespace diag {
 	void gather_wk_timestep(int tstp,int Nk_rank,DIST_TIMESTEP &wk_all_timesteps, std::vector<gw::kpoint> &corrK_rank,
 		std::vector<int> &kindex_rank);
 	void set_density_k(int tstp, int Norb,DIST_TIMESTEP &gk_all_timesteps,lattice_1d_1b &lattice,std::vector<CFUNC> & density_k,std::vector<int> &kindex_rank,CFUNC &rho_loc);
-	void get_loc(int tstp,int Ntau,int Norb,lattice_1d_1b &lattice,GREEN &Gloc,DIST_TIMESTEP &gk_all_timesteps);
+	void get_loc(int tstp,int Ntau,int Norb,lattice_1d_1b &lattice,GREEN &Gloc,DIST_TIMESTEP &gk_all_timesteps,std::vector<int> &kindex_rank);
 	void sigma_Hartree(int tstp,int Norb,CFUNC &S,lattice_1d_1b &lattice,std::vector<CFUNC> &density_k,std::vector<CFUNC> &vertex,CFUNC &Ut);
 	void sigma_Fock(int tstp,int Norb,int kk,CFUNC &S,lattice_1d_1b &lattice,std::vector<CFUNC> &density_k,std::vector<CFUNC> &vertex,CFUNC &Ut);
-	void sigma_GW(int tstp,int kk,GREEN &S,DIST_TIMESTEP &gk_all_timesteps,DIST_TIMESTEP &wk_all_timesteps,lattice_1d_1b &lattice,int Ntau,int Norb);
-	void get_Polarization_Bubble(int tstp,int Norb,int Ntau,int qq,GREEN &P,DIST_TIMESTEP &gk_all_timesteps,lattice_1d_1b &lattice);
+	void sigma_GW(int tstp,cntr::lattice_convolution<double> &conv,DIST_TIMESTEP &sk_all_timesteps,DIST_TIMESTEP &gk_all_timesteps,
+		DIST_TIMESTEP &wk_all_timesteps,std::vector<gw::kpoint> &corrK_rank,std::vector<int> &kindex_rank);
+	void get_Polarization_Bubble(int tstp,cntr::lattice_convolution<double> &conv,DIST_TIMESTEP &pk_all_timesteps,
+		DIST_TIMESTEP &gk_all_timesteps,std::vector<gw::kpoint> &corrK_rank,std::vector<int> &kindex_rank);
 	void symmetrise_mat(GREEN &G,int Ntau);
 	void extrapolate_timestep_W(int tstp,int Nk_rank,int SolverOrder,int Nt,std::vector<gw::kpoint> &corrK_rank);
 	void extrapolate_timestep_G(int tstp,int Nk_rank,int SolverOrder,int Nt,std::vector<gw::kpoint> &corrK_rank);
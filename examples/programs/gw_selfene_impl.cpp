@@ -18,10 +18,10 @@ namespace diag {
    void gather_gk_timestep(int tstp,int Nk_rank,DIST_TIMESTEP &gk_all_timesteps,std::vector<gw::kpoint> &corrK_rank,std::vector<int> &kindex_rank){
       gk_all_timesteps.reset_tstp(tstp);
       for(int k=0;k<Nk_rank;k++){
-         gk_all_timesteps.G()[kindex_rank[k]].get_data(corrK_rank[k].G_);
+         gk_all_timesteps.G(kindex_rank[k]).get_data(corrK_rank[k].G_);
       }
       cdmatrix tmp;
-      gk_all_timesteps.G()[0].density_matrix(tstp,tmp);
+      gk_all_timesteps.G(0).density_matrix(tstp,tmp);
    // distribute to all nodes
       gk_all_timesteps.mpi_bcast_all();
    }
@@ -30,7 +30,7 @@ namespace diag {
    void gather_wk_timestep(int tstp,int Nk_rank,DIST_TIMESTEP &wk_all_timesteps,std::vector<gw::kpoint> &corrK_rank,std::vector<int> &kindex_rank){
       wk_all_timesteps.reset_tstp(tstp);
       for(int k=0;k<Nk_rank;k++){
-         wk_all_timesteps.G()[kindex_rank[k]].get_data(corrK_rank[k].W_);
+         wk_all_timesteps.G(kindex_rank[k]).get_data(corrK_rank[k].W_);
       }
    // distribute to all nodes
       wk_all_timesteps.mpi_bcast_all();
@@ -42,7 +42,7 @@ namespace diag {
       cdmatrix local(Norb,Norb);
       local.setZero();
       for(int k=0;k<lattice.nk_;k++){
-         gk_all_timesteps.G()[k].density_matrix(tstp,tmp);
+         gk_all_timesteps.G(k).density_matrix(tstp,tmp);
          double wt=lattice.kweight_[k];
          local+=wt*tmp;
          density_k[k].set_value(tstp,tmp);
@@ -50,14 +50,15 @@ namespace diag {
       rho_loc.set_value(tstp,local);
    }
 
-   // get local propagator
-   void get_loc(int tstp,int Ntau,int Norb,lattice_1d_1b &lattice,GREEN &Gloc,DIST_TIMESTEP &gk_all_timesteps){
+   // get local propagator: each rank sums over its own k-points, followed by an allreduce
+   void get_loc(int tstp,int Ntau,int Norb,lattice_1d_1b &lattice,GREEN &Gloc,DIST_TIMESTEP &gk_all_timesteps,std::vector<int> &kindex_rank){
       cntr::herm_matrix_timestep<double> gtmp(tstp,Ntau,Norb,-1);
-      for(int k=0;k<lattice.nk_;k++){
-         double wt=lattice.kweight_[k];
-         herm_matrix_timestep_view<double> tview(tstp,gtmp);
-         tview.incr_timestep(gk_all_timesteps.G()[k],std::complex<double>(wt,0.0));
+      herm_matrix_timestep_view<double> tview(tstp,gtmp);
+      for(int k=0;k<kindex_rank.size();k++){
+         double wt=lattice.kweight_[kindex_rank[k]];
+         tview.incr_timestep(gk_all_timesteps.G(kindex_rank[k]),std::complex<double>(wt,0.0));
       }
+      cntr::Allreduce_timestep(tstp,gtmp);
       Gloc.set_timestep(tstp,gtmp);
    }
 
@@ -110,49 +111,28 @@ namespace diag {
       S.set_value(tstp,stmp);
    }
 
-   //Evaluate GW self-energy
-   void sigma_GW(int tstp,int kk,GREEN &S,DIST_TIMESTEP &gk_all_timesteps,DIST_TIMESTEP &wk_all_timesteps,
-      lattice_1d_1b &lattice,int Ntau,int Norb){
+   //Evaluate GW self-energy Sigma(k) = 1/Nk sum_q ii G(k-q) W(q) for the k-points of this rank
+   void sigma_GW(int tstp,cntr::lattice_convolution<double> &conv,DIST_TIMESTEP &sk_all_timesteps,DIST_TIMESTEP &gk_all_timesteps,
+      DIST_TIMESTEP &wk_all_timesteps,std::vector<gw::kpoint> &corrK_rank,std::vector<int> &kindex_rank){
       assert(tstp==gk_all_timesteps.tstp());
       assert(tstp==wk_all_timesteps.tstp());
-      GREEN_TSTP stmp(tstp,Ntau,Norb,FERMION);
-      S.set_timestep_zero(tstp);
-      for(int q=0;q<lattice.nk_;q++){
-         double wk=lattice.kweight_[q];
-         int kq=lattice.add_kpoints(kk,1,q,-1);
-         stmp.clear();
-         for(int i1=0;i1<Norb;i1++){
-            for(int i2=0;i2<Norb;i2++){
-               cntr::Bubble2(tstp,stmp,i1,i2,gk_all_timesteps.G()[kq],gk_all_timesteps.G()[kq],i1,i2,
-                  wk_all_timesteps.G()[q],wk_all_timesteps.G()[q],i1,i2);
-            }
-         }
-         S.incr_timestep(tstp,stmp,wk);
-
+      sk_all_timesteps.reset_tstp(tstp);
+      conv.Bubble2(tstp,sk_all_timesteps,gk_all_timesteps,wk_all_timesteps);
+      for(int k=0;k<kindex_rank.size();k++){
+         herm_matrix_timestep_view<double> sview(tstp,corrK_rank[k].Sigma_);
+         sview.get_data(sk_all_timesteps.G(kindex_rank[k]));
       }
    }
 
-   //Evaluate polarization
-   void get_Polarization_Bubble(int tstp,int Norb,int Ntau,int qq,GREEN &P,DIST_TIMESTEP &gk_all_timesteps,lattice_1d_1b &lattice){
-      assert(tstp==gk_all_timesteps.tstp());	
-      // compute P_{a,a'}(q;t,t') on a timestep
-      int kq;
-      GREEN_TSTP ptmp(tstp,Ntau,Norb,BOSON);
-      P.set_timestep_zero(tstp);
-      for(int kk=0;kk<lattice.nk_;kk++){
-      double wk=lattice.kweight_[kk]; // factor 2: ksum normalized for RBZ
-      // get bubble 
-      // -ii*sum_{j1,j2} G_{(a1),(a2)}(k-q;t,t') G_{(a2),(a1)}(k;t',t)
-      kq=lattice.add_kpoints(kk,1,qq,-1);
-      ptmp.clear();
-      for(int i1=0;i1<Norb;i1++){
-         for(int i2=0;i2<Norb;i2++){
-            cntr::Bubble1(tstp,ptmp,i1,i2,gk_all_timesteps.G()[kq],gk_all_timesteps.G()[kq],i1,i2,gk_all_timesteps.G()[kk],
-            gk_all_timesteps.G()[kk],i1,i2);										  
-         }
-      }
-      // increment P += -wt*Ptmp
-      P.incr_timestep(tstp,ptmp,-wk);
+   //Evaluate polarization P(q) = -1/Nk sum_k ii G(k-q;t,t') G(k;t',t) for the q-points of this rank
+   void get_Polarization_Bubble(int tstp,cntr::lattice_convolution<double> &conv,DIST_TIMESTEP &pk_all_timesteps,
+      DIST_TIMESTEP &gk_all_timesteps,std::vector<gw::kpoint> &corrK_rank,std::vector<int> &kindex_rank){
+      assert(tstp==gk_all_timesteps.tstp());
+      pk_all_timesteps.reset_tstp(tstp);
+      conv.Bubble1(tstp,pk_all_timesteps,gk_all_timesteps,gk_all_timesteps,-1.0);
+      for(int k=0;k<kindex_rank.size();k++){
+         herm_matrix_timestep_view<double> pview(tstp,corrK_rank[k].P_);
+         pview.get_data(pk_all_timesteps.G(kindex_rank[k]));
       }
    }
 
@@ -0,0 +1,88 @@
+#ifndef CNTR_CHECKPOINT_DECL_H
+#define CNTR_CHECKPOINT_DECL_H
+
+#include "cntr_global_settings.hpp"
+
+#if CNTR_USE_HDF5 == 1
+
+#include <ctime>
+
+namespace cntr {
+
+template <typename T> class function;
+template <typename T> class herm_matrix;
+
+/// @private
+#define CNTR_CHECKPOINT_FORMAT 1
+
+/** \brief <b> Checkpoint/restart of a time propagation. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Named `herm_matrix` and `function` objects and scalar variables (the state of the
+ * > solver, e.g. the chemical potential or iteration counters) are registered once; `write(tstp)`
+ * > then stores a checkpoint of the state after timestep `tstp`, and `restore()` reads the last
+ * > checkpoint back into the registered objects, so that the propagation continues
+ * > bit-identically at `tstp+1`.
+ * >
+ * > Checkpoints are incremental: the \f$ k\f$-th checkpoint writes only the timesteps
+ * > `tstp` of the registered objects that were completed since the previous one, to the
+ * > segment file `filename.k`. The scalar variables and the list of segments are kept in the
+ * > manifest `filename`, which is written to a temporary file and renamed, so that an
+ * > interrupted checkpoint leaves the previous one intact. The manifest carries a format
+ * > version and the number of checkpoints.
+ * >
+ * > It is assumed that the timesteps of the registered objects do not change after they have
+ * > been checkpointed, i.e. checkpoints are written after the start-up (bootstrapping) phase
+ * > of the propagation. Data are stored lossless; a lossy `hdf5_storage_policy` is not allowed.
+ * > With MPI, only one rank should write, and the decision `due` should be taken on one rank
+ * > if `every_seconds` is used.
+ */
+template <typename T>
+class checkpoint {
+  public:
+    /* construction, destruction */
+    checkpoint();
+    checkpoint(const char *filename, int every_steps = 0, double every_seconds = 0.0);
+    // registration
+    void add(const char *name, herm_matrix<T> &G);
+    void add(const char *name, function<T> &f);
+    void add(const char *name, int &x);
+    void add(const char *name, double &x);
+    // checkpointing
+    bool due(int tstp) const;
+    void write(int tstp);
+    int restore(void);
+    /** \brief Timestep of the last checkpoint (-2: none) */
+    int tstp(void) const { return tstp_; }
+    /** \brief Number of checkpoints (segments) */
+    int version(void) const { return version_; }
+
+  private:
+    /// @private
+    std::string segment_name(int k) const;
+    std::string filename_;                 /*!< Name of the manifest */
+    int every_steps_;                      /*!< Checkpoint every every_steps_ timesteps (0: off) */
+    double every_seconds_;                 /*!< Checkpoint every every_seconds_ seconds (0: off) */
+    int tstp_;                             /*!< Timestep of the last checkpoint */
+    int version_;                          /*!< Number of checkpoints */
+    std::vector<int> segment_tstp_;        /*!< Last timestep of each segment */
+    std::time_t last_time_;                /*!< Time of the last checkpoint */
+    std::vector<std::string> G_names_;     /*!< Names of the registered herm_matrix objects */
+    std::vector<herm_matrix<T> *> G_;      /*!< Registered herm_matrix objects */
+    std::vector<std::string> f_names_;     /*!< Names of the registered function objects */
+    std::vector<function<T> *> f_;         /*!< Registered function objects */
+    std::vector<std::string> int_names_;   /*!< Names of the registered int variables */
+    std::vector<int *> int_;               /*!< Registered int variables */
+    std::vector<std::string> double_names_; /*!< Names of the registered double variables */
+    std::vector<double *> double_;         /*!< Registered double variables */
+};
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
+
+#endif  // CNTR_CHECKPOINT_DECL_H
@@ -0,0 +1,14 @@
+#include "cntr_checkpoint_extern_templates.hpp"
+#include "cntr_function_impl.hpp"
+#include "cntr_herm_matrix_impl.hpp"
+#include "cntr_checkpoint_impl.hpp"
+
+#if CNTR_USE_HDF5 == 1
+
+namespace cntr {
+
+  template class checkpoint<double>;
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
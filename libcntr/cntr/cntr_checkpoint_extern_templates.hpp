@@ -0,0 +1,16 @@
+#ifndef CNTR_CHECKPOINT_EXTERN_TEMPLATES_H
+#define CNTR_CHECKPOINT_EXTERN_TEMPLATES_H
+
+#include "cntr_checkpoint_decl.hpp"
+
+#if CNTR_USE_HDF5 == 1
+
+namespace cntr {
+
+  extern template class checkpoint<double>;
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
+
+#endif  // CNTR_CHECKPOINT_EXTERN_TEMPLATES_H
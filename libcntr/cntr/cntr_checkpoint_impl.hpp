@@ -0,0 +1,396 @@
+#ifndef CNTR_CHECKPOINT_IMPL_H
+#define CNTR_CHECKPOINT_IMPL_H
+
+#include "cntr_checkpoint_decl.hpp"
+#include "cntr_function_decl.hpp"
+#include "cntr_herm_matrix_decl.hpp"
+
+#if CNTR_USE_HDF5 == 1
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace cntr {
+
+/// @private
+// rows (of size element_size) stored for the timesteps t0..t1 of G
+template <typename T>
+size_t checkpoint_rows(const herm_matrix<T> &G, int t0, int t1) {
+    size_t rows = 0;
+    for (int t = t0; t <= t1; t++)
+        rows += (t == -1 ? G.ntau() + 1 : 2 * (t + 1) + G.ntau() + 1);
+    return rows;
+}
+/// @private
+// copies the timesteps t0..t1 of G to buf, or back if unpack
+template <typename T>
+void checkpoint_pack(herm_matrix<T> &G, int t0, int t1, std::complex<T> *buf,
+                     bool unpack) {
+    int es = G.element_size(), ntau = G.ntau();
+    for (int t = t0; t <= t1; t++) {
+        std::complex<T> *ptr[3];
+        int len[3], n;
+        if (t == -1) {
+            ptr[0] = G.matptr(0);
+            len[0] = (ntau + 1) * es;
+            n = 1;
+        } else {
+            ptr[0] = G.retptr(t, 0);
+            ptr[1] = G.lesptr(0, t);
+            ptr[2] = G.tvptr(t, 0);
+            len[0] = len[1] = (t + 1) * es;
+            len[2] = (ntau + 1) * es;
+            n = 3;
+        }
+        for (int i = 0; i < n; i++) {
+            if (unpack)
+                std::copy(buf, buf + len[i], ptr[i]);
+            else
+                std::copy(ptr[i], ptr[i] + len[i], buf);
+            buf += len[i];
+        }
+    }
+}
+
+template <typename T>
+checkpoint<T>::checkpoint() {
+    every_steps_ = 0;
+    every_seconds_ = 0.0;
+    tstp_ = -2;
+    version_ = 0;
+    last_time_ = std::time(0);
+}
+/** \brief <b> Initializes a `checkpoint` with a file name and a checkpoint interval. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Initializes an empty `checkpoint`. No file is accessed.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [const char*] The name of the manifest; segments are stored as `filename.1`, `filename.2`, ...
+ * @param every_steps
+ * > [int] `due(tstp)` is true every `every_steps` timesteps (0: never).
+ * @param every_seconds
+ * > [double] `due(tstp)` is true if the last checkpoint is older than `every_seconds` (0: never).
+ */
+template <typename T>
+checkpoint<T>::checkpoint(const char *filename, int every_steps, double every_seconds) {
+    filename_ = std::string(filename);
+    every_steps_ = every_steps;
+    every_seconds_ = every_seconds;
+    tstp_ = -2;
+    version_ = 0;
+    last_time_ = std::time(0);
+}
+/// @private
+template <typename T>
+std::string checkpoint<T>::segment_name(int k) const {
+    std::ostringstream name;
+    name << filename_ << "." << k;
+    return name.str();
+}
+/** \brief <b> Registers a `herm_matrix` for checkpointing. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Registers `G` under `name`. On `restore`, `G` must have the same dimensions.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param name
+ * > [const char*] Unique name of the object.
+ * @param G
+ * > [herm_matrix<T>] The contour function; referenced by the `checkpoint`.
+ */
+template <typename T>
+void checkpoint<T>::add(const char *name, herm_matrix<T> &G) {
+    G_names_.push_back(std::string(name));
+    G_.push_back(&G);
+}
+/** \brief <b> Registers a `function` for checkpointing. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Registers `f` under `name`. On `restore`, `f` must have the same dimensions.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param name
+ * > [const char*] Unique name of the object.
+ * @param f
+ * > [function<T>] The function; referenced by the `checkpoint`.
+ */
+template <typename T>
+void checkpoint<T>::add(const char *name, function<T> &f) {
+    f_names_.push_back(std::string(name));
+    f_.push_back(&f);
+}
+/** \brief <b> Registers an integer variable for checkpointing. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Registers `x` under `name`. Its value at the time of `write` is stored.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param name
+ * > [const char*] Unique name of the variable.
+ * @param x
+ * > [int] The variable; referenced by the `checkpoint`.
+ */
+template <typename T>
+void checkpoint<T>::add(const char *name, int &x) {
+    int_names_.push_back(std::string(name));
+    int_.push_back(&x);
+}
+/** \brief <b> Registers a double variable for checkpointing. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Registers `x` under `name`. Its value at the time of `write` is stored.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param name
+ * > [const char*] Unique name of the variable.
+ * @param x
+ * > [double] The variable; referenced by the `checkpoint`.
+ */
+template <typename T>
+void checkpoint<T>::add(const char *name, double &x) {
+    double_names_.push_back(std::string(name));
+    double_.push_back(&x);
+}
+/** \brief <b> Returns whether a checkpoint is due after timestep `tstp`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > True if `tstp` is at least `every_steps` timesteps after the last checkpoint
+ * > (or after timestep 0), or if the last checkpoint (or the construction) is more than
+ * > `every_seconds` ago.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] The last completed timestep.
+ */
+template <typename T>
+bool checkpoint<T>::due(int tstp) const {
+    if (tstp <= tstp_)
+        return false;
+    if (every_steps_ > 0 && tstp >= std::max(tstp_, 0) + every_steps_)
+        return true;
+    if (every_seconds_ > 0.0 &&
+        std::difftime(std::time(0), last_time_) >= every_seconds_)
+        return true;
+    return false;
+}
+/** \brief <b> Writes a checkpoint of the state after timestep `tstp`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Writes the timesteps `tstp(),...,tstp` of all registered objects to a new segment
+ * > (all timesteps -1,...,`tstp` for the first checkpoint), and then replaces the manifest
+ * > by one containing the registered variables and the new segment. The first checkpoint
+ * > of a run that was not restored removes an existing manifest first.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] The last completed timestep; must be larger than `tstp()`.
+ *
+ * Throws `std::runtime_error` if the new manifest cannot be moved into place; the
+ * checkpoint then still refers to the previous manifest.
+ */
+template <typename T>
+void checkpoint<T>::write(int tstp) {
+    assert(tstp > tstp_);
+    assert(get_hdf5_storage_policy().tolerance == 0.0);
+    // a stale manifest of an earlier run may refer to the segments overwritten below
+    if (version_ == 0)
+        std::remove(filename_.c_str());
+    int t0 = tstp_ + 1, k = version_ + 1;
+
+    // -- segment
+    hid_t file_id = open_hdf5_file(segment_name(k));
+    store_int_attribute_to_hid(file_id, std::string("t0"), t0);
+    store_int_attribute_to_hid(file_id, std::string("t1"), tstp);
+    for (size_t i = 0; i < G_.size(); i++) {
+        herm_matrix<T> &G = *G_[i];
+        assert(tstp <= G.nt());
+        hid_t group_id = create_group(file_id, G_names_[i]);
+        store_int_attribute_to_hid(group_id, std::string("ntau"), G.ntau());
+        store_int_attribute_to_hid(group_id, std::string("size1"), G.size1());
+        store_int_attribute_to_hid(group_id, std::string("size2"), G.size2());
+        hsize_t len_shape = 3, shape[3];
+        shape[0] = checkpoint_rows(G, t0, tstp);
+        shape[1] = G.size1();
+        shape[2] = G.size2();
+        std::vector<std::complex<T> > buf(shape[0] * G.element_size());
+        checkpoint_pack(G, t0, tstp, buf.data(), false);
+        store_cplx_array_to_hid(group_id, std::string("data"), buf.data(), shape,
+                                len_shape);
+        close_group(group_id);
+    }
+    for (size_t i = 0; i < f_.size(); i++) {
+        function<T> &f = *f_[i];
+        assert(tstp <= f.nt());
+        hid_t group_id = create_group(file_id, f_names_[i]);
+        store_int_attribute_to_hid(group_id, std::string("size1"), f.size1());
+        store_int_attribute_to_hid(group_id, std::string("size2"), f.size2());
+        hsize_t len_shape = 3, shape[3];
+        shape[0] = tstp - t0 + 1;
+        shape[1] = f.size1();
+        shape[2] = f.size2();
+        store_cplx_array_to_hid(group_id, std::string("data"), f.ptr(t0), shape,
+                                len_shape);
+        close_group(group_id);
+    }
+    close_hdf5_file(file_id);
+
+    // -- manifest, replaced atomically
+    std::vector<int> segment_tstp(segment_tstp_);
+    segment_tstp.push_back(tstp);
+    std::string tmpname = filename_ + ".tmp";
+    file_id = open_hdf5_file(tmpname);
+    store_int_attribute_to_hid(file_id, std::string("format"), CNTR_CHECKPOINT_FORMAT);
+    store_int_attribute_to_hid(file_id, std::string("version"), k);
+    store_int_attribute_to_hid(file_id, std::string("tstp"), tstp);
+    hsize_t nseg = k;
+    store_array_to_hid(file_id, std::string("segment_tstp"), segment_tstp.data(),
+                       &nseg, 1, H5T_NATIVE_INT);
+    hid_t group_id = create_group(file_id, std::string("int"));
+    for (size_t i = 0; i < int_.size(); i++)
+        store_int_attribute_to_hid(group_id, int_names_[i], *int_[i]);
+    close_group(group_id);
+    group_id = create_group(file_id, std::string("double"));
+    for (size_t i = 0; i < double_.size(); i++)
+        store_double_attribute_to_hid(group_id, double_names_[i], *double_[i]);
+    close_group(group_id);
+    close_hdf5_file(file_id);
+    if (std::rename(tmpname.c_str(), filename_.c_str()) != 0) {
+        // the previous manifest (if any) and the state of the object are unchanged
+        throw std::runtime_error("checkpoint: cannot rename " + tmpname + " to " + filename_ +
+                                 ": " + std::strerror(errno));
+    }
+
+    segment_tstp_ = segment_tstp;
+    version_ = k;
+    tstp_ = tstp;
+    last_time_ = std::time(0);
+}
+/** \brief <b> Restores the state of the last checkpoint. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Reads the registered variables and the timesteps -1,...,`tstp` of the registered
+ * > objects from the last checkpoint, where `tstp` is the timestep of the checkpoint.
+ * > Objects must have been allocated with the dimensions they had when written.
+ * > Later calls of `write` continue the same sequence of segments.
+ * > Returns `tstp`, or -2 if there is no checkpoint (the objects are not changed).
+ */
+template <typename T>
+int checkpoint<T>::restore(void) {
+    std::FILE *fp = std::fopen(filename_.c_str(), "r");
+    if (fp == 0)
+        return -2;
+    std::fclose(fp);
+
+    // -- manifest
+    hid_t file_id = read_hdf5_file(filename_);
+    int format = read_primitive_type<int>(file_id, "format");
+    assert(format == CNTR_CHECKPOINT_FORMAT);
+    int version = read_primitive_type<int>(file_id, "version");
+    int tstp = read_primitive_type<int>(file_id, "tstp");
+    std::vector<int> segment_tstp(version);
+    read_primitive_type_array(file_id, "segment_tstp", version, segment_tstp.data());
+    hid_t group_id = open_group(file_id, std::string("int"));
+    for (size_t i = 0; i < int_.size(); i++)
+        *int_[i] = read_primitive_type<int>(group_id, int_names_[i]);
+    close_group(group_id);
+    group_id = open_group(file_id, std::string("double"));
+    for (size_t i = 0; i < double_.size(); i++)
+        *double_[i] = read_primitive_type<double>(group_id, double_names_[i]);
+    close_group(group_id);
+    close_hdf5_file(file_id);
+
+    // -- segments
+    for (int k = 1; k <= version; k++) {
+        int t0 = (k == 1 ? -1 : segment_tstp[k - 2] + 1), t1 = segment_tstp[k - 1];
+        file_id = read_hdf5_file(segment_name(k));
+        assert(read_primitive_type<int>(file_id, "t0") == t0);
+        assert(read_primitive_type<int>(file_id, "t1") == t1);
+        for (size_t i = 0; i < G_.size(); i++) {
+            herm_matrix<T> &G = *G_[i];
+            assert(t1 <= G.nt());
+            group_id = open_group(file_id, G_names_[i]);
+            assert(read_primitive_type<int>(group_id, "ntau") == G.ntau());
+            assert(read_primitive_type<int>(group_id, "size1") == G.size1());
+            assert(read_primitive_type<int>(group_id, "size2") == G.size2());
+            std::vector<std::complex<T> > buf(checkpoint_rows(G, t0, t1) *
+                                              G.element_size());
+            read_primitive_type_array(group_id, "data", buf.size(), buf.data());
+            checkpoint_pack(G, t0, t1, buf.data(), true);
+            close_group(group_id);
+        }
+        for (size_t i = 0; i < f_.size(); i++) {
+            function<T> &f = *f_[i];
+            assert(t1 <= f.nt());
+            group_id = open_group(file_id, f_names_[i]);
+            assert(read_primitive_type<int>(group_id, "size1") == f.size1());
+            assert(read_primitive_type<int>(group_id, "size2") == f.size2());
+            read_primitive_type_array(group_id, "data",
+                                      (t1 - t0 + 1) * f.element_size(), f.ptr(t0));
+            close_group(group_id);
+        }
+        close_hdf5_file(file_id);
+    }
+
+    segment_tstp_ = segment_tstp;
+    version_ = version;
+    tstp_ = tstp;
+    last_time_ = std::time(0);
+    return tstp;
+}
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
+
+#endif  // CNTR_CHECKPOINT_IMPL_H
@@ -445,6 +445,36 @@ void convolution_omp(int omp_num_threads, herm_matrix<T> &C, herm_matrix<T> &A,
 #undef CPLX
 #endif // CNTR_USE_OMP
 
+#if CNTR_USE_MPI == 1
+/// @private
+inline void mpi_timestep_ranges(int tstp, int ntau, std::vector<int> &ret_first,
+                                std::vector<int> &tv_first);
+/// @private
+template <typename T>
+void mpi_allgather_timestep_ranges(int tstp, herm_matrix<T> &G, const std::vector<int> &ret_first,
+                                   const std::vector<int> &tv_first);
+/// @private
+template <typename T, class GG, int SIZE1>
+void incr_convolution_mpi(int tstp, std::complex<T> alpha, GG &C, GG &A, GG &Acc,
+                          std::complex<T> *f0, std::complex<T> *ft, GG &B, GG &Bcc,
+                          integration::Integrator<T> &I, T beta, T h);
+template <typename T>
+void convolution_timestep_mpi(int tstp, herm_matrix<T> &C, herm_matrix<T> &A,
+                              herm_matrix<T> &Acc, function<T> &ft, herm_matrix<T> &B,
+                              herm_matrix<T> &Bcc, T beta, T h, int SolveOrder=MAX_SOLVE_ORDER);
+template <typename T>
+void convolution_timestep_mpi(int tstp, herm_matrix<T> &C, herm_matrix<T> &A,
+                              function<T> &ft, herm_matrix<T> &B, T beta, T h,
+                              int SolveOrder=MAX_SOLVE_ORDER);
+template <typename T>
+void convolution_timestep_mpi(int tstp, herm_matrix<T> &C, herm_matrix<T> &A,
+                              herm_matrix<T> &Acc, herm_matrix<T> &B, herm_matrix<T> &Bcc,
+                              T beta, T h, int SolveOrder=MAX_SOLVE_ORDER);
+template <typename T>
+void convolution_timestep_mpi(int tstp, herm_matrix<T> &C, herm_matrix<T> &A,
+                              herm_matrix<T> &B, T beta, T h, int SolveOrder=MAX_SOLVE_ORDER);
+#endif // CNTR_USE_MPI
+
 } // namespace cntr
 
 #endif  // CNTR_CONVOLUTION_DECL_H
@@ -135,4 +135,24 @@ void convolution_omp<double>(int omp_num_threads, herm_matrix<double> &C, herm_m
 
 #endif
 
+#if CNTR_USE_MPI==1
+
+template
+void convolution_timestep_mpi<double>(int tstp, herm_matrix<double> &C, herm_matrix<double> &A,
+                              herm_matrix<double> &Acc, function<double> &ft, herm_matrix<double> &B,
+                              herm_matrix<double> &Bcc, double beta, double h, int SolveOrder);
+template
+void convolution_timestep_mpi<double>(int tstp, herm_matrix<double> &C, herm_matrix<double> &A,
+                              function<double> &ft, herm_matrix<double> &B, double beta, double h,
+                              int SolveOrder);
+template
+void convolution_timestep_mpi<double>(int tstp, herm_matrix<double> &C, herm_matrix<double> &A,
+                              herm_matrix<double> &Acc, herm_matrix<double> &B, herm_matrix<double> &Bcc,
+                              double beta, double h, int SolveOrder);
+template
+void convolution_timestep_mpi<double>(int tstp, herm_matrix<double> &C, herm_matrix<double> &A,
+                              herm_matrix<double> &B, double beta, double h, int SolveOrder);
+
+#endif // CNTR_USE_MPI
+
 }  // namespace cntr
@@ -6,6 +6,7 @@
 #include "cntr_elements.hpp"
 #include "cntr_function_decl.hpp"
 #include "cntr_herm_matrix_decl.hpp"
+#include "cntr_mpitools_decl.hpp"
 
 namespace cntr {
 
@@ -5941,6 +5942,427 @@ void convolution_omp(int omp_num_threads, herm_matrix<T> &C, herm_matrix<T> &A,
 
 #endif
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////
+// MPI paralellized routines
+#if CNTR_USE_MPI == 1
+
+#define CPLX std::complex<T>
+/// @private
+/** \brief <b> Splits the time arguments of a timestep into contiguous ranges, one for each MPI rank </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *   \par Purpose
+ * <!-- ========= -->
+ *
+ * > Rank \f$ r \f$ is responsible for \f$ C^R(t,t_i)\f$ and \f$ C^<(t_{tstp-i},t)\f$ with
+ * > `ret_first[r]` \f$\leq i <\f$ `ret_first[r+1]`, and for \f$ C^\rceil(t,\tau_m)\f$
+ * > (\f$ C^M(\tau_m)\f$ for `tstp=-1`) with `tv_first[r]` \f$\leq m <\f$ `tv_first[r+1]`.
+ * > Pairing the long retarded rows with the short lesser columns balances the work, as for the
+ * > `openMP` masks. The lesser entries of one rank form a contiguous block, too.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] time step
+ * @param ntau
+ * > [int] number of imaginary time points
+ * @param ret_first
+ * > [std::vector<int>] on return: first retarded index of each rank (size ntasks+1)
+ * @param tv_first
+ * > [std::vector<int>] on return: first imaginary time index of each rank (size ntasks+1)
+ */
+inline void mpi_timestep_ranges(int tstp, int ntau, std::vector<int> &ret_first,
+                                std::vector<int> &tv_first) {
+    int ntasks, r;
+    MPI_Comm_size(MPI_COMM_WORLD, &ntasks);
+    ret_first.resize(ntasks + 1);
+    tv_first.resize(ntasks + 1);
+    for (r = 0; r <= ntasks; r++) {
+        ret_first[r] = (tstp >= 0 ? (r * (tstp + 1)) / ntasks : 0);
+        tv_first[r] = (r * (ntau + 1)) / ntasks;
+    }
+}
+
+/// @private
+/** \brief <b> In-place MPI allgather of the ranges of a timestep computed by the individual ranks </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *   \par Purpose
+ * <!-- ========= -->
+ *
+ * > After every rank has computed its part of the timestep `tstp` of `G` (see `mpi_timestep_ranges`),
+ * > the parts are exchanged such that all ranks hold the complete timestep. Since the retarded row,
+ * > the lesser column and the left-mixing row of a timestep are contiguous in memory, this is
+ * > done directly on the data of `G` without any buffer.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] time step
+ * @param G
+ * > [herm_matrix] Green's function; the timestep `tstp` is completed on all ranks
+ * @param ret_first
+ * > [std::vector<int>] first retarded index of each rank
+ * @param tv_first
+ * > [std::vector<int>] first imaginary time index of each rank
+ */
+template <typename T>
+void mpi_allgather_timestep_ranges(int tstp, herm_matrix<T> &G, const std::vector<int> &ret_first,
+                                   const std::vector<int> &tv_first) {
+    int ntasks = ret_first.size() - 1, r;
+    int es = G.element_size();
+    MPI_Datatype dtype = mpi_complex_datatype<T>();
+    std::vector<int> counts(ntasks), displs(ntasks);
+    for (r = 0; r < ntasks; r++) {
+        counts[r] = (tv_first[r + 1] - tv_first[r]) * es;
+        displs[r] = tv_first[r] * es;
+    }
+    if (tstp == -1) {
+        MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, G.matptr(0), counts.data(),
+                       displs.data(), dtype, MPI_COMM_WORLD);
+        return;
+    }
+    MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, G.tvptr(tstp, 0), counts.data(),
+                   displs.data(), dtype, MPI_COMM_WORLD);
+    for (r = 0; r < ntasks; r++) {
+        counts[r] = (ret_first[r + 1] - ret_first[r]) * es;
+        displs[r] = ret_first[r] * es;
+    }
+    MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, G.retptr(tstp, 0), counts.data(),
+                   displs.data(), dtype, MPI_COMM_WORLD);
+    // les(tstp-i,tstp) for ret_first[r] <= i < ret_first[r+1]
+    for (r = 0; r < ntasks; r++)
+        displs[r] = (tstp + 1 - ret_first[r + 1]) * es;
+    MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, G.lesptr(0, tstp), counts.data(),
+                   displs.data(), dtype, MPI_COMM_WORLD);
+}
+
+/// @private
+/** \brief <b> Adds a convolution of two matrices and a function with a given weight to a matrix at a given time step </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *   \par Purpose
+ * <!-- ========= -->
+ *
+ * > Performs the operation \f$C \rightarrow C + \alpha A*ft*B\f$ at time step `tstp`, like
+ * > `incr_convolution_omp`. The time arguments are split into contiguous ranges over the
+ * > MPI ranks, and the timestep of `C` is completed on all ranks by an allgather.
+ * > `C`, `A`, `Acc`, `B` and `Bcc` must be identical on all ranks.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] given time-step
+ * @param alpha
+ * > [CPLX] The weight in front of \f$A*f0*B\f$
+ * @param C
+ * > [GG] contour Green's function
+ * @param A
+ * > [GG] contour Green's function
+ * @param Acc
+ * > [GG] complex conjugate to A
+ * @param *f0
+ * > [std::complex] Pointer to \f$F(-\mathrm{i}\beta)\f$ on the Matsubara axis (this is just a constant matrix)
+ * @param *ft
+ * > [std::complex] Pointer to \f$F(t)\f$ on the real axis (complex function).
+ * @param B
+ * > [GG] contour Green's function
+ * @param Bcc
+ * > [GG] complex conjugate to B
+ * @param I
+ * > [Integrator] integrator class
+ * @param beta
+ * > inversed temperature
+ * @param h
+ * > time step interval
+ */
+template <typename T, class GG, int SIZE1>
+void incr_convolution_mpi(int tstp, CPLX alpha, GG &C, GG &A, GG &Acc, CPLX *f0, CPLX *ft,
+                          GG &B, GG &Bcc, integration::Integrator<T> &I, T beta, T h) {
+    int taskid, ntau = A.ntau(), i;
+    std::vector<int> ret_first, tv_first;
+    MPI_Comm_rank(MPI_COMM_WORLD, &taskid);
+    mpi_timestep_ranges(tstp, ntau, ret_first, tv_first);
+    std::vector<bool> mask_tv(ntau + 1, false);
+    for (i = tv_first[taskid]; i < tv_first[taskid + 1]; i++)
+        mask_tv[i] = true;
+    if (tstp == -1) {
+        incr_convolution_mat<T, GG, SIZE1>(mask_tv, alpha, C, A, f0, B, I, beta);
+    } else if (tstp >= 0) {
+        std::vector<bool> mask_ret(tstp + 1, false);
+        std::vector<bool> mask_les(tstp + 1, false);
+        for (i = ret_first[taskid]; i < ret_first[taskid + 1]; i++) {
+            mask_ret[i] = true;
+            mask_les[tstp - i] = true;
+        }
+        incr_convolution_ret<T, GG, SIZE1>(tstp, mask_ret, alpha, C, A, Acc, ft, B, Bcc, I, h);
+        incr_convolution_tv<T, GG, SIZE1>(tstp, mask_tv, alpha, C, A, Acc, f0, ft, B, Bcc, I,
+                                          beta, h);
+        incr_convolution_les<T, GG, SIZE1>(tstp, mask_les, alpha, C, A, Acc, f0, ft, B, Bcc, I,
+                                           beta, h);
+    }
+    mpi_allgather_timestep_ranges(tstp, C, ret_first, tv_first);
+}
+
+/// @private
+template <typename T>
+void convolution_timestep_mpi_dispatch(int tstp, herm_matrix<T> &C, herm_matrix<T> &A,
+                                       herm_matrix<T> &Acc, CPLX *f0, CPLX *ft,
+                                       herm_matrix<T> &B, herm_matrix<T> &Bcc,
+                                       integration::Integrator<T> &I, T beta, T h) {
+    switch (A.size1()) {
+    case 1:
+        incr_convolution_mpi<T, herm_matrix<T>, 1>(tstp, CPLX(1, 0), C, A, Acc, f0, ft, B, Bcc,
+                                                   I, beta, h);
+        break;
+    case 2:
+        incr_convolution_mpi<T, herm_matrix<T>, 2>(tstp, CPLX(1, 0), C, A, Acc, f0, ft, B, Bcc,
+                                                   I, beta, h);
+        break;
+    case 3:
+        incr_convolution_mpi<T, herm_matrix<T>, 3>(tstp, CPLX(1, 0), C, A, Acc, f0, ft, B, Bcc,
+                                                   I, beta, h);
+        break;
+    case 4:
+        incr_convolution_mpi<T, herm_matrix<T>, 4>(tstp, CPLX(1, 0), C, A, Acc, f0, ft, B, Bcc,
+                                                   I, beta, h);
+        break;
+    case 5:
+        incr_convolution_mpi<T, herm_matrix<T>, 5>(tstp, CPLX(1, 0), C, A, Acc, f0, ft, B, Bcc,
+                                                   I, beta, h);
+        break;
+    case 6:
+        incr_convolution_mpi<T, herm_matrix<T>, 6>(tstp, CPLX(1, 0), C, A, Acc, f0, ft, B, Bcc,
+                                                   I, beta, h);
+        break;
+    case 8:
+        incr_convolution_mpi<T, herm_matrix<T>, 8>(tstp, CPLX(1, 0), C, A, Acc, f0, ft, B, Bcc,
+                                                   I, beta, h);
+        break;
+    default:
+        incr_convolution_mpi<T, herm_matrix<T>, LARGESIZE>(tstp, CPLX(1, 0), C, A, Acc, f0, ft,
+                                                           B, Bcc, I, beta, h);
+        break;
+    }
+}
+
+/** \brief <b> Returns convolution \f$C = A\ast f\ast B\f$ at a given time step, distributed over the MPI ranks</b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Computes contour convolution C=A*f*B of the objects with class 'herm_matrix'
+* > at a given time step 't=nh'. Works for a scalar and square matrices. `MPI` parallelized version:
+* > all arguments must be identical on all ranks. Each rank computes a contiguous range of the
+* > second time argument of \f$C^R\f$, \f$C^<\f$ and of the imaginary time argument of
+* > \f$C^\rceil\f$ (or \f$C^M\f$), and the timestep of `C` is then allgathered, so that it is
+* > known on all ranks on return.
+*
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > [int] time step
+* @param C
+* > [herm_matrix] Matrix to which the result of the convolution is given
+* @param A
+* > [herm_matrix] contour Green's function
+* @param Acc
+* > [herm_matrix] hermitian conjugate of A
+* @param ft
+* > [function] function \f$f\f$
+* @param B
+* > [herm_matrix] contour Green's function
+* @param Bcc
+* > [herm_matrix] hermitian conjugate of B
+* @param beta
+* > inversed temperature
+* @param h
+* > time step interval
+* @param SolveOrder
+* > [int] integrator order
+*/
+template <typename T>
+void convolution_timestep_mpi(int tstp, herm_matrix<T> &C, herm_matrix<T> &A,
+                              herm_matrix<T> &Acc, function<T> &ft, herm_matrix<T> &B,
+                              herm_matrix<T> &Bcc, T beta, T h, int SolveOrder) {
+    int ntmin = (tstp == -1 || tstp > SolveOrder ? tstp : SolveOrder);
+    if (tstp < -1)
+        return;
+    int size1 = A.size1();
+    assert(C.size1()==size1);
+    assert(ft.size1()==size1);
+    assert(B.size1()==size1);
+    assert(Bcc.size1()==size1);
+    assert(Acc.size1()==size1);
+    assert(SolveOrder>=0 && SolveOrder <=5);
+    assert(C.ntau()>=SolveOrder);
+    assert(C.nt()>=ntmin);
+    assert(A.nt()>=ntmin);
+    assert(Acc.nt()>=ntmin);
+    assert(B.nt()>=ntmin);
+    assert(Bcc.nt()>=ntmin);
+    assert(ft.nt()>=ntmin);
+    assert(C.ntau()==A.ntau());
+    assert(C.ntau()==Acc.ntau());
+    assert(C.ntau()==B.ntau());
+    assert(C.ntau()==Bcc.ntau());
+    C.set_timestep_zero(tstp);
+    convolution_timestep_mpi_dispatch<T>(tstp, C, A, Acc, ft.ptr(-1),
+                                         (tstp == -1 ? ft.ptr(-1) : ft.ptr(0)), B, Bcc,
+                                         integration::I<T>(SolveOrder), beta, h);
+}
+
+/** \brief <b> Returns convolution \f$C = A\ast f\ast B\f$ at a given time step, distributed over the MPI ranks</b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Computes contour convolution C=A*f*B of the objects with class 'herm_matrix'
+* > at a given time step 't=nh'. Here we assume that A and B are hermitian.
+* > Works for a scalar and square matrices. `MPI` parallelized version, see above.
+*
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > [int] index of the time step ('t=nh')
+* @param C
+* > [herm_matrix] Matrix to which the result of the convolution is given
+* @param A
+* > [herm_matrix] contour Green's function
+* @param ft
+* > [function] function \f$f\f$
+* @param B
+* > [herm_matrix] contour Green's function
+* @param beta
+* > inversed temperature
+* @param h
+* > time step interval
+* @param SolveOrder
+* > [int] integrator order
+*/
+template <typename T>
+void convolution_timestep_mpi(int tstp, herm_matrix<T> &C, herm_matrix<T> &A,
+                              function<T> &ft, herm_matrix<T> &B, T beta, T h, int SolveOrder) {
+    convolution_timestep_mpi<T>(tstp, C, A, A, ft, B, B, beta, h, SolveOrder);
+}
+
+/** \brief <b> Returns convolution \f$C = A\ast B\f$ at a given time step, distributed over the MPI ranks</b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Computes contour convolution C=A*B of the objects with class 'herm_matrix'
+* > at a given time step 't=nh'. Works for a scalar and square matrices. `MPI` parallelized version:
+* > all arguments must be identical on all ranks, and the timestep of `C` is known on all
+* > ranks on return.
+*
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > [int] index of the time step ('t=nh')
+* @param C
+* > [herm_matrix] Matrix to which the result of the convolution is given
+* @param A
+* > [herm_matrix] contour Green's function
+* @param Acc
+* > [herm_matrix] hermitian conjugate of A
+* @param B
+* > [herm_matrix] contour Green's function
+* @param Bcc
+* > [herm_matrix] hermitian conjugate of B
+* @param beta
+* > inversed temperature
+* @param h
+* > time step interval
+* @param SolveOrder
+* > [int] integrator order
+*/
+template <typename T>
+void convolution_timestep_mpi(int tstp, herm_matrix<T> &C, herm_matrix<T> &A,
+                              herm_matrix<T> &Acc, herm_matrix<T> &B, herm_matrix<T> &Bcc,
+                              T beta, T h, int SolveOrder) {
+    int ntmin = (tstp == -1 || tstp > SolveOrder ? tstp : SolveOrder);
+    if (tstp < -1)
+        return;
+    int size1 = A.size1();
+    assert(C.size1()==size1);
+    assert(B.size1()==size1);
+    assert(Bcc.size1()==size1);
+    assert(Acc.size1()==size1);
+    assert(SolveOrder>=0 && SolveOrder <=5);
+    assert(C.ntau()>=SolveOrder);
+    assert(C.nt()>=ntmin);
+    assert(A.nt()>=ntmin);
+    assert(Acc.nt()>=ntmin);
+    assert(B.nt()>=ntmin);
+    assert(Bcc.nt()>=ntmin);
+    assert(C.ntau()==A.ntau());
+    assert(C.ntau()==Acc.ntau());
+    assert(C.ntau()==B.ntau());
+    assert(C.ntau()==Bcc.ntau());
+    C.set_timestep_zero(tstp);
+    convolution_timestep_mpi_dispatch<T>(tstp, C, A, Acc, NULL, NULL, B, Bcc,
+                                         integration::I<T>(SolveOrder), beta, h);
+}
+
+/** \brief <b> Returns convolution \f$C = A\ast B\f$ at a given time step, distributed over the MPI ranks</b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Computes contour convolution C=A*B of the objects with class 'herm_matrix'
+* > at a given time step 't=nh'. Here we assume that A and B are hermitian.
+* > Works for a scalar and square matrices. `MPI` parallelized version, see above.
+*
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > [int] index of the time step ('t=nh')
+* @param C
+* > [herm_matrix] Matrix to which the result of the convolution is given
+* @param A
+* > [herm_matrix] contour Green's function
+* @param B
+* > [herm_matrix] contour Green's function
+* @param beta
+* > inversed temperature
+* @param h
+* > time step interval
+* @param SolveOrder
+* > [int] integrator order
+*/
+template <typename T>
+void convolution_timestep_mpi(int tstp, herm_matrix<T> &C, herm_matrix<T> &A,
+                              herm_matrix<T> &B, T beta, T h, int SolveOrder) {
+    convolution_timestep_mpi<T>(tstp, C, A, A, B, B, beta, h, SolveOrder);
+}
+
+#undef CPLX
+
+#endif // CNTR_USE_MPI
+
 } // namespace cntr
 
 #endif  // CNTR_CONVOLUTION_IMPL_H
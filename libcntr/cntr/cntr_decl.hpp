@@ -27,11 +27,26 @@
 #include "cntr_bubble_decl.hpp"
 #include "cntr_distributed_array_decl.hpp"
 #include "cntr_distributed_timestep_array_decl.hpp"
+#include "cntr_lattice_convolution_decl.hpp"
+#include "cntr_hdf5_timestep_writer_decl.hpp"
+#include "cntr_hdf5_async_writer_decl.hpp"
+#include "cntr_hdf5_partial_decl.hpp"
+#include "cntr_checkpoint_decl.hpp"
+#include "cntr_snapshot_decl.hpp"
+#include "cntr_tavtrel_decl.hpp"
+#include "cntr_herm_matrix_hdf5_view_decl.hpp"
+#include "cntr_herm_matrix_tti_decl.hpp"
+#include "cntr_wigner_decl.hpp"
+#include "cntr_dlr_decl.hpp"
+#include "cntr_tau_grid_decl.hpp"
+#include "cntr_matsubara_fft_decl.hpp"
+#include "cntr_newton_krylov_decl.hpp"
 
 #include "cntr_getset_decl.hpp"
 
 #if CNTR_USE_MPI == 1
 #include "cntr_mpitools_decl.hpp"
+#include "cntr_hdf5_mpi_decl.hpp"
 #endif
 
 #endif  // CNTR_DECL_H
@@ -34,12 +34,13 @@ public:
   ~distributed_array();
   distributed_array(const distributed_array &g);
   distributed_array &operator=(const distributed_array &g);
-  // #if __cplusplus >= 201103L
-  // distributed_array(distributed_array &&g) noexcept;
-  // distributed_array &operator=(distributed_array &&g) noexcept;
-  // #endif
+#if __cplusplus >= 201103L
+  distributed_array(distributed_array &&g) noexcept;
+  distributed_array &operator=(distributed_array &&g) noexcept;
+#endif
   distributed_array(int n,int maxlen,bool mpi);
   T* block(int j);
+  const T* block(int j) const;
   void clear(void);
   void reset_blocksize(int blocksize);
   T* data(void) const {return data_;}
@@ -48,22 +49,24 @@ public:
   int firstblock_rank(void);
   int blocksize(void) const {return blocksize_;}
   int maxlen(void) const {return maxlen_;}
-  std::vector<int> tid_map(void) const {return tid_map_;}
+  const std::vector<int> &tid_map(void) const {return tid_map_;}
   int tid(void) const {return tid_;}
   int ntasks(void) const {return ntasks_;}
-  bool rank_owns(int k) const {return tid_map()[k] == tid();}
+  bool rank_owns(int k) const {return tid_map_[k] == tid_;}
   
   // MPI UTILS
   // all MPI routines are given "trivial" no MPI versions, which basically assume ntasks=1 and do nothing
 #if CNTR_USE_MPI==0
   void mpi_bcast_block(int j);
   void mpi_bcast_all(void);
+  void mpi_bcast_all(int wire,double tol=0.0);
   void mpi_gather(void);
 #else  // CNTR_USE_MPI==1
   void mpi_send_block(int j,int dest);
   void mpi_gather(int dest);
   void mpi_bcast_block(int j);
   void mpi_bcast_all(void);
+  void mpi_bcast_all(int wire,double tol=0.0);
 #endif  // CNTR_USE_MPI
 private:
   T *data_;                  /*!< Pointer to the contiguous data */
@@ -73,6 +76,7 @@ private:
   std::vector<int> tid_map_; /*!< Returns the rank owning block j \f$ tid_map(j) = tid_\f$. */
   int tid_;                  /*!< mpi rank if MPI is defined, else 0 */
   int ntasks_;               /*!< mpi size if MPI is defined, else 1 */
+  std::vector<double> wire_ref_; /*!< Reference data known to all ranks, used by the CNTR_WIRE_DELTA wire format */
 };
 
 } //namespace cntr
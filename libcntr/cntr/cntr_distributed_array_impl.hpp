@@ -6,6 +6,7 @@
 #ifndef CNTR_DISTRIBUTED_ARRAY_IMPL_H
 #define CNTR_DISTRIBUTED_ARRAY_IMPL_H
 
+#include <algorithm>
 #include "cntr_herm_matrix_timestep_view_decl.hpp"
 #include "cntr_distributed_array_decl.hpp"
 
@@ -37,6 +38,7 @@ template <typename T> distributed_array<T>::distributed_array(const distributed_
 	ntasks_=g.ntasks();
 	tid_map_=g.tid_map();
 	maxlen_=g.maxlen();
+	wire_ref_=g.wire_ref_;
 	len=maxlen_*n_;
 	if(len>0){
 	  data_ = new T [len];
@@ -55,6 +57,7 @@ template <typename T> distributed_array<T> & distributed_array<T>::operator=(con
 	ntasks_=g.ntasks();
 	tid_map_=g.tid_map();
 	maxlen_=g.maxlen();
+	wire_ref_=g.wire_ref_;
 	len=maxlen_*n_;
 	if(len>0){
 		data_ = new T [len];
@@ -65,6 +68,40 @@ template <typename T> distributed_array<T> & distributed_array<T>::operator=(con
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+template <typename T> distributed_array<T>::distributed_array(distributed_array &&g) noexcept
+	: data_(g.data_),
+	  n_(g.n_),
+	  blocksize_(g.blocksize_),
+	  maxlen_(g.maxlen_),
+	  tid_map_(std::move(g.tid_map_)),
+	  tid_(g.tid_),
+	  ntasks_(g.ntasks_),
+	  wire_ref_(std::move(g.wire_ref_)) {
+	g.data_=nullptr;
+	g.n_=0;
+	g.blocksize_=0;
+	g.maxlen_=0;
+}
+template <typename T> distributed_array<T> & distributed_array<T>::operator=(distributed_array &&g) noexcept{
+	if(this==&g) return *this;
+	if(data_!=0) delete [] data_;
+	data_=g.data_;
+	n_=g.n_;
+	blocksize_=g.blocksize_;
+	maxlen_=g.maxlen_;
+	tid_map_=std::move(g.tid_map_);
+	tid_=g.tid_;
+	ntasks_=g.ntasks_;
+	wire_ref_=std::move(g.wire_ref_);
+	g.data_=nullptr;
+	g.n_=0;
+	g.blocksize_=0;
+	g.maxlen_=0;
+	return *this;
+}
+#endif
+
 /** \brief <b> Initializes the `distributed_array` class.  </b>
 *
 * <!-- ====== DOCUMENTATION ====== -->
@@ -168,7 +205,12 @@ template <typename T> distributed_array<T> & distributed_array<T>::operator=(con
 */
   
 template <typename T> T* distributed_array<T>::block(int j){
-	assert(j<=n_-1);
+	assert(0<=j && j<=n_-1);
+	return data_+j*blocksize_;
+}
+/// @private
+template <typename T> const T* distributed_array<T>::block(int j) const{
+	assert(0<=j && j<=n_-1);
 	return data_+j*blocksize_;
 }
 
@@ -196,6 +238,8 @@ template <typename T> void distributed_array<T>::clear(void){
 *
 *
 * > Clear the previous data and reset the block size for each block.
+* > If the block size changes, the reference data of the `CNTR_WIRE_DELTA`
+* > wire format is discarded.
 * <!-- ARGUMENTS
 *      ========= -->
 *
@@ -206,6 +250,7 @@ template <typename T> void distributed_array<T>::clear(void){
 template <typename T> void distributed_array<T>::reset_blocksize(int blocksize){
 	assert(0<=blocksize && 0<=blocksize_ && 0<= (int) maxlen_);
 	clear();
+	if(blocksize!=blocksize_) wire_ref_.clear();
 	blocksize_=blocksize;
 }
 
@@ -261,6 +306,18 @@ template <typename T> int distributed_array<T>::firstblock_rank(void){
 #   MPI UTILS
 #
 ########################################################################################*/
+/// @private
+/** \brief <b> Number of doubles per element for the reduced-size wire formats. </b>
+*
+* Only defined for double and std::complex<double>, so that `mpi_bcast_all(wire,tol)`
+* does not compile for any other type (e.g. std::complex<float>, which has the size of a double).
+*/
+template <typename T> struct distributed_array_wire_doubles;
+/// @private
+template <> struct distributed_array_wire_doubles<double> { enum { value = 1 }; };
+/// @private
+template <> struct distributed_array_wire_doubles<std::complex<double> > { enum { value = 2 }; };
+
 // In case you don't use MPI all routines are given "trivial" no MPI versions, assume ntasks=1 and do nothing
 #if CNTR_USE_MPI==0
 template <typename T> void distributed_array<T>::mpi_bcast_block(int j){
@@ -272,6 +329,10 @@ template <typename T> void distributed_array<T>::mpi_bcast_all(void){
 template <typename T> void distributed_array<T>::mpi_gather(void){
     // donothing
 }
+template <typename T> void distributed_array<T>::mpi_bcast_all(int wire,double tol){
+    // donothing (but only for the types of the MPI version)
+    (void) distributed_array_wire_doubles<T>::value;
+}
 #else  // CNTR_USE_MPI==1
 /** \brief <b> Sends the j-th block to the MPI rank dest  </b>
 *
@@ -396,6 +457,113 @@ template <typename T> void distributed_array<T>::mpi_bcast_all(void){
   	recvcount.data(), displs.data(), MPI_INT, MPI_COMM_WORLD);
 	
 }
+/** \brief <b> MPI Allgather equivalent for the distributed array with a reduced-size wire format </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* MPI Allgather equivalent for the distributed array, where the data is sent in a
+* reduced-size wire format to save bandwidth. The data must consist of double precision
+* numbers (T=double or T=std::complex<double>, checked at compile time). The following wire formats are available:
+* - `CNTR_WIRE_EXACT`: the data is sent unchanged (same as `mpi_bcast_all()`).
+* - `CNTR_WIRE_FLOAT`: the data is converted to single precision before it is sent.
+* - `CNTR_WIRE_DELTA`: the difference to the data of the previous call (which is kept as
+*   reference on all ranks) is sent in single precision. Blocks for which the largest
+*   difference is not larger than `tol` are not sent at all. Close to convergence of
+*   an iteration the differences are small, so the rounding error is small as well.
+*   The reference is reset when the block size changes (e.g. by `reset_blocksize`).
+*
+* The blocks owned by the rank itself are never modified.
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param wire
+* > The wire format (`CNTR_WIRE_EXACT`, `CNTR_WIRE_FLOAT` or `CNTR_WIRE_DELTA`)
+* @param tol
+* > Only for `CNTR_WIRE_DELTA`: blocks with a maximal change not larger than `tol` are skipped
+*/
+template <typename T> void distributed_array<T>::mpi_bcast_all(int wire,double tol){
+  if(wire==CNTR_WIRE_EXACT){
+    mpi_bcast_all();
+    return;
+  }
+  assert(wire==CNTR_WIRE_FLOAT || wire==CNTR_WIRE_DELTA);
+  int double_per_t = distributed_array_wire_doubles<T>::value;
+  int element_size = blocksize_ * double_per_t;
+  double *data = (double*) data_;
+  bool delta = (wire==CNTR_WIRE_DELTA);
+
+  if(delta && (int) wire_ref_.size()!=n_*element_size){
+    wire_ref_.assign(n_*element_size,0.0);
+  }
+
+  // decide which blocks are sent
+  std::vector<int> send(n_, 0);
+  for(int j=0;j<n_;j++) {
+    if(tid_map_[j]!=tid_) continue;
+    if(!delta){
+      send[j]=1;
+    }else{
+      double *x=data+j*element_size;
+      double *xref=wire_ref_.data()+j*element_size;
+      double diff=0.0;
+      for(int i=0;i<element_size;i++) diff=std::max(diff,std::abs(x[i]-xref[i]));
+      send[j]=(diff>tol ? 1 : 0);
+    }
+  }
+
+  std::vector<int> blockcount(ntasks_, 0);
+  for(int j=0;j<n_;j++) blockcount[tid_map_[j]] += 1;
+  std::vector<int> blockdispls(ntasks_, 0);
+  for(int rank = 1; rank < ntasks_; rank++) {
+    blockdispls[rank] = blockdispls[rank - 1] + blockcount[rank - 1];
+  }
+  MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, send.data(),
+    blockcount.data(), blockdispls.data(), MPI_INT, MPI_COMM_WORLD);
+
+  // pack the (converted) data of the blocks which are sent
+  std::vector<int> recvcount(ntasks_, 0);
+  for(int j=0;j<n_;j++) recvcount[tid_map_[j]] += send[j] * element_size;
+  std::vector<int> displs(ntasks_, 0);
+  for(int rank = 1; rank < ntasks_; rank++) {
+    displs[rank] = displs[rank - 1] + recvcount[rank - 1];
+  }
+  std::vector<float> buffer(displs[ntasks_-1] + recvcount[ntasks_-1]);
+  size_t offset = displs[tid_];
+  for(int j=0;j<n_;j++) {
+    if(tid_map_[j]!=tid_ || send[j]==0) continue;
+    double *x=data+j*element_size;
+    if(delta){
+      double *xref=wire_ref_.data()+j*element_size;
+      for(int i=0;i<element_size;i++) buffer[offset+i]=(float)(x[i]-xref[i]);
+    }else{
+      for(int i=0;i<element_size;i++) buffer[offset+i]=(float)x[i];
+    }
+    offset += element_size;
+  }
+
+  MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, buffer.data(),
+    recvcount.data(), displs.data(), MPI_FLOAT, MPI_COMM_WORLD);
+
+  // unpack; the reference is updated identically on all ranks
+  offset = 0;
+  for(int j=0;j<n_;j++) {
+    double *x=data+j*element_size;
+    bool owned=(tid_map_[j]==tid_);
+    if(delta){
+      double *xref=wire_ref_.data()+j*element_size;
+      if(send[j]){
+        for(int i=0;i<element_size;i++) xref[i]+=(double)buffer[offset+i];
+      }
+      if(!owned) memcpy(x, xref, sizeof(double)*element_size);
+    }else if(!owned){
+      for(int i=0;i<element_size;i++) x[i]=(double)buffer[offset+i];
+    }
+    offset += send[j] * element_size;
+  }
+}
 #endif // CNTR_USE_MPI
 
 
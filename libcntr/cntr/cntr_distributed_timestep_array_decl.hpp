@@ -22,6 +22,7 @@ namespace cntr{
   template <typename T>
   class distributed_timestep_array{
   public:
+    typedef typename std::vector<cntr::herm_matrix_timestep_view<T> >::const_iterator const_iterator;
 
     /* construction,destruction  */
     distributed_timestep_array();
@@ -29,23 +30,30 @@ namespace cntr{
     distributed_timestep_array(const distributed_timestep_array &a);
     distributed_timestep_array<T> & operator=(const distributed_timestep_array &a);
     distributed_timestep_array(int n,int nt,int ntau,int size,int sig,bool mpi);
-    // #if __cplusplus >= 201103L
-    //   		distributed_timestep_array(distributed_timestep_array &&a) noexcept;
-    //   		distributed_timestep_array &operator=(distributed_timestep_array &&a) noexcept;
-    // #endif
+#if __cplusplus >= 201103L
+    distributed_timestep_array(distributed_timestep_array &&a) noexcept;
+    distributed_timestep_array &operator=(distributed_timestep_array &&a) noexcept;
+#endif
     ////////////////////////////////////////////
     void reset_tstp(int tstp);
     void clear(void); // se all data to zero
     ////////////////////////////////////////////
-    // access:
+    // access (no copies of the data are made); the data is written only through G(j),
+    // so that the views stay consistent with tstp and the packed storage
     cntr::herm_matrix_timestep_view<T> &G(int j);
+    const cntr::herm_matrix_timestep_view<T> &G(int j) const;
+    const std::vector<cntr::herm_matrix_timestep_view<T> > &G(void) const {return G_;}
+    const_iterator begin(void) const {return G_.begin();}
+    const_iterator end(void) const {return G_.end();}
+    bool rank_owns(int j) const {return data_.rank_owns(j);}
+    // start of the packed data of block j, through the view G(j): mat for tstp=-1, else ret,tv,les
+    std::complex<T> *block(int j) {return (tstp_ == -1 ? G(j).matptr(0) : G(j).retptr(0));}
     ////////////////////////////////////////////
     // MPI collective distribution routines
-    distributed_array<std::complex<T> > data(void) const {return data_;}
+    const distributed_array<std::complex<T> > &data(void) const {return data_;}
     int n(void) const {return n_;}
     int tid(void) const {return tid_;}
     int ntasks(void) const {return ntasks_;}
-    std::vector<cntr::herm_matrix_timestep_view<T> > G(void) const {return G_;}
     int tstp(void) const {return tstp_;}
     int nt(void) const {return nt_;}
     int ntau(void) const {return ntau_;}
@@ -54,6 +62,7 @@ namespace cntr{
 
     void mpi_bcast_block(int j);
     void mpi_bcast_all(void);
+    void mpi_bcast_all(int wire,double tol=0.0);
 
   private:
     distributed_array<std::complex<T> > data_;          /*!< Pointer to the contiguous data */
@@ -58,6 +58,42 @@ template <typename T> distributed_timestep_array<T>& distributed_timestep_array<
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+template <typename T> distributed_timestep_array<T>::distributed_timestep_array(distributed_timestep_array &&a) noexcept
+	: data_(std::move(a.data_)),
+	  n_(a.n_),
+	  tid_(a.tid_),
+	  ntasks_(a.ntasks_),
+	  G_(std::move(a.G_)),
+	  tstp_(a.tstp_),
+	  nt_(a.nt_),
+	  ntau_(a.ntau_),
+	  size_(a.size_),
+	  sig_(a.sig_) {
+	// the views in G_ still point to the (moved) data
+	a.n_=0;
+	a.G_.clear();
+	a.tstp_=-2;
+}
+template <typename T> distributed_timestep_array<T>& distributed_timestep_array<T>::operator=(distributed_timestep_array &&a) noexcept{
+	if(this==&a) return *this;
+	data_=std::move(a.data_);
+	n_=a.n_;
+	tid_=a.tid_;
+	ntasks_=a.ntasks_;
+	G_=std::move(a.G_);
+	tstp_=a.tstp_;
+	nt_=a.nt_;
+	ntau_=a.ntau_;
+	size_=a.size_;
+	sig_=a.sig_;
+	a.n_=0;
+	a.G_.clear();
+	a.tstp_=-2;
+	return *this;
+}
+#endif
+
 /** \brief <b> Initializes the `distributed_timestep_array` class.  </b>
 *
 * <!-- ====== DOCUMENTATION ====== -->
@@ -158,7 +194,12 @@ template <typename T> void distributed_timestep_array<T>::clear(void){
 */
   
 template <typename T> cntr::herm_matrix_timestep_view<T>& distributed_timestep_array<T>::G(int j){
-	assert(0<=j && 0<=n_-1);
+	assert(0<=j && j<=n_-1);
+	return G_[j];
+}
+/// @private
+template <typename T> const cntr::herm_matrix_timestep_view<T>& distributed_timestep_array<T>::G(int j) const{
+	assert(0<=j && j<=n_-1);
 	return G_[j];
 }
 
@@ -198,5 +239,29 @@ template <typename T> void distributed_timestep_array<T>::mpi_bcast_all(void){
 	data_.mpi_bcast_all();
 }
 
+/** \brief <b> MPI allgather equivalent with a reduced-size wire format </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* MPI allgather equivalent of the distributed timestep array, where the data is sent
+* in single precision (`CNTR_WIRE_FLOAT`) or as single precision difference to the
+* previous call (`CNTR_WIRE_DELTA`); see `distributed_array::mpi_bcast_all(int,double)`.
+* The reference of `CNTR_WIRE_DELTA` is kept as long as the time step is not changed
+* by `reset_tstp`, i.e. during the iterations on one time step.
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param wire
+* > The wire format (`CNTR_WIRE_EXACT`, `CNTR_WIRE_FLOAT` or `CNTR_WIRE_DELTA`)
+* @param tol
+* > Only for `CNTR_WIRE_DELTA`: blocks with a maximal change not larger than `tol` are skipped
+*/
+template <typename T> void distributed_timestep_array<T>::mpi_bcast_all(int wire,double tol){
+	data_.mpi_bcast_all(wire,tol);
+}
+
 }
 #endif
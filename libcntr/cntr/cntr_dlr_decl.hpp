@@ -0,0 +1,140 @@
+#ifndef CNTR_DLR_DECL_H
+#define CNTR_DLR_DECL_H
+
+#include "cntr_global_settings.hpp"
+
+namespace cntr {
+
+template <typename T> class herm_matrix;
+
+// Chebyshev points per panel of the fine grids used to select the DLR nodes
+#define CNTR_DLR_PANEL_POINTS 24
+
+/** \brief <b> Class `dlr_basis` defines the discrete Lehmann representation (DLR)
+ * of imaginary-time functions.</b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ *  A function \f$ G(\tau) = \int d\omega\, K(\tau,\omega) A(\omega) \f$,
+ *  \f$ K(\tau,\omega) = -e^{-\omega\tau}/(1+e^{-\beta\omega}) \f$, with spectral support
+ *  in \f$ [-\Lambda/\beta,\Lambda/\beta] \f$ is represented to accuracy \f$ \epsilon \f$ by
+ *  \f$ G(\tau) = \sum_{l} g_l K(\tau,\omega_l) \f$ with \f$ r=O(\log(\Lambda)\log(1/\epsilon)) \f$
+ *  frequencies \f$ \omega_l \f$, selected by a pivoted QR decomposition of the kernel on
+ *  fine composite Chebyshev grids. The coefficients \f$ g_l \f$ are determined by the values
+ *  at \f$ r \f$ interpolation nodes \f$ \tau_k \f$ or at \f$ r \f$ Matsubara frequencies
+ *  \f$ i\nu_n \f$, where \f$ G(i\nu_n)=\sum_l g_l K(i\nu_n,\omega_l) \f$ with
+ *  \f$ K(i\nu_n,\omega)=1/(i\nu_n-\omega) \f$ (fermions) or
+ *  \f$ \tanh(\beta\omega/2)/(i\nu_n-\omega) \f$ (bosons).
+ *
+ *  The Matsubara component and the left-mixing component at a time step (as a function of
+ *  \f$ \tau \f$) are stored as `rank()` coefficient matrices, layout `coef[l*size1*size1]`,
+ *  instead of `ntau+1` values. Convolutions on the Matsubara axis are products at the
+ *  Matsubara nodes, so the Matsubara Dyson equation and VIE2 cost \f$ O(r) \f$ matrix
+ *  inversions, see `dyson_mat_dlr`, `vie2_mat_dlr`, and the left-mixing convolution costs
+ *  \f$ O(r^2) \f$ matrix products per time step, see `dlr_tv_kernel`.
+ *  The object is immutable after construction and can be shared between threads.
+ */
+template <typename T>
+class dlr_basis {
+  public:
+    typedef std::complex<T> cplx;
+    dlr_basis();
+    dlr_basis(T beta, T lambda, T eps, int sig = -1, int ntau = -1);
+    int rank(void) const { return omega_.size(); }
+    T beta(void) const { return beta_; }
+    T lambda(void) const { return lambda_; }
+    T eps(void) const { return eps_; }
+    int sig(void) const { return sig_; }
+    /** \brief <b> Number of intervals of the uniform grid with a precomputed fit (-1 if none) </b> */
+    int ntau(void) const { return ntau_; }
+    /** \brief <b> DLR frequency \f$ \omega_l \f$ </b> */
+    T omega(int l) const { return omega_[l]; }
+    /** \brief <b> Imaginary-time node \f$ \tau_k \f$ </b> */
+    T tau(int k) const { return tau_[k]; }
+    /** \brief <b> Index n of the Matsubara node \f$ i\nu_n \f$ </b> */
+    int matsubara_index(int k) const { return nu_[k]; }
+    T kernel(T tau, T omega) const;
+    cplx kernel_matsubara(int n, T omega) const;
+    /* coefficients from/to values at the tau nodes, the Matsubara nodes, or a uniform grid */
+    void coeffs_from_tau(int size1, const cplx *val, cplx *coef) const;
+    void tau_from_coeffs(int size1, const cplx *coef, cplx *val) const;
+    void coeffs_from_matsubara(int size1, const cplx *val, cplx *coef) const;
+    void matsubara_from_coeffs(int size1, const cplx *coef, cplx *val) const;
+    void coeffs_from_uniform(int size1, int ntau, const cplx *val, cplx *coef) const;
+    void evaluate(int size1, T tau, const cplx *coef, cplx *val) const;
+    void evaluate_matsubara(int size1, int n, const cplx *coef, cplx *val) const;
+
+  private:
+    void uniform_kernel(int ntau, cdmatrix &ku) const;
+    T beta_;
+    T lambda_;
+    T eps_;
+    int sig_;
+    int ntau_;
+    std::vector<T> omega_;
+    std::vector<T> tau_;
+    std::vector<int> nu_;
+    Eigen::PartialPivLU<cdmatrix> ktau_lu_;  /*!< LU of K(tau_k,omega_l) */
+    Eigen::PartialPivLU<cdmatrix> kmat_lu_;  /*!< LU of K(i nu_k,omega_l) */
+    Eigen::ColPivHouseholderQR<cdmatrix> kuni_qr_;  /*!< QR of K(m beta/ntau_,omega_l), m=0..ntau_ */
+};
+
+/** \brief <b> Class `dlr_tv_kernel` precomputes the \f$\tau\f$-integral of the left-mixing
+ * convolution with a fixed Matsubara function in the DLR.</b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > For \f$ B^\mathrm{M} \f$ given by its DLR coefficients, `apply` maps the DLR coefficients
+ * > of \f$ A^\rceil(t,\cdot) \f$ to those of \f$ \int_0^\beta d\tau' A^\rceil(t,\tau')
+ * > B^\mathrm{M}(\tau'-\tau) \f$ with \f$ O(r^2) \f$ matrix products. The integrals of
+ * > products of kernel functions are evaluated analytically.
+ */
+template <typename T>
+class dlr_tv_kernel {
+  public:
+    typedef std::complex<T> cplx;
+    dlr_tv_kernel(const dlr_basis<T> &basis, int size1, const cplx *bmat);
+    int size1(void) const { return size1_; }
+    int rank(void) const { return rank_; }
+    void apply(const cplx *atv, cplx *ctv) const;
+
+  private:
+    int size1_;
+    int rank_;
+    std::vector<cplx> n_;  /*!< n_[(p*rank+l)*es]: coefficient p of the result for a_l=1 */
+};
+
+template <typename T>
+void dlr_get_mat(herm_matrix<T> &G, const dlr_basis<T> &basis, std::complex<T> *coef);
+template <typename T>
+void dlr_set_mat(herm_matrix<T> &G, const dlr_basis<T> &basis, const std::complex<T> *coef);
+template <typename T>
+void dlr_get_tv(int tstp, herm_matrix<T> &G, const dlr_basis<T> &basis, std::complex<T> *coef);
+template <typename T>
+void dlr_set_tv(int tstp, herm_matrix<T> &G, const dlr_basis<T> &basis,
+                const std::complex<T> *coef);
+
+template <typename T>
+void convolution_mat_dlr(std::complex<T> *C, const std::complex<T> *A, const std::complex<T> *B,
+                         int size1, const dlr_basis<T> &basis);
+template <typename T>
+void dyson_mat_dlr(std::complex<T> *G, T mu, cdmatrix &H, const std::complex<T> *Sigma,
+                   const dlr_basis<T> &basis);
+template <typename T>
+void vie2_mat_dlr(std::complex<T> *G, const std::complex<T> *F, const std::complex<T> *Q,
+                  int size1, const dlr_basis<T> &basis);
+template <typename T>
+void convolution_timestep_tv_dlr(int n, std::complex<T> *ctv, herm_matrix<T> &A,
+                                 herm_matrix<T> &Acc, const std::complex<T> *atv,
+                                 const std::complex<T> *btv, const dlr_tv_kernel<T> &Bmat, T h,
+                                 const int SolveOrder = MAX_SOLVE_ORDER);
+
+}  // namespace cntr
+
+#endif  // CNTR_DLR_DECL_H
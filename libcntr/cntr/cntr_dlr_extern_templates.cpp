@@ -0,0 +1,30 @@
+#include "cntr_dlr_extern_templates.hpp"
+#include "cntr_herm_matrix_impl.hpp"
+#include "cntr_dlr_impl.hpp"
+
+namespace cntr {
+
+  template class dlr_basis<double>;
+  template class dlr_tv_kernel<double>;
+  template void dlr_get_mat<double>(herm_matrix<double> &G, const dlr_basis<double> &basis,
+    std::complex<double> *coef);
+  template void dlr_set_mat<double>(herm_matrix<double> &G, const dlr_basis<double> &basis,
+    const std::complex<double> *coef);
+  template void dlr_get_tv<double>(int tstp, herm_matrix<double> &G,
+    const dlr_basis<double> &basis, std::complex<double> *coef);
+  template void dlr_set_tv<double>(int tstp, herm_matrix<double> &G,
+    const dlr_basis<double> &basis, const std::complex<double> *coef);
+  template void convolution_mat_dlr<double>(std::complex<double> *C,
+    const std::complex<double> *A, const std::complex<double> *B, int size1,
+    const dlr_basis<double> &basis);
+  template void dyson_mat_dlr<double>(std::complex<double> *G, double mu, cdmatrix &H,
+    const std::complex<double> *Sigma, const dlr_basis<double> &basis);
+  template void vie2_mat_dlr<double>(std::complex<double> *G, const std::complex<double> *F,
+    const std::complex<double> *Q, int size1, const dlr_basis<double> &basis);
+  template void convolution_timestep_tv_dlr<double>(int n, std::complex<double> *ctv,
+    herm_matrix<double> &A, herm_matrix<double> &Acc, const std::complex<double> *atv,
+    const std::complex<double> *btv, const dlr_tv_kernel<double> &Bmat, double h,
+    const int SolveOrder);
+
+}  // namespace cntr
+
@@ -0,0 +1,792 @@
+#ifndef CNTR_DLR_IMPL_H
+#define CNTR_DLR_IMPL_H
+
+#include "cntr_dlr_decl.hpp"
+#include "cntr_elements.hpp"
+#include "cntr_herm_matrix_decl.hpp"
+#include "integration.hpp"
+
+namespace cntr {
+
+/// @private
+// K(tau,omega) = -e^{-omega tau}/(1+e^{-beta omega}), without overflow for large |beta omega|
+template <typename T>
+inline T dlr_kernel(T beta, T tau, T omega) {
+    if (omega >= 0.0)
+        return -exp(-omega * tau) / (1.0 + exp(-beta * omega));
+    return -exp(omega * (beta - tau)) / (1.0 + exp(beta * omega));
+}
+/// @private
+// Fourier transform of dlr_kernel at the Matsubara frequency nu_n
+template <typename T>
+inline std::complex<T> dlr_kernel_matsubara(T beta, int sig, int n, T omega) {
+    T nu = CNTR_PI / beta * (2 * n + (sig == -1 ? 1 : 0));
+    if (sig == -1)
+        return 1.0 / std::complex<T>(-omega, nu);
+    if (n == 0 && omega == 0.0)
+        return -0.5 * beta;
+    return tanh(0.5 * beta * omega) / std::complex<T>(-omega, nu);
+}
+/// @private
+// c += a*b for row-major size1 x size1 matrices
+template <typename T>
+inline void dlr_incr(int size1, std::complex<T> *c, const std::complex<T> *a,
+                     const std::complex<T> *b) {
+    for (int i = 0; i < size1; i++)
+        for (int l = 0; l < size1; l++)
+            for (int j = 0; j < size1; j++)
+                c[i * size1 + j] += a[i * size1 + l] * b[l * size1 + j];
+}
+/// @private
+// Chebyshev points of the first kind on the panels [p_i,p_{i+1}]
+template <typename T>
+void dlr_panel_points(const std::vector<T> &p, std::vector<T> &x) {
+    int np = CNTR_DLR_PANEL_POINTS;
+    x.clear();
+    for (int i = 0; i + 1 < (int)p.size(); i++) {
+        for (int j = np - 1; j >= 0; j--)
+            x.push_back(0.5 * (p[i] + p[i + 1]) +
+                        0.5 * (p[i + 1] - p[i]) * cos(CNTR_PI * (2 * j + 1) / (2.0 * np)));
+    }
+}
+/// @private
+// integral over [a,a+len] of exp(phi0 - s (x-a)), with phi <= 0 on the interval
+template <typename T>
+inline T dlr_exp_integral(T phi0, T s, T len) {
+    if (len <= 0.0)
+        return 0.0;
+    T y = std::abs(s) * len, phimax = (s >= 0.0 ? phi0 : phi0 - s * len);
+    T g = (y < 1e-8 ? 1.0 - 0.5 * y : -expm1(-y) / y);
+    return exp(phimax) * len * g;
+}
+/// @private
+// int_0^beta dx K(x,wl) B_m(x-tau), B_m(x) = K(x,wm) for x>=0 and sig*K(x+beta,wm) for x<0
+template <typename T>
+T dlr_tv_integral(T beta, int sig, T tau, T wl, T wm) {
+    // K(x,w) = -c e^{-w (x-x0)} with e^{-w (x-x0)} <= 1 on [0,beta]
+    T cl = 1.0 / (1.0 + exp(-beta * std::abs(wl))), xl = (wl >= 0.0 ? 0.0 : beta);
+    T cm = 1.0 / (1.0 + exp(-beta * std::abs(wm))), xm = (wm >= 0.0 ? 0.0 : beta);
+    T s = wl + wm;
+    // x in [tau,beta]: argument x-tau of B
+    T i1 = dlr_exp_integral(-wl * (tau - xl) - wm * (0.0 - xm), s, beta - tau);
+    // x in [0,tau]: argument x-tau+beta of B
+    T i2 = dlr_exp_integral(-wl * (0.0 - xl) - wm * (beta - tau - xm), s, tau);
+    return cl * cm * (i1 + sig * i2);
+}
+
+/* #######################################################################################
+#
+#   CONSTRUCTION
+#
+########################################################################################*/
+template <typename T>
+dlr_basis<T>::dlr_basis() {
+    beta_ = 0.0;
+    lambda_ = 0.0;
+    eps_ = 0.0;
+    sig_ = -1;
+    ntau_ = -1;
+}
+/** \brief <b> Constructs the DLR basis for given \f$ \beta \f$, cutoff and accuracy. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > The kernel \f$ K(\tau,\omega) \f$ is sampled on composite Chebyshev grids in
+ * > \f$ \beta\omega\in[-\Lambda,\Lambda] \f$ and \f$ \tau\in[0,\beta] \f$, with panels refined
+ * > dyadically towards \f$ \omega=0 \f$ and \f$ \tau=0,\beta \f$. A pivoted QR decomposition
+ * > selects the frequencies \f$ \omega_l \f$ (rank at relative accuracy `eps`), then the
+ * > \f$ \tau \f$ nodes and the Matsubara nodes (among \f$ |n|\le\Lambda \f$) by pivoted QR
+ * > of the selected columns. The construction costs \f$ O(\log^2(\Lambda)) \f$ kernel
+ * > columns and is done once. If `ntau` is given, the QR decomposition of the kernel on the
+ * > uniform grid with `ntau` intervals is also computed once, for `coeffs_from_uniform`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param beta
+ * > [T] Inverse temperature.
+ * @param lambda
+ * > [T] Dimensionless cutoff \f$ \Lambda=\beta\omega_{max} \f$.
+ * @param eps
+ * > [T] Accuracy of the representation, e.g. 1e-10.
+ * @param sig
+ * > [int] `sig = -1` for fermions or `sig = +1` for bosons.
+ * @param ntau
+ * > [int] Number of intervals of the uniform grid of the `herm_matrix` objects (optional).
+ */
+template <typename T>
+dlr_basis<T>::dlr_basis(T beta, T lambda, T eps, int sig, int ntau) {
+    int i, j, m, r, nx, nw, nmat;
+    assert(beta > 0.0 && lambda > 0.0 && eps > 0.0 && "beta, lambda, eps > 0");
+    assert((sig == -1 || sig == 1) && "sig = -1 or 1");
+    beta_ = beta;
+    lambda_ = lambda;
+    eps_ = eps;
+    sig_ = sig;
+    // dimensionless fine grids (beta=1)
+    m = std::max(1, (int)ceil(log(lambda) / log(2.0)));
+    std::vector<T> pw, px, w, x, w1, x1;
+    pw.push_back(0.0);
+    for (i = m; i >= 0; i--)
+        pw.push_back(lambda * pow(2.0, -i));
+    dlr_panel_points(pw, w1);
+    for (i = (int)w1.size() - 1; i >= 0; i--)
+        w.push_back(-w1[i]);
+    w.insert(w.end(), w1.begin(), w1.end());
+    px.push_back(0.0);
+    for (i = m; i >= 1; i--)
+        px.push_back(pow(2.0, -i));
+    dlr_panel_points(px, x1);
+    x = x1;
+    for (i = (int)x1.size() - 1; i >= 0; i--)
+        x.push_back(1.0 - x1[i]);
+    nx = x.size();
+    nw = w.size();
+    dmatrix kfine(nx, nw);
+    for (i = 0; i < nx; i++)
+        for (j = 0; j < nw; j++)
+            kfine(i, j) = dlr_kernel<T>(1.0, x[i], w[j]);
+    // frequencies
+    Eigen::ColPivHouseholderQR<dmatrix> qrw(kfine);
+    qrw.setThreshold(eps);
+    r = qrw.rank();
+    std::vector<int> iw(r);
+    for (j = 0; j < r; j++)
+        iw[j] = qrw.colsPermutation().indices()(j);
+    std::sort(iw.begin(), iw.end());
+    omega_.resize(r);
+    for (j = 0; j < r; j++)
+        omega_[j] = w[iw[j]] / beta;
+    // tau nodes
+    dmatrix kt(r, nx);
+    for (j = 0; j < r; j++)
+        for (i = 0; i < nx; i++)
+            kt(j, i) = kfine(i, iw[j]);
+    Eigen::ColPivHouseholderQR<dmatrix> qrx(kt);
+    std::vector<int> ix(r);
+    for (j = 0; j < r; j++)
+        ix[j] = qrx.colsPermutation().indices()(j);
+    std::sort(ix.begin(), ix.end());
+    tau_.resize(r);
+    for (j = 0; j < r; j++)
+        tau_[j] = x[ix[j]] * beta;
+    // Matsubara nodes
+    nmat = std::max(100, (int)ceil(lambda));
+    cdmatrix km(r, 2 * nmat + 1);
+    for (j = 0; j < r; j++)
+        for (i = -nmat; i <= nmat; i++)
+            km(j, i + nmat) = dlr_kernel_matsubara<T>(1.0, sig, i, w[iw[j]]);
+    Eigen::ColPivHouseholderQR<cdmatrix> qrm(km);
+    nu_.resize(r);
+    for (j = 0; j < r; j++)
+        nu_[j] = qrm.colsPermutation().indices()(j) - nmat;
+    std::sort(nu_.begin(), nu_.end());
+    // interpolation matrices
+    cdmatrix ktau(r, r), kmat(r, r);
+    for (i = 0; i < r; i++) {
+        for (j = 0; j < r; j++) {
+            ktau(i, j) = kernel(tau_[i], omega_[j]);
+            kmat(i, j) = kernel_matsubara(nu_[i], omega_[j]);
+        }
+    }
+    ktau_lu_.compute(ktau);
+    kmat_lu_.compute(kmat);
+    // least-squares fit on the uniform grid
+    ntau_ = ntau;
+    if (ntau >= 0) {
+        cdmatrix ku;
+        uniform_kernel(ntau, ku);
+        kuni_qr_.compute(ku);
+    }
+}
+/// @private
+// K(tau_m,omega_l) on the uniform grid tau_m=m*beta/ntau
+template <typename T>
+void dlr_basis<T>::uniform_kernel(int ntau, cdmatrix &ku) const {
+    int r = rank();
+    assert(ntau + 1 >= r && "ntau+1 >= rank");
+    ku.resize(ntau + 1, r);
+    for (int m = 0; m <= ntau; m++)
+        for (int l = 0; l < r; l++)
+            ku(m, l) = kernel(m * beta_ / ntau, omega_[l]);
+}
+
+/* #######################################################################################
+#
+#   KERNEL AND TRANSFORMATIONS
+#
+########################################################################################*/
+/** \brief <b> Returns \f$ K(\tau,\omega)=-e^{-\omega\tau}/(1+e^{-\beta\omega}) \f$ </b> */
+template <typename T>
+T dlr_basis<T>::kernel(T tau, T omega) const {
+    return dlr_kernel<T>(beta_, tau, omega);
+}
+/** \brief <b> Returns \f$ \int_0^\beta d\tau\, e^{i\nu_n\tau} K(\tau,\omega) \f$ </b> */
+template <typename T>
+std::complex<T> dlr_basis<T>::kernel_matsubara(int n, T omega) const {
+    return dlr_kernel_matsubara<T>(beta_, sig_, n, omega);
+}
+/** \brief <b> DLR coefficients from the values at the \f$ \tau \f$ nodes. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Solves \f$ \sum_l K(\tau_k,\omega_l) g_l = G(\tau_k) \f$ with the precomputed LU
+ * > decomposition.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param size1
+ * > [int] Matrix size.
+ * @param val
+ * > [complex<T>*] Values \f$ G(\tau_k) \f$ at `val[k*size1*size1]`.
+ * @param coef
+ * > [complex<T>*] On return, the coefficients \f$ g_l \f$ at `coef[l*size1*size1]`.
+ */
+template <typename T>
+void dlr_basis<T>::coeffs_from_tau(int size1, const cplx *val, cplx *coef) const {
+    int es = size1 * size1, r = rank();
+    Eigen::Map<const cdmatrix> v(val, es, r);
+    Eigen::Map<cdmatrix> c(coef, es, r);
+    c = ktau_lu_.solve(v.transpose()).transpose();
+}
+/** \brief <b> Values at the \f$ \tau \f$ nodes from the DLR coefficients. </b> */
+template <typename T>
+void dlr_basis<T>::tau_from_coeffs(int size1, const cplx *coef, cplx *val) const {
+    int es = size1 * size1, r = rank();
+    for (int k = 0; k < r; k++)
+        evaluate(size1, tau_[k], coef, val + k * es);
+}
+/** \brief <b> DLR coefficients from the values at the Matsubara nodes. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Solves \f$ \sum_l K(i\nu_{n_k},\omega_l) g_l = G(i\nu_{n_k}) \f$, \f$ n_k \f$ =
+ * > `matsubara_index(k)`, with the precomputed LU decomposition.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param size1
+ * > [int] Matrix size.
+ * @param val
+ * > [complex<T>*] Values \f$ G(i\nu_{n_k}) \f$ at `val[k*size1*size1]`.
+ * @param coef
+ * > [complex<T>*] On return, the coefficients \f$ g_l \f$ at `coef[l*size1*size1]`.
+ */
+template <typename T>
+void dlr_basis<T>::coeffs_from_matsubara(int size1, const cplx *val, cplx *coef) const {
+    int es = size1 * size1, r = rank();
+    Eigen::Map<const cdmatrix> v(val, es, r);
+    Eigen::Map<cdmatrix> c(coef, es, r);
+    c = kmat_lu_.solve(v.transpose()).transpose();
+}
+/** \brief <b> Values at the Matsubara nodes from the DLR coefficients. </b> */
+template <typename T>
+void dlr_basis<T>::matsubara_from_coeffs(int size1, const cplx *coef, cplx *val) const {
+    int es = size1 * size1, r = rank();
+    for (int k = 0; k < r; k++)
+        evaluate_matsubara(size1, nu_[k], coef, val + k * es);
+}
+/** \brief <b> DLR coefficients from values on the uniform grid \f$ \tau_m=m\beta/ntau \f$. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Least-squares fit of the coefficients to `ntau+1` values (e.g. the Matsubara component
+ * > of a `herm_matrix`). If `ntau` is the grid given to the constructor, the precomputed
+ * > QR decomposition is used and the fit costs \f$ O(ntau\,r\,size1^2) \f$ operations;
+ * > otherwise the kernel is decomposed in each call, with \f$ O(ntau\,r^2) \f$ operations.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param size1
+ * > [int] Matrix size.
+ * @param ntau
+ * > [int] Number of intervals of the uniform grid.
+ * @param val
+ * > [complex<T>*] Values \f$ G(\tau_m) \f$ at `val[m*size1*size1]`, m=0,...,ntau.
+ * @param coef
+ * > [complex<T>*] On return, the coefficients \f$ g_l \f$ at `coef[l*size1*size1]`.
+ */
+template <typename T>
+void dlr_basis<T>::coeffs_from_uniform(int size1, int ntau, const cplx *val, cplx *coef) const {
+    int es = size1 * size1, r = rank();
+    Eigen::Map<const cdmatrix> v(val, es, ntau + 1);
+    Eigen::Map<cdmatrix> c(coef, es, r);
+    if (ntau == ntau_) {
+        c = kuni_qr_.solve(v.transpose()).transpose();
+    } else {
+        cdmatrix ku;
+        uniform_kernel(ntau, ku);
+        c = ku.colPivHouseholderQr().solve(v.transpose()).transpose();
+    }
+}
+/** \brief <b> Evaluates \f$ G(\tau)=\sum_l g_l K(\tau,\omega_l) \f$ at given \f$ \tau \f$. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Evaluates the DLR expansion at \f$ 0\le\tau\le\beta \f$.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param size1
+ * > [int] Matrix size.
+ * @param tau
+ * > [T] Imaginary time.
+ * @param coef
+ * > [complex<T>*] The coefficients \f$ g_l \f$ at `coef[l*size1*size1]`.
+ * @param val
+ * > [complex<T>*] On return, \f$ G(\tau) \f$ (size1*size1 entries).
+ */
+template <typename T>
+void dlr_basis<T>::evaluate(int size1, T tau, const cplx *coef, cplx *val) const {
+    int es = size1 * size1;
+    for (int e = 0; e < es; e++)
+        val[e] = 0.0;
+    for (int l = 0; l < rank(); l++) {
+        T k = kernel(tau, omega_[l]);
+        for (int e = 0; e < es; e++)
+            val[e] += k * coef[l * es + e];
+    }
+}
+/** \brief <b> Evaluates \f$ G(i\nu_n)=\sum_l g_l K(i\nu_n,\omega_l) \f$. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Evaluates the DLR expansion at the Matsubara frequency \f$ \nu_n \f$.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param size1
+ * > [int] Matrix size.
+ * @param n
+ * > [int] Index of the Matsubara frequency.
+ * @param coef
+ * > [complex<T>*] The coefficients \f$ g_l \f$ at `coef[l*size1*size1]`.
+ * @param val
+ * > [complex<T>*] On return, \f$ G(i\nu_n) \f$ (size1*size1 entries).
+ */
+template <typename T>
+void dlr_basis<T>::evaluate_matsubara(int size1, int n, const cplx *coef, cplx *val) const {
+    int es = size1 * size1;
+    for (int e = 0; e < es; e++)
+        val[e] = 0.0;
+    for (int l = 0; l < rank(); l++) {
+        cplx k = kernel_matsubara(n, omega_[l]);
+        for (int e = 0; e < es; e++)
+            val[e] += k * coef[l * es + e];
+    }
+}
+
+/* #######################################################################################
+#
+#   LEFT-MIXING CONVOLUTION KERNEL
+#
+########################################################################################*/
+/** \brief <b> Precomputes the left-mixing convolution with \f$ B^\mathrm{M} \f$. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Computes \f$ M_{kl} = \sum_m b_m \int_0^\beta d\tau' K(\tau',\omega_l) K(\tau'-\tau_k,\omega_m) \f$
+ * > (with the (anti)periodic extension of the second factor) and folds in the map from the
+ * > values at the \f$ \tau \f$ nodes to coefficients; \f$ O(r^3) \f$ operations.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param basis
+ * > [dlr_basis] The DLR basis.
+ * @param size1
+ * > [int] Matrix size.
+ * @param bmat
+ * > [complex<T>*] DLR coefficients of \f$ B^\mathrm{M} \f$.
+ */
+template <typename T>
+dlr_tv_kernel<T>::dlr_tv_kernel(const dlr_basis<T> &basis, int size1, const cplx *bmat) {
+    int r = basis.rank(), es = size1 * size1, k, l, m, e;
+    size1_ = size1;
+    rank_ = r;
+    std::vector<cplx> mkl((size_t)r * r * es, 0.0);
+    for (k = 0; k < r; k++) {
+        for (l = 0; l < r; l++) {
+            cplx *z = &mkl[((size_t)l * r + k) * es];
+            for (m = 0; m < r; m++) {
+                T j = dlr_tv_integral<T>(basis.beta(), basis.sig(), basis.tau(k),
+                                         basis.omega(l), basis.omega(m));
+                for (e = 0; e < es; e++)
+                    z[e] += j * bmat[m * es + e];
+            }
+        }
+    }
+    // coefficients of the result for a_l=1: n_[p*r+l] = sum_k (K^{-1})_{pk} M_{kl}
+    n_.resize((size_t)r * r * es);
+    for (l = 0; l < r; l++) {
+        std::vector<cplx> c(r * es);
+        basis.coeffs_from_tau(size1, &mkl[(size_t)l * r * es], c.data());
+        for (k = 0; k < r; k++)
+            element_set<T, LARGESIZE>(size1, &n_[((size_t)k * r + l) * es], &c[k * es]);
+    }
+}
+/** \brief <b> Applies the left-mixing convolution kernel. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Computes the DLR coefficients of \f$ \int_0^\beta d\tau' A^\rceil(\tau')
+ * > B^\mathrm{M}(\tau'-\tau) \f$ from those of \f$ A^\rceil \f$; \f$ O(r^2) \f$ matrix products.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param atv
+ * > [complex<T>*] DLR coefficients of \f$ A^\rceil(t,\cdot) \f$.
+ * @param ctv
+ * > [complex<T>*] On return, DLR coefficients of the result.
+ */
+template <typename T>
+void dlr_tv_kernel<T>::apply(const cplx *atv, cplx *ctv) const {
+    int r = rank_, es = size1_ * size1_;
+    for (int p = 0; p < r; p++) {
+        cplx *c = ctv + p * es;
+        for (int e = 0; e < es; e++)
+            c[e] = 0.0;
+        for (int l = 0; l < r; l++)
+            dlr_incr(size1_, c, atv + l * es, &n_[((size_t)p * r + l) * es]);
+    }
+}
+
+/* #######################################################################################
+#
+#   CONVERSION FROM/TO herm_matrix
+#
+########################################################################################*/
+/** \brief <b> DLR coefficients of the Matsubara component of `herm_matrix`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Least-squares fit to the values on the uniform grid, see `coeffs_from_uniform`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix] The contour function.
+ * @param basis
+ * > [dlr_basis] The DLR basis.
+ * @param coef
+ * > [complex<T>*] On return, the coefficients (rank*element_size entries).
+ */
+template <typename T>
+void dlr_get_mat(herm_matrix<T> &G, const dlr_basis<T> &basis, std::complex<T> *coef) {
+    assert(G.size1() == G.size2() && "G.size1() == G.size2()");
+    basis.coeffs_from_uniform(G.size1(), G.ntau(), G.matptr(0), coef);
+}
+/** \brief <b> Sets the Matsubara component of `herm_matrix` from DLR coefficients. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Evaluates the DLR expansion on the uniform grid of `G`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix] The contour function.
+ * @param basis
+ * > [dlr_basis] The DLR basis.
+ * @param coef
+ * > [complex<T>*] The coefficients (rank*element_size entries).
+ */
+template <typename T>
+void dlr_set_mat(herm_matrix<T> &G, const dlr_basis<T> &basis, const std::complex<T> *coef) {
+    assert(G.size1() == G.size2() && "G.size1() == G.size2()");
+    for (int m = 0; m <= G.ntau(); m++)
+        basis.evaluate(G.size1(), m * basis.beta() / G.ntau(), coef, G.matptr(m));
+}
+/** \brief <b> DLR coefficients of the left-mixing component of `herm_matrix` at a time step. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Least-squares fit of \f$ C^\rceil(t,\tau) \f$ to the values on the uniform grid, see
+ * > `coeffs_from_uniform`; with `basis` constructed for `G.ntau()`, the decomposition of the
+ * > kernel is not repeated in each time step.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] Time step.
+ * @param G
+ * > [herm_matrix] The contour function.
+ * @param basis
+ * > [dlr_basis] The DLR basis.
+ * @param coef
+ * > [complex<T>*] On return, the coefficients (rank*element_size entries).
+ */
+template <typename T>
+void dlr_get_tv(int tstp, herm_matrix<T> &G, const dlr_basis<T> &basis, std::complex<T> *coef) {
+    assert(tstp >= 0 && tstp <= G.nt() && "tstp >= 0 && tstp <= nt");
+    assert(G.size1() == G.size2() && "G.size1() == G.size2()");
+    basis.coeffs_from_uniform(G.size1(), G.ntau(), G.tvptr(tstp, 0), coef);
+}
+/** \brief <b> Sets the left-mixing component of `herm_matrix` at a time step from DLR coefficients. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Evaluates the DLR expansion on the uniform grid of `G`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] Time step.
+ * @param G
+ * > [herm_matrix] The contour function.
+ * @param basis
+ * > [dlr_basis] The DLR basis.
+ * @param coef
+ * > [complex<T>*] The coefficients (rank*element_size entries).
+ */
+template <typename T>
+void dlr_set_tv(int tstp, herm_matrix<T> &G, const dlr_basis<T> &basis,
+                const std::complex<T> *coef) {
+    assert(tstp >= 0 && tstp <= G.nt() && "tstp >= 0 && tstp <= nt");
+    assert(G.size1() == G.size2() && "G.size1() == G.size2()");
+    for (int m = 0; m <= G.ntau(); m++)
+        basis.evaluate(G.size1(), m * basis.beta() / G.ntau(), coef, G.tvptr(tstp, m));
+}
+
+/* #######################################################################################
+#
+#   MATSUBARA SOLVERS
+#
+########################################################################################*/
+/** \brief <b> Matsubara convolution \f$ C^\mathrm{M}=A^\mathrm{M}*B^\mathrm{M} \f$ in the DLR. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Computes \f$ C(i\nu)=A(i\nu)B(i\nu) \f$ at the Matsubara nodes; \f$ O(r) \f$ matrix
+ * > products and \f$ O(r^2) \f$ kernel evaluations.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param C
+ * > [complex<T>*] On return, DLR coefficients of \f$ C^\mathrm{M} \f$.
+ * @param A
+ * > [complex<T>*] DLR coefficients of \f$ A^\mathrm{M} \f$.
+ * @param B
+ * > [complex<T>*] DLR coefficients of \f$ B^\mathrm{M} \f$.
+ * @param size1
+ * > [int] Matrix size.
+ * @param basis
+ * > [dlr_basis] The DLR basis.
+ */
+template <typename T>
+void convolution_mat_dlr(std::complex<T> *C, const std::complex<T> *A, const std::complex<T> *B,
+                         int size1, const dlr_basis<T> &basis) {
+    int r = basis.rank(), es = size1 * size1;
+    std::vector<std::complex<T> > a(r * es), b(r * es), c(r * es);
+    basis.matsubara_from_coeffs(size1, A, a.data());
+    basis.matsubara_from_coeffs(size1, B, b.data());
+    for (int k = 0; k < r; k++)
+        element_mult<T, LARGESIZE>(size1, &c[k * es], &a[k * es], &b[k * es]);
+    basis.coeffs_from_matsubara(size1, c.data(), C);
+}
+/** \brief <b> Solves the Matsubara Dyson equation in the DLR. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Solves \f$ [-\partial_\tau + \mu - H] G^\mathrm{M}(\tau) - [\Sigma^\mathrm{M}*G^\mathrm{M}](\tau)
+ * > = \delta(\tau) \f$ as \f$ G(i\nu)=[i\nu+\mu-H-\Sigma(i\nu)]^{-1} \f$ at the \f$ r \f$
+ * > Matsubara nodes, i.e. with \f$ O(r) \f$ matrix inversions instead of \f$ O(ntau^2) \f$
+ * > operations. The same equation as `dyson_mat`; \f$ H \f$ includes the mean-field part
+ * > of the self-energy.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [complex<T>*] On return, DLR coefficients of \f$ G^\mathrm{M} \f$.
+ * @param mu
+ * > [T] Chemical potential.
+ * @param H
+ * > [cdmatrix] Hamiltonian.
+ * @param Sigma
+ * > [complex<T>*] DLR coefficients of \f$ \Sigma^\mathrm{M} \f$.
+ * @param basis
+ * > [dlr_basis] The DLR basis.
+ */
+template <typename T>
+void dyson_mat_dlr(std::complex<T> *G, T mu, cdmatrix &H, const std::complex<T> *Sigma,
+                   const dlr_basis<T> &basis) {
+    typedef std::complex<T> cplx;
+    int r = basis.rank(), size1 = H.rows(), es = size1 * size1;
+    assert(H.rows() == H.cols() && "H.rows() == H.cols()");
+    std::vector<cplx> s(r * es), g(r * es), z(es), hmu(es);
+    basis.matsubara_from_coeffs(size1, Sigma, s.data());
+    for (int i = 0; i < size1; i++)
+        for (int j = 0; j < size1; j++)
+            hmu[i * size1 + j] = H(i, j) - (i == j ? mu : 0.0);
+    for (int k = 0; k < r; k++) {
+        cplx iw(0.0, CNTR_PI / basis.beta() *
+                          (2 * basis.matsubara_index(k) + (basis.sig() == -1 ? 1 : 0)));
+        for (int e = 0; e < es; e++)
+            z[e] = -hmu[e] - s[k * es + e];
+        for (int i = 0; i < size1; i++)
+            z[i * size1 + i] += iw;
+        element_inverse<T, LARGESIZE>(size1, &g[k * es], z.data());
+    }
+    basis.coeffs_from_matsubara(size1, g.data(), G);
+}
+/** \brief <b> Solves the Matsubara VIE2 in the DLR. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Solves \f$ G^\mathrm{M} + F^\mathrm{M}*G^\mathrm{M} = Q^\mathrm{M} \f$ as
+ * > \f$ G(i\nu)=[1+F(i\nu)]^{-1}Q(i\nu) \f$ at the \f$ r \f$ Matsubara nodes.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [complex<T>*] On return, DLR coefficients of \f$ G^\mathrm{M} \f$.
+ * @param F
+ * > [complex<T>*] DLR coefficients of \f$ F^\mathrm{M} \f$.
+ * @param Q
+ * > [complex<T>*] DLR coefficients of \f$ Q^\mathrm{M} \f$.
+ * @param size1
+ * > [int] Matrix size.
+ * @param basis
+ * > [dlr_basis] The DLR basis.
+ */
+template <typename T>
+void vie2_mat_dlr(std::complex<T> *G, const std::complex<T> *F, const std::complex<T> *Q,
+                  int size1, const dlr_basis<T> &basis) {
+    typedef std::complex<T> cplx;
+    int r = basis.rank(), es = size1 * size1;
+    std::vector<cplx> f(r * es), q(r * es), g(r * es);
+    basis.matsubara_from_coeffs(size1, F, f.data());
+    basis.matsubara_from_coeffs(size1, Q, q.data());
+    for (int k = 0; k < r; k++) {
+        for (int i = 0; i < size1; i++)
+            f[k * es + i * size1 + i] += 1.0;
+        element_linsolve_right<T, LARGESIZE>(size1, &g[k * es], &f[k * es], &q[k * es]);
+    }
+    basis.coeffs_from_matsubara(size1, g.data(), G);
+}
+
+/** \brief <b> Left-mixing convolution at a time step in the DLR. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Computes the DLR coefficients of
+ * > \f$ C^\rceil(t_n,\tau) = \int_0^\beta d\tau' A^\rceil(t_n,\tau') B^\mathrm{M}(\tau'-\tau)
+ * >  + \int_0^{t_n} ds\, A^\mathrm{R}(t_n,s) B^\rceil(s,\tau) \f$,
+ * > as `convolution_timestep_tv`, with the left-mixing components given by their DLR
+ * > coefficients at all time steps. The cost per time step is \f$ O((r+n)r) \f$ matrix
+ * > products instead of \f$ O((ntau+n)ntau) \f$. Only the retarded components of `A` and
+ * > `Acc` are used.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param n
+ * > [int] Time step.
+ * @param ctv
+ * > [complex<T>*] On return, DLR coefficients of \f$ C^\rceil(t_n,\cdot) \f$.
+ * @param A
+ * > [herm_matrix] Contour function A (retarded component).
+ * @param Acc
+ * > [herm_matrix] Hermitian conjugate of A (retarded component).
+ * @param atv
+ * > [complex<T>*] DLR coefficients of \f$ A^\rceil(t_j,\cdot) \f$ at `atv[j*rank*element_size]`.
+ * @param btv
+ * > [complex<T>*] DLR coefficients of \f$ B^\rceil(t_j,\cdot) \f$, same layout.
+ * @param Bmat
+ * > [dlr_tv_kernel] Kernel of \f$ B^\mathrm{M} \f$.
+ * @param h
+ * > [T] Time step interval.
+ * @param SolveOrder
+ * > [const int] Order of integration.
+ */
+template <typename T>
+void convolution_timestep_tv_dlr(int n, std::complex<T> *ctv, herm_matrix<T> &A,
+                                 herm_matrix<T> &Acc, const std::complex<T> *atv,
+                                 const std::complex<T> *btv, const dlr_tv_kernel<T> &Bmat, T h,
+                                 const int SolveOrder) {
+    typedef std::complex<T> cplx;
+    int size1 = Bmat.size1(), es = size1 * size1, r = Bmat.rank();
+    int k = SolveOrder, n1 = (n > k ? n : k);
+    integration::Integrator<T> I(k);
+    assert(A.size1() == size1 && Acc.size1() == size1 && "size1");
+    assert(A.nt() >= n1 && Acc.nt() >= n1 && "nt >= max(n,SolveOrder)");
+    std::vector<cplx> atemp(es);
+    Bmat.apply(atv + (size_t)n * r * es, ctv);
+    for (int j = 0; j <= n1; j++) {
+        T weight = I.gregory_weights(n, j);
+        if (n < j) {
+            element_conj<T, LARGESIZE>(size1, atemp.data(), Acc.retptr(j, n));
+            element_smul<T, LARGESIZE>(size1, atemp.data(), -1);
+        } else {
+            element_set<T, LARGESIZE>(size1, atemp.data(), A.retptr(n, j));
+        }
+        element_smul<T, LARGESIZE>(size1, atemp.data(), h * weight);
+        for (int l = 0; l < r; l++)
+            dlr_incr(size1, ctv + l * es, atemp.data(), btv + ((size_t)j * r + l) * es);
+    }
+}
+
+}  // namespace cntr
+
+#endif  // CNTR_DLR_IMPL_H
@@ -7,6 +7,7 @@
 #include "cntr_function_decl.hpp"
 #include "cntr_herm_matrix_decl.hpp"
 #include "cntr_matsubara_impl.hpp"
+#include "cntr_matsubara_fft_decl.hpp"
 #include "cntr_convolution_impl.hpp"
 #include "cntr_equilibrium_decl.hpp"
 #include "cntr_vie2_decl.hpp"
@@ -1180,7 +1181,7 @@ void dyson_mat_steep(herm_matrix<T> &G, herm_matrix<T> &Sigma, T mu, function<T>
 * > One solves the Dyson equation of the following form:
 * > \f$ [ id/dt + \mu - H(t) ] G(t,t^\prime) - [\Sigma*G](t,t^\prime) = \delta(t,t^\prime)\f$
 * > for a hermitian matrix \f$G(t, t^\prime)\f$ on a Matsubara axis.
-* > There are 3 possible methods for solution: Fourier, steep, and fixpoint.
+* > There are 4 possible methods for solution: Fourier, steep, fixpoint, and FFT.
 * > Fixpoint method is choosen by default.
 *
 * <!-- ARGUMENTS
@@ -1201,7 +1202,7 @@ void dyson_mat_steep(herm_matrix<T> &G, herm_matrix<T> &Sigma, T mu, function<T>
 * @param beta
 * > [double] inverse temperature
 * @param method
-* > [const] Solution method on the Matsubara axis with 0: Fourier, 1: steep, 2: fixpoint
+* > [const] Solution method on the Matsubara axis with 0: Fourier, 1: steep, 2: fixpoint, 3: FFT
 * @param force_hermitian
 * > [const bool] force hermitian solution, if 'true'
 */
@@ -1209,7 +1210,7 @@ template <typename T>
 void dyson_mat(herm_matrix<T> &G, herm_matrix<T> &Sigma, T mu, function<T> &H,
            function<T> &SigmaMF, integration::Integrator<T> &I,T beta, const int method,
          const bool force_hermitian){
-  assert(method <= 2 && "UNKNOWN CNTR_MAT_METHOD");
+  assert(method <= 3 && "UNKNOWN CNTR_MAT_METHOD");
 
 
   const int fourier_order = 3;
@@ -1223,6 +1224,9 @@ void dyson_mat(herm_matrix<T> &G, herm_matrix<T> &Sigma, T mu, function<T> &H,
     maxiter = 40;
     dyson_mat_steep(G, Sigma, mu, H, SigmaMF, I, beta, maxiter, tol);
     break;
+  case CNTR_MAT_FFT:
+    dyson_mat_fft(G, Sigma, mu, H, SigmaMF, beta);
+    break;
   default:
     maxiter = 6;
     dyson_mat_fixpoint(G, Sigma, mu, H, SigmaMF, I, beta, maxiter);
@@ -1245,7 +1249,7 @@ void dyson_mat(herm_matrix<T> &G, herm_matrix<T> &Sigma, T mu, function<T> &H,
 * > One solves the Dyson equation of the following form:
 * > \f$ [ id/dt + \mu - H(t) ] G(t,t^\prime) - [\Sigma*G](t,t^\prime) = \delta(t,t^\prime)\f$
 * > for a hermitian matrix \f$G(t, t^\prime)\f$ on a Matsubara axis.
-* > There are 3 possible methods for solution: Fourier, steep, and fixpoint.
+* > There are 4 possible methods for solution: Fourier, steep, fixpoint, and FFT.
 * > Fixpoint method is choosen by default.
 *
 * <!-- ARGUMENTS
@@ -1266,7 +1270,7 @@ void dyson_mat(herm_matrix<T> &G, herm_matrix<T> &Sigma, T mu, function<T> &H,
 * @param SolveOrder
 * > [int] integrator order
 * @param method
-* > [const] Solution method on the Matsubara axis with 0: Fourier, 1: steep, 2: fixpoint
+* > [const] Solution method on the Matsubara axis with 0: Fourier, 1: steep, 2: fixpoint, 3: FFT
 * @param force_hermitian
 * > [const bool] force hermitian solution, if 'true'
 */
@@ -1274,7 +1278,7 @@ template <typename T>
 void dyson_mat(herm_matrix<T> &G, T mu, function<T> &H,
            function<T> &SigmaMF, herm_matrix<T> &Sigma, T beta, const int SolveOrder,const int method,
          const bool force_hermitian){
-  assert(method <= 2 && "UNKNOWN CNTR_MAT_METHOD");
+  assert(method <= 3 && "UNKNOWN CNTR_MAT_METHOD");
   assert(SolveOrder <= MAX_SOLVE_ORDER);
 
   const int fourier_order = 3;
@@ -1288,6 +1292,9 @@ void dyson_mat(herm_matrix<T> &G, T mu, function<T> &H,
     maxiter = 40;
     dyson_mat_steep(G, Sigma, mu, H, SigmaMF, integration::I<T>(SolveOrder), beta, maxiter, tol);
     break;
+  case CNTR_MAT_FFT:
+    dyson_mat_fft(G, Sigma, mu, H, SigmaMF, beta);
+    break;
   default:
     maxiter = 6;
     dyson_mat_fixpoint(G, Sigma, mu, H, SigmaMF, integration::I<T>(SolveOrder), beta, maxiter);
@@ -1308,7 +1315,7 @@ void dyson_mat(herm_matrix<T> &G, T mu, function<T> &H,
 * > One solves the Dyson equation of the following form:
 * > \f$ [ id/dt + \mu - H(t) ] G(t,t^\prime) - [\Sigma*G](t,t^\prime) = \delta(t,t^\prime)\f$
 * > for a hermitian matrix \f$G(t, t^\prime)\f$ on a Matsubara axis.
-* > There are 3 possible methods for solution: Fourier, steep, and fixpoint.
+* > There are 4 possible methods for solution: Fourier, steep, fixpoint, and FFT.
 *
 * <!-- ARGUMENTS
 *      ========= -->
@@ -1326,14 +1333,14 @@ void dyson_mat(herm_matrix<T> &G, T mu, function<T> &H,
 * @param beta
 * > [double] inverse temperature
 * @param method
-* > [const] Solution method on the Matsubara axis with 0: Fourier, 1: steep, 2: fixpoint
+* > [const] Solution method on the Matsubara axis with 0: Fourier, 1: steep, 2: fixpoint, 3: FFT
 * @param force_hermitian
 * > [const bool] force hermitian solution, if 'true'
 */
 template <typename T>
 void dyson_mat(herm_matrix<T> &G, herm_matrix<T> &Sigma, T mu, function<T> &H,
            integration::Integrator<T> &I,T beta, const int method,const bool force_hermitian){
-  assert(method <= 2 && "UNKNOWN CNTR_MAT_METHOD");
+  assert(method <= 3 && "UNKNOWN CNTR_MAT_METHOD");
 
   const int fourier_order = 3;
   const double tol=1.0e-12;
@@ -1351,6 +1358,9 @@ void dyson_mat(herm_matrix<T> &G, herm_matrix<T> &Sigma, T mu, function<T> &H,
     maxiter=6;
     dyson_mat_fixpoint(G, Sigma, mu, H, I, beta, maxiter);
     break;
+  case 3:
+    dyson_mat_fft(G, Sigma, mu, H, beta);
+    break;
   }
   if(force_hermitian){
     force_matsubara_hermitian(G);
@@ -1367,7 +1377,7 @@ void dyson_mat(herm_matrix<T> &G, herm_matrix<T> &Sigma, T mu, function<T> &H,
 * > One solves the Dyson equation of the following form:
 * > \f$ [ id/dt + \mu - H(t) ] G(t,t^\prime) - [\Sigma*G](t,t^\prime) = \delta(t,t^\prime)\f$
 * > for a hermitian matrix \f$G(t, t^\prime)\f$ on a Matsubara axis.
-* > There are 3 possible methods for solution: Fourier, steep, and fixpoint.
+* > There are 4 possible methods for solution: Fourier, steep, fixpoint, and FFT.
 *
 * <!-- ARGUMENTS
 *      ========= -->
@@ -1385,14 +1395,14 @@ void dyson_mat(herm_matrix<T> &G, herm_matrix<T> &Sigma, T mu, function<T> &H,
 * @param beta
 * > [double] inverse temperature
 * @param method
-* > [int] Solution method on the Matsubara axis with 0: Fourier, 1: steep, 2: fixpoint
+* > [int] Solution method on the Matsubara axis with 0: Fourier, 1: steep, 2: fixpoint, 3: FFT
 * @param force_hermitian
 * > [bool] force hermitian solution, if 'true'
 */
 template <typename T>
 void dyson_mat(herm_matrix<T> &G, T mu, function<T> &H, herm_matrix<T> &Sigma,
            T beta, const int SolveOrder, const int method,const bool force_hermitian){
-  assert(method <= 2 && "UNKNOWN CNTR_MAT_METHOD");
+  assert(method <= 3 && "UNKNOWN CNTR_MAT_METHOD");
   assert(SolveOrder <= MAX_SOLVE_ORDER);
 
   const int fourier_order = 3;
@@ -1411,6 +1421,9 @@ void dyson_mat(herm_matrix<T> &G, T mu, function<T> &H, herm_matrix<T> &Sigma,
     maxiter=6;
     dyson_mat_fixpoint(G, Sigma, mu, H, integration::I<T>(SolveOrder), beta, maxiter);
     break;
+  case 3:
+    dyson_mat_fft(G, Sigma, mu, H, beta);
+    break;
   }
   if(force_hermitian){
     force_matsubara_hermitian(G);
@@ -1668,7 +1681,7 @@ void dyson_timestep(int n, herm_matrix<T> &G, T mu, function<T> &H, herm_matrix<
 * @param h
 * > [double] time interval
 * @param matsubara_method
-* > [int] Solution method on the Matsubara axis with 0: Fourier, 1: steep, 2: fixpoint
+* > [int] Solution method on the Matsubara axis with 0: Fourier, 1: steep, 2: fixpoint, 3: FFT
 * @param force_hermitian
 * > [bool] force hermitian solution
 */
@@ -1717,7 +1730,7 @@ void dyson(herm_matrix<T> &G, T mu, function<T> &H, herm_matrix<T> &Sigma,
 * @param SolveOrder
 * > [int] integrator order
 * @param matsubara_method
-* > [int] Solution method on the Matsubara axis with 0: Fourier, 1: steep, 2: fixpoint
+* > [int] Solution method on the Matsubara axis with 0: Fourier, 1: steep, 2: fixpoint, 3: FFT
 * @param force_hermitian
 * > [bool] force hermitian solution
 */
@@ -9,6 +9,15 @@ namespace cntr {
   template <typename T> class herm_matrix;
   template <typename T> class herm_matrix_timestep;
   template <typename T> class herm_pseudo;
+  template <typename T> class distributed_timestep_array;
+
+// propagator_exp uses Krylov propagation for size1 >= CNTR_KRYLOV_MIN_SIZE
+// and at most a fraction CNTR_KRYLOV_MAX_FILL of nonzero elements of H
+#define CNTR_KRYLOV_MIN_SIZE 64
+#define CNTR_KRYLOV_MAX_FILL 0.1
+// max dimension of the Krylov space and error tolerance per step
+#define CNTR_KRYLOV_DIM 40
+#define CNTR_KRYLOV_TOL 1e-12
 
   /*###########################################################################################
     #
@@ -57,6 +66,13 @@ namespace cntr {
   template <typename T, class dos_function>
   void green_equilibrium(herm_matrix<T> &G, dos_function &dos, double beta,
     double h, double mu=0.0, int limit = 100, int nn = 20);
+  // same, sampling the dos once for all times (much faster for large nt, ntau)
+  template <typename T, class dos_function>
+  void green_equilibrium_fast(herm_matrix<T> &G, dos_function &dos, double beta,
+    double h, double mu=0.0, int limit = 100, int nn = 20);
+  template <typename T>
+  void green_equilibrium_bethe_fast(herm_matrix<T> &G, double beta, double h,
+    int limit = 100, int nn = 20,double mu=0.0,double Eshift=0.0);
 
   // other "simple" Greenfunctions: [idt + mu - H(t)]^{-1} and [idt + mu -
   // H0]^{-1} etc
@@ -85,6 +101,25 @@ namespace cntr {
   void green_from_H(int tstp, herm_matrix<T> &G,T mu,cntr::function<T> &eps,
            T beta,T h,bool fixHam=false,int SolveOrder=MAX_SOLVE_ORDER,int cf_order=4);
 
+  // sparse Hamiltonian H(t)=eps[t+1], t=-1..nt (Krylov propagation for large size1)
+  template <typename T>
+  void green_from_H(herm_matrix<T> &G,T mu,std::vector<cdspmatrix> &eps,
+           T beta,T h,int SolveOrder=MAX_SOLVE_ORDER,int cf_order=4);
+  // same for many Hamiltonians (e.g. k-points), known at all times
+  template <typename T>
+  void green_from_H_batch(std::vector<herm_matrix<T> > &G,T mu,std::vector<cntr::function<T> > &eps,
+           T beta,T h,int SolveOrder=MAX_SOLVE_ORDER,int cf_order=4);
+  template <typename T,class hamiltonian>
+  void green_from_H_batch(std::vector<herm_matrix<T> > &G,T mu,hamiltonian &H,
+           T beta,T h,int SolveOrder=MAX_SOLVE_ORDER,int cf_order=4);
+  template <typename T>
+  void green_from_H_batch(int tstp,distributed_timestep_array<T> &G,T mu,std::vector<cntr::function<T> > &eps,
+           T beta,T h,int SolveOrder=MAX_SOLVE_ORDER,int cf_order=4);
+
+  template <typename T>
+  void krylov_exp_apply(const cdspmatrix &H,double dt,cdmatrix &U,
+           int maxdim=CNTR_KRYLOV_DIM,double tol=CNTR_KRYLOV_TOL);
+
   /// @private
   template <typename T>
   void green_from_H(herm_matrix_timestep<T> &G,T mu,cdmatrix &eps,T beta,T h);
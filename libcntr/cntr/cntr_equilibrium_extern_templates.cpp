@@ -2,6 +2,7 @@
 #include "cntr_global_settings.hpp"
 #include "cntr_equilibrium_extern_templates.hpp"
 #include "cntr_equilibrium_impl.hpp"
+#include "cntr_herm_matrix_timestep_view_impl.hpp"
 
 namespace cntr {
 
@@ -18,6 +19,7 @@ namespace cntr {
 
   template void green_equilibrium_mat_bethe<double>(herm_matrix<double> &G,double beta,int limit,int nn,double mu,double Eshift);
   template void green_equilibrium_bethe<double>(herm_matrix<double> &G,double beta,double h,int limit,int nn,double mu,double Eshift);
+  template void green_equilibrium_bethe_fast<double>(herm_matrix<double> &G,double beta,double h,int limit,int nn,double mu,double Eshift);
 
   // green_from_H: prefered interfaces
   /// @private
@@ -36,6 +38,14 @@ namespace cntr {
   template void green_from_H<double>(int tstp, herm_matrix<double> &G,double mu,cntr::function<double> &eps,
            double beta,double h,bool fixHam,int SolveOrder,int cf_order);
 
+  template void green_from_H<double>(herm_matrix<double> &G,double mu,std::vector<cdspmatrix> &eps,
+    double beta,double h,int SolveOrder,int cf_order);
+  template void krylov_exp_apply<double>(const cdspmatrix &H,double dt,cdmatrix &U,int maxdim,double tol);
+  template void green_from_H_batch<double>(std::vector<herm_matrix<double> > &G,double mu,
+    std::vector<cntr::function<double> > &eps,double beta,double h,int SolveOrder,int cf_order);
+  template void green_from_H_batch<double>(int tstp,distributed_timestep_array<double> &G,double mu,
+    std::vector<cntr::function<double> > &eps,double beta,double h,int SolveOrder,int cf_order);
+
   // green_from_H: legacy interfaces 
   /// @private
   template void green_from_H<double>(herm_matrix<double> &G,double mu,cntr::function<double> &eps,
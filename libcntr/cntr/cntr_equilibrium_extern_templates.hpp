@@ -13,6 +13,7 @@ namespace cntr {
   extern template cdmatrix diag_prop<double>(double time,dvector &omega);
   extern template void green_equilibrium_mat_bethe<double>(herm_matrix<double> &G,double beta,int limit,int nn,double mu,double Eshift);
   extern template void green_equilibrium_bethe<double>(herm_matrix<double> &G,double beta,double h,int limit,int nn,double mu,double Eshift);
+  extern template void green_equilibrium_bethe_fast<double>(herm_matrix<double> &G,double beta,double h,int limit,int nn,double mu,double Eshift);
 
 
   // prefered interfaces
@@ -26,6 +27,14 @@ namespace cntr {
   extern template void green_from_H<double>(int tstp, herm_matrix<double> &G,double mu,cntr::function<double> &eps,
            double beta,double h,bool fixHam,int SolveOrder,int cf_order);
 
+  extern template void green_from_H<double>(herm_matrix<double> &G,double mu,std::vector<cdspmatrix> &eps,
+    double beta,double h,int SolveOrder,int cf_order);
+  extern template void krylov_exp_apply<double>(const cdspmatrix &H,double dt,cdmatrix &U,int maxdim,double tol);
+  extern template void green_from_H_batch<double>(std::vector<herm_matrix<double> > &G,double mu,
+    std::vector<cntr::function<double> > &eps,double beta,double h,int SolveOrder,int cf_order);
+  extern template void green_from_H_batch<double>(int tstp,distributed_timestep_array<double> &G,double mu,
+    std::vector<cntr::function<double> > &eps,double beta,double h,int SolveOrder,int cf_order);
+
   // legacy interfaces 
   extern template void green_from_H<double>(herm_matrix<double> &G,double mu,cntr::function<double> &eps,
     double beta,double h,bool fixHam,int SolveOrder,int cf_order);
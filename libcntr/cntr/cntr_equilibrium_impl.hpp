@@ -9,6 +9,8 @@
 //#include "cntr_exception.hpp"
 #include "cntr_herm_matrix_decl.hpp"
 #include "cntr_herm_matrix_timestep_decl.hpp"
+#include "cntr_herm_matrix_timestep_view_decl.hpp"
+#include "cntr_distributed_timestep_array_decl.hpp"
 #include "cntr_herm_pseudo_decl.hpp"
 #include "cntr_function_decl.hpp"
 #include "cntr_utilities_decl.hpp"
@@ -248,7 +250,11 @@ template < class dos > struct dos_wrapper{
       sign_=sign;
     }
     double operator()(double omega){
-      double a=A_(omega),fm;
+      return A_(omega)*kernel(omega);
+    }
+    // distribution factor multiplying the dos for flavor x_
+    double kernel(double omega) const{
+      double fm;
       if(x_==ret){
           fm=1;
       }else if(x_==les){
@@ -264,7 +270,7 @@ template < class dos > struct dos_wrapper{
       }else{
         fm=0;
       }
-      return a*fm;
+      return fm;
     }
 };
 
@@ -406,9 +412,8 @@ class smooth_box {
         typedef std::complex<double> cplx;
         cplx res, err;
         N_ = 1.0;
-        fourier::adft_func adft;
-        adft.sample(0.0, lo_, hi_, *this, 20, 100);
-        adft.dft(0.0, res, err);
+        fourier::sampled_function f(lo_, hi_, *this, 20, 100);
+        f.dft(0.0, res, err);
         N_ = res.real();
     }
     double operator()(double x) {
@@ -428,17 +433,17 @@ void green_equilibrium_ret(herm_matrix<T> &G,dos_function &dos,double h,int limi
   typedef std::complex<double> cplx;
   int nt=G.nt(),i,l,size1=G.size1();
   int sign=G.sig();
-  double t;
-  cplx res,err,cplx_i=cplx(0,1);
-  fourier::adft_func adft;
+  cplx res;
+  std::vector<double> w(nt+1);
+  std::vector<cplx> fw(nt+1);
   dos_wrapper<dos_function> dos1(dos,sign,mu);
   dos1.mu_=mu;
   dos1.x_=ret;
-  adft.sample(0.0,dos.lo_,dos.hi_,dos1,nn,limit);
+  fourier::sampled_function f(dos.lo_,dos.hi_,dos1,nn,limit);
+  for(l=0;l<=nt;l++) w[l]=-h*l;
+  f.dft(nt+1,w.data(),fw.data());
   for(l=0;l<=nt;l++){ // l = t-t'
-   t=h*l;
-   adft.dft(-t,res,err);
-   res *= std::complex<double>(0,-1.0);
+   res=fw[l]*std::complex<double>(0,-1.0);
    for(i=l;i<=nt;i++) element_set<T,LARGESIZE>(size1,G.retptr(i,i-l),(std::complex<T>)(res));
   }
 }
@@ -452,7 +457,6 @@ void green_equilibrium_mat(herm_matrix<T> &G,dos_function &dos,double beta,int l
   int sign=G.sig();
   double dtau;
   cplx res,err;
-  fourier::adft_func adft;
   dos_wrapper<dos_function> dos1(dos,sign,mu);
   dos1.beta_=beta;
   dtau=beta/ntau;
@@ -460,8 +464,8 @@ void green_equilibrium_mat(herm_matrix<T> &G,dos_function &dos,double beta,int l
   dos1.x_=mat;
   for(m=0;m<=ntau;m++){
     dos1.tau_=m*dtau;
-    adft.sample(0.0,dos.lo_,dos.hi_,dos1,nn,limit);
-    adft.dft(0.0,res,err);
+    fourier::sampled_function f(dos.lo_,dos.hi_,dos1,nn,limit);
+    f.dft(0.0,res,err);
     element_set<T,LARGESIZE>(size1,G.matptr(m),(std::complex<T>)(res));
   }
 }
@@ -473,19 +477,21 @@ void green_equilibrium_tv(herm_matrix<T> &G,dos_function &dos,double beta,double
   int ntau=G.ntau(),nt=G.nt(),n,m,size1=G.size1();
   double dtau;
   int sign=G.sig();
-  cplx res,err,cplx_i=cplx(0,1);
-  fourier::adft_func adft;
+  cplx res;
+  std::vector<double> w(nt+1);
+  std::vector<cplx> fw(nt+1);
   dos_wrapper<dos_function> dos1(dos,sign,mu);
   dos1.beta_=beta;
   dtau=beta/ntau;
   dos1.x_=tv;
   dos1.mu_=mu;
+  for(n=0;n<=nt;n++) w[n]=-n*h;
   for(m=0;m<=ntau;m++){
     dos1.tau_=m*dtau;
-    adft.sample(0.0,dos.lo_,dos.hi_,dos1,nn,limit);
+    fourier::sampled_function f(dos.lo_,dos.hi_,dos1,nn,limit);
+    f.dft(nt+1,w.data(),fw.data());
     for(n=0;n<=nt;n++){
-      adft.dft(-n*h,res,err);
-      res *= std::complex<double>(0,-1.0);
+      res=fw[n]*std::complex<double>(0,-1.0);
       element_set<T,LARGESIZE>(size1,G.tvptr(n,m),(std::complex<T>)(res));
     }
   }
@@ -496,19 +502,19 @@ void green_equilibrium_les(herm_matrix<T> &G,dos_function &dos,double beta,doubl
 {
   typedef std::complex<double> cplx;
   int nt=G.nt(),i,l,size1=G.size1();
-  double t;
   int sign=G.sig();
-  cplx res,err,cplx_i=cplx(0,1);
-  fourier::adft_func adft;
+  cplx res;
+  std::vector<double> w(nt+1);
+  std::vector<cplx> fw(nt+1);
   dos_wrapper<dos_function> dos1(dos,sign,mu);
   dos1.mu_=mu;
   dos1.x_=les;
   dos1.beta_=beta;
-  adft.sample(0.0,dos.lo_-0.0,dos.hi_-0.0,dos1,nn,limit);
+  fourier::sampled_function f(dos.lo_,dos.hi_,dos1,nn,limit);
+  for(l=0;l<=nt;l++) w[l]=h*l;
+  f.dft(nt+1,w.data(),fw.data());
   for(l=0;l<=nt;l++){ // l = t'-t
-   t=h*l;
-   adft.dft(t,res,err);
-   res *= std::complex<double>(0,-1.0);
+   res=fw[l]*std::complex<double>(0,-1.0);
    for(i=l;i<=nt;i++) element_set<T,LARGESIZE>(size1,G.lesptr(i-l,i),(std::complex<T>)res);
   }
 }
@@ -622,6 +628,346 @@ void green_equilibrium_bethe(herm_matrix<T> &G, double beta, double h,
     green_equilibrium(G, dos, beta, h, limit, nn,mu);
 }
 
+/*####################################################################################
+#
+#   Fast construction: the dos is sampled once on an adaptive grid, and all
+#   components are linear combinations of the samples, with the weights of the
+#   cubically corrected DFT (fourier::dft_cplx) of the individual intervals.
+#
+######################################################################################*/
+/// @private
+/** \brief <b> Adaptive partition of the support of a density of states. </b>
+ *
+ * > Intervals of `nn` equidistant steps, obtained by repeatedly splitting intervals in two,
+ * > as in `fourier::adft_func::sample`. `A[i*(nn+1)+j]` is the density of states at the
+ * > point `j` of interval `i`.
+ */
+struct equilibrium_grid {
+    int nn;
+    std::vector<double> a;
+    std::vector<double> b;
+    std::vector<double> A;
+    int intervals(void) const { return (int)a.size(); }
+    int size(void) const { return (int)a.size() * (nn + 1); }
+    double omega(int k) const {
+        int i = k / (nn + 1), j = k % (nn + 1);
+        return a[i] + j * (b[i] - a[i]) / nn;
+    }
+};
+
+/// @private
+/** \brief <b> Binary tree of the intervals visited by the adaptive sampling. </b>
+ *
+ * > Node `i` holds the interval `[a[i],b[i]]`, the dos at its `nn+1` points (`A`), and
+ * > the error estimate of `fourier::dft_cplx` for each integrand (`err`). The children of
+ * > a node are created once, on its first split; they take every second sample from the
+ * > parent, so that each point is evaluated only once for all partitions of the tree.
+ */
+struct equilibrium_grid_tree {
+    int nn;
+    std::vector<double> a;
+    std::vector<double> b;
+    std::vector<int> child;                 /*!< left child, the right one is child+1; -1: none */
+    std::vector<std::vector<double> > A;
+    std::vector<std::vector<double> > err;
+};
+
+/// @private
+template <class dos_function>
+void equilibrium_grid_node(equilibrium_grid_tree &tree, dos_function &dos,
+                           std::vector<dos_wrapper<dos_function> > &probes, double a, double b,
+                           const double *Aeven) {
+    int nn = tree.nn;
+    std::vector<double> A(nn + 1), err(probes.size());
+    std::vector<std::complex<double> > f(nn + 1);
+    std::complex<double> res, e;
+    for (int j = 0; j <= nn; j++)
+        A[j] = (Aeven != 0 && j % 2 == 0 ? Aeven[j / 2] : dos(a + j * (b - a) / nn));
+    for (size_t p = 0; p < probes.size(); p++) {
+        for (int j = 0; j <= nn; j++)
+            f[j] = A[j] * probes[p].kernel(a + j * (b - a) / nn);
+        fourier::dft_cplx(0.0, nn, a, b, f.data(), res, e);
+        err[p] = std::abs(e);
+    }
+    tree.a.push_back(a);
+    tree.b.push_back(b);
+    tree.child.push_back(-1);
+    tree.A.push_back(A);
+    tree.err.push_back(err);
+}
+
+/// @private
+// Replaces node cut[i] of the partition cut by its children
+template <class dos_function>
+void equilibrium_grid_split(equilibrium_grid_tree &tree, dos_function &dos,
+                            std::vector<dos_wrapper<dos_function> > &probes,
+                            std::vector<int> &cut, int i) {
+    int n = cut[i], nn = tree.nn;
+    if (tree.child[n] < 0) {
+        double a0 = tree.a[n], b0 = tree.b[n], mid = (a0 + b0) / 2.0;
+        tree.child[n] = tree.a.size();
+        equilibrium_grid_node(tree, dos, probes, a0, mid, &tree.A[n][0]);
+        equilibrium_grid_node(tree, dos, probes, mid, b0, &tree.A[n][nn / 2]);
+    }
+    cut[i] = tree.child[n];
+    cut.insert(cut.begin() + i + 1, tree.child[n] + 1);
+}
+
+/// @private
+// Refines the partition cut of the tree for the integrands use[q], splitting the interval
+// with the largest error relative to target[q]. At least limit-1 (and at least 2 for
+// limit>1) intervals are made, then refinement stops once the total error of each
+// integrand is below its target, or at maxint intervals.
+template <class dos_function>
+void equilibrium_grid_refine(equilibrium_grid_tree &tree, dos_function &dos,
+                             std::vector<dos_wrapper<dos_function> > &probes,
+                             std::vector<int> &cut, const std::vector<int> &use,
+                             const std::vector<double> &target, int limit, int maxint) {
+    int nq = use.size();
+    std::vector<double> total(nq);
+    cut.assign(1, 0);
+    if (limit > 1)
+        equilibrium_grid_split(tree, dos, probes, cut, 0);
+    while ((int)cut.size() < maxint) {
+        int isplit = 0;
+        double emax = -1.0;
+        total.assign(nq, 0.0);
+        for (size_t i = 0; i < cut.size(); i++) {
+            for (int q = 0; q < nq; q++) {
+                double e = tree.err[cut[i]][use[q]];
+                total[q] += e;
+                e /= std::max(target[q], 1e-300);
+                if (e > emax) {
+                    emax = e;
+                    isplit = i;
+                }
+            }
+        }
+        bool done = ((int)cut.size() + 1 >= limit);
+        for (int q = 0; q < nq; q++)
+            done = done && total[q] <= target[q];
+        if (done)
+            break;
+        equilibrium_grid_split(tree, dos, probes, cut, isplit);
+    }
+}
+
+/// @private
+// Refines [lo,hi] for the integrands probes. Each integrand p is first refined alone with
+// limit intervals, as in green_equilibrium, which gives its total error estimate target[p].
+// The common partition is then refined until the total error of each integrand is below
+// its target. Both refinements walk the same tree, so no point is sampled twice.
+template <class dos_function>
+void equilibrium_grid_sample(equilibrium_grid &grid, dos_function &dos,
+                             std::vector<dos_wrapper<dos_function> > &probes,
+                             double lo, double hi, int nn, int limit) {
+    assert(nn >= ADFT_MINPTS && nn % 2 == 0 && limit >= 1 && lo < hi);
+    int np = probes.size();
+    equilibrium_grid_tree tree;
+    tree.nn = nn;
+    equilibrium_grid_node(tree, dos, probes, lo, hi, (const double *)0);
+    std::vector<int> cut, use(np);
+    std::vector<double> target(np, 0.0);
+    for (int p = 0; p < np; p++) {
+        // alone: the error relative to any positive target orders the intervals
+        equilibrium_grid_refine(tree, dos, probes, cut, std::vector<int>(1, p),
+                                std::vector<double>(1, 1.0), limit,
+                                (limit > 1 ? std::max(limit - 1, 2) : 1));
+        for (size_t i = 0; i < cut.size(); i++)
+            target[p] += tree.err[cut[i]][p];
+        use[p] = p;
+    }
+    equilibrium_grid_refine(tree, dos, probes, cut, use, target, limit, limit * np);
+    grid.nn = nn;
+    grid.a.resize(cut.size());
+    grid.b.resize(cut.size());
+    grid.A.resize(cut.size() * (nn + 1));
+    for (size_t i = 0; i < cut.size(); i++) {
+        grid.a[i] = tree.a[cut[i]];
+        grid.b[i] = tree.b[cut[i]];
+        std::copy(tree.A[cut[i]].begin(), tree.A[cut[i]].end(), grid.A.begin() + i * (nn + 1));
+    }
+}
+
+/// @private
+// c[k](w): sum_k c[k] f(omega_k) = sum over intervals of fourier::dft_cplx(w, ...)
+inline void equilibrium_grid_weights(const equilibrium_grid &grid, double w,
+                                     std::complex<double> *c) {
+    for (size_t i = 0; i < grid.a.size(); i++)
+        fourier::dft_cubic_weights(w, grid.nn, grid.a[i], grid.b[i], c + i * (grid.nn + 1));
+}
+
+/** \brief <b> Equilibrium propagator for the given density of states (fast construction). </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Same as `green_equilibrium`, but the density of states is sampled only once: the
+* > intervals of `nn` points of the Fourier integrals are refined adaptively for the
+* > integrands of all components at several imaginary times at once, until each of them
+* > is at least as accurate as with its own `limit` intervals in `green_equilibrium`. All time and imaginary-time points are then obtained as
+* > weighted sums of the samples, using the weights of the cubically corrected DFT; the
+* > left-mixing component, which dominates the cost, is evaluated as a blocked matrix
+* > product. Parallelized with OpenMP over imaginary times and blocks of real times.
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param G
+* > The output Greens function set to the equilibrium free propagator
+* @param dos
+* > density of states
+* @param beta
+* > inverse temperature
+* @param h
+* > timestep
+* @param mu
+* > chemical potential
+* @param limit
+* > max number of intervals in Fourier transform (default: 100)
+* @param nn
+* > number of points in each interval of the Fourier transform (default: 20)
+*/
+template <typename T, class dos_function>
+void green_equilibrium_fast(herm_matrix<T> &G, dos_function &dos, double beta, double h,
+                            double mu, int limit, int nn) {
+    typedef std::complex<double> cplx;
+    int nt = G.nt(), ntau = G.ntau(), size1 = G.size1(), sign = G.sig();
+    double dtau = beta / ntau;
+    const cplx mi(0.0, -1.0);
+    // adaptive grid, common to the integrands of all components
+    std::vector<dos_wrapper<dos_function> > probes;
+    dos_wrapper<dos_function> dos1(dos, sign, mu);
+    dos1.beta_ = beta;
+    for (int q = 0; q <= 8; q++) {
+        dos1.tau_ = ((q * ntau) / 8) * dtau;
+        dos1.x_ = mat;
+        probes.push_back(dos1);
+        if (nt >= 0) {
+            dos1.x_ = tv;
+            probes.push_back(dos1);
+        }
+    }
+    if (nt >= 0) {
+        dos1.tau_ = 0.0;
+        dos1.x_ = ret;
+        probes.push_back(dos1);
+        dos1.x_ = les;
+        probes.push_back(dos1);
+    }
+    equilibrium_grid grid;
+    equilibrium_grid_sample(grid, dos, probes, dos.lo_, dos.hi_, nn, limit);
+    int nk = grid.size();
+    const std::vector<double> &A = grid.A;
+    std::vector<double> omega(nk);
+    for (int k = 0; k < nk; k++)
+        omega[k] = grid.omega(k);
+    // Matsubara
+    {
+        std::vector<cplx> c0(nk);
+        equilibrium_grid_weights(grid, 0.0, c0.data());
+#if CNTR_USE_OMP == 1
+#pragma omp parallel for
+#endif
+        for (int m = 0; m <= ntau; m++) {
+            dos_wrapper<dos_function> w(dos1);
+            w.x_ = mat;
+            w.tau_ = m * dtau;
+            cplx res = 0.0;
+            for (int k = 0; k < nk; k++)
+                res += c0[k] * (A[k] * w.kernel(omega[k]));
+            element_set<T, LARGESIZE>(size1, G.matptr(m), (std::complex<T>)res);
+        }
+    }
+    if (nt < 0)
+        return;
+    // B(k,m) = A(omega_k) * tv-kernel(tau_m, omega_k)
+    Eigen::MatrixXd B(nk, ntau + 1);
+    std::vector<double> Ales(nk);
+    for (int k = 0; k < nk; k++) {
+        dos_wrapper<dos_function> w(dos1);
+        w.x_ = les;
+        Ales[k] = A[k] * w.kernel(omega[k]);
+    }
+#if CNTR_USE_OMP == 1
+#pragma omp parallel for
+#endif
+    for (int m = 0; m <= ntau; m++) {
+        dos_wrapper<dos_function> w(dos1);
+        w.x_ = tv;
+        w.tau_ = m * dtau;
+        for (int k = 0; k < nk; k++)
+            B(k, m) = A[k] * w.kernel(omega[k]);
+    }
+    // blocks of real times: weights c(-t), then ret, les and tv = c(-t) * B
+    int bt = 32, nblocks = (nt + bt) / bt;
+#if CNTR_USE_OMP == 1
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int ib = 0; ib < nblocks; ib++) {
+        int n0 = ib * bt, n1 = std::min(nt + 1, n0 + bt);
+        Eigen::MatrixXd Cre(n1 - n0, nk), Cim(n1 - n0, nk);
+        std::vector<cplx> c(nk);
+        for (int n = n0; n < n1; n++) {
+            equilibrium_grid_weights(grid, -n * h, c.data());
+            cplx rret = 0.0, rles = 0.0;
+            for (int k = 0; k < nk; k++) {
+                Cre(n - n0, k) = c[k].real();
+                Cim(n - n0, k) = c[k].imag();
+                rret += c[k] * A[k];
+                rles += std::conj(c[k]) * Ales[k];
+            }
+            rret *= mi;
+            rles *= mi;
+            for (int i = n; i <= nt; i++) {
+                element_set<T, LARGESIZE>(size1, G.retptr(i, i - n), (std::complex<T>)rret);
+                element_set<T, LARGESIZE>(size1, G.lesptr(i - n, i), (std::complex<T>)rles);
+            }
+        }
+        Eigen::MatrixXd TVre = Cre * B, TVim = Cim * B;
+        for (int n = n0; n < n1; n++) {
+            for (int m = 0; m <= ntau; m++) {
+                cplx res = mi * cplx(TVre(n - n0, m), TVim(n - n0, m));
+                element_set<T, LARGESIZE>(size1, G.tvptr(n, m), (std::complex<T>)res);
+            }
+        }
+    }
+}
+
+/** \brief <b> Equilibrium propagator for Bethe semicircular density of states (fast construction). </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Same as `green_equilibrium_bethe`, using `green_equilibrium_fast`.
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param G
+* > The output Greens function set to the equilibrium free propagator
+* @param beta
+* > inverse temperature
+* @param h
+* > timestep
+* @param limit
+* > max number of intervals in Fourier transform
+* @param nn
+* > number of points in each interval of the Fourier transform
+* @param mu
+* > chemical potential
+* @param Eshift
+* > shift of the center of the band
+*/
+template <typename T>
+void green_equilibrium_bethe_fast(herm_matrix<T> &G, double beta, double h, int limit,
+                                  int nn, double mu, double Eshift) {
+    bethedos dos(Eshift);
+    green_equilibrium_fast(G, dos, beta, h, mu, limit, nn);
+}
+
 
 
 
@@ -719,6 +1065,124 @@ void interpolate_CF4(int tstp,cntr::function<T> &H,cdmatrix &Hinte1,cdmatrix &Hi
 
 }
 
+/// @private
+/** \brief <b> One Lanczos step \f$v \to e^{-i\,dt\,H}v\f$; returns false if not converged within maxdim. </b>
+*
+* > The Krylov space is fully reorthogonalized. The error estimate is
+* > \f$\beta_j |[e^{-i\,dt\,T_j}]_{j,0}|\f$ for the Lanczos tridiagonal matrix \f$T_j\f$.
+*/
+template<typename T>
+bool krylov_exp_step(const cdspmatrix &H,double dt,cdvector &v,int maxdim,double tol){
+  int n=v.size(),m=(maxdim<n ? maxdim : n);
+  double nrm=v.norm();
+  if(nrm==0.0) return true;
+  cdmatrix V(n,m+1);
+  std::vector<double> a(m),b(m);
+  cdvector w(n),y;
+  V.col(0)=v/nrm;
+  for(int j=0;j<m;j++){
+    w=H*V.col(j);
+    a[j]=V.col(j).dot(w).real();
+    w-=a[j]*V.col(j);
+    if(j>0) w-=b[j-1]*V.col(j-1);
+    for(int i=0;i<=j;i++) w-=V.col(i).dot(w)*V.col(i);
+    b[j]=w.norm();
+    dmatrix Tj=dmatrix::Zero(j+1,j+1);
+    for(int i=0;i<=j;i++) Tj(i,i)=a[i];
+    for(int i=0;i<j;i++) Tj(i,i+1)=Tj(i+1,i)=b[i];
+    Eigen::SelfAdjointEigenSolver<dmatrix> es(Tj);
+    cdvector c(j+1);
+    for(int i=0;i<=j;i++){
+      double arg=-dt*es.eigenvalues()(i);
+      c(i)=std::complex<double>(cos(arg),sin(arg))*es.eigenvectors()(0,i);
+    }
+    y=es.eigenvectors()*c;
+    if(b[j]*std::abs(y(j))<=tol || j+1==n){
+      v=nrm*(V.leftCols(j+1)*y);
+      return true;
+    }
+    V.col(j+1)=w/b[j];
+  }
+  return false;
+}
+
+/** \brief <b> Applies \f$e^{-i\,dt\,H}\f$ to a matrix, for a sparse Hermitian \f$H\f$ (Krylov method) </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Sets \f$U \to e^{-i\,dt\,H}U\f$ column by column with the Lanczos method, using only
+* > products of the sparse \f$H\f$ with vectors. The time step is subdivided if a column does
+* > not converge within `maxdim` Krylov vectors. The cost per column is \f$O(m\,\mathrm{nnz}(H)+m^2 N)\f$
+* > for \f$m\f$ Krylov vectors, instead of \f$O(N^3)\f$ for the dense exponential.
+* > Parallelized with OpenMP over the columns.
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param H
+* > [cdspmatrix] Hermitian (N x N) matrix
+* @param dt
+* > time step
+* @param U
+* > [cdmatrix] (N x M) matrix, overwritten by the result
+* @param maxdim
+* > maximum dimension of the Krylov space (default CNTR_KRYLOV_DIM)
+* @param tol
+* > error tolerance per column and step (default CNTR_KRYLOV_TOL)
+*/
+template<typename T>
+void krylov_exp_apply(const cdspmatrix &H,double dt,cdmatrix &U,int maxdim,double tol){
+  int ncol=U.cols();
+  assert(H.rows()==H.cols() && H.cols()==U.rows());
+  assert(maxdim>0);
+#if CNTR_USE_OMP == 1
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for(int col=0;col<ncol;col++){
+    cdvector v=U.col(col);
+    double left=fabs(dt),step=fabs(dt),sgn=(dt<0 ? -1.0 : 1.0);
+    while(left>0.0){
+      if(step>left) step=left;
+      if(krylov_exp_step<T>(H,sgn*step,v,maxdim,tol)) left-=step;
+      else step*=0.5;
+    }
+    U.col(col)=v;
+  }
+}
+
+/// @private
+/** \brief <b> \f$U \to e^{-i\,dt\,H}U\f$ with the backend selected by size and sparsity of H. </b>
+*
+* > Krylov propagation (krylov_exp_apply) if H has at least CNTR_KRYLOV_MIN_SIZE rows and at most
+* > a fraction CNTR_KRYLOV_MAX_FILL of nonzero elements, else the dense matrix exponential.
+*/
+template<typename T>
+void propagator_exp_apply(cdmatrix &U,const cdmatrix &H,double dt){
+  int size=H.rows();
+  if(size>=CNTR_KRYLOV_MIN_SIZE){
+    cdspmatrix Hs=H.sparseView();
+    if(Hs.nonZeros()<=CNTR_KRYLOV_MAX_FILL*size*size){
+      krylov_exp_apply<T>(Hs,dt,U,CNTR_KRYLOV_DIM,CNTR_KRYLOV_TOL);
+      return;
+    }
+  }
+  cdmatrix arg=std::complex<double>(0.0,-1.0)*dt*H;
+  U=arg.exp()*U;
+}
+
+/// @private
+template<typename T>
+void propagator_exp_apply(cdmatrix &U,const cdspmatrix &H,double dt){
+  if(H.rows()>=CNTR_KRYLOV_MIN_SIZE){
+    krylov_exp_apply<T>(H,dt,U,CNTR_KRYLOV_DIM,CNTR_KRYLOV_TOL);
+  }else{
+    cdmatrix arg=std::complex<double>(0.0,-1.0)*dt*cdmatrix(H);
+    U=arg.exp()*U;
+  }
+}
+
 /** \brief <b> Propagator for time-dependent free Hamiltonian </b>
 *
 * <!-- ====== DOCUMENTATION ====== -->
@@ -730,6 +1194,7 @@ void interpolate_CF4(int tstp,cntr::function<T> &H,cdmatrix &Hinte1,cdmatrix &Hi
 *   see https://doi.org/10.1016/j.jcp.2011.04.006 for the description.
 *   Currently implemented versions are the second order using one exponential CF2:1 (order=2) and fourth order using two exponentials CF4:2 (order=4),
 *   see also article for more details.
+*   For large sparse Hamiltonians the exponentials are applied by Krylov propagation (see propagator_exp_apply).
 *
 *
 *
@@ -769,21 +1234,19 @@ void propagator_exp(int tstp,cntr::function<T> &U,cntr::function<T> &H,double dt
         cdmatrix arg(size,size);
         // Get H(t+dt/2)-> Extrapolate and interpolate
         interpolate_CF2(tstp,H,arg,kt,fixHam);
-        arg=arg*std::complex<double>(0.0,-1.0)*dt;
         U.get_value(tstp-1,prop);
-        prop=arg.exp()*prop;
+        propagator_exp_apply<T>(prop,arg,dt);
         U.set_value(tstp,prop);
     }else if(order==4){
        cdmatrix H1(size,size),H2(size,size);
-       cdmatrix arg1(size,size),arg2(size,size);
        // Get H(t+dt*c1) and H(t+dt*c2) -> Extrapolate and interpolate
        interpolate_CF4(tstp,H,H1,H2,kt,fixHam);
        double a1=(3.0-2.0*sqrt(3.0))/12.0;
        double a2=(3.0+2.0*sqrt(3.0))/12.0;
-       arg1=std::complex<double>(0.0,-1.0)*dt*(a1*H1+a2*H2);
-       arg2=std::complex<double>(0.0,-1.0)*dt*(a2*H1+a1*H2);
        U.get_value(tstp-1,prop);
-       prop=arg1.exp()*arg2.exp()*prop;
+       // exp(-i dt (a1 H1 + a2 H2)) exp(-i dt (a2 H1 + a1 H2)) U(t-1)
+       propagator_exp_apply<T>(prop,(a2*H1+a1*H2).eval(),dt);
+       propagator_exp_apply<T>(prop,(a1*H1+a2*H2).eval(),dt);
        U.set_value(tstp,prop);
     }
   }
@@ -1416,6 +1879,390 @@ void green_from_H(int tstp, herm_matrix<T> &G,T mu,cntr::function<T> &eps,T beta
   G.set_timestep(tstp, Gstep);
 }
 
+/*####################################################################################
+#
+#   Free propagators for many Hamiltonians (e.g. lattice k-points)
+#
+######################################################################################*/
+
+/// @private
+/** \brief <b> Weights of the commutator-free interpolants, shared by all Hamiltonians. </b>
+*
+* > \f$H(t-1+c_j) = \sum_{l=0}^{kt} w_l H(\mathrm{first}(t)+l)\f$ for the nodes \f$c_j\f$ of
+* > the CF2:1 (order=2) or CF4:2 (order=4) propagator, as in interpolate_CF2/interpolate_CF4 for a
+* > Hamiltonian known at all times. The weights depend only on the time step, not on H.
+*/
+struct cf_interpolants {
+    int order;
+    int kt;
+    int nodes;
+    std::vector<double> w;
+    cf_interpolants(int nt, int order1, int kt1) {
+        integration::Integrator<double> &I = integration::I<double>(kt1);
+        double c[2];
+        order = order1;
+        kt = kt1;
+        if (order == 2) {
+            nodes = 1;
+            c[0] = 0.5;
+        } else {
+            nodes = 2;
+            c[0] = 0.5 - sqrt(3.0) / 6.0;
+            c[1] = 0.5 + sqrt(3.0) / 6.0;
+        }
+        w.resize((nt > 0 ? nt : 0) * nodes * (kt + 1));
+        for (int tstp = 1; tstp <= nt; tstp++) {
+            for (int j = 0; j < nodes; j++) {
+                double dt = tstp - 1 + c[j] - first(tstp), *wj = &w[((tstp - 1) * nodes + j) * (kt + 1)];
+                for (int l = 0; l <= kt; l++) {
+                    double t1 = 1.0;
+                    wj[l] = I.poly_interpolation(0, l);
+                    for (int p = 1; p <= kt; p++) {
+                        t1 *= dt;
+                        wj[l] += t1 * I.poly_interpolation(p, l);
+                    }
+                }
+            }
+        }
+    }
+    int first(int tstp) const { return (tstp <= kt ? kt : tstp) - kt; }
+    const double *weights(int tstp, int j) const {
+        return &w[((tstp - 1) * nodes + j) * (kt + 1)];
+    }
+};
+
+/// @private
+/** \brief <b> Matrix type of the Hamiltonians: dense for cntr::function, sparse for std::vector<cdspmatrix>. </b> */
+template<class hamiltonian_list> struct cf_matrix_type { typedef cdmatrix type; };
+/// @private
+template<> struct cf_matrix_type<std::vector<cdspmatrix> > { typedef cdspmatrix type; };
+
+/// @private
+template<typename T>
+void cf_hamiltonian(cntr::function<T> &eps,int tstp,cdmatrix &H){
+  eps.get_value(tstp,H);
+}
+/// @private
+template<typename T>
+void cf_hamiltonian(std::vector<cdspmatrix> &eps,int tstp,cdspmatrix &H){
+  H=eps[tstp+1];
+}
+
+/// @private
+/** \brief <b> Equilibrium and propagator data of one Hamiltonian, from which G is assembled. </b>
+*
+* > U[n]: propagator \f$U(n h,0)e^{i\mu n h}\f$ for n=0..nt1 (same as propagator_exp with fixHam=true),
+* > M[m] / V[m]: Matsubara component and right factor of the left-mixing component at \f$\tau_m\f$,
+* > \f$G^\rceil(n,m)=U[n]V[m]\f$, W[n]: \f$iU[n]\rho\f$, such that
+* > \f$G^<(n,m)=W[n]U[m]^\dagger\f$ and \f$G^R(m,n)=-iU[m]U[n]^\dagger\f$.
+* > `eps` is a cntr::function or a std::vector<cdspmatrix> (H(t) at index t+1); the equilibrium
+* > Hamiltonian is diagonalized as a dense matrix in both cases.
+*/
+template<typename T,class hamiltonian_list>
+void green_from_H_batch_data(T mu,hamiltonian_list &eps,T beta,T h,int sign,int ntau,int nt1,
+                             const cf_interpolants &cf,std::vector<cdmatrix> &U,
+                             std::vector<cdmatrix> &M,std::vector<cdmatrix> &V,std::vector<cdmatrix> &W){
+  typedef typename cf_matrix_type<hamiltonian_list>::type matrix;
+  std::complex<T> iu = std::complex<T>(0.0, 1.0);
+  double tau,dtau=beta/ntau;
+  matrix Ht,Hc[2];
+  cf_hamiltonian<T>(eps,-1,Ht);
+  int size=Ht.rows();
+  cdmatrix H1(size,size),evec0(size,size),rho(size,size);
+  dvector eval0(size),eval0m(size);
+  H1=mu*cdmatrix::Identity(size,size)-cdmatrix(Ht);
+  Eigen::SelfAdjointEigenSolver<cdmatrix> eigensolver(H1);
+  evec0=eigensolver.eigenvectors();
+  eval0=eigensolver.eigenvalues();
+  eval0m=(-1.0)*eval0;
+  M.resize(ntau+1);
+  V.resize(ntau+1);
+  for(int m=0;m<=ntau;m++){
+    tau=m*dtau;
+    if(sign==-1){
+      M[m]=(-1.0)*evec0*fermi_exp(beta,tau,eval0).asDiagonal()*evec0.adjoint();
+      V[m]=iu*evec0*fermi_exp(beta,tau,eval0m).asDiagonal()*evec0.adjoint();
+    }else{
+      M[m]=evec0*bose_exp(beta,tau,eval0).asDiagonal()*evec0.adjoint();
+      V[m]=-iu*evec0*bose_exp(beta,tau,eval0m).asDiagonal()*evec0.adjoint();
+    }
+  }
+  if(nt1<0) return;
+  U.resize(nt1+1);
+  W.resize(nt1+1);
+  U[0]=cdmatrix::Identity(size,size);
+  for(int tstp=1;tstp<=nt1;tstp++){
+    for(int j=0;j<cf.nodes;j++){
+      const double *w=cf.weights(tstp,j);
+      for(int l=0;l<=cf.kt;l++){
+        cf_hamiltonian<T>(eps,cf.first(tstp)+l,Ht);
+        if(l==0) Hc[j]=w[l]*Ht;
+        else Hc[j]+=w[l]*Ht;
+      }
+    }
+    U[tstp]=U[tstp-1];
+    if(cf.order==2){
+      propagator_exp_apply<T>(U[tstp],Hc[0],h);
+    }else{
+      double a1=(3.0-2.0*sqrt(3.0))/12.0;
+      double a2=(3.0+2.0*sqrt(3.0))/12.0;
+      propagator_exp_apply<T>(U[tstp],matrix(a2*Hc[0]+a1*Hc[1]),h);
+      propagator_exp_apply<T>(U[tstp],matrix(a1*Hc[0]+a2*Hc[1]),h);
+    }
+  }
+  for(int tstp=0;tstp<=nt1;tstp++) U[tstp]*=std::complex<T>(cos(mu*h*tstp),sin(mu*h*tstp));
+  if(sign==-1){
+    rho=evec0*fermi(beta,eval0m).asDiagonal()*evec0.adjoint();
+  }else{
+    rho=-1.0*evec0*bose(beta,eval0m).asDiagonal()*evec0.adjoint();
+  }
+  for(int n=0;n<=nt1;n++) W[n]=iu*U[n]*rho;
+}
+
+/// @private
+template<typename T,class hamiltonian_list>
+void green_from_H_batch_k(herm_matrix<T> &G,T mu,hamiltonian_list &eps,T beta,T h,const cf_interpolants &cf){
+  std::complex<T> iu = std::complex<T>(0.0, 1.0);
+  int nt=G.nt(),ntau=G.ntau();
+  std::vector<cdmatrix> U,M,V,W;
+  cdmatrix tmp;
+  green_from_H_batch_data(mu,eps,beta,h,G.sig(),ntau,nt,cf,U,M,V,W);
+  for(int m=0;m<=ntau;m++) G.set_mat(m,M[m]);
+  for(int n=0;n<=nt;n++){
+    for(int m=0;m<=ntau;m++){
+      tmp=U[n]*V[m];
+      G.set_tv(n,m,tmp);
+    }
+  }
+  for(int m=0;m<=nt;m++){
+    for(int n=0;n<=m;n++){
+      tmp=-iu*U[m]*U[n].adjoint();
+      G.set_ret(m,n,tmp);
+      tmp=W[n]*U[m].adjoint();
+      G.set_les(n,m,tmp);
+    }
+  }
+}
+
+/// @private
+template<typename T,class hamiltonian_list>
+void green_from_H_batch_k(int tstp,herm_matrix_timestep_view<T> &G,T mu,hamiltonian_list &eps,T beta,T h,
+                          const cf_interpolants &cf){
+  std::complex<T> iu = std::complex<T>(0.0, 1.0);
+  int ntau=G.ntau();
+  std::vector<cdmatrix> U,M,V,W;
+  cdmatrix tmp;
+  green_from_H_batch_data(mu,eps,beta,h,G.sig(),ntau,tstp,cf,U,M,V,W);
+  if(tstp==-1){
+    for(int m=0;m<=ntau;m++) G.set_mat(m,M[m]);
+    return;
+  }
+  for(int m=0;m<=ntau;m++){
+    tmp=U[tstp]*V[m];
+    G.set_tv(tstp,m,tmp);
+  }
+  for(int n=0;n<=tstp;n++){
+    tmp=-iu*U[tstp]*U[n].adjoint();
+    G.set_ret(tstp,n,tmp);
+    tmp=W[n]*U[tstp].adjoint();
+    G.set_les(n,tstp,tmp);
+  }
+}
+
+/** \brief <b> Free propagators for many time-dependent Hamiltonians (e.g. lattice k-points) </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Same as `green_from_H(G[k],mu,eps[k],beta,h,SolveOrder,cf_order)` for all k, for Hamiltonians
+* > known at all times. The interpolation weights of the commutator-free propagator are computed
+* > once for all k, the equilibrium density matrix and imaginary-time factors are diagonalized once
+* > per k and reused for all times, and the loop over k is parallelized with OpenMP.
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param G
+* > [std::vector<herm_matrix>] The output Greens functions, G[k] set to the free propagator of eps[k]
+* @param mu
+* > chemical potential
+* @param eps
+* > [std::vector<function>] time dependent representation of the quadratic hamiltonians
+* @param beta
+* > inverse temperature
+* @param h
+* > timestep
+* @param SolveOrder
+* > Order of integrator used for interpolation
+* @param cf_order
+* > Order of approximation for commutator-free exponential, currently implemented orders = 2,4
+*/
+template<typename T>
+void green_from_H_batch(std::vector<herm_matrix<T> > &G,T mu,std::vector<cntr::function<T> > &eps,
+                        T beta,T h,int SolveOrder,int cf_order){
+  int nk=G.size();
+  assert(eps.size()==G.size());
+  assert(SolveOrder <= MAX_SOLVE_ORDER);
+  assert(cf_order == 2 || cf_order == 4);
+  if(nk==0) return;
+  for(int k=0;k<nk;k++){
+    assert(G[k].nt()==G[0].nt());
+    assert(G[k].size1()==eps[k].size2_);
+    assert(eps[k].size1_==eps[k].size2_);
+  }
+  cf_interpolants cf(G[0].nt(),cf_order,SolveOrder);
+#if CNTR_USE_OMP == 1
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for(int k=0;k<nk;k++) green_from_H_batch_k(G[k],mu,eps[k],beta,h,cf);
+}
+
+/** \brief <b> Free propagators for many time-dependent Hamiltonians given by a callback </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Same as `green_from_H_batch` for a vector of functions, with the Hamiltonian of G[k] given by
+* > `H(k,tstp,Hk)`, which must set the (size1 x size1) matrix `Hk` to the Hamiltonian at time step
+* > `tstp` (-1 for the equilibrium Hamiltonian). The callback is called from several OpenMP
+* > threads, each k on one thread, and only the Hamiltonian of the k on a thread is stored.
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param G
+* > [std::vector<herm_matrix>] The output Greens functions
+* @param mu
+* > chemical potential
+* @param H
+* > [hamiltonian] callback `void operator()(int k,int tstp,cdmatrix &Hk)`
+* @param beta
+* > inverse temperature
+* @param h
+* > timestep
+* @param SolveOrder
+* > Order of integrator used for interpolation
+* @param cf_order
+* > Order of approximation for commutator-free exponential, currently implemented orders = 2,4
+*/
+template<typename T,class hamiltonian>
+void green_from_H_batch(std::vector<herm_matrix<T> > &G,T mu,hamiltonian &H,
+                        T beta,T h,int SolveOrder,int cf_order){
+  int nk=G.size();
+  assert(SolveOrder <= MAX_SOLVE_ORDER);
+  assert(cf_order == 2 || cf_order == 4);
+  if(nk==0) return;
+  cf_interpolants cf(G[0].nt(),cf_order,SolveOrder);
+#if CNTR_USE_OMP == 1
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for(int k=0;k<nk;k++){
+    int nt=G[k].nt(),size=G[k].size1();
+    cntr::function<T> eps(nt,size);
+    cdmatrix Hk(size,size);
+    assert(nt==G[0].nt());
+    for(int tstp=-1;tstp<=nt;tstp++){
+      H(k,tstp,Hk);
+      eps.set_value(tstp,Hk);
+    }
+    green_from_H_batch_k(G[k],mu,eps,beta,h,cf);
+  }
+}
+
+/** \brief <b> Time step of the free propagators for many time-dependent Hamiltonians,
+*  stored in a distributed_timestep_array </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Sets the time step `tstp` of `G.G(k)` to the free propagator of `eps[k]`, as in
+* > `green_from_H(tstp,G,mu,eps[k],beta,h,true,SolveOrder,cf_order)`, for all k owned by this
+* > rank (`G.rank_owns(k)`); use `G.mpi_bcast_all()` to distribute the result. The loop over
+* > k is parallelized with OpenMP. `G` must be at time step `tstp` (see `reset_tstp`).
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > time step
+* @param G
+* > [distributed_timestep_array] The output Greens functions
+* @param mu
+* > chemical potential
+* @param eps
+* > [std::vector<function>] time dependent representation of the quadratic hamiltonians
+* @param beta
+* > inverse temperature
+* @param h
+* > timestep
+* @param SolveOrder
+* > Order of integrator used for interpolation
+* @param cf_order
+* > Order of approximation for commutator-free exponential, currently implemented orders = 2,4
+*/
+template<typename T>
+void green_from_H_batch(int tstp,distributed_timestep_array<T> &G,T mu,std::vector<cntr::function<T> > &eps,
+                        T beta,T h,int SolveOrder,int cf_order){
+  int nk=G.n();
+  assert(tstp==G.tstp());
+  assert((int)eps.size()==nk);
+  assert(SolveOrder <= MAX_SOLVE_ORDER);
+  assert(cf_order == 2 || cf_order == 4);
+  cf_interpolants cf(tstp,cf_order,SolveOrder);
+#if CNTR_USE_OMP == 1
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for(int k=0;k<nk;k++){
+    if(!G.rank_owns(k)) continue;
+    assert(G.size()==eps[k].size2_);
+    green_from_H_batch_k(tstp,G.G(k),mu,eps[k],beta,h,cf);
+  }
+}
+
+/** \brief <b> Propagator for a time-dependent sparse free Hamiltonian </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Same as `green_from_H(G,mu,eps,beta,h,SolveOrder,cf_order)` for a Hamiltonian given as Eigen
+* > sparse matrices, e.g. for long real-space chains. The commutator-free exponentials are
+* > applied by Krylov propagation if size1 >= CNTR_KRYLOV_MIN_SIZE, so that the cost per time step is
+* > \f$O(N\,\mathrm{nnz}(H))\f$ instead of \f$O(N^3)\f$; the equilibrium Hamiltonian is diagonalized once.
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param G
+* > The output Greens function set to time dependent free propagator
+* @param mu
+* > chemical potential
+* @param eps
+* > [std::vector<cdspmatrix>] Hermitian Hamiltonian at time steps -1..nt, H(t)=eps[t+1]
+* @param beta
+* > inverse temperature
+* @param h
+* > timestep
+* @param SolveOrder
+* > Order of integrator used for interpolation
+* @param cf_order
+* > Order of approximation for commutator-free exponential, currently implemented orders = 2,4
+*/
+template<typename T>
+void green_from_H(herm_matrix<T> &G,T mu,std::vector<cdspmatrix> &eps,T beta,T h,int SolveOrder,int cf_order){
+  assert((int)eps.size()==G.nt()+2);
+  assert(SolveOrder <= MAX_SOLVE_ORDER);
+  assert(cf_order == 2 || cf_order == 4);
+  for(size_t t=0;t<eps.size();t++){
+    assert(eps[t].rows()==G.size1());
+    assert(eps[t].cols()==G.size1());
+  }
+  cf_interpolants cf(G.nt(),cf_order,SolveOrder);
+  green_from_H_batch_k(G,mu,eps,beta,h,cf);
+}
 
 ///////////////////////////////////////////////////////////////////////////////////////
 // BOSONIC GREENS FUNCTION:
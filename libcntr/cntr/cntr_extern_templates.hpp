@@ -19,10 +19,25 @@
 #include "cntr_equilibrium_extern_templates.hpp"
 #include "cntr_vie2_extern_templates.hpp"
 #include "cntr_dyson_extern_templates.hpp"
+#include "cntr_lattice_convolution_extern_templates.hpp"
+#include "cntr_hdf5_timestep_writer_extern_templates.hpp"
+#include "cntr_hdf5_async_writer_extern_templates.hpp"
+#include "cntr_hdf5_partial_extern_templates.hpp"
+#include "cntr_checkpoint_extern_templates.hpp"
+#include "cntr_snapshot_extern_templates.hpp"
+#include "cntr_tavtrel_extern_templates.hpp"
+#include "cntr_herm_matrix_hdf5_view_extern_templates.hpp"
+#include "cntr_herm_matrix_tti_extern_templates.hpp"
+#include "cntr_wigner_extern_templates.hpp"
+#include "cntr_dlr_extern_templates.hpp"
+#include "cntr_tau_grid_extern_templates.hpp"
+#include "cntr_matsubara_fft_extern_templates.hpp"
+#include "cntr_newton_krylov_extern_templates.hpp"
 
 #include "cntr_getset_extern_templates.hpp"
 #if CNTR_USE_MPI == 1
 #include "cntr_mpitools_extern_templates.hpp"
+#include "cntr_hdf5_mpi_extern_templates.hpp"
 #endif
 
 #endif  // CNTR_EXTERN_TEMPLATES_H
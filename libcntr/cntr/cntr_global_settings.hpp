@@ -41,6 +41,12 @@
 #define CNTR_MAT_FOURIER 0
 #define CNTR_MAT_CG 1
 #define CNTR_MAT_FIXPOINT 2
+#define CNTR_MAT_FFT 3
+
+// wire formats for MPI data exchange of timesteps
+#define CNTR_WIRE_EXACT 0
+#define CNTR_WIRE_FLOAT 1
+#define CNTR_WIRE_DELTA 2
 
 #define GREEN cntr::herm_matrix<double>
 #define GREEN_TSTP cntr::herm_matrix_timestep<double>
@@ -0,0 +1,102 @@
+#ifndef CNTR_HDF5_ASYNC_WRITER_DECL_H
+#define CNTR_HDF5_ASYNC_WRITER_DECL_H
+
+#include "cntr_global_settings.hpp"
+#include "cntr_hdf5_timestep_writer_decl.hpp"
+
+#if CNTR_USE_HDF5 == 1 && __cplusplus >= 201103L
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace cntr {
+
+template <typename T> class function;
+template <typename T> class herm_matrix;
+template <typename T> class herm_matrix_timestep;
+
+/** \brief <b> HDF5 output on a background thread. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > The calling thread copies the data to be written (a timestep of the streamed objects,
+ * > see `hdf5_timestep_writer`, or a snapshot of a whole object) into a queue, and returns
+ * > immediately; a dedicated I/O thread writes the queued snapshots to HDF5 in order.
+ * > Output thus overlaps with the computation of the next timestep, and the objects may be
+ * > modified as soon as the call returns.
+ * >
+ * > The queue holds at most `max_bytes` of snapshot data (at least one snapshot): if it is
+ * > full, the calling thread blocks until the I/O thread has caught up (back-pressure).
+ * > `fence()` blocks until everything queued so far is on disk; the destructor does the same.
+ * >
+ * > The HDF5 library is in general not thread safe: while snapshots are pending, the
+ * > calling program must not do HDF5 I/O itself (including `set_hdf5_storage_policy`);
+ * > call `fence()` first. Arbitrary output, e.g. `write_lattice_to_hdf5_file_gw` on a copy of
+ * > the lattice data, can be queued with `submit`.
+ */
+template <typename T>
+class hdf5_async_writer {
+  public:
+    typedef std::complex<T> cplx;
+    /* construction, destruction */
+    explicit hdf5_async_writer(size_t max_bytes = ((size_t)1) << 28);
+    ~hdf5_async_writer();
+    // streaming output, see hdf5_timestep_writer
+    void open(const char *filename);
+    void add(const char *groupname, herm_matrix<T> &G);
+    void add(const char *groupname, function<T> &f);
+    void write_timestep(int tstp);
+    void close(void);
+    // snapshots of whole objects
+    void write_to_hdf5(const char *filename, const char *groupname,
+                       const herm_matrix<T> &G);
+    void write_to_hdf5(const char *filename, const char *groupname,
+                       const herm_matrix_timestep<T> &G);
+    void write_to_hdf5(const char *filename, const char *groupname,
+                       const function<T> &f);
+    void write_to_hdf5_slices(const char *filename, const char *groupname,
+                              const herm_matrix<T> &G, int dt);
+    void write_to_hdf5_tavtrel(const char *filename, const char *groupname,
+                               const herm_matrix<T> &G, int dt);
+    // generic job; bytes: size of the data held by job
+    void submit(const std::function<void()> &job, size_t bytes);
+    void fence(void);
+    size_t max_bytes(void) const { return max_bytes_; }
+    size_t pending_bytes(void) const;
+
+  private:
+    /// @private
+    hdf5_async_writer(const hdf5_async_writer &w);
+    /// @private
+    hdf5_async_writer &operator=(const hdf5_async_writer &w);
+    /// @private
+    void reserve(size_t bytes);
+    /// @private
+    void push(const std::function<void()> &job, size_t bytes);
+    /// @private
+    void run(void);
+
+    hdf5_timestep_writer<T> stream_;   /*!< Streaming output, written by the I/O thread */
+    int stream_tstp_;                  /*!< Last timestep queued for streaming output */
+    std::deque<std::pair<std::function<void()>, size_t> > queue_; /*!< Queued jobs and their size */
+    size_t max_bytes_;                 /*!< Maximal size of the pending snapshots */
+    size_t pending_bytes_;             /*!< Size of the reserved, queued and running snapshots */
+    int pending_jobs_;                 /*!< Number of reserved, queued and running jobs */
+    bool stop_;                        /*!< Set by the destructor */
+    mutable std::mutex mutex_;         /*!< Protects the members above */
+    std::condition_variable work_;     /*!< Signals new jobs to the I/O thread */
+    std::condition_variable done_;     /*!< Signals finished jobs to the calling thread */
+    std::thread thread_;               /*!< The I/O thread */
+};
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
+
+#endif  // CNTR_HDF5_ASYNC_WRITER_DECL_H
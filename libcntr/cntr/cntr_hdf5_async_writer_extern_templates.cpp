@@ -0,0 +1,15 @@
+#include "cntr_hdf5_async_writer_extern_templates.hpp"
+#include "cntr_function_impl.hpp"
+#include "cntr_herm_matrix_impl.hpp"
+#include "cntr_herm_matrix_timestep_impl.hpp"
+#include "cntr_hdf5_async_writer_impl.hpp"
+
+#if CNTR_USE_HDF5 == 1 && __cplusplus >= 201103L
+
+namespace cntr {
+
+  template class hdf5_async_writer<double>;
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
@@ -0,0 +1,16 @@
+#ifndef CNTR_HDF5_ASYNC_WRITER_EXTERN_TEMPLATES_H
+#define CNTR_HDF5_ASYNC_WRITER_EXTERN_TEMPLATES_H
+
+#include "cntr_hdf5_async_writer_decl.hpp"
+
+#if CNTR_USE_HDF5 == 1 && __cplusplus >= 201103L
+
+namespace cntr {
+
+  extern template class hdf5_async_writer<double>;
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
+
+#endif  // CNTR_HDF5_ASYNC_WRITER_EXTERN_TEMPLATES_H
@@ -0,0 +1,427 @@
+#ifndef CNTR_HDF5_ASYNC_WRITER_IMPL_H
+#define CNTR_HDF5_ASYNC_WRITER_IMPL_H
+
+#include "cntr_hdf5_async_writer_decl.hpp"
+#include "cntr_hdf5_timestep_writer_impl.hpp"
+#include "cntr_function_decl.hpp"
+#include "cntr_herm_matrix_decl.hpp"
+#include "cntr_herm_matrix_timestep_decl.hpp"
+
+#if CNTR_USE_HDF5 == 1 && __cplusplus >= 201103L
+
+#include <memory>
+
+namespace cntr {
+
+/** \brief <b> Initializes the `hdf5_async_writer` and starts the I/O thread. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Starts the I/O thread with an empty queue.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param max_bytes
+ * > [size_t] Maximal size of the pending snapshots, in bytes (default: 256MB).
+ * > A single larger snapshot is accepted when the queue is empty.
+ */
+template <typename T>
+hdf5_async_writer<T>::hdf5_async_writer(size_t max_bytes) {
+    stream_tstp_ = -2;
+    max_bytes_ = max_bytes;
+    pending_bytes_ = 0;
+    pending_jobs_ = 0;
+    stop_ = false;
+    thread_ = std::thread(&hdf5_async_writer<T>::run, this);
+}
+/** \brief <b> Writes all pending snapshots and stops the I/O thread. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Blocks until all queued snapshots are written, stops the I/O thread and closes
+ * > the streaming output file.
+ */
+template <typename T>
+hdf5_async_writer<T>::~hdf5_async_writer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_.notify_all();
+    thread_.join();
+    stream_.close();
+}
+/// @private
+template <typename T>
+void hdf5_async_writer<T>::run(void) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        work_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (queue_.empty())
+            return;
+        std::pair<std::function<void()>, size_t> job = queue_.front();
+        queue_.pop_front();
+        lock.unlock();
+        job.first();
+        job.first = std::function<void()>(); // release the snapshot
+        lock.lock();
+        pending_bytes_ -= job.second;
+        pending_jobs_--;
+        done_.notify_all();
+    }
+}
+/// @private
+// back-pressure: wait for space in the queue before the snapshot is allocated
+template <typename T>
+void hdf5_async_writer<T>::reserve(size_t bytes) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this, bytes] {
+        return pending_jobs_ == 0 || pending_bytes_ + bytes <= max_bytes_;
+    });
+    pending_bytes_ += bytes;
+    pending_jobs_++;
+}
+/// @private
+template <typename T>
+void hdf5_async_writer<T>::push(const std::function<void()> &job, size_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::make_pair(job, bytes));
+    }
+    work_.notify_one();
+}
+/** \brief <b> Queues a user-defined output job. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Queues `job` for execution on the I/O thread, after all previously queued jobs.
+ * > The job must own (a copy of) the data it writes. Blocks while the queue is full.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param job
+ * > [std::function<void()>] The output job.
+ * @param bytes
+ * > [size_t] The size of the data held by `job`, counted against `max_bytes`.
+ */
+template <typename T>
+void hdf5_async_writer<T>::submit(const std::function<void()> &job, size_t bytes) {
+    reserve(bytes);
+    push(job, bytes);
+}
+/** \brief <b> Blocks until all queued snapshots are written. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Returns when the I/O thread has written everything queued before the call and is idle.
+ * > Afterwards the calling thread may access HDF5 files itself.
+ */
+template <typename T>
+void hdf5_async_writer<T>::fence(void) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return pending_jobs_ == 0; });
+}
+/** \brief <b> Size of the snapshots not yet written, in bytes. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Returns the size of the snapshots that are queued or being written.
+ */
+template <typename T>
+size_t hdf5_async_writer<T>::pending_bytes(void) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_bytes_;
+}
+/** \brief <b> Opens (and truncates) an HDF5 file for streaming output. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Waits for all pending output, closes the previous streaming file and opens `filename`,
+ * > see `hdf5_timestep_writer::open`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [const char*] The name of the HDF5 file.
+ */
+template <typename T>
+void hdf5_async_writer<T>::open(const char *filename) {
+    fence();
+    stream_.open(filename);
+    stream_tstp_ = -2;
+}
+/** \brief <b> Closes the streaming output file. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Waits for all pending output and closes the streaming output file.
+ */
+template <typename T>
+void hdf5_async_writer<T>::close(void) {
+    fence();
+    stream_.close();
+    stream_tstp_ = -2;
+}
+/** \brief <b> Registers a `herm_matrix` for streaming output. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > See `hdf5_timestep_writer::add`. Must be called before the first `write_timestep`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param groupname
+ * > [const char*] The name of the HDF5 group.
+ * @param G
+ * > [herm_matrix<T>] The contour function; referenced until the last `write_timestep`.
+ */
+template <typename T>
+void hdf5_async_writer<T>::add(const char *groupname, herm_matrix<T> &G) {
+    assert(stream_tstp_ == -2);
+    fence();
+    stream_.add(groupname, G);
+}
+/** \brief <b> Registers a `function` for streaming output. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > See `hdf5_timestep_writer::add`. Must be called before the first `write_timestep`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param groupname
+ * > [const char*] The name of the HDF5 group.
+ * @param f
+ * > [function<T>] The function; referenced until the last `write_timestep`.
+ */
+template <typename T>
+void hdf5_async_writer<T>::add(const char *groupname, function<T> &f) {
+    assert(stream_tstp_ == -2);
+    fence();
+    stream_.add(groupname, f);
+}
+/** \brief <b> Queues timestep `tstp` of all registered objects for streaming output. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Copies the data of timestep `tstp` of the registered objects and queues them;
+ * > the I/O thread appends them to the file as `hdf5_timestep_writer::write_timestep`.
+ * > Timesteps must be queued consecutively, starting with `tstp=-1`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] The timestep; must be the last timestep queued plus one.
+ */
+template <typename T>
+void hdf5_async_writer<T>::write_timestep(int tstp) {
+    assert(stream_.is_open());
+    assert(tstp == stream_tstp_ + 1);
+    size_t len = stream_.timestep_size(tstp);
+    reserve(len * sizeof(cplx));
+    std::shared_ptr<std::vector<cplx> > buf(new std::vector<cplx>(len));
+    stream_.pack_timestep(tstp, buf->data());
+    hdf5_timestep_writer<T> *stream = &stream_;
+    push([stream, tstp, buf] { stream->write_packed_timestep(tstp, buf->data()); },
+         len * sizeof(cplx));
+    stream_tstp_ = tstp;
+}
+/** \brief <b> Queues a snapshot of a `herm_matrix` for output with `write_to_hdf5`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Copies `G` and queues `herm_matrix::write_to_hdf5(filename,groupname)` of the copy.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [const char*] The name of the HDF5 file (truncated).
+ * @param groupname
+ * > [const char*] The name of the HDF5 group.
+ * @param G
+ * > [herm_matrix<T>] The contour function.
+ */
+template <typename T>
+void hdf5_async_writer<T>::write_to_hdf5(const char *filename, const char *groupname,
+                                         const herm_matrix<T> &G) {
+    int nt = G.nt(), ntau = G.ntau();
+    size_t bytes = ((size_t)(nt + 1) * (nt + 2) + (size_t)(nt + 1) * (ntau + 1) + ntau + 1) *
+                   G.element_size() * sizeof(cplx);
+    reserve(bytes);
+    std::shared_ptr<herm_matrix<T> > Gc(new herm_matrix<T>(G));
+    std::string file(filename), group(groupname);
+    push([Gc, file, group] { Gc->write_to_hdf5(file.c_str(), group.c_str()); }, bytes);
+}
+/** \brief <b> Queues a snapshot of a `herm_matrix_timestep` for output with `write_to_hdf5`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Copies `G` and queues `herm_matrix_timestep::write_to_hdf5(filename,groupname)` of the copy.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [const char*] The name of the HDF5 file (truncated).
+ * @param groupname
+ * > [const char*] The name of the HDF5 group.
+ * @param G
+ * > [herm_matrix_timestep<T>] The timestep.
+ */
+template <typename T>
+void hdf5_async_writer<T>::write_to_hdf5(const char *filename, const char *groupname,
+                                         const herm_matrix_timestep<T> &G) {
+    size_t bytes = (size_t)(2 * (G.tstp() + 1) + G.ntau() + 1) * G.size1() * G.size2() *
+                   sizeof(cplx);
+    reserve(bytes);
+    std::shared_ptr<herm_matrix_timestep<T> > Gc(new herm_matrix_timestep<T>(G));
+    std::string file(filename), group(groupname);
+    push([Gc, file, group] { Gc->write_to_hdf5(file.c_str(), group.c_str()); }, bytes);
+}
+/** \brief <b> Queues a snapshot of a `function` for output with `write_to_hdf5`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Copies `f` and queues `function::write_to_hdf5(filename,groupname)` of the copy.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [const char*] The name of the HDF5 file (truncated).
+ * @param groupname
+ * > [const char*] The name of the HDF5 group.
+ * @param f
+ * > [function<T>] The function.
+ */
+template <typename T>
+void hdf5_async_writer<T>::write_to_hdf5(const char *filename, const char *groupname,
+                                         const function<T> &f) {
+    size_t bytes = (size_t)(f.nt() + 2) * f.element_size() * sizeof(cplx);
+    reserve(bytes);
+    std::shared_ptr<function<T> > fc(new function<T>(f));
+    std::string file(filename), group(groupname);
+    push([fc, file, group] { fc->write_to_hdf5(file.c_str(), group.c_str()); }, bytes);
+}
+/** \brief <b> Queues a snapshot of a `herm_matrix` for output with `write_to_hdf5_slices`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Copies `G` and queues `herm_matrix::write_to_hdf5_slices(filename,groupname,dt)` of the copy.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [const char*] The name of the HDF5 file (truncated).
+ * @param groupname
+ * > [const char*] The name of the HDF5 group.
+ * @param G
+ * > [herm_matrix<T>] The contour function.
+ * @param dt
+ * > [int] Distance between the time slices.
+ */
+template <typename T>
+void hdf5_async_writer<T>::write_to_hdf5_slices(const char *filename,
+                                                const char *groupname,
+                                                const herm_matrix<T> &G, int dt) {
+    int nt = G.nt(), ntau = G.ntau();
+    size_t bytes = ((size_t)(nt + 1) * (nt + 2) + (size_t)(nt + 1) * (ntau + 1) + ntau + 1) *
+                   G.element_size() * sizeof(cplx);
+    reserve(bytes);
+    std::shared_ptr<herm_matrix<T> > Gc(new herm_matrix<T>(G));
+    std::string file(filename), group(groupname);
+    push([Gc, file, group, dt] {
+        Gc->write_to_hdf5_slices(file.c_str(), group.c_str(), dt);
+    }, bytes);
+}
+/** \brief <b> Queues a snapshot of a `herm_matrix` for output with `write_to_hdf5_tavtrel`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Copies `G` and queues `herm_matrix::write_to_hdf5_tavtrel(filename,groupname,dt)` of the copy.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [const char*] The name of the HDF5 file (truncated).
+ * @param groupname
+ * > [const char*] The name of the HDF5 group.
+ * @param G
+ * > [herm_matrix<T>] The contour function.
+ * @param dt
+ * > [int] Distance between the average times.
+ */
+template <typename T>
+void hdf5_async_writer<T>::write_to_hdf5_tavtrel(const char *filename,
+                                                 const char *groupname,
+                                                 const herm_matrix<T> &G, int dt) {
+    int nt = G.nt(), ntau = G.ntau();
+    size_t bytes = ((size_t)(nt + 1) * (nt + 2) + (size_t)(nt + 1) * (ntau + 1) + ntau + 1) *
+                   G.element_size() * sizeof(cplx);
+    reserve(bytes);
+    std::shared_ptr<herm_matrix<T> > Gc(new herm_matrix<T>(G));
+    std::string file(filename), group(groupname);
+    push([Gc, file, group, dt] {
+        Gc->write_to_hdf5_tavtrel(file.c_str(), group.c_str(), dt);
+    }, bytes);
+}
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
+
+#endif  // CNTR_HDF5_ASYNC_WRITER_IMPL_H
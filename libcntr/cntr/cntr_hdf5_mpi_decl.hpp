@@ -0,0 +1,36 @@
+#ifndef CNTR_HDF5_MPI_DECL_H
+#define CNTR_HDF5_MPI_DECL_H
+
+#include "cntr_global_settings.hpp"
+
+#if CNTR_USE_HDF5 == 1 && CNTR_USE_MPI == 1
+
+namespace cntr {
+
+template <typename T> class herm_matrix;
+template <typename T> class distributed_timestep_array;
+
+/* /////////////////////////////////////////////////////////////////////////////
+// Collective HDF5 I/O of distributed data: all ranks write their owned blocks
+// into one shared file. Rank 0 creates the file and preallocates contiguous
+// datasets with a serial HDF5 library; the ranks then write the raw data of
+// their blocks concurrently through MPI-IO. Reading is independent per rank.
+///////////////////////////////////////////////////////////////////////////// */
+template <typename T>
+void write_to_hdf5_mpi(const char *filename, const char *groupname,
+                       distributed_timestep_array<T> &G);
+template <typename T>
+void read_from_hdf5_mpi(const char *filename, const char *groupname,
+                        distributed_timestep_array<T> &G);
+template <typename T>
+void write_to_hdf5_mpi(const char *filename, const char *groupname,
+                       std::vector<herm_matrix<T> > &G, const std::vector<int> &tid_map);
+template <typename T>
+void read_from_hdf5_mpi(const char *filename, const char *groupname,
+                        std::vector<herm_matrix<T> > &G, const std::vector<int> &tid_map);
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5 && CNTR_USE_MPI
+
+#endif  // CNTR_HDF5_MPI_DECL_H
@@ -0,0 +1,23 @@
+#include "cntr_hdf5_mpi_extern_templates.hpp"
+#include "cntr_herm_matrix_impl.hpp"
+#include "cntr_herm_matrix_timestep_view_impl.hpp"
+#include "cntr_distributed_array_impl.hpp"
+#include "cntr_distributed_timestep_array_impl.hpp"
+#include "cntr_hdf5_mpi_impl.hpp"
+
+#if CNTR_USE_HDF5 == 1 && CNTR_USE_MPI == 1
+
+namespace cntr {
+
+  template void write_to_hdf5_mpi<double>(const char *filename, const char *groupname,
+    distributed_timestep_array<double> &G);
+  template void read_from_hdf5_mpi<double>(const char *filename, const char *groupname,
+    distributed_timestep_array<double> &G);
+  template void write_to_hdf5_mpi<double>(const char *filename, const char *groupname,
+    std::vector<herm_matrix<double> > &G, const std::vector<int> &tid_map);
+  template void read_from_hdf5_mpi<double>(const char *filename, const char *groupname,
+    std::vector<herm_matrix<double> > &G, const std::vector<int> &tid_map);
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5 && CNTR_USE_MPI
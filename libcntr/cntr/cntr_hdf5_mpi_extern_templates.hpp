@@ -0,0 +1,23 @@
+#ifndef CNTR_HDF5_MPI_EXTERN_TEMPLATES_H
+#define CNTR_HDF5_MPI_EXTERN_TEMPLATES_H
+
+#include "cntr_hdf5_mpi_decl.hpp"
+
+#if CNTR_USE_HDF5 == 1 && CNTR_USE_MPI == 1
+
+namespace cntr {
+
+  extern template void write_to_hdf5_mpi<double>(const char *filename, const char *groupname,
+    distributed_timestep_array<double> &G);
+  extern template void read_from_hdf5_mpi<double>(const char *filename, const char *groupname,
+    distributed_timestep_array<double> &G);
+  extern template void write_to_hdf5_mpi<double>(const char *filename, const char *groupname,
+    std::vector<herm_matrix<double> > &G, const std::vector<int> &tid_map);
+  extern template void read_from_hdf5_mpi<double>(const char *filename, const char *groupname,
+    std::vector<herm_matrix<double> > &G, const std::vector<int> &tid_map);
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5 && CNTR_USE_MPI
+
+#endif  // CNTR_HDF5_MPI_EXTERN_TEMPLATES_H
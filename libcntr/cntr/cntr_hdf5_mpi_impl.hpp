@@ -0,0 +1,435 @@
+#ifndef CNTR_HDF5_MPI_IMPL_H
+#define CNTR_HDF5_MPI_IMPL_H
+
+#include "cntr_hdf5_mpi_decl.hpp"
+#include "cntr_herm_matrix_decl.hpp"
+#include "cntr_distributed_timestep_array_decl.hpp"
+#include "cntr_mpitools_decl.hpp"
+
+#if CNTR_USE_HDF5 == 1 && CNTR_USE_MPI == 1
+
+#include <climits>
+#include <stdexcept>
+
+namespace cntr {
+
+/// @private
+// Attributes and datasets (shape nblocks x rows[d] x size1 x size2) of a distributed group
+struct hdf5_mpi_layout {
+    std::vector<std::string> int_names;
+    std::vector<int> int_values;
+    std::vector<std::string> datasets;
+    std::vector<hsize_t> rows;
+    hsize_t nblocks, size1, size2;
+};
+
+/// @private
+// Compound type {r,i} of std::complex<T>, as in herm_matrix::write_to_hdf5
+template <typename T>
+hid_t hdf5_mpi_complex_type(void) {
+    hid_t base = (sizeof(T) == sizeof(double) ? H5T_NATIVE_DOUBLE : H5T_NATIVE_FLOAT);
+    hid_t type_id = H5Tcreate(H5T_COMPOUND, sizeof(T) * 2);
+    H5Tinsert(type_id, "r", 0, base);
+    H5Tinsert(type_id, "i", sizeof(T), base);
+    return type_id;
+}
+
+/// @private
+// Reads block k of a dataset into ptr
+template <typename T>
+void hdf5_mpi_read_block(hid_t data_id, int k, std::complex<T> *ptr) {
+    hid_t file_space = H5Dget_space(data_id);
+    hsize_t dims[4], start[4] = {(hsize_t)k, 0, 0, 0};
+    H5Sget_simple_extent_dims(file_space, dims, NULL);
+    hsize_t count[4] = {1, dims[1], dims[2], dims[3]};
+    hid_t mem_space = H5Screate_simple(4, count, NULL);
+    H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+    hid_t type_id = hdf5_mpi_complex_type<T>();
+    herr_t status = H5Dread(data_id, type_id, mem_space, file_space, H5P_DEFAULT, ptr);
+    H5Tclose(type_id);
+    H5Sclose(mem_space);
+    H5Sclose(file_space);
+    if (status < 0)
+        throw std::runtime_error("read_from_hdf5_mpi: cannot read block");
+}
+
+/// @private
+// Reads the owned blocks of all datasets of group_id; ptr[d][i]: data of block owned[i] in
+// dataset d. The file is opened read-only on all ranks, which read independently.
+template <typename T>
+void hdf5_mpi_read_blocks(hid_t group_id, const std::vector<std::string> &datasets,
+                          const std::vector<int> &owned,
+                          std::vector<std::vector<std::complex<T> *> > &ptr) {
+    for (size_t d = 0; d < datasets.size(); d++) {
+        hid_t data_id = H5Dopen(group_id, datasets[d].c_str(), H5P_DEFAULT);
+        if (data_id < 0)
+            throw std::runtime_error("read_from_hdf5_mpi: no dataset " + datasets[d]);
+        for (size_t i = 0; i < owned.size(); i++)
+            hdf5_mpi_read_block(data_id, owned[i], ptr[d][i]);
+        H5Dclose(data_id);
+    }
+}
+
+/// @private
+inline hid_t hdf5_mpi_open_read(const char *filename) {
+    hid_t file_id = read_hdf5_file(std::string(filename));
+    if (file_id < 0)
+        throw std::runtime_error(std::string("read_from_hdf5_mpi: cannot open ") + filename);
+    return file_id;
+}
+
+/// @private
+// Writes the owned blocks of all ranks into one file. Rank 0 creates the file with all
+// metadata and contiguous, preallocated datasets, and broadcasts their file offsets; then
+// every rank writes the raw data of its blocks concurrently through MPI-IO. This needs
+// only a serial HDF5 library, and no data pass through rank 0.
+template <typename T>
+void hdf5_mpi_write_blocks(const char *filename, const char *groupname,
+                           const hdf5_mpi_layout &L, const std::vector<int> &owned,
+                           std::vector<std::vector<std::complex<T> *> > &ptr) {
+    int tid, nd = L.datasets.size();
+    MPI_Comm_rank(MPI_COMM_WORLD, &tid);
+    // the file may still be open on ranks reading it
+    MPI_Barrier(MPI_COMM_WORLD);
+    // file offset of each dataset; -1: no storage (empty), -2: rank 0 failed
+    std::vector<long long> offset(nd + 1, -1);
+    if (tid == 0) {
+        offset[nd] = 0;
+        hid_t file_id = open_hdf5_file(std::string(filename));
+        if (file_id < 0) {
+            offset[nd] = -2;
+        } else {
+            hid_t group_id = create_group(file_id, std::string(groupname));
+            for (size_t i = 0; i < L.int_names.size(); i++)
+                store_int_attribute_to_hid(group_id, L.int_names[i], L.int_values[i]);
+            hid_t type_id = hdf5_mpi_complex_type<T>();
+            hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+            H5Pset_layout(dcpl, H5D_CONTIGUOUS);
+            H5Pset_alloc_time(dcpl, H5D_ALLOC_TIME_EARLY);
+            H5Pset_fill_time(dcpl, H5D_FILL_TIME_NEVER);
+            for (int d = 0; d < nd; d++) {
+                hsize_t shape[4] = {L.nblocks, L.rows[d], L.size1, L.size2};
+                hid_t space_id = H5Screate_simple(4, shape, NULL);
+                hid_t data_id = H5Dcreate(group_id, L.datasets[d].c_str(), type_id, space_id,
+                                          H5P_DEFAULT, dcpl, H5P_DEFAULT);
+                if (data_id < 0) {
+                    offset[nd] = -2;
+                } else {
+                    haddr_t addr = H5Dget_offset(data_id);
+                    if (addr != HADDR_UNDEF)
+                        offset[d] = (long long)addr;
+                    else if (H5Dget_storage_size(data_id) > 0)
+                        offset[nd] = -2;
+                    H5Dclose(data_id);
+                }
+                H5Sclose(space_id);
+            }
+            H5Pclose(dcpl);
+            H5Tclose(type_id);
+            close_group(group_id);
+            if (H5Fclose(file_id) < 0)
+                offset[nd] = -2;
+        }
+    }
+    MPI_Bcast(offset.data(), nd + 1, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+    if (offset[nd] != 0)
+        throw std::runtime_error(std::string("write_to_hdf5_mpi: cannot create ") + filename);
+    MPI_File fh;
+    if (MPI_File_open(MPI_COMM_WORLD, const_cast<char *>(filename), MPI_MODE_WRONLY,
+                      MPI_INFO_NULL, &fh) != MPI_SUCCESS)
+        throw std::runtime_error(std::string("write_to_hdf5_mpi: cannot open ") + filename);
+    bool ok = true;
+    for (int d = 0; d < nd; d++) {
+        // blocks of the contiguous dataset are stored one after the other
+        long long len = (long long)(L.rows[d] * L.size1 * L.size2);
+        MPI_Offset bytes = (MPI_Offset)(len * sizeof(std::complex<T>));
+        for (size_t i = 0; i < owned.size() && ok && len > 0; i++) {
+            assert(len <= INT_MAX);
+            ok = (MPI_File_write_at(fh, (MPI_Offset)offset[d] + owned[i] * bytes, ptr[d][i],
+                                    (int)len, mpi_complex_datatype<T>(),
+                                    MPI_STATUS_IGNORE) == MPI_SUCCESS);
+        }
+    }
+    if (MPI_File_close(&fh) != MPI_SUCCESS)
+        ok = false;
+    if (!ok)
+        throw std::runtime_error(std::string("write_to_hdf5_mpi: cannot write ") + filename);
+}
+
+/** \brief <b> Writes a `distributed_timestep_array` to one shared HDF5 file, in parallel. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Collective over `MPI_COMM_WORLD`: each rank writes the blocks it owns into the group
+ * > `groupname` of the file `filename` (truncated). The group holds `n`, `tstp`, `ntau`, `sig`,
+ * > `size1`, `size2`, `element_size` and the dataset `data` of shape
+ * > (`n`, `2*(tstp+1)+ntau+1`, `size1`, `size2`), block `j` containing the timestep of `G.G(j)`
+ * > in the layout of `herm_matrix_timestep` (ret, tv, les; mat for `tstp=-1`).
+ * > No data pass through the root rank: rank 0 writes the metadata and preallocates the
+ * > datasets, then all ranks write their blocks concurrently through MPI-IO.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [const char*] The name of the HDF5 file.
+ * @param groupname
+ * > [const char*] The name of the HDF5 group.
+ * @param G
+ * > [distributed_timestep_array<T>] The distributed timestep (constructed with `mpi=true`).
+ */
+template <typename T>
+void write_to_hdf5_mpi(const char *filename, const char *groupname,
+                       distributed_timestep_array<T> &G) {
+    int tstp = G.tstp(), ntau = G.ntau(), size = G.size();
+    hdf5_mpi_layout L;
+    L.int_names.push_back("n");
+    L.int_values.push_back(G.n());
+    L.int_names.push_back("tstp");
+    L.int_values.push_back(tstp);
+    L.int_names.push_back("ntau");
+    L.int_values.push_back(ntau);
+    L.int_names.push_back("sig");
+    L.int_values.push_back(G.sig());
+    L.int_names.push_back("size1");
+    L.int_values.push_back(size);
+    L.int_names.push_back("size2");
+    L.int_values.push_back(size);
+    L.int_names.push_back("element_size");
+    L.int_values.push_back(size * size);
+    L.datasets.push_back("data");
+    L.rows.push_back(2 * (tstp + 1) + ntau + 1);
+    L.nblocks = G.n();
+    L.size1 = size;
+    L.size2 = size;
+    std::vector<int> owned;
+    std::vector<std::vector<std::complex<T> *> > ptr(1);
+    for (int j = 0; j < G.n(); j++) {
+        if (G.rank_owns(j)) {
+            owned.push_back(j);
+            ptr[0].push_back(G.block(j));
+        }
+    }
+    hdf5_mpi_write_blocks(filename, groupname, L, owned, ptr);
+}
+/** \brief <b> Reads a `distributed_timestep_array` from a shared HDF5 file, in parallel. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Collective over `MPI_COMM_WORLD`: reads a group written by `write_to_hdf5_mpi`.
+ * > `G` is set to the stored timestep, and each rank reads the blocks it owns.
+ * > `G` must have the number of blocks, `ntau`, the size and the statistics of the stored data.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [const char*] The name of the HDF5 file.
+ * @param groupname
+ * > [const char*] The name of the HDF5 group.
+ * @param G
+ * > [distributed_timestep_array<T>] The distributed timestep.
+ */
+template <typename T>
+void read_from_hdf5_mpi(const char *filename, const char *groupname,
+                        distributed_timestep_array<T> &G) {
+    hid_t file_id = hdf5_mpi_open_read(filename);
+    hid_t group_id = open_group(file_id, std::string(groupname));
+    int tstp = read_primitive_type<int>(group_id, "tstp");
+    assert(read_primitive_type<int>(group_id, "n") == G.n());
+    assert(read_primitive_type<int>(group_id, "ntau") == G.ntau());
+    assert(read_primitive_type<int>(group_id, "sig") == G.sig());
+    assert(read_primitive_type<int>(group_id, "size1") == G.size());
+    assert(tstp <= G.nt());
+    G.reset_tstp(tstp);
+    std::vector<std::string> datasets(1, std::string("data"));
+    std::vector<int> owned;
+    std::vector<std::vector<std::complex<T> *> > ptr(1);
+    for (int j = 0; j < G.n(); j++) {
+        if (G.rank_owns(j)) {
+            owned.push_back(j);
+            ptr[0].push_back(G.block(j));
+        }
+    }
+    hdf5_mpi_read_blocks(group_id, datasets, owned, ptr);
+    close_group(group_id);
+    close_hdf5_file(file_id);
+}
+/** \brief <b> Writes a collection of `herm_matrix` objects (e.g. one per k-point) to one shared HDF5 file, in parallel. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Collective over `MPI_COMM_WORLD`: `G[k]` is owned by rank `tid_map[k]`, and only owned
+ * > entries are accessed (the others may be empty). Each rank writes its entries into the
+ * > group `groupname` of the file `filename` (truncated), which holds `nk`, `nt`, `ntau`, `sig`,
+ * > `size1`, `size2`, `element_size` and the datasets `mat`, `ret`, `les`, `tv` of
+ * > `herm_matrix::write_to_hdf5` with an additional first axis of length `nk`.
+ * > All owned entries must have the same dimensions.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [const char*] The name of the HDF5 file.
+ * @param groupname
+ * > [const char*] The name of the HDF5 group.
+ * @param G
+ * > [std::vector<herm_matrix<T>>] The collection.
+ * @param tid_map
+ * > [std::vector<int>] Owner of each entry, e.g. `distributed_array::tid_map()`.
+ */
+template <typename T>
+void write_to_hdf5_mpi(const char *filename, const char *groupname,
+                       std::vector<herm_matrix<T> > &G, const std::vector<int> &tid_map) {
+    int tid, nk = G.size();
+    MPI_Comm_rank(MPI_COMM_WORLD, &tid);
+    assert((int)tid_map.size() == nk);
+    std::vector<int> owned;
+    for (int k = 0; k < nk; k++)
+        if (tid_map[k] == tid)
+            owned.push_back(k);
+    // dimensions, also on ranks without entries
+    int dims[5] = {INT_MIN, INT_MIN, INT_MIN, INT_MIN, INT_MIN};
+    if (owned.size() > 0) {
+        herm_matrix<T> &G0 = G[owned[0]];
+        dims[0] = G0.nt();
+        dims[1] = G0.ntau();
+        dims[2] = G0.sig();
+        dims[3] = G0.size1();
+        dims[4] = G0.size2();
+    }
+    MPI_Allreduce(MPI_IN_PLACE, dims, 5, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    int nt = dims[0], ntau = dims[1], size1 = dims[3], size2 = dims[4];
+    hdf5_mpi_layout L;
+    L.int_names.push_back("nk");
+    L.int_values.push_back(nk);
+    L.int_names.push_back("nt");
+    L.int_values.push_back(nt);
+    L.int_names.push_back("ntau");
+    L.int_values.push_back(ntau);
+    L.int_names.push_back("sig");
+    L.int_values.push_back(dims[2]);
+    L.int_names.push_back("size1");
+    L.int_values.push_back(size1);
+    L.int_names.push_back("size2");
+    L.int_values.push_back(size2);
+    L.int_names.push_back("element_size");
+    L.int_values.push_back(size1 * size2);
+    L.nblocks = nk;
+    L.size1 = size1;
+    L.size2 = size2;
+    std::vector<std::vector<std::complex<T> *> > ptr;
+    if (nt > -2) {
+        L.datasets.push_back("mat");
+        L.rows.push_back(ntau + 1);
+        ptr.push_back(std::vector<std::complex<T> *>());
+        for (size_t i = 0; i < owned.size(); i++)
+            ptr.back().push_back(G[owned[i]].matptr(0));
+    }
+    if (nt > -1) {
+        L.datasets.push_back("ret");
+        L.rows.push_back(((nt + 1) * (nt + 2)) / 2);
+        L.datasets.push_back("les");
+        L.rows.push_back(((nt + 1) * (nt + 2)) / 2);
+        L.datasets.push_back("tv");
+        L.rows.push_back((nt + 1) * (ntau + 1));
+        ptr.resize(4);
+        for (size_t i = 0; i < owned.size(); i++) {
+            ptr[1].push_back(G[owned[i]].retptr(0, 0));
+            ptr[2].push_back(G[owned[i]].lesptr(0, 0));
+            ptr[3].push_back(G[owned[i]].tvptr(0, 0));
+        }
+    }
+    for (size_t i = 0; i < owned.size(); i++) {
+        herm_matrix<T> &Gk = G[owned[i]];
+        assert(Gk.nt() == nt && Gk.ntau() == ntau && Gk.sig() == dims[2]);
+        assert(Gk.size1() == size1 && Gk.size2() == size2);
+    }
+    hdf5_mpi_write_blocks(filename, groupname, L, owned, ptr);
+}
+/** \brief <b> Reads a collection of `herm_matrix` objects from a shared HDF5 file, in parallel. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Collective over `MPI_COMM_WORLD`: reads a group written by `write_to_hdf5_mpi`.
+ * > Each rank resizes and reads the entries `G[k]` with `tid_map[k]` equal to its rank;
+ * > the other entries are not changed.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [const char*] The name of the HDF5 file.
+ * @param groupname
+ * > [const char*] The name of the HDF5 group.
+ * @param G
+ * > [std::vector<herm_matrix<T>>] The collection, resized to the stored number of entries.
+ * @param tid_map
+ * > [std::vector<int>] Owner of each entry.
+ */
+template <typename T>
+void read_from_hdf5_mpi(const char *filename, const char *groupname,
+                        std::vector<herm_matrix<T> > &G, const std::vector<int> &tid_map) {
+    int tid;
+    MPI_Comm_rank(MPI_COMM_WORLD, &tid);
+    hid_t file_id = hdf5_mpi_open_read(filename);
+    hid_t group_id = open_group(file_id, std::string(groupname));
+    int nk = read_primitive_type<int>(group_id, "nk");
+    int nt = read_primitive_type<int>(group_id, "nt");
+    int ntau = read_primitive_type<int>(group_id, "ntau");
+    int sig = read_primitive_type<int>(group_id, "sig");
+    int size1 = read_primitive_type<int>(group_id, "size1");
+    int size2 = read_primitive_type<int>(group_id, "size2");
+    assert((int)tid_map.size() == nk);
+    G.resize(nk);
+    std::vector<int> owned;
+    for (int k = 0; k < nk; k++) {
+        if (tid_map[k] == tid) {
+            owned.push_back(k);
+            if (G[k].nt() != nt || G[k].ntau() != ntau || G[k].size1() != size1 ||
+                G[k].size2() != size2)
+                G[k] = herm_matrix<T>(nt, ntau, size1, size2, sig);
+            G[k].set_sig(sig);
+        }
+    }
+    std::vector<std::string> datasets;
+    std::vector<std::vector<std::complex<T> *> > ptr;
+    if (nt > -2) {
+        datasets.push_back("mat");
+        ptr.push_back(std::vector<std::complex<T> *>());
+        for (size_t i = 0; i < owned.size(); i++)
+            ptr.back().push_back(G[owned[i]].matptr(0));
+    }
+    if (nt > -1) {
+        datasets.push_back("ret");
+        datasets.push_back("les");
+        datasets.push_back("tv");
+        ptr.resize(4);
+        for (size_t i = 0; i < owned.size(); i++) {
+            ptr[1].push_back(G[owned[i]].retptr(0, 0));
+            ptr[2].push_back(G[owned[i]].lesptr(0, 0));
+            ptr[3].push_back(G[owned[i]].tvptr(0, 0));
+        }
+    }
+    hdf5_mpi_read_blocks(group_id, datasets, owned, ptr);
+    close_group(group_id);
+    close_hdf5_file(file_id);
+}
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5 && CNTR_USE_MPI
+
+#endif  // CNTR_HDF5_MPI_IMPL_H
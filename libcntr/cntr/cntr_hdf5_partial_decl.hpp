@@ -0,0 +1,49 @@
+#ifndef CNTR_HDF5_PARTIAL_DECL_H
+#define CNTR_HDF5_PARTIAL_DECL_H
+
+#include "cntr_global_settings.hpp"
+
+#if CNTR_USE_HDF5 == 1
+
+namespace cntr {
+
+template <typename T> class herm_matrix;
+template <typename T> class herm_matrix_timestep;
+
+/* /////////////////////////////////////////////////////////////////////////////
+// Partial reads of a herm_matrix stored by herm_matrix::write_to_hdf5 (or by
+// hdf5_timestep_writer): only the requested timestep, component or orbital
+// element is read from the packed triangular datasets, via HDF5 hyperslabs.
+///////////////////////////////////////////////////////////////////////////// */
+template <typename T>
+void read_timestep_from_hdf5(int tstp, herm_matrix_timestep<T> &G, hid_t group_id);
+template <typename T>
+void read_timestep_from_hdf5(int tstp, herm_matrix_timestep<T> &G, hid_t group_id,
+                             const char *groupname);
+template <typename T>
+void read_timestep_from_hdf5(int tstp, herm_matrix_timestep<T> &G, const char *filename,
+                             const char *groupname);
+
+template <typename T>
+void read_component_from_hdf5(const char *component, herm_matrix<T> &G, hid_t group_id);
+template <typename T>
+void read_component_from_hdf5(const char *component, herm_matrix<T> &G, hid_t group_id,
+                              const char *groupname);
+template <typename T>
+void read_component_from_hdf5(const char *component, herm_matrix<T> &G,
+                              const char *filename, const char *groupname);
+
+template <typename T>
+void read_element_from_hdf5(int i1, int i2, herm_matrix<T> &G, hid_t group_id);
+template <typename T>
+void read_element_from_hdf5(int i1, int i2, herm_matrix<T> &G, hid_t group_id,
+                            const char *groupname);
+template <typename T>
+void read_element_from_hdf5(int i1, int i2, herm_matrix<T> &G, const char *filename,
+                            const char *groupname);
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
+
+#endif  // CNTR_HDF5_PARTIAL_DECL_H
@@ -0,0 +1,31 @@
+#include "cntr_hdf5_partial_extern_templates.hpp"
+#include "cntr_herm_matrix_impl.hpp"
+#include "cntr_herm_matrix_timestep_impl.hpp"
+#include "cntr_hdf5_partial_impl.hpp"
+
+#if CNTR_USE_HDF5 == 1
+
+namespace cntr {
+
+  template void read_timestep_from_hdf5<double>(int tstp, herm_matrix_timestep<double> &G,
+    hid_t group_id);
+  template void read_timestep_from_hdf5<double>(int tstp, herm_matrix_timestep<double> &G,
+    hid_t group_id, const char *groupname);
+  template void read_timestep_from_hdf5<double>(int tstp, herm_matrix_timestep<double> &G,
+    const char *filename, const char *groupname);
+  template void read_component_from_hdf5<double>(const char *component,
+    herm_matrix<double> &G, hid_t group_id);
+  template void read_component_from_hdf5<double>(const char *component,
+    herm_matrix<double> &G, hid_t group_id, const char *groupname);
+  template void read_component_from_hdf5<double>(const char *component,
+    herm_matrix<double> &G, const char *filename, const char *groupname);
+  template void read_element_from_hdf5<double>(int i1, int i2, herm_matrix<double> &G,
+    hid_t group_id);
+  template void read_element_from_hdf5<double>(int i1, int i2, herm_matrix<double> &G,
+    hid_t group_id, const char *groupname);
+  template void read_element_from_hdf5<double>(int i1, int i2, herm_matrix<double> &G,
+    const char *filename, const char *groupname);
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
@@ -0,0 +1,33 @@
+#ifndef CNTR_HDF5_PARTIAL_EXTERN_TEMPLATES_H
+#define CNTR_HDF5_PARTIAL_EXTERN_TEMPLATES_H
+
+#include "cntr_hdf5_partial_decl.hpp"
+
+#if CNTR_USE_HDF5 == 1
+
+namespace cntr {
+
+  extern template void read_timestep_from_hdf5<double>(int tstp, herm_matrix_timestep<double> &G,
+    hid_t group_id);
+  extern template void read_timestep_from_hdf5<double>(int tstp, herm_matrix_timestep<double> &G,
+    hid_t group_id, const char *groupname);
+  extern template void read_timestep_from_hdf5<double>(int tstp, herm_matrix_timestep<double> &G,
+    const char *filename, const char *groupname);
+  extern template void read_component_from_hdf5<double>(const char *component,
+    herm_matrix<double> &G, hid_t group_id);
+  extern template void read_component_from_hdf5<double>(const char *component,
+    herm_matrix<double> &G, hid_t group_id, const char *groupname);
+  extern template void read_component_from_hdf5<double>(const char *component,
+    herm_matrix<double> &G, const char *filename, const char *groupname);
+  extern template void read_element_from_hdf5<double>(int i1, int i2, herm_matrix<double> &G,
+    hid_t group_id);
+  extern template void read_element_from_hdf5<double>(int i1, int i2, herm_matrix<double> &G,
+    hid_t group_id, const char *groupname);
+  extern template void read_element_from_hdf5<double>(int i1, int i2, herm_matrix<double> &G,
+    const char *filename, const char *groupname);
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
+
+#endif  // CNTR_HDF5_PARTIAL_EXTERN_TEMPLATES_H
@@ -0,0 +1,334 @@
+#ifndef CNTR_HDF5_PARTIAL_IMPL_H
+#define CNTR_HDF5_PARTIAL_IMPL_H
+
+#include "cntr_hdf5_partial_decl.hpp"
+#include "cntr_herm_matrix_decl.hpp"
+#include "cntr_herm_matrix_timestep_decl.hpp"
+
+#if CNTR_USE_HDF5 == 1
+
+namespace cntr {
+
+/// @private
+// Reads one component (mat, ret, les or tv) of all timesteps into G, which has the
+// dimensions of the stored object; only the element (i1,i2) if i1 >= 0 (then G.size1()==1)
+template <typename T>
+void hdf5_partial_read_component(hid_t group_id, const std::string &component,
+                                 herm_matrix<T> &G, int i1, int i2) {
+    int nt = G.nt(), ntau = G.ntau();
+    if (component == "mat") {
+        read_cplx_rows_from_hid(group_id, component, 0, ntau + 1, G.matptr(0), i1, i2);
+    } else if (component == "ret" || component == "les") {
+        assert(nt > -1 && "no real-time components stored");
+        read_cplx_rows_from_hid(group_id, component, 0, (hsize_t)(nt + 1) * (nt + 2) / 2,
+                                (component == "ret" ? G.retptr(0, 0) : G.lesptr(0, 0)),
+                                i1, i2);
+    } else if (component == "tv") {
+        assert(nt > -1 && "no real-time components stored");
+        read_cplx_rows_from_hid(group_id, component, 0, (hsize_t)(nt + 1) * (ntau + 1), G.tvptr(0, 0),
+                                i1, i2);
+    } else {
+        assert(0 && "component must be mat, ret, les or tv");
+    }
+}
+
+/** \brief <b> Reads a single time step of a `herm_matrix` from a given HDF5 group handle. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Reads the time step `tstp` of a `herm_matrix` stored by `write_to_hdf5` into a
+ * > `herm_matrix_timestep`, without reading the rest of the file: the retarded row
+ * > \f$ G^\mathrm{R}(t,t_j) \f$, the lesser column \f$ G^<(t_j,t) \f$ and the left-mixing row
+ * > \f$ G^\rceil(t,\tau_k) \f$ are contiguous in the packed triangular datasets and are read
+ * > as hyperslabs. For `tstp=-1` the Matsubara component is read.
+ * > `G` is resized to the stored dimensions if necessary.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] The time step to read, -1 <= tstp <= nt of the stored `herm_matrix`.
+ * @param G
+ * > [herm_matrix_timestep] On return, the time step `tstp`.
+ * @param group_id
+ * > [hid_t] The HDF5 group handle under which the `herm_matrix` is stored.
+ */
+template <typename T>
+void read_timestep_from_hdf5(int tstp, herm_matrix_timestep<T> &G, hid_t group_id) {
+    int nt = read_primitive_type<int>(group_id, "nt");
+    int ntau = read_primitive_type<int>(group_id, "ntau");
+    int sig = read_primitive_type<int>(group_id, "sig");
+    int size1 = read_primitive_type<int>(group_id, "size1");
+    assert(tstp >= -1 && tstp <= nt && "tstp >= -1 && tstp <= nt");
+    if (G.tstp() != tstp || G.ntau() != ntau || G.size1() != size1 || G.sig() != sig)
+        G = herm_matrix_timestep<T>(tstp, ntau, size1, sig);
+    if (tstp == -1) {
+        read_cplx_rows_from_hid(group_id, "mat", 0, ntau + 1, G.matptr(0));
+    } else {
+        hsize_t row = (hsize_t)tstp * (tstp + 1) / 2;
+        read_cplx_rows_from_hid(group_id, "ret", row, tstp + 1, G.retptr(0));
+        read_cplx_rows_from_hid(group_id, "les", row, tstp + 1, G.lesptr(0));
+        read_cplx_rows_from_hid(group_id, "tv", (hsize_t) tstp * (ntau + 1), ntau + 1,
+                                G.tvptr(0));
+    }
+}
+/** \brief <b> Reads a single time step of a `herm_matrix` from a given HDF5 group handle and group name. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Reads the time step `tstp` of a `herm_matrix` stored by `write_to_hdf5` into a
+ * > `herm_matrix_timestep`, reading only the corresponding hyperslabs.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] The time step to read.
+ * @param G
+ * > [herm_matrix_timestep] On return, the time step `tstp`.
+ * @param group_id
+ * > [hid_t] The HDF5 group handle.
+ * @param groupname
+ * > [char*] The name of the HDF5 group of the `herm_matrix`.
+ */
+template <typename T>
+void read_timestep_from_hdf5(int tstp, herm_matrix_timestep<T> &G, hid_t group_id,
+                             const char *groupname) {
+    hid_t sub_group_id = open_group(group_id, groupname);
+    read_timestep_from_hdf5(tstp, G, sub_group_id);
+    close_group(sub_group_id);
+}
+/** \brief <b> Reads a single time step of a `herm_matrix` from a given HDF5 file. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Reads the time step `tstp` of a `herm_matrix` stored by `write_to_hdf5` into a
+ * > `herm_matrix_timestep`, reading only the corresponding hyperslabs.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] The time step to read.
+ * @param G
+ * > [herm_matrix_timestep] On return, the time step `tstp`.
+ * @param filename
+ * > [char*] The name of the HDF5 file.
+ * @param groupname
+ * > [char*] The name of the HDF5 group of the `herm_matrix`.
+ */
+template <typename T>
+void read_timestep_from_hdf5(int tstp, herm_matrix_timestep<T> &G, const char *filename,
+                             const char *groupname) {
+    hid_t file_id = read_hdf5_file(filename);
+    read_timestep_from_hdf5(tstp, G, file_id, groupname);
+    close_hdf5_file(file_id);
+}
+
+/** \brief <b> Reads a single component of a `herm_matrix` from a given HDF5 group handle. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Reads only one of the components `mat`, `ret`, `les` or `tv` of a `herm_matrix`
+ * > stored by `write_to_hdf5`. If `G` has the stored dimensions, the other components
+ * > of `G` are left unchanged; otherwise `G` is resized first.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param component
+ * > [char*] The component to read: "mat", "ret", "les" or "tv".
+ * @param G
+ * > [herm_matrix] The `herm_matrix` into which the component is read.
+ * @param group_id
+ * > [hid_t] The HDF5 group handle under which the `herm_matrix` is stored.
+ */
+template <typename T>
+void read_component_from_hdf5(const char *component, herm_matrix<T> &G, hid_t group_id) {
+    int nt = read_primitive_type<int>(group_id, "nt");
+    int ntau = read_primitive_type<int>(group_id, "ntau");
+    int sig = read_primitive_type<int>(group_id, "sig");
+    int size1 = read_primitive_type<int>(group_id, "size1");
+    if (G.nt() != nt || G.ntau() != ntau || G.size1() != size1)
+        G.resize(nt, ntau, size1);
+    G.set_sig(sig);
+    hdf5_partial_read_component(group_id, component, G, -1, -1);
+}
+/** \brief <b> Reads a single component of a `herm_matrix` from a given HDF5 group handle and group name. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Reads only one of the components `mat`, `ret`, `les` or `tv` of a `herm_matrix`
+ * > stored by `write_to_hdf5`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param component
+ * > [char*] The component to read: "mat", "ret", "les" or "tv".
+ * @param G
+ * > [herm_matrix] The `herm_matrix` into which the component is read.
+ * @param group_id
+ * > [hid_t] The HDF5 group handle.
+ * @param groupname
+ * > [char*] The name of the HDF5 group of the `herm_matrix`.
+ */
+template <typename T>
+void read_component_from_hdf5(const char *component, herm_matrix<T> &G, hid_t group_id,
+                              const char *groupname) {
+    hid_t sub_group_id = open_group(group_id, groupname);
+    read_component_from_hdf5(component, G, sub_group_id);
+    close_group(sub_group_id);
+}
+/** \brief <b> Reads a single component of a `herm_matrix` from a given HDF5 file. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Reads only one of the components `mat`, `ret`, `les` or `tv` of a `herm_matrix`
+ * > stored by `write_to_hdf5`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param component
+ * > [char*] The component to read: "mat", "ret", "les" or "tv".
+ * @param G
+ * > [herm_matrix] The `herm_matrix` into which the component is read.
+ * @param filename
+ * > [char*] The name of the HDF5 file.
+ * @param groupname
+ * > [char*] The name of the HDF5 group of the `herm_matrix`.
+ */
+template <typename T>
+void read_component_from_hdf5(const char *component, herm_matrix<T> &G,
+                              const char *filename, const char *groupname) {
+    hid_t file_id = read_hdf5_file(filename);
+    read_component_from_hdf5(component, G, file_id, groupname);
+    close_hdf5_file(file_id);
+}
+
+/** \brief <b> Reads a single matrix element of a `herm_matrix` from a given HDF5 group handle. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Reads the orbital element \f$ (i_1,i_2) \f$ of all components of a `herm_matrix`
+ * > stored by `write_to_hdf5` into a scalar `herm_matrix`, selecting a strided
+ * > hyperslab of each dataset. `G` is resized to `size1=1` and the stored `nt`, `ntau`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param i1
+ * > [int] Row index of the element.
+ * @param i2
+ * > [int] Column index of the element.
+ * @param G
+ * > [herm_matrix] On return, the scalar `herm_matrix` of the element.
+ * @param group_id
+ * > [hid_t] The HDF5 group handle under which the `herm_matrix` is stored.
+ */
+template <typename T>
+void read_element_from_hdf5(int i1, int i2, herm_matrix<T> &G, hid_t group_id) {
+    int nt = read_primitive_type<int>(group_id, "nt");
+    int ntau = read_primitive_type<int>(group_id, "ntau");
+    int sig = read_primitive_type<int>(group_id, "sig");
+    assert(i1 >= 0 && i2 >= 0 && "i1 >= 0 && i2 >= 0");
+    if (G.nt() != nt || G.ntau() != ntau || G.size1() != 1)
+        G.resize(nt, ntau, 1);
+    G.set_sig(sig);
+    hdf5_partial_read_component(group_id, "mat", G, i1, i2);
+    if (nt > -1) {
+        hdf5_partial_read_component(group_id, "ret", G, i1, i2);
+        hdf5_partial_read_component(group_id, "les", G, i1, i2);
+        hdf5_partial_read_component(group_id, "tv", G, i1, i2);
+    }
+}
+/** \brief <b> Reads a single matrix element of a `herm_matrix` from a given HDF5 group handle and group name. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Reads the orbital element \f$ (i_1,i_2) \f$ of all components of a `herm_matrix`
+ * > stored by `write_to_hdf5` into a scalar `herm_matrix`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param i1
+ * > [int] Row index of the element.
+ * @param i2
+ * > [int] Column index of the element.
+ * @param G
+ * > [herm_matrix] On return, the scalar `herm_matrix` of the element.
+ * @param group_id
+ * > [hid_t] The HDF5 group handle.
+ * @param groupname
+ * > [char*] The name of the HDF5 group of the `herm_matrix`.
+ */
+template <typename T>
+void read_element_from_hdf5(int i1, int i2, herm_matrix<T> &G, hid_t group_id,
+                            const char *groupname) {
+    hid_t sub_group_id = open_group(group_id, groupname);
+    read_element_from_hdf5(i1, i2, G, sub_group_id);
+    close_group(sub_group_id);
+}
+/** \brief <b> Reads a single matrix element of a `herm_matrix` from a given HDF5 file. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Reads the orbital element \f$ (i_1,i_2) \f$ of all components of a `herm_matrix`
+ * > stored by `write_to_hdf5` into a scalar `herm_matrix`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param i1
+ * > [int] Row index of the element.
+ * @param i2
+ * > [int] Column index of the element.
+ * @param G
+ * > [herm_matrix] On return, the scalar `herm_matrix` of the element.
+ * @param filename
+ * > [char*] The name of the HDF5 file.
+ * @param groupname
+ * > [char*] The name of the HDF5 group of the `herm_matrix`.
+ */
+template <typename T>
+void read_element_from_hdf5(int i1, int i2, herm_matrix<T> &G, const char *filename,
+                            const char *groupname) {
+    hid_t file_id = read_hdf5_file(filename);
+    read_element_from_hdf5(i1, i2, G, file_id, groupname);
+    close_hdf5_file(file_id);
+}
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
+
+#endif  // CNTR_HDF5_PARTIAL_IMPL_H
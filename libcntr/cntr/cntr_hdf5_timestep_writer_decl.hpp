@@ -0,0 +1,82 @@
+#ifndef CNTR_HDF5_TIMESTEP_WRITER_DECL_H
+#define CNTR_HDF5_TIMESTEP_WRITER_DECL_H
+
+#include "cntr_global_settings.hpp"
+
+#if CNTR_USE_HDF5 == 1
+
+namespace cntr {
+
+template <typename T> class function;
+template <typename T> class herm_matrix;
+
+/** \brief <b> Streaming HDF5 output of `herm_matrix` and `function` objects, one timestep at a time. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > The file is opened once, and every registered object gets a group with the same
+ * > layout as written by `write_to_hdf5`. The datasets `ret`, `les`, `tv` (and `data` for
+ * > a `function`) are created with an unlimited, chunked first axis, and `write_timestep(tstp)`
+ * > appends the data that become final at `tstp`: the retarded row \f$ C^\mathrm{R}(t,t_j) \f$,
+ * > the lesser column \f$ C^<(t_j,t) \f$ and the left-mixing row \f$ C^\rceil(t,\tau_k) \f$,
+ * > \f$ j\leq t \f$. Since these are exactly the contiguous blocks of the triangular storage,
+ * > the file can be read with `read_from_hdf5` at any point: the dataset `nt` holds the last
+ * > completed timestep and is updated (and the file flushed) after each call.
+ * > Timesteps must be written in order, starting with `tstp=-1` (Matsubara).
+ * > Chunking and filters follow the current `hdf5_storage_policy`.
+ * >
+ * > The writer keeps pointers to the registered objects; they must stay alive until
+ * > the last call of `write_timestep`.
+ */
+template <typename T>
+class hdf5_timestep_writer {
+  public:
+    /* construction, destruction */
+    hdf5_timestep_writer();
+    explicit hdf5_timestep_writer(const char *filename);
+    ~hdf5_timestep_writer();
+    void open(const char *filename);
+    void close(void);
+    bool is_open(void) const { return file_id_ >= 0; }
+    /** \brief Last timestep written (-2: none) */
+    int tstp(void) const { return tstp_; }
+    hid_t file_id(void) const { return file_id_; }
+    // registration, before the first write_timestep
+    void add(const char *groupname, herm_matrix<T> &G);
+    void add(const char *groupname, function<T> &f);
+    void write_timestep(int tstp);
+    // write_timestep in two steps: copy the data of tstp to a buffer, write the buffer
+    size_t timestep_size(int tstp) const;
+    void pack_timestep(int tstp, std::complex<T> *buf) const;
+    void write_packed_timestep(int tstp, std::complex<T> *buf);
+
+  private:
+    /// @private
+    hdf5_timestep_writer(const hdf5_timestep_writer &w);
+    /// @private
+    hdf5_timestep_writer &operator=(const hdf5_timestep_writer &w);
+    /// @private
+    struct entry {
+        herm_matrix<T> *G;   /*!< Registered herm_matrix, or 0 */
+        function<T> *f;      /*!< Registered function, or 0 */
+        hid_t group_id;      /*!< Group holding the object */
+        hid_t ret_id;        /*!< Extendible dataset `ret` (`data` for a function) */
+        hid_t les_id;        /*!< Extendible dataset `les` */
+        hid_t tv_id;         /*!< Extendible dataset `tv` */
+    };
+    /// @private
+    void write_entry(entry &e, int tstp, std::complex<T> *ret, std::complex<T> *les,
+                     std::complex<T> *tv);
+    hid_t file_id_;                /*!< File handle, -1 if closed */
+    int tstp_;                     /*!< Last timestep written */
+    std::vector<entry> entries_;   /*!< Registered objects */
+};
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
+
+#endif  // CNTR_HDF5_TIMESTEP_WRITER_DECL_H
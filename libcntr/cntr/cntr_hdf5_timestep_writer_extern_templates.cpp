@@ -0,0 +1,14 @@
+#include "cntr_hdf5_timestep_writer_extern_templates.hpp"
+#include "cntr_function_impl.hpp"
+#include "cntr_herm_matrix_impl.hpp"
+#include "cntr_hdf5_timestep_writer_impl.hpp"
+
+#if CNTR_USE_HDF5 == 1
+
+namespace cntr {
+
+  template class hdf5_timestep_writer<double>;
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
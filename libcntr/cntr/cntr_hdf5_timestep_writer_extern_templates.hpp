@@ -0,0 +1,16 @@
+#ifndef CNTR_HDF5_TIMESTEP_WRITER_EXTERN_TEMPLATES_H
+#define CNTR_HDF5_TIMESTEP_WRITER_EXTERN_TEMPLATES_H
+
+#include "cntr_hdf5_timestep_writer_decl.hpp"
+
+#if CNTR_USE_HDF5 == 1
+
+namespace cntr {
+
+  extern template class hdf5_timestep_writer<double>;
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
+
+#endif  // CNTR_HDF5_TIMESTEP_WRITER_EXTERN_TEMPLATES_H
@@ -0,0 +1,362 @@
+#ifndef CNTR_HDF5_TIMESTEP_WRITER_IMPL_H
+#define CNTR_HDF5_TIMESTEP_WRITER_IMPL_H
+
+#include "cntr_hdf5_timestep_writer_decl.hpp"
+#include "cntr_function_decl.hpp"
+#include "cntr_herm_matrix_decl.hpp"
+
+#if CNTR_USE_HDF5 == 1
+
+namespace cntr {
+
+template <typename T>
+hdf5_timestep_writer<T>::hdf5_timestep_writer() {
+    file_id_ = -1;
+    tstp_ = -2;
+}
+/** \brief <b> Initializes the `hdf5_timestep_writer` and opens the file. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Opens (and truncates) the HDF5 file `filename` for streaming output.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [const char*] The name of the HDF5 file.
+ */
+template <typename T>
+hdf5_timestep_writer<T>::hdf5_timestep_writer(const char *filename) {
+    file_id_ = -1;
+    tstp_ = -2;
+    open(filename);
+}
+template <typename T>
+hdf5_timestep_writer<T>::~hdf5_timestep_writer() {
+    close();
+}
+/** \brief <b> Opens (and truncates) an HDF5 file for streaming output. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Closes a previously opened file and opens `filename`. All objects have to be
+ * > registered again with `add`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [const char*] The name of the HDF5 file.
+ */
+template <typename T>
+void hdf5_timestep_writer<T>::open(const char *filename) {
+    close();
+    file_id_ = open_hdf5_file(std::string(filename));
+    assert(file_id_ >= 0);
+    tstp_ = -2;
+}
+/** \brief <b> Closes all datasets, groups and the file. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Closes all datasets, groups and the file. The data written so far remain
+ * > readable with `read_from_hdf5`. Does nothing if no file is open.
+ */
+template <typename T>
+void hdf5_timestep_writer<T>::close(void) {
+    if (file_id_ < 0)
+        return;
+    for (size_t i = 0; i < entries_.size(); i++) {
+        entry &e = entries_[i];
+        if (e.ret_id >= 0)
+            H5Dclose(e.ret_id);
+        if (e.les_id >= 0)
+            H5Dclose(e.les_id);
+        if (e.tv_id >= 0)
+            H5Dclose(e.tv_id);
+        close_group(e.group_id);
+    }
+    entries_.clear();
+    close_hdf5_file(file_id_);
+    file_id_ = -1;
+    tstp_ = -2;
+}
+/** \brief <b> Registers a `herm_matrix` for streaming output. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Creates the group `groupname` with the dimensions of `G` and empty, extendible
+ * > datasets `ret`, `les` and `tv`. Must be called before the first `write_timestep`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param groupname
+ * > [const char*] The name of the HDF5 group.
+ * @param G
+ * > [herm_matrix<T>] The contour function; referenced until the last `write_timestep`.
+ */
+template <typename T>
+void hdf5_timestep_writer<T>::add(const char *groupname, herm_matrix<T> &G) {
+    assert(file_id_ >= 0);
+    assert(tstp_ == -2);
+    entry e;
+    e.G = &G;
+    e.f = 0;
+    e.group_id = create_group(file_id_, std::string(groupname));
+    store_int_attribute_to_hid(e.group_id, std::string("ntau"), G.ntau());
+    store_int_attribute_to_hid(e.group_id, std::string("nt"), -2);
+    store_int_attribute_to_hid(e.group_id, std::string("sig"), G.sig());
+    store_int_attribute_to_hid(e.group_id, std::string("size1"), G.size1());
+    store_int_attribute_to_hid(e.group_id, std::string("size2"), G.size2());
+    store_int_attribute_to_hid(e.group_id, std::string("element_size"),
+                               G.element_size());
+    hsize_t len_shape = 3, shape[3];
+    shape[0] = 0;
+    shape[1] = G.size1();
+    shape[2] = G.size2();
+    e.ret_id = create_extendible_cplx_array(e.group_id, std::string("ret"),
+                                            shape, len_shape, G.nt() + 1);
+    e.les_id = create_extendible_cplx_array(e.group_id, std::string("les"),
+                                            shape, len_shape, G.nt() + 1);
+    e.tv_id = create_extendible_cplx_array(e.group_id, std::string("tv"),
+                                           shape, len_shape, G.ntau() + 1);
+    entries_.push_back(e);
+}
+/** \brief <b> Registers a `function` for streaming output. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Creates the group `groupname` with the dimensions of `f` and an empty, extendible
+ * > dataset `data`. Must be called before the first `write_timestep`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param groupname
+ * > [const char*] The name of the HDF5 group.
+ * @param f
+ * > [function<T>] The function; referenced until the last `write_timestep`.
+ */
+template <typename T>
+void hdf5_timestep_writer<T>::add(const char *groupname, function<T> &f) {
+    assert(file_id_ >= 0);
+    assert(tstp_ == -2);
+    entry e;
+    e.G = 0;
+    e.f = &f;
+    e.group_id = create_group(file_id_, std::string(groupname));
+    store_int_attribute_to_hid(e.group_id, std::string("nt"), -2);
+    store_int_attribute_to_hid(e.group_id, std::string("size1"), f.size1());
+    store_int_attribute_to_hid(e.group_id, std::string("size2"), f.size2());
+    store_int_attribute_to_hid(e.group_id, std::string("element_size"),
+                               f.element_size());
+    hsize_t len_shape = 3, shape[3];
+    shape[0] = 0;
+    shape[1] = f.size1();
+    shape[2] = f.size2();
+    e.ret_id = create_extendible_cplx_array(e.group_id, std::string("data"),
+                                            shape, len_shape, 1);
+    e.les_id = -1;
+    e.tv_id = -1;
+    entries_.push_back(e);
+}
+/// @private
+template <typename T>
+void hdf5_timestep_writer<T>::write_entry(entry &e, int tstp, std::complex<T> *ret,
+                                          std::complex<T> *les, std::complex<T> *tv) {
+    if (e.G != 0) {
+        herm_matrix<T> &G = *e.G;
+        if (tstp == -1) {
+            hsize_t len_shape = 3, shape[3];
+            shape[0] = G.ntau() + 1;
+            shape[1] = G.size1();
+            shape[2] = G.size2();
+            store_cplx_array_to_hid(e.group_id, std::string("mat"), ret, shape,
+                                    len_shape);
+        } else {
+            append_cplx_array_to_hid(e.ret_id, ret, tstp + 1);
+            append_cplx_array_to_hid(e.les_id, les, tstp + 1);
+            append_cplx_array_to_hid(e.tv_id, tv, G.ntau() + 1);
+        }
+    } else {
+        append_cplx_array_to_hid(e.ret_id, ret, 1);
+    }
+    update_int_attribute_in_hid(e.group_id, std::string("nt"), tstp);
+}
+/** \brief <b> Appends timestep `tstp` of all registered objects to the file. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > For `tstp=-1`, the Matsubara component is written. For `tstp>=0`, the retarded row,
+ * > the lesser column and the left-mixing row at `tstp` are appended
+ * > (for a `function`: the value at `tstp`). Afterwards, `nt` is set to `tstp` in every
+ * > group and the file is flushed, so that the file is consistent after each call.
+ * > Timesteps must be written consecutively, starting with `tstp=-1`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] The timestep; must be the last timestep written plus one.
+ */
+template <typename T>
+void hdf5_timestep_writer<T>::write_timestep(int tstp) {
+    assert(file_id_ >= 0);
+    assert(tstp == tstp_ + 1);
+    for (size_t i = 0; i < entries_.size(); i++) {
+        entry &e = entries_[i];
+        if (e.G != 0) {
+            herm_matrix<T> &G = *e.G;
+            assert(tstp <= G.nt());
+            if (tstp == -1)
+                write_entry(e, tstp, G.matptr(0), 0, 0);
+            else
+                write_entry(e, tstp, G.retptr(tstp, 0), G.lesptr(0, tstp),
+                            G.tvptr(tstp, 0));
+        } else {
+            assert(tstp <= e.f->nt());
+            write_entry(e, tstp, e.f->ptr(tstp), 0, 0);
+        }
+    }
+    H5Fflush(file_id_, H5F_SCOPE_GLOBAL);
+    tstp_ = tstp;
+}
+/** \brief <b> Number of complex numbers written by `write_timestep(tstp)`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Returns the size of the buffer for `pack_timestep`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] The timestep.
+ */
+template <typename T>
+size_t hdf5_timestep_writer<T>::timestep_size(int tstp) const {
+    size_t len = 0;
+    for (size_t i = 0; i < entries_.size(); i++) {
+        const entry &e = entries_[i];
+        if (e.G != 0) {
+            if (tstp == -1)
+                len += (e.G->ntau() + 1) * e.G->element_size();
+            else
+                len += (2 * (tstp + 1) + e.G->ntau() + 1) * e.G->element_size();
+        } else {
+            len += e.f->element_size();
+        }
+    }
+    return len;
+}
+/** \brief <b> Copies the data written at timestep `tstp` to a buffer. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Copies the data of all registered objects that `write_timestep(tstp)` would write
+ * > to `buf`, for a later `write_packed_timestep(tstp,buf)`. Does not access the file,
+ * > so it can be called while another thread writes previous timesteps.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] The timestep.
+ * @param buf
+ * > [complex<T>*] The buffer, of size `timestep_size(tstp)`.
+ */
+template <typename T>
+void hdf5_timestep_writer<T>::pack_timestep(int tstp, std::complex<T> *buf) const {
+    for (size_t i = 0; i < entries_.size(); i++) {
+        const entry &e = entries_[i];
+        if (e.G != 0) {
+            const herm_matrix<T> &G = *e.G;
+            int es = G.element_size();
+            assert(tstp <= G.nt());
+            if (tstp == -1) {
+                buf = std::copy(G.matptr(0), G.matptr(0) + (G.ntau() + 1) * es, buf);
+            } else {
+                buf = std::copy(G.retptr(tstp, 0), G.retptr(tstp, 0) + (tstp + 1) * es, buf);
+                buf = std::copy(G.lesptr(0, tstp), G.lesptr(0, tstp) + (tstp + 1) * es, buf);
+                buf = std::copy(G.tvptr(tstp, 0), G.tvptr(tstp, 0) + (G.ntau() + 1) * es, buf);
+            }
+        } else {
+            assert(tstp <= e.f->nt());
+            buf = std::copy(e.f->ptr(tstp), e.f->ptr(tstp) + e.f->element_size(), buf);
+        }
+    }
+}
+/** \brief <b> Appends timestep `tstp` from a buffer filled by `pack_timestep`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Same as `write_timestep(tstp)`, but the data are taken from `buf`; the registered
+ * > objects are not accessed.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] The timestep; must be the last timestep written plus one.
+ * @param buf
+ * > [complex<T>*] The buffer filled by `pack_timestep(tstp,buf)`.
+ */
+template <typename T>
+void hdf5_timestep_writer<T>::write_packed_timestep(int tstp, std::complex<T> *buf) {
+    assert(file_id_ >= 0);
+    assert(tstp == tstp_ + 1);
+    for (size_t i = 0; i < entries_.size(); i++) {
+        entry &e = entries_[i];
+        if (e.G != 0) {
+            int es = e.G->element_size();
+            if (tstp == -1) {
+                write_entry(e, tstp, buf, 0, 0);
+                buf += (e.G->ntau() + 1) * es;
+            } else {
+                write_entry(e, tstp, buf, buf + (tstp + 1) * es,
+                            buf + 2 * (tstp + 1) * es);
+                buf += (2 * (tstp + 1) + e.G->ntau() + 1) * es;
+            }
+        } else {
+            write_entry(e, tstp, buf, 0, 0);
+            buf += e.f->element_size();
+        }
+    }
+    H5Fflush(file_id_, H5F_SCOPE_GLOBAL);
+    tstp_ = tstp;
+}
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
+
+#endif  // CNTR_HDF5_TIMESTEP_WRITER_IMPL_H
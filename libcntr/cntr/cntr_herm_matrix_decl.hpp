@@ -258,6 +258,7 @@ class herm_matrix {
 #if CNTR_USE_MPI == 1
     void Reduce_timestep(int tstp, int root);
     void Bcast_timestep(int tstp, int root);
+    void Bcast_timestep(int tstp, int root, int wire);
     void Send_timestep(int tstp, int dest, int tag);
     void Recv_timestep(int tstp, int root, int tag);
 #endif
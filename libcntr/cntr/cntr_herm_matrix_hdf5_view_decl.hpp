@@ -0,0 +1,151 @@
+#ifndef CNTR_HERM_MATRIX_HDF5_VIEW_DECL_H
+#define CNTR_HERM_MATRIX_HDF5_VIEW_DECL_H
+
+#include "cntr_global_settings.hpp"
+#include <list>
+#include <map>
+
+#if CNTR_USE_HDF5 == 1
+
+namespace cntr {
+
+template <typename T> class herm_matrix;
+template <typename T> class herm_matrix_timestep_view;
+
+// default number of time steps per cached chunk
+#define CNTR_HDF5_VIEW_CHUNK_TSTP 8
+// default capacity (bytes) of the chunk cache
+#define CNTR_HDF5_VIEW_CACHE_BYTES (1 << 28)
+// chunks that are never evicted to make room, whatever their size
+#define CNTR_HDF5_VIEW_MIN_CHUNKS 4
+
+/** \brief <b> Read-only access to a `herm_matrix` stored in an HDF5 file, loaded on demand. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Gives the read accessors of `herm_matrix` (`get_les`, `get_ret`, `get_gtr`, `get_tv`,
+ * > `get_mat`, `density_matrix`, ...) for a `herm_matrix` stored by `write_to_hdf5`,
+ * > without reading the complete object: a component is read in chunks of
+ * > `chunk_tstp` consecutive time steps (the Matsubara component in one chunk), which
+ * > are contiguous hyperslabs of the packed datasets. Chunks are kept in a
+ * > least-recently-used cache of at most `cache_bytes` bytes.
+ * >
+ * > A `herm_matrix_timestep_view` can be constructed on a time step of the view, so that
+ * > routines taking a generic contour object, such as `Bubble1`/`Bubble2` and
+ * > `distance_norm2`, run directly on the stored data. Pointers into the cache
+ * > (`retptr`, `lesptr`, `tvptr`, `matptr`, and views built from them) remain valid as
+ * > long as at most CNTR_HDF5_VIEW_MIN_CHUNKS-1 other chunks are loaded.
+ * > The class is not thread-safe. Only T=double is supported by the HDF5 interface.
+ */
+/// !! NOTE: MIND DANGLING POINTERS
+template <typename T>
+class herm_matrix_hdf5_view {
+  public:
+    typedef std::complex<T> cplx;
+    typedef T scalar_type;
+    /* construction, destruction */
+    herm_matrix_hdf5_view();
+    herm_matrix_hdf5_view(const char *filename, const char *groupname,
+                          int chunk_tstp = CNTR_HDF5_VIEW_CHUNK_TSTP,
+                          size_t cache_bytes = CNTR_HDF5_VIEW_CACHE_BYTES);
+    herm_matrix_hdf5_view(hid_t group_id, int chunk_tstp = CNTR_HDF5_VIEW_CHUNK_TSTP,
+                          size_t cache_bytes = CNTR_HDF5_VIEW_CACHE_BYTES);
+    ~herm_matrix_hdf5_view();
+    void open(const char *filename, const char *groupname,
+              int chunk_tstp = CNTR_HDF5_VIEW_CHUNK_TSTP,
+              size_t cache_bytes = CNTR_HDF5_VIEW_CACHE_BYTES);
+    void open(hid_t group_id, int chunk_tstp = CNTR_HDF5_VIEW_CHUNK_TSTP,
+              size_t cache_bytes = CNTR_HDF5_VIEW_CACHE_BYTES);
+    void close(void);
+    bool is_open(void) const { return group_id_ >= 0; }
+    /* dimensions */
+    int element_size(void) const { return element_size_; }
+    int size1(void) const { return size1_; }
+    int size2(void) const { return size2_; }
+    int ntau(void) const { return ntau_; }
+    int nt(void) const { return nt_; }
+    int sig(void) const { return sig_; }
+    /* cache */
+    void clear_cache(void);
+    /** \brief Bytes currently held in the cache (at most the `cache_bytes` capacity) */
+    size_t cache_used_bytes(void) const { return cache_size_; }
+    size_t chunk_reads(void) const { return reads_; }
+    /* raw pointers to the cached data, same layout as in herm_matrix */
+    /// @private
+    cplx *retptr(int i, int j);
+    /// @private
+    cplx *lesptr(int i, int j);
+    /// @private
+    cplx *tvptr(int i, int j);
+    /// @private
+    cplx *matptr(int i);
+    /* read individual time-matrix elements */
+    template <class Matrix> void get_les(int i, int j, Matrix &M);
+    template <class Matrix> void get_gtr(int i, int j, Matrix &M);
+    template <class Matrix> void get_ret(int i, int j, Matrix &M);
+    template <class Matrix> void get_tv(int i, int j, Matrix &M);
+    template <class Matrix> void get_vt(int i, int j, Matrix &M);
+    template <class Matrix> void get_mat(int i, Matrix &M);
+    template <class Matrix> void get_matminus(int i, Matrix &M);
+    inline void get_les(int i, int j, cplx &x);
+    inline void get_gtr(int i, int j, cplx &x);
+    inline void get_ret(int i, int j, cplx &x);
+    inline void get_tv(int i, int j, cplx &x);
+    inline void get_vt(int i, int j, cplx &x);
+    inline void get_mat(int i, cplx &x);
+    inline void get_matminus(int i, cplx &x);
+    cplx density_matrix(int tstp);
+    template <class Matrix> void density_matrix(int tstp, Matrix &M);
+    /* copies */
+    void get_timestep(int tstp, herm_matrix_timestep_view<T> &G);
+    void get_data(herm_matrix<T> &G);
+
+  private:
+    /// @private
+    herm_matrix_hdf5_view(const herm_matrix_hdf5_view &g);
+    /// @private
+    herm_matrix_hdf5_view &operator=(const herm_matrix_hdf5_view &g);
+    /// @private
+    cplx *chunk(int component, int tstp, hsize_t row);
+    /// @private
+    void read_header(void);
+    /// @private
+    typedef std::pair<int, int> chunk_key;  /*!< (component, chunk index) */
+    /// @private
+    struct chunk_entry {
+        std::vector<cplx> data;
+        hsize_t first_row;
+        typename std::list<chunk_key>::iterator lru;
+    };
+    int nt_;
+    int ntau_;
+    int size1_;
+    int size2_;
+    int element_size_;
+    int sig_;
+    hid_t file_id_;           /*!< File handle if opened by filename, else -1 */
+    hid_t group_id_;          /*!< Group of the stored herm_matrix, -1 if closed */
+    bool own_group_;          /*!< Whether group_id_ is closed by close() */
+    int chunk_tstp_;          /*!< Time steps per chunk */
+    size_t max_bytes_;        /*!< Capacity of the cache in bytes */
+    size_t cache_size_;       /*!< Bytes currently cached */
+    size_t reads_;            /*!< Number of chunks read from the file */
+    std::map<chunk_key, chunk_entry> cache_;
+    std::list<chunk_key> lru_;  /*!< Most recently used chunk first */
+};
+
+template <typename T>
+T distance_norm2(int tstp, herm_matrix_hdf5_view<T> &g1, herm_matrix<T> &g2);
+template <typename T>
+T distance_norm2(int tstp, herm_matrix<T> &g1, herm_matrix_hdf5_view<T> &g2);
+template <typename T>
+T distance_norm2(int tstp, herm_matrix_hdf5_view<T> &g1, herm_matrix_hdf5_view<T> &g2);
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
+
+#endif  // CNTR_HERM_MATRIX_HDF5_VIEW_DECL_H
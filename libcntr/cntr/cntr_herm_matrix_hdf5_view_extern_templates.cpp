@@ -0,0 +1,21 @@
+#include "cntr_herm_matrix_hdf5_view_extern_templates.hpp"
+#include "cntr_herm_matrix_impl.hpp"
+#include "cntr_herm_matrix_timestep_view_impl.hpp"
+#include "cntr_utilities_impl.hpp"
+#include "cntr_herm_matrix_hdf5_view_impl.hpp"
+
+#if CNTR_USE_HDF5 == 1
+
+namespace cntr {
+
+  template class herm_matrix_hdf5_view<double>;
+  template double distance_norm2<double>(int tstp, herm_matrix_hdf5_view<double> &g1,
+    herm_matrix<double> &g2);
+  template double distance_norm2<double>(int tstp, herm_matrix<double> &g1,
+    herm_matrix_hdf5_view<double> &g2);
+  template double distance_norm2<double>(int tstp, herm_matrix_hdf5_view<double> &g1,
+    herm_matrix_hdf5_view<double> &g2);
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
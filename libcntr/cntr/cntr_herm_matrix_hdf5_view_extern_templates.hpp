@@ -0,0 +1,22 @@
+#ifndef CNTR_HERM_MATRIX_HDF5_VIEW_EXTERN_TEMPLATES_H
+#define CNTR_HERM_MATRIX_HDF5_VIEW_EXTERN_TEMPLATES_H
+
+#include "cntr_herm_matrix_hdf5_view_decl.hpp"
+
+#if CNTR_USE_HDF5 == 1
+
+namespace cntr {
+
+  extern template class herm_matrix_hdf5_view<double>;
+  extern template double distance_norm2<double>(int tstp, herm_matrix_hdf5_view<double> &g1,
+    herm_matrix<double> &g2);
+  extern template double distance_norm2<double>(int tstp, herm_matrix<double> &g1,
+    herm_matrix_hdf5_view<double> &g2);
+  extern template double distance_norm2<double>(int tstp, herm_matrix_hdf5_view<double> &g1,
+    herm_matrix_hdf5_view<double> &g2);
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
+
+#endif  // CNTR_HERM_MATRIX_HDF5_VIEW_EXTERN_TEMPLATES_H
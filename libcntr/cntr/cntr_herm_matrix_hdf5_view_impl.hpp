@@ -0,0 +1,554 @@
+#ifndef CNTR_HERM_MATRIX_HDF5_VIEW_IMPL_H
+#define CNTR_HERM_MATRIX_HDF5_VIEW_IMPL_H
+
+#include "cntr_herm_matrix_hdf5_view_decl.hpp"
+#include "cntr_herm_matrix_decl.hpp"
+#include "cntr_herm_matrix_timestep_view_decl.hpp"
+#include "cntr_utilities_decl.hpp"
+
+#if CNTR_USE_HDF5 == 1
+
+namespace cntr {
+
+// components, in the order of the snapshot files
+#define CNTR_HDF5_VIEW_MAT 0
+#define CNTR_HDF5_VIEW_RET 1
+#define CNTR_HDF5_VIEW_LES 2
+#define CNTR_HDF5_VIEW_TV 3
+
+/* #######################################################################################
+#
+#   CONSTRUCTION/DESTRUCTION
+#
+########################################################################################*/
+template <typename T>
+herm_matrix_hdf5_view<T>::herm_matrix_hdf5_view() {
+    nt_ = -2;
+    ntau_ = 0;
+    size1_ = 0;
+    size2_ = 0;
+    element_size_ = 0;
+    sig_ = -1;
+    file_id_ = -1;
+    group_id_ = -1;
+    own_group_ = false;
+    chunk_tstp_ = CNTR_HDF5_VIEW_CHUNK_TSTP;
+    max_bytes_ = CNTR_HDF5_VIEW_CACHE_BYTES;
+    cache_size_ = 0;
+    reads_ = 0;
+}
+/** \brief <b> Opens a `herm_matrix` stored in an HDF5 file for reading on demand. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Opens the file and the group of a `herm_matrix` stored by `write_to_hdf5`, and reads
+ * > its dimensions. No component data is read until it is accessed.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [char*] The name of the HDF5 file.
+ * @param groupname
+ * > [char*] The name of the HDF5 group of the `herm_matrix`.
+ * @param chunk_tstp
+ * > [int] Number of time steps read at once for the real-time components.
+ * @param cache_bytes
+ * > [size_t] Capacity of the chunk cache in bytes.
+ */
+template <typename T>
+herm_matrix_hdf5_view<T>::herm_matrix_hdf5_view(const char *filename, const char *groupname,
+                                                int chunk_tstp, size_t cache_bytes) {
+    file_id_ = -1;
+    group_id_ = -1;
+    own_group_ = false;
+    cache_size_ = 0;
+    reads_ = 0;
+    open(filename, groupname, chunk_tstp, cache_bytes);
+}
+/** \brief <b> Opens a `herm_matrix` stored under a given HDF5 group handle for reading on demand. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > As above, for an open group handle, which must remain open while the view is used
+ * > and is not closed by the view.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param group_id
+ * > [hid_t] The HDF5 group handle under which the `herm_matrix` is stored.
+ * @param chunk_tstp
+ * > [int] Number of time steps read at once for the real-time components.
+ * @param cache_bytes
+ * > [size_t] Capacity of the chunk cache in bytes.
+ */
+template <typename T>
+herm_matrix_hdf5_view<T>::herm_matrix_hdf5_view(hid_t group_id, int chunk_tstp,
+                                                size_t cache_bytes) {
+    file_id_ = -1;
+    group_id_ = -1;
+    own_group_ = false;
+    cache_size_ = 0;
+    reads_ = 0;
+    open(group_id, chunk_tstp, cache_bytes);
+}
+template <typename T>
+herm_matrix_hdf5_view<T>::~herm_matrix_hdf5_view() {
+    close();
+}
+/// @private
+template <typename T>
+void herm_matrix_hdf5_view<T>::open(const char *filename, const char *groupname,
+                                    int chunk_tstp, size_t cache_bytes) {
+    close();
+    file_id_ = read_hdf5_file(filename);
+    group_id_ = open_group(file_id_, groupname);
+    own_group_ = true;
+    chunk_tstp_ = chunk_tstp;
+    max_bytes_ = cache_bytes;
+    read_header();
+}
+/// @private
+template <typename T>
+void herm_matrix_hdf5_view<T>::open(hid_t group_id, int chunk_tstp, size_t cache_bytes) {
+    close();
+    group_id_ = group_id;
+    own_group_ = false;
+    chunk_tstp_ = chunk_tstp;
+    max_bytes_ = cache_bytes;
+    read_header();
+}
+/// @private
+template <typename T>
+void herm_matrix_hdf5_view<T>::read_header(void) {
+    assert(chunk_tstp_ >= 1);
+    nt_ = read_primitive_type<int>(group_id_, "nt");
+    ntau_ = read_primitive_type<int>(group_id_, "ntau");
+    sig_ = read_primitive_type<int>(group_id_, "sig");
+    size1_ = read_primitive_type<int>(group_id_, "size1");
+    size2_ = read_primitive_type<int>(group_id_, "size2");
+    element_size_ = size1_ * size2_;
+    reads_ = 0;
+}
+/// @private
+template <typename T>
+void herm_matrix_hdf5_view<T>::close(void) {
+    clear_cache();
+    if (own_group_ && group_id_ >= 0)
+        close_group(group_id_);
+    if (file_id_ >= 0)
+        close_hdf5_file(file_id_);
+    file_id_ = -1;
+    group_id_ = -1;
+    own_group_ = false;
+    nt_ = -2;
+}
+/// @private
+template <typename T>
+void herm_matrix_hdf5_view<T>::clear_cache(void) {
+    cache_.clear();
+    lru_.clear();
+    cache_size_ = 0;
+}
+
+/* #######################################################################################
+#
+#   CHUNK CACHE
+#
+########################################################################################*/
+/// @private
+// Returns a pointer to row `row` of the dataset of `component`, which belongs to time
+// step tstp; the chunk containing tstp is read if it is not cached.
+template <typename T>
+std::complex<T> *herm_matrix_hdf5_view<T>::chunk(int component, int tstp, hsize_t row) {
+    assert(group_id_ >= 0 && "herm_matrix_hdf5_view is not open");
+    chunk_key key(component, (component == CNTR_HDF5_VIEW_MAT ? 0 : tstp / chunk_tstp_));
+    typename std::map<chunk_key, chunk_entry>::iterator it = cache_.find(key);
+    if (it != cache_.end()) {
+        // move to the front of the LRU list
+        lru_.splice(lru_.begin(), lru_, it->second.lru);
+        return it->second.data.data() + (row - it->second.first_row) * element_size_;
+    }
+    hsize_t first, rows;
+    if (component == CNTR_HDF5_VIEW_MAT) {
+        first = 0;
+        rows = ntau_ + 1;
+    } else {
+        hsize_t t0 = key.second * chunk_tstp_;
+        hsize_t t1 = std::min<hsize_t>(nt_, t0 + chunk_tstp_ - 1);
+        if (component == CNTR_HDF5_VIEW_TV) {
+            first = t0 * (ntau_ + 1);
+            rows = (t1 - t0 + 1) * (ntau_ + 1);
+        } else {
+            first = (t0 * (t0 + 1)) / 2;
+            rows = ((t1 + 1) * (t1 + 2)) / 2 - first;
+        }
+    }
+    static const char *names[4] = {"mat", "ret", "les", "tv"};
+    chunk_entry &e = cache_[key];
+    e.data.resize(rows * element_size_);
+    e.first_row = first;
+    read_cplx_rows_from_hid(group_id_, names[component], first, rows, e.data.data());
+    reads_++;
+    lru_.push_front(key);
+    e.lru = lru_.begin();
+    cache_size_ += rows * element_size_ * sizeof(cplx);
+    // evict least recently used chunks, never the most recent ones
+    while (cache_size_ > max_bytes_ && lru_.size() > CNTR_HDF5_VIEW_MIN_CHUNKS) {
+        typename std::map<chunk_key, chunk_entry>::iterator old = cache_.find(lru_.back());
+        cache_size_ -= old->second.data.size() * sizeof(cplx);
+        cache_.erase(old);
+        lru_.pop_back();
+    }
+    return e.data.data() + (row - first) * element_size_;
+}
+/// @private
+template <typename T>
+std::complex<T> *herm_matrix_hdf5_view<T>::retptr(int i, int j) {
+    assert(0 <= j && j <= i && i <= nt_);
+    return chunk(CNTR_HDF5_VIEW_RET, i, (hsize_t)i * (i + 1) / 2 + j);
+}
+/// @private
+template <typename T>
+std::complex<T> *herm_matrix_hdf5_view<T>::lesptr(int i, int j) {
+    assert(0 <= i && i <= j && j <= nt_);
+    return chunk(CNTR_HDF5_VIEW_LES, j, (hsize_t)j * (j + 1) / 2 + i);
+}
+/// @private
+template <typename T>
+std::complex<T> *herm_matrix_hdf5_view<T>::tvptr(int i, int j) {
+    assert(0 <= i && i <= nt_ && 0 <= j && j <= ntau_);
+    return chunk(CNTR_HDF5_VIEW_TV, i, (hsize_t)i * (ntau_ + 1) + j);
+}
+/// @private
+template <typename T>
+std::complex<T> *herm_matrix_hdf5_view<T>::matptr(int i) {
+    assert(0 <= i && i <= ntau_ && nt_ >= -1);
+    return chunk(CNTR_HDF5_VIEW_MAT, -1, i);
+}
+
+/* #######################################################################################
+#
+#   READING ELEMENTS TO ANY MATRIX TYPE
+#   OR TO COMPLEX NUMBERS (then only the (0,0) element is addressed for dim>0)
+#
+########################################################################################*/
+#define herm_matrix_hdf5_view_READ_ELEMENT                                   \
+    {                                                                        \
+        int r, s;                                                            \
+        M.resize(size1_, size2_);                                            \
+        for (r = 0; r < size1_; r++)                                         \
+            for (s = 0; s < size2_; s++)                                     \
+                M(r, s) = x[r * size2_ + s];                                 \
+    }
+#define herm_matrix_hdf5_view_READ_ELEMENT_MINUS_CONJ                        \
+    {                                                                        \
+        cplx w;                                                              \
+        int r, s, dim = size1_;                                              \
+        M.resize(dim, dim);                                                  \
+        for (r = 0; r < dim; r++)                                            \
+            for (s = 0; s < dim; s++) {                                      \
+                w = x[s * dim + r];                                          \
+                M(r, s) = std::complex<T>(-w.real(), w.imag());              \
+            }                                                                \
+    }
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_hdf5_view<T>::get_les(int i, int j, Matrix &M) {
+    cplx *x;
+    if (i <= j) {
+        x = lesptr(i, j);
+        herm_matrix_hdf5_view_READ_ELEMENT
+    } else {
+        x = lesptr(j, i);
+        herm_matrix_hdf5_view_READ_ELEMENT_MINUS_CONJ
+    }
+}
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_hdf5_view<T>::get_ret(int i, int j, Matrix &M) {
+    cplx *x;
+    if (i >= j) {
+        x = retptr(i, j);
+        herm_matrix_hdf5_view_READ_ELEMENT
+    } else {
+        x = retptr(j, i);
+        herm_matrix_hdf5_view_READ_ELEMENT_MINUS_CONJ
+    }
+}
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_hdf5_view<T>::get_gtr(int i, int j, Matrix &M) {
+    Matrix M1;
+    get_ret(i, j, M);
+    get_les(i, j, M1);
+    M += M1;
+}
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_hdf5_view<T>::get_tv(int i, int j, Matrix &M) {
+    cplx *x = tvptr(i, j);
+    herm_matrix_hdf5_view_READ_ELEMENT
+}
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_hdf5_view<T>::get_vt(int i, int j, Matrix &M) {
+    assert(i <= ntau_);
+    cplx *x = tvptr(j, ntau_ - i);
+    herm_matrix_hdf5_view_READ_ELEMENT_MINUS_CONJ
+    if (sig_ == -1)
+        M = -M;
+}
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_hdf5_view<T>::get_mat(int i, Matrix &M) {
+    cplx *x = matptr(i);
+    herm_matrix_hdf5_view_READ_ELEMENT
+}
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_hdf5_view<T>::get_matminus(int i, Matrix &M) {
+    assert(i <= ntau_);
+    cplx *x = matptr(ntau_ - i);
+    herm_matrix_hdf5_view_READ_ELEMENT
+    if (sig_ == -1)
+        M = -M;
+}
+#undef herm_matrix_hdf5_view_READ_ELEMENT
+#undef herm_matrix_hdf5_view_READ_ELEMENT_MINUS_CONJ
+
+/// @private
+template <typename T>
+inline void herm_matrix_hdf5_view<T>::get_les(int i, int j, cplx &x) {
+    if (i <= j)
+        x = *lesptr(i, j);
+    else
+        x = -std::conj(*lesptr(j, i));
+}
+/// @private
+template <typename T>
+inline void herm_matrix_hdf5_view<T>::get_ret(int i, int j, cplx &x) {
+    if (i >= j)
+        x = *retptr(i, j);
+    else
+        x = -std::conj(*retptr(j, i));
+}
+/// @private
+template <typename T>
+inline void herm_matrix_hdf5_view<T>::get_gtr(int i, int j, cplx &x) {
+    cplx x1;
+    get_ret(i, j, x);
+    get_les(i, j, x1);
+    x += x1;
+}
+/// @private
+template <typename T>
+inline void herm_matrix_hdf5_view<T>::get_tv(int i, int j, cplx &x) {
+    x = *tvptr(i, j);
+}
+/// @private
+template <typename T>
+inline void herm_matrix_hdf5_view<T>::get_vt(int i, int j, cplx &x) {
+    x = *tvptr(j, ntau_ - i);
+    if (sig_ == -1)
+        x = std::conj(x);
+    else
+        x = -std::conj(x);
+}
+/// @private
+template <typename T>
+inline void herm_matrix_hdf5_view<T>::get_mat(int i, cplx &x) {
+    x = *matptr(i);
+}
+/// @private
+template <typename T>
+inline void herm_matrix_hdf5_view<T>::get_matminus(int i, cplx &x) {
+    x = *matptr(ntau_ - i);
+    if (sig_ == -1)
+        x = -x;
+}
+/** \brief <b> Returns the density matrix at given time step (scalar case). </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Returns \f$ \rho = i \eta C^<(t,t) \f$, or \f$ -C^\mathrm{M}(\beta) \f$ for
+ * > `tstp=-1`, reading only the chunk which contains it.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] The time step, -1 <= tstp <= nt.
+ */
+template <typename T>
+std::complex<T> herm_matrix_hdf5_view<T>::density_matrix(int tstp) {
+    assert(tstp >= -1 && tstp <= nt_);
+    cplx x1;
+    if (tstp == -1) {
+        get_mat(ntau_, x1);
+        return -x1;
+    } else {
+        get_les(tstp, tstp, x1);
+        return std::complex<T>(0.0, sig_) * x1;
+    }
+}
+/** \brief <b> Returns the density matrix at given time step. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Returns \f$ \rho = i \eta C^<(t,t) \f$, or \f$ -C^\mathrm{M}(\beta) \f$ for
+ * > `tstp=-1`, reading only the chunk which contains it.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] The time step, -1 <= tstp <= nt.
+ * @param M
+ * > [Matrix] On return, the density matrix.
+ */
+template <typename T>
+template <class Matrix>
+void herm_matrix_hdf5_view<T>::density_matrix(int tstp, Matrix &M) {
+    assert(tstp >= -1 && tstp <= nt_);
+    if (tstp == -1) {
+        get_mat(ntau_, M);
+        M *= (-1.0);
+    } else {
+        get_les(tstp, tstp, M);
+        M *= std::complex<T>(0.0, 1.0 * sig_);
+    }
+}
+
+/* #######################################################################################
+#
+#   TIME STEPS AND COPIES
+#
+########################################################################################*/
+/** \brief <b> Points a `herm_matrix_timestep_view` to a time step in the cache. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Loads the chunks containing time step `tstp` and sets `G` to the cached data,
+ * > without copying. The view is valid while its chunks stay in the cache
+ * > (see the class description). Equivalent to
+ * > `G = herm_matrix_timestep_view<T>(tstp, *this)`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] The time step, -1 <= tstp <= nt.
+ * @param G
+ * > [herm_matrix_timestep_view] On return, a view of time step `tstp`.
+ */
+template <typename T>
+void herm_matrix_hdf5_view<T>::get_timestep(int tstp, herm_matrix_timestep_view<T> &G) {
+    G = herm_matrix_timestep_view<T>(tstp, *this);
+}
+/** \brief <b> Reads the complete stored `herm_matrix`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Copies all components into `G`, which is resized if necessary. The data is read
+ * > directly from the file, bypassing (and not filling) the cache.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix] On return, the stored `herm_matrix`.
+ */
+template <typename T>
+void herm_matrix_hdf5_view<T>::get_data(herm_matrix<T> &G) {
+    assert(group_id_ >= 0 && "herm_matrix_hdf5_view is not open");
+    if (G.nt() != nt_ || G.ntau() != ntau_ || G.size1() != size1_)
+        G.resize(nt_, ntau_, size1_);
+    G.set_sig(sig_);
+    if (nt_ > -2)
+        read_cplx_rows_from_hid(group_id_, "mat", 0, ntau_ + 1, G.matptr(0));
+    if (nt_ > -1) {
+        hsize_t rows = ((nt_ + 1) * (nt_ + 2)) / 2;
+        read_cplx_rows_from_hid(group_id_, "ret", 0, rows, G.retptr(0, 0));
+        read_cplx_rows_from_hid(group_id_, "les", 0, rows, G.lesptr(0, 0));
+        read_cplx_rows_from_hid(group_id_, "tv", 0, (hsize_t)(nt_ + 1) * (ntau_ + 1),
+                                G.tvptr(0, 0));
+    }
+}
+
+#undef CNTR_HDF5_VIEW_MAT
+#undef CNTR_HDF5_VIEW_RET
+#undef CNTR_HDF5_VIEW_LES
+#undef CNTR_HDF5_VIEW_TV
+
+/** \brief <b> Distance between a stored `herm_matrix` and a `herm_matrix` at a given time step. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > As `distance_norm2(tstp, g1, g2)` for two `herm_matrix`, where `g1` is read on demand
+ * > from an HDF5 file.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] The time step.
+ * @param g1
+ * > [herm_matrix_hdf5_view] The stored contour object.
+ * @param g2
+ * > [herm_matrix] The contour object to compare with.
+ */
+template <typename T>
+T distance_norm2(int tstp, herm_matrix_hdf5_view<T> &g1, herm_matrix<T> &g2) {
+    assert(g1.nt() >= tstp);
+    herm_matrix_timestep_view<T> g1_view(tstp, g1);
+    return distance_norm2(tstp, g1_view, g2);
+}
+/// @private
+template <typename T>
+T distance_norm2(int tstp, herm_matrix<T> &g1, herm_matrix_hdf5_view<T> &g2) {
+    return distance_norm2(tstp, g2, g1);
+}
+/// @private
+template <typename T>
+T distance_norm2(int tstp, herm_matrix_hdf5_view<T> &g1, herm_matrix_hdf5_view<T> &g2) {
+    assert(g1.nt() >= tstp && g2.nt() >= tstp);
+    herm_matrix_timestep_view<T> g1_view(tstp, g1);
+    herm_matrix_timestep_view<T> g2_view(tstp, g2);
+    return distance_norm2(tstp, g1_view, g2_view);
+}
+
+}  // namespace cntr
+
+#endif  // CNTR_USE_HDF5
+
+#endif  // CNTR_HERM_MATRIX_HDF5_VIEW_IMPL_H
@@ -7,6 +7,7 @@
 #include "cntr_function_decl.hpp"
 #include "cntr_herm_matrix_timestep_decl.hpp"
 #include "cntr_herm_matrix_timestep_view_impl.hpp"
+#include "cntr_tavtrel_decl.hpp"
 
 namespace cntr {
 
@@ -1588,12 +1589,12 @@ void herm_matrix<T>::write_to_hdf5(hid_t group_id) {
         shape[0] = ((nt_ + 1) * (nt_ + 2)) / 2;
         // CHECK: implement store_cplx_array_to_hid with template typename T
         store_cplx_array_to_hid(group_id, std::string("ret"), retptr(0, 0),
-                                shape, len_shape);
+                                shape, len_shape, nt_ + 1);
         store_cplx_array_to_hid(group_id, std::string("les"), lesptr(0, 0),
-                                shape, len_shape);
+                                shape, len_shape, nt_ + 1);
         shape[0] = (nt_ + 1) * (ntau_ + 1);
         store_cplx_array_to_hid(group_id, std::string("tv"), tvptr(0, 0),
-                                shape, len_shape);
+                                shape, len_shape, ntau_ + 1);
     }
 }
 /** \brief <b> Stores `herm_matrix` to a given group in HDF5 format. </b>
@@ -1860,6 +1861,7 @@ void herm_matrix<T>::write_to_hdf5_slices(hid_t group_id, int dt) {
             std::sprintf(groupname, "t%d", tstp);
             subgroup_id = create_group(group_id, std::string(groupname));
             tmp.write_to_hdf5(subgroup_id);
+            close_group(subgroup_id);
         }
     }
 }
@@ -1937,47 +1939,7 @@ void herm_matrix<T>::write_to_hdf5_slices(const char *filename,
  */
 template <typename T>
 void herm_matrix<T>::write_to_hdf5_tavtrel(hid_t group_id, int dt) {
-  assert(dt >= 1);
-
-    typedef std::complex<double> complex;
-    char name[100];
-    if (nt_ < 0)
-        return;
-    complex *ggtr = new complex[(nt_ + 1) * element_size_]; // temp storage
-    complex *gles = new complex[(nt_ + 1) * element_size_]; // temp storage
-    store_int_attribute_to_hid(group_id, std::string("nt"), nt_);
-    store_int_attribute_to_hid(group_id, std::string("size1"), size1_);
-    store_int_attribute_to_hid(group_id, std::string("size2"), size2_);
-    store_int_attribute_to_hid(group_id, std::string("element_size"),
-                               element_size_);
-    hid_t group_id_les = create_group(group_id, std::string("les"));
-    hid_t group_id_gtr = create_group(group_id, std::string("gtr"));
-    hsize_t len_shape = 3, shape[3];
-    shape[1] = size1_;
-    shape[2] = size2_;
-    for (int tav = 0; tav <= nt_; tav += dt) {
-        int len = (tav <= nt_ - tav ? tav : nt_ - tav);
-        std::sprintf(name, "%d", tav);
-        shape[0] = len + 1;
-        // read data: trel2 is trel/2
-        for (int trel2 = 0; trel2 <= len; trel2++) {
-            cdmatrix ggtrtt, glestt;
-            this->get_les(tav + trel2, tav - trel2, glestt);
-            this->get_gtr(tav + trel2, tav - trel2, ggtrtt);
-            for (int i = 0; i < element_size_; i++) {
-                gles[trel2 * element_size_ + i] =
-                    glestt(i / size2_, i % size2_);
-                ggtr[trel2 * element_size_ + i] =
-                    ggtrtt(i / size2_, i % size2_);
-            }
-        }
-        store_cplx_array_to_hid(group_id_les, std::string(name), gles, shape,
-                                len_shape);
-        store_cplx_array_to_hid(group_id_gtr, std::string(name), ggtr, shape,
-                                len_shape);
-    }
-    delete[] ggtr;
-    delete[] gles;
+    write_tavtrel_to_hdf5(group_id, *this, dt);
 }
  /** \brief <b> Stores greater and lesser components of `herm_matrix` average-relative time representation to a given HDF5 group handle and group name. </b>
  *
@@ -3488,6 +3450,40 @@ void herm_matrix<T>::Bcast_timestep(int tstp, int root) {
         this->set_timestep(tstp, Gtemp);
 }
 
+/** \brief <b> Broadcasts the `herm_matrix` at a given time step to all tasks using a given wire format. </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* Broadcasts the `herm_matrix` at a given time step `tstp` to all tasks. For
+* `wire = CNTR_WIRE_FLOAT`, the data is sent in single precision, which halves the
+* communicated data; see `herm_matrix_timestep::Bcast_timestep`.
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > Time step which should be broadcasted.
+* @param root
+* > The task rank from which the `herm_matrix` should be broadcasted.
+* @param wire
+* > The wire format (`CNTR_WIRE_EXACT` or `CNTR_WIRE_FLOAT`)
+*/
+
+template <typename T>
+void herm_matrix<T>::Bcast_timestep(int tstp, int root, int wire) {
+    int taskid;
+    herm_matrix_timestep<T> Gtemp;
+    MPI_Comm_rank(MPI_COMM_WORLD, &taskid);
+    Gtemp.resize(tstp, ntau_, size1_);
+    if (taskid == root)
+        this->get_timestep(tstp, Gtemp);
+    Gtemp.Bcast_timestep(tstp, root, wire);
+    if (taskid != root)
+        this->set_timestep(tstp, Gtemp);
+}
+
 /** \brief <b> Sends the `herm_matrix` at a given time step to a specific task. </b>
 *
 * <!-- ====== DOCUMENTATION ====== -->
@@ -201,6 +201,7 @@ class herm_matrix_timestep {
     // preferred interfaces
     void Reduce_timestep(int tstp, int root);
     void Bcast_timestep(int tstp, int root);
+    void Bcast_timestep(int tstp, int root, int wire);
     void Send_timestep(int tstp, int dest, int tag);
     void Recv_timestep(int tstp, int root, int tag);
 
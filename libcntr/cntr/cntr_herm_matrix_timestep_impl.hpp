@@ -2636,6 +2636,53 @@ void herm_matrix_timestep<T>::Bcast_timestep(int tstp, int root) {
       MPI_Bcast(data_, len, MPI_COMPLEX, root, MPI_COMM_WORLD);
 }
 
+/** \brief <b> Broadcasts the `herm_matrix_timestep` at a given time step to all ranks using a given wire format. </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Broadcasts the `herm_matrix_timestep` at a given time step `tstp` to all ranks.
+* > For `wire = CNTR_WIRE_FLOAT`, double precision data is converted to single precision
+* > before it is sent, which halves the communicated data (the data on `root` is not changed).
+* > For `wire = CNTR_WIRE_EXACT`, this is identical to `Bcast_timestep(tstp, root)`.
+*
+*<!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > Time step which should be broadcasted.
+* @param root
+* > The rank from which the `herm_matrix_timestep` should be broadcasted.
+* @param wire
+* > The wire format (`CNTR_WIRE_EXACT` or `CNTR_WIRE_FLOAT`)
+*/
+template <typename T>
+void herm_matrix_timestep<T>::Bcast_timestep(int tstp, int root, int wire) {
+   assert(wire == CNTR_WIRE_EXACT || wire == CNTR_WIRE_FLOAT);
+   if (wire == CNTR_WIRE_EXACT || sizeof(T) != sizeof(double)) {
+      Bcast_timestep(tstp, root);
+      return;
+   }
+   int taskid;
+   MPI_Comm_rank(MPI_COMM_WORLD, &taskid);
+   if (taskid != root)
+      resize(tstp, ntau_, size1_);
+   assert(tstp == tstp_);
+   int len = (2 * (tstp_ + 1) + ntau_ + 1) * element_size_;
+   std::vector<std::complex<float> > buffer(len);
+   if (taskid == root) {
+      for (int i = 0; i < len; i++)
+         buffer[i] = std::complex<float>(data_[i].real(), data_[i].imag());
+   }
+   MPI_Bcast(buffer.data(), len, MPI_C_FLOAT_COMPLEX, root, MPI_COMM_WORLD);
+   if (taskid != root) {
+      for (int i = 0; i < len; i++)
+         data_[i] = cplx(buffer[i].real(), buffer[i].imag());
+   }
+}
+
 /** \brief <b> Sends the `herm_matrix_timestep` at a given time step to a specific task. </b>
 *
 * <!-- ====== DOCUMENTATION ====== -->
@@ -8,6 +8,9 @@ namespace cntr {
 template <typename T> class herm_matrix_timestep;
 template <typename T> class herm_matrix;
 template <typename T> class function;
+#if CNTR_USE_HDF5 == 1
+template <typename T> class herm_matrix_hdf5_view;
+#endif
 
 template <typename T>
 /** \brief <b> Class `herm_matrix_timestep_view` serves for interfacing with class herm_matrix_timestep</b>
@@ -44,6 +47,9 @@ class herm_matrix_timestep_view {
     herm_matrix_timestep_view(int tstp, int ntau, int size1, int size2, int sig);
     herm_matrix_timestep_view(int tstp, herm_matrix_timestep<T> &g, bool check_assert=true);
     herm_matrix_timestep_view(int tstp, herm_matrix_timestep_view<T> &g);
+#if CNTR_USE_HDF5 == 1
+    herm_matrix_timestep_view(int tstp, herm_matrix_hdf5_view<T> &g);
+#endif
     ///////////////////////////////////////////
     int size1(void) const { return size1_; }
     int size2(void) const { return size2_; }
@@ -2,6 +2,7 @@
 #define CNTR_HERM_TIMESTEP_VIEW_IMPL_H
 
 #include "cntr_herm_matrix_timestep_view_decl.hpp"
+#include "cntr_herm_matrix_hdf5_view_decl.hpp"
 #include "cntr_elements.hpp"
 //#include "cntr_exception.hpp"
 
@@ -325,6 +326,51 @@ herm_matrix_timestep_view<T>::herm_matrix_timestep_view(int tstp,
     }
 }
 
+#if CNTR_USE_HDF5 == 1
+/** \brief <b> Initializes the `herm_matrix_timestep_view` class on a time step of a `herm_matrix_hdf5_view g`.</b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Loads the time step `tstp` of a `herm_matrix` stored in an HDF5 file into the chunk cache
+* > of `g`, and points the view to the cached data. No data is copied; the view becomes
+* > invalid when the chunks are evicted from the cache of `g`.
+*
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > Index of time
+* @param g
+* > The `herm_matrix_hdf5_view` of the stored `herm_matrix`
+*/
+template <typename T>
+herm_matrix_timestep_view<T>::herm_matrix_timestep_view(int tstp,
+                                                        herm_matrix_hdf5_view<T> &g) {
+    assert(tstp >= -1 && tstp <= g.nt());
+    tstp_ = tstp;
+    ntau_ = g.ntau();
+    size1_ = g.size1();
+    size2_ = g.size2();
+    element_size_ = size1_ * size2_;
+    sig_ = g.sig();
+    if (tstp_ == -1) {
+        mat_ = g.matptr(0);
+        ret_ = 0;
+        les_ = 0;
+        tv_ = 0;
+    } else {
+        mat_ = 0;
+        ret_ = g.retptr(tstp_, 0);
+        les_ = g.lesptr(0, tstp_);
+        tv_ = g.tvptr(tstp_, 0);
+    }
+}
+#endif
+
 /* #######################################################################################
 #
 #   WRITING ELEMENTS FROM ANY MATRIX TYPE
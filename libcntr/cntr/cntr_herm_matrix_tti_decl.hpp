@@ -0,0 +1,184 @@
+#ifndef CNTR_HERM_MATRIX_TTI_DECL_H
+#define CNTR_HERM_MATRIX_TTI_DECL_H
+
+#include "cntr_global_settings.hpp"
+#include "integration.hpp"
+#include "cntr_lattice_convolution_decl.hpp"
+
+namespace cntr {
+
+template <typename T> class herm_matrix;
+
+// below this block length, the relaxed convolutions of herm_matrix_tti use direct sums
+#define CNTR_TTI_FFT_MIN 32
+
+/** \brief <b> Class `herm_matrix_tti` for time-translation invariant contour objects
+ * \f$ C(t,t')=C(t-t') \f$ with hermitian symmetry.</b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ *  In equilibrium (or a steady state reached from it), the real-time components depend
+ *  only on the time difference. The class `herm_matrix_tti` stores
+ *   - the Matsubara component \f$ C^\mathrm{M}(\tau_k) \f$, k=0,...,`ntau`,
+ *   - the retarded component \f$ C^\mathrm{R}(t_l,0) \f$, l=0,...,`nt`,
+ *   - the lesser component \f$ C^<(0,t_l) \f$, l=0,...,`nt`,
+ *   - the left-mixing component \f$ C^\rceil(t_i,\tau_k) \f$, i=0,...,`nt`, k=0,...,`ntau`,
+ *
+ *  i.e., \f$ O(nt) \f$ instead of \f$ O(nt^2) \f$ real-time elements. The accessors
+ *  take two time arguments as in `herm_matrix`, so that \f$ C^\mathrm{R}(t_i,t_j) \f$
+ *  is returned as the element \f$ l=i-j \f$. The element layout is that of `herm_matrix`.
+ *
+ *  `get_data` converts to a `herm_matrix`, which can be used as initial state of a
+ *  nonequilibrium calculation; `set_from` takes the last time step of a `herm_matrix`.
+ *  Dyson equation, VIE2 and convolution are solved by `dyson_tti`, `vie2_tti` and
+ *  `convolution_tti`. Only square matrices are supported.
+ */
+template <typename T>
+class herm_matrix_tti {
+  public:
+    typedef std::complex<T> cplx;
+    typedef T scalar_type;
+    /* construction, destruction */
+    herm_matrix_tti();
+    herm_matrix_tti(int nt, int ntau, int size1 = 1, int sig = -1);
+    void resize(int nt, int ntau, int size1);
+    void clear(void);
+    /* access size etc ... */
+    /// @private
+    int element_size(void) const { return element_size_; }
+    int size1(void) const { return size1_; }
+    int size2(void) const { return size2_; }
+    int ntau(void) const { return ntau_; }
+    int nt(void) const { return nt_; }
+    int sig(void) const { return sig_; }
+    void set_sig(int sig) { sig_ = sig; }
+    /* raw pointers to the elements */
+    /// @private
+    inline cplx *retptr(int l);
+    /// @private
+    inline cplx *lesptr(int l);
+    /// @private
+    inline cplx *tvptr(int i, int j);
+    /// @private
+    inline cplx *matptr(int i);
+    /* reading elements at two times, as for herm_matrix */
+    /// @private
+    template <class Matrix> void get_les(int i, int j, Matrix &M);
+    /// @private
+    template <class Matrix> void get_gtr(int i, int j, Matrix &M);
+    /// @private
+    template <class Matrix> void get_ret(int i, int j, Matrix &M);
+    /// @private
+    template <class Matrix> void get_tv(int i, int j, Matrix &M);
+    /// @private
+    template <class Matrix> void get_vt(int i, int j, Matrix &M);
+    /// @private
+    template <class Matrix> void get_mat(int i, Matrix &M);
+    /// @private
+    template <class Matrix> void get_matminus(int i, Matrix &M);
+    /// @private
+    inline void get_les(int i, int j, cplx &x);
+    /// @private
+    inline void get_gtr(int i, int j, cplx &x);
+    /// @private
+    inline void get_ret(int i, int j, cplx &x);
+    /// @private
+    inline void get_tv(int i, int j, cplx &x);
+    /// @private
+    inline void get_vt(int i, int j, cplx &x);
+    /// @private
+    inline void get_mat(int i, cplx &x);
+    /// @private
+    inline void get_matminus(int i, cplx &x);
+    cplx density_matrix(int tstp);
+    template <class Matrix> void density_matrix(int tstp, Matrix &M);
+    /* writing elements, l is the time difference */
+    /// @private
+    template <class Matrix> void set_ret(int l, Matrix &M);
+    /// @private
+    template <class Matrix> void set_les(int l, Matrix &M);
+    /// @private
+    template <class Matrix> void set_tv(int i, int j, Matrix &M);
+    /// @private
+    template <class Matrix> void set_mat(int i, Matrix &M);
+    void set_les_from_tv(void);
+    /* conversion to/from herm_matrix */
+    void set_from(herm_matrix<T> &G);
+    void get_data(herm_matrix<T> &G);
+
+  private:
+    int nt_;
+    int ntau_;
+    int size1_;
+    int size2_;
+    int element_size_;
+    int sig_;
+    std::vector<cplx> mat_;
+    std::vector<cplx> ret_;
+    std::vector<cplx> les_;
+    std::vector<cplx> tv_;
+};
+
+/// @private
+/** \brief <b> Relaxed product \f$ c_t = \sum_{q<t} x_q s_{t-q} \f$ of matrix-valued series.</b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > The series \f$ s_d \f$, d=0,...,`nmax`, is known in advance, the series \f$ x_q \f$ is
+ * > passed one index at a time by `push(q,...)`. Once \f$ x_0,\dots,x_{t-1}\f$ are pushed,
+ * > `acc(t)` is complete, so \f$ x_t \f$ can depend on it, as in a time-stepping solver.
+ * > Each \f$ x_q \f$ consists of `nch` matrices (e.g. the \f$\tau\f$ points of a left-mixing
+ * > component), which are multiplied with the same \f$ s_d \f$ from the left
+ * > (`sleft=true`) or the right. An aligned block of \f$ L \f$ pushed elements is multiplied
+ * > with \f$ s_d, L\le d<2L \f$ as soon as it is complete, using an FFT of length \f$ 2L \f$
+ * > for \f$ L\ge \f$ CNTR_TTI_FFT_MIN; this gives \f$ O(N\log^2 N) \f$ operations in total.
+ */
+template <typename T>
+class tti_relaxed_product {
+  public:
+    typedef std::complex<T> cplx;
+    tti_relaxed_product(int size1, int nch, int nmax, cplx *s, bool sleft);
+    void push(int q, cplx *x, int chstride);
+    cplx *acc(int t) { return &acc_[(size_t)t * nch_ * es_]; }
+    cplx *x(int q) { return &x_[(size_t)q * nch_ * es_]; }
+    cplx *s(int d) { return &s_[(size_t)d * es_]; }
+    void add_gregory_correction(int t, int qmax, integration::Integrator<T> &I, cplx *res);
+
+  private:
+    void block_direct(int q0, int len);
+    void block_fft(int q0, int len);
+    int size1_;
+    int es_;
+    int nch_;
+    int nmax_;
+    bool sleft_;
+    std::vector<cplx> s_;
+    std::vector<cplx> x_;
+    std::vector<cplx> acc_;
+    std::vector<std::vector<cplx> > sfft_;  /*!< transform of s_d, L<=d<2L, for L=2^i */
+    std::vector<fft_plan<T> > plan_;        /*!< FFT of length 2L, for L=2^i */
+};
+
+template <typename T>
+void dyson_tti(herm_matrix_tti<T> &G, T mu, cdmatrix &H, herm_matrix_tti<T> &Sigma, T beta,
+               T h, const int SolveOrder = MAX_SOLVE_ORDER,
+               const int matsubara_method = CNTR_MAT_FIXPOINT,
+               const bool force_hermitian = true);
+template <typename T>
+void vie2_tti(herm_matrix_tti<T> &G, herm_matrix_tti<T> &F, herm_matrix_tti<T> &Fcc,
+              herm_matrix_tti<T> &Q, T beta, T h, const int SolveOrder = MAX_SOLVE_ORDER,
+              const int matsubara_method = CNTR_MAT_FIXPOINT);
+template <typename T>
+void convolution_tti(herm_matrix_tti<T> &C, herm_matrix_tti<T> &A, herm_matrix_tti<T> &Acc,
+                     herm_matrix_tti<T> &B, herm_matrix_tti<T> &Bcc, T beta, T h,
+                     const int SolveOrder = MAX_SOLVE_ORDER);
+
+}  // namespace cntr
+
+#endif  // CNTR_HERM_MATRIX_TTI_DECL_H
@@ -0,0 +1,21 @@
+#include "cntr_herm_matrix_tti_extern_templates.hpp"
+#include "cntr_herm_matrix_impl.hpp"
+#include "cntr_function_impl.hpp"
+#include "cntr_convolution_impl.hpp"
+#include "cntr_herm_matrix_tti_impl.hpp"
+
+namespace cntr {
+
+  template class herm_matrix_tti<double>;
+  template class tti_relaxed_product<double>;
+  template void dyson_tti<double>(herm_matrix_tti<double> &G, double mu, cdmatrix &H,
+    herm_matrix_tti<double> &Sigma, double beta, double h, const int SolveOrder,
+    const int matsubara_method, const bool force_hermitian);
+  template void vie2_tti<double>(herm_matrix_tti<double> &G, herm_matrix_tti<double> &F,
+    herm_matrix_tti<double> &Fcc, herm_matrix_tti<double> &Q, double beta, double h,
+    const int SolveOrder, const int matsubara_method);
+  template void convolution_tti<double>(herm_matrix_tti<double> &C,
+    herm_matrix_tti<double> &A, herm_matrix_tti<double> &Acc, herm_matrix_tti<double> &B,
+    herm_matrix_tti<double> &Bcc, double beta, double h, const int SolveOrder);
+
+}  // namespace cntr
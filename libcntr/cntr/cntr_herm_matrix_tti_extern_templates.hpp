@@ -0,0 +1,22 @@
+#ifndef CNTR_HERM_MATRIX_TTI_EXTERN_TEMPLATES_H
+#define CNTR_HERM_MATRIX_TTI_EXTERN_TEMPLATES_H
+
+#include "cntr_herm_matrix_tti_decl.hpp"
+
+namespace cntr {
+
+  extern template class herm_matrix_tti<double>;
+  extern template class tti_relaxed_product<double>;
+  extern template void dyson_tti<double>(herm_matrix_tti<double> &G, double mu, cdmatrix &H,
+    herm_matrix_tti<double> &Sigma, double beta, double h, const int SolveOrder,
+    const int matsubara_method, const bool force_hermitian);
+  extern template void vie2_tti<double>(herm_matrix_tti<double> &G, herm_matrix_tti<double> &F,
+    herm_matrix_tti<double> &Fcc, herm_matrix_tti<double> &Q, double beta, double h,
+    const int SolveOrder, const int matsubara_method);
+  extern template void convolution_tti<double>(herm_matrix_tti<double> &C,
+    herm_matrix_tti<double> &A, herm_matrix_tti<double> &Acc, herm_matrix_tti<double> &B,
+    herm_matrix_tti<double> &Bcc, double beta, double h, const int SolveOrder);
+
+}  // namespace cntr
+
+#endif  // CNTR_HERM_MATRIX_TTI_EXTERN_TEMPLATES_H
@@ -0,0 +1,975 @@
+#ifndef CNTR_HERM_MATRIX_TTI_IMPL_H
+#define CNTR_HERM_MATRIX_TTI_IMPL_H
+
+#include "cntr_herm_matrix_tti_decl.hpp"
+#include "cntr_elements.hpp"
+#include "cntr_herm_matrix_decl.hpp"
+#include "cntr_function_decl.hpp"
+#include "cntr_convolution_decl.hpp"
+#include "cntr_dyson_decl.hpp"
+#include "cntr_vie2_decl.hpp"
+
+namespace cntr {
+
+/* #######################################################################################
+#
+#   CONSTRUCTION/DESTRUCTION
+#
+########################################################################################*/
+template <typename T>
+herm_matrix_tti<T>::herm_matrix_tti() {
+    nt_ = -2;
+    ntau_ = 0;
+    size1_ = 0;
+    size2_ = 0;
+    element_size_ = 0;
+    sig_ = -1;
+}
+/** \brief <b> Initializes the `herm_matrix_tti` class for a square-matrix contour function. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Allocates the Matsubara component, and for `nt >= 0` the real-time and left-mixing
+ * > components, and sets all elements to zero.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param nt
+ * > [int] Largest time difference (number of time steps); `nt = -1`: only the Matsubara component.
+ * @param ntau
+ * > [int] Number of points on the Matsubara axis.
+ * @param size1
+ * > [int] Matrix rank of the contour function.
+ * @param sig
+ * > [int] Bosonic (`sig = 1`) or fermionic (`sig = -1`) statistics.
+ */
+template <typename T>
+herm_matrix_tti<T>::herm_matrix_tti(int nt, int ntau, int size1, int sig) {
+    assert(size1 >= 0 && nt >= -1 && sig * sig == 1 && ntau >= 0);
+    sig_ = sig;
+    resize(nt, ntau, size1);
+}
+/** \brief <b> Resizes the `herm_matrix_tti` object and sets all elements to zero. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Changes the number of time steps, \f$\tau\f$ points and the matrix rank.
+ * > The content is discarded.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param nt
+ * > [int] Largest time difference.
+ * @param ntau
+ * > [int] Number of points on the Matsubara axis.
+ * @param size1
+ * > [int] Matrix rank of the contour function.
+ */
+template <typename T>
+void herm_matrix_tti<T>::resize(int nt, int ntau, int size1) {
+    assert(size1 >= 0 && nt >= -1 && ntau >= 0);
+    nt_ = nt;
+    ntau_ = ntau;
+    size1_ = size1;
+    size2_ = size1;
+    element_size_ = size1 * size1;
+    mat_.assign((size_t)(ntau_ + 1) * element_size_, cplx(0.0, 0.0));
+    ret_.assign((size_t)(nt_ + 1) * element_size_, cplx(0.0, 0.0));
+    les_.assign((size_t)(nt_ + 1) * element_size_, cplx(0.0, 0.0));
+    tv_.assign((size_t)(nt_ + 1) * (ntau_ + 1) * element_size_, cplx(0.0, 0.0));
+}
+/// @private
+template <typename T>
+void herm_matrix_tti<T>::clear(void) {
+    std::fill(mat_.begin(), mat_.end(), cplx(0.0, 0.0));
+    std::fill(ret_.begin(), ret_.end(), cplx(0.0, 0.0));
+    std::fill(les_.begin(), les_.end(), cplx(0.0, 0.0));
+    std::fill(tv_.begin(), tv_.end(), cplx(0.0, 0.0));
+}
+
+/* #######################################################################################
+#
+#   RAW POINTERS TO ELEMENTS
+#
+########################################################################################*/
+/// @private
+template <typename T>
+inline std::complex<T> *herm_matrix_tti<T>::retptr(int l) {
+    assert(0 <= l && l <= nt_);
+    return &ret_[(size_t)l * element_size_];
+}
+/// @private
+template <typename T>
+inline std::complex<T> *herm_matrix_tti<T>::lesptr(int l) {
+    assert(0 <= l && l <= nt_);
+    return &les_[(size_t)l * element_size_];
+}
+/// @private
+template <typename T>
+inline std::complex<T> *herm_matrix_tti<T>::tvptr(int i, int j) {
+    assert(0 <= i && i <= nt_ && 0 <= j && j <= ntau_);
+    return &tv_[((size_t)i * (ntau_ + 1) + j) * element_size_];
+}
+/// @private
+template <typename T>
+inline std::complex<T> *herm_matrix_tti<T>::matptr(int i) {
+    assert(0 <= i && i <= ntau_);
+    return &mat_[(size_t)i * element_size_];
+}
+
+/* #######################################################################################
+#
+#   READING ELEMENTS TO ANY MATRIX TYPE
+#   OR TO COMPLEX NUMBERS (then only the (0,0) element is addressed for dim>0)
+#
+########################################################################################*/
+#define herm_matrix_tti_READ_ELEMENT                                         \
+    {                                                                        \
+        int r, s;                                                            \
+        M.resize(size1_, size2_);                                            \
+        for (r = 0; r < size1_; r++)                                         \
+            for (s = 0; s < size2_; s++)                                     \
+                M(r, s) = x[r * size2_ + s];                                 \
+    }
+#define herm_matrix_tti_READ_ELEMENT_MINUS_CONJ                              \
+    {                                                                        \
+        cplx w;                                                              \
+        int r, s, dim = size1_;                                              \
+        M.resize(dim, dim);                                                  \
+        for (r = 0; r < dim; r++)                                            \
+            for (s = 0; s < dim; s++) {                                      \
+                w = x[s * dim + r];                                          \
+                M(r, s) = std::complex<T>(-w.real(), w.imag());              \
+            }                                                                \
+    }
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_tti<T>::get_les(int i, int j, Matrix &M) {
+    cplx *x;
+    if (i <= j) {
+        x = lesptr(j - i);
+        herm_matrix_tti_READ_ELEMENT
+    } else {
+        x = lesptr(i - j);
+        herm_matrix_tti_READ_ELEMENT_MINUS_CONJ
+    }
+}
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_tti<T>::get_ret(int i, int j, Matrix &M) {
+    cplx *x;
+    if (i >= j) {
+        x = retptr(i - j);
+        herm_matrix_tti_READ_ELEMENT
+    } else {
+        x = retptr(j - i);
+        herm_matrix_tti_READ_ELEMENT_MINUS_CONJ
+    }
+}
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_tti<T>::get_gtr(int i, int j, Matrix &M) {
+    Matrix M1;
+    get_ret(i, j, M);
+    get_les(i, j, M1);
+    M += M1;
+}
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_tti<T>::get_tv(int i, int j, Matrix &M) {
+    cplx *x = tvptr(i, j);
+    herm_matrix_tti_READ_ELEMENT
+}
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_tti<T>::get_vt(int i, int j, Matrix &M) {
+    assert(i <= ntau_);
+    cplx *x = tvptr(j, ntau_ - i);
+    herm_matrix_tti_READ_ELEMENT_MINUS_CONJ if (sig_ == -1) M = -M;
+}
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_tti<T>::get_mat(int i, Matrix &M) {
+    cplx *x = matptr(i);
+    herm_matrix_tti_READ_ELEMENT
+}
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_tti<T>::get_matminus(int i, Matrix &M) {
+    assert(i <= ntau_);
+    cplx *x = matptr(ntau_ - i);
+    herm_matrix_tti_READ_ELEMENT if (sig_ == -1) M = -M;
+}
+#undef herm_matrix_tti_READ_ELEMENT
+#undef herm_matrix_tti_READ_ELEMENT_MINUS_CONJ
+
+/// @private
+template <typename T>
+inline void herm_matrix_tti<T>::get_les(int i, int j, cplx &x) {
+    if (i <= j)
+        x = *lesptr(j - i);
+    else
+        x = -std::conj(*lesptr(i - j));
+}
+/// @private
+template <typename T>
+inline void herm_matrix_tti<T>::get_ret(int i, int j, cplx &x) {
+    if (i >= j)
+        x = *retptr(i - j);
+    else
+        x = -std::conj(*retptr(j - i));
+}
+/// @private
+template <typename T>
+inline void herm_matrix_tti<T>::get_gtr(int i, int j, cplx &x) {
+    cplx x1;
+    get_ret(i, j, x);
+    get_les(i, j, x1);
+    x += x1;
+}
+/// @private
+template <typename T>
+inline void herm_matrix_tti<T>::get_tv(int i, int j, cplx &x) {
+    x = *tvptr(i, j);
+}
+/// @private
+template <typename T>
+inline void herm_matrix_tti<T>::get_vt(int i, int j, cplx &x) {
+    x = *tvptr(j, ntau_ - i);
+    if (sig_ == -1)
+        x = std::conj(x);
+    else
+        x = -std::conj(x);
+}
+/// @private
+template <typename T>
+inline void herm_matrix_tti<T>::get_mat(int i, cplx &x) {
+    x = *matptr(i);
+}
+/// @private
+template <typename T>
+inline void herm_matrix_tti<T>::get_matminus(int i, cplx &x) {
+    x = *matptr(ntau_ - i);
+    if (sig_ == -1)
+        x = -x;
+}
+/** \brief <b> Returns the density matrix at given time step (scalar case). </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Returns \f$ \rho = i \eta C^<(t,t) \f$, which does not depend on \f$t\f$,
+ * > or \f$ -C^\mathrm{M}(\beta) \f$ for `tstp=-1`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] The time step, -1 <= tstp <= nt.
+ */
+template <typename T>
+std::complex<T> herm_matrix_tti<T>::density_matrix(int tstp) {
+    assert(tstp >= -1 && tstp <= nt_);
+    if (tstp == -1)
+        return -(*matptr(ntau_));
+    else
+        return std::complex<T>(0.0, sig_) * (*lesptr(0));
+}
+/** \brief <b> Returns the density matrix at given time step. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Returns \f$ \rho = i \eta C^<(t,t) \f$, or \f$ -C^\mathrm{M}(\beta) \f$ for `tstp=-1`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] The time step, -1 <= tstp <= nt.
+ * @param M
+ * > [Matrix] The density matrix (output).
+ */
+template <typename T>
+template <class Matrix>
+void herm_matrix_tti<T>::density_matrix(int tstp, Matrix &M) {
+    assert(tstp >= -1 && tstp <= nt_);
+    if (tstp == -1) {
+        get_mat(ntau_, M);
+        M *= (-1.0);
+    } else {
+        get_les(0, 0, M);
+        M *= std::complex<T>(0.0, 1.0 * sig_);
+    }
+}
+
+/* #######################################################################################
+#
+#   WRITING ELEMENTS FROM ANY MATRIX TYPE
+#
+########################################################################################*/
+#define herm_matrix_tti_SET_ELEMENT_MATRIX                                   \
+    {                                                                        \
+        int r, s;                                                            \
+        for (r = 0; r < size1_; r++)                                         \
+            for (s = 0; s < size2_; s++)                                     \
+                x[r * size2_ + s] = M(r, s);                                 \
+    }
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_tti<T>::set_ret(int l, Matrix &M) {
+    cplx *x = retptr(l);
+    herm_matrix_tti_SET_ELEMENT_MATRIX
+}
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_tti<T>::set_les(int l, Matrix &M) {
+    cplx *x = lesptr(l);
+    herm_matrix_tti_SET_ELEMENT_MATRIX
+}
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_tti<T>::set_tv(int i, int j, Matrix &M) {
+    cplx *x = tvptr(i, j);
+    herm_matrix_tti_SET_ELEMENT_MATRIX
+}
+/// @private
+template <typename T>
+template <class Matrix>
+void herm_matrix_tti<T>::set_mat(int i, Matrix &M) {
+    cplx *x = matptr(i);
+    herm_matrix_tti_SET_ELEMENT_MATRIX
+}
+#undef herm_matrix_tti_SET_ELEMENT_MATRIX
+
+/** \brief <b> Sets the lesser component from the left-mixing component. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Uses \f$ C^<(t,0) = C^\rceil(t,0) \f$ and hermitian symmetry,
+ * > \f$ C^<(0,t_l) = -[C^\rceil(t_l,0)]^\dagger \f$.
+ */
+template <typename T>
+void herm_matrix_tti<T>::set_les_from_tv(void) {
+    for (int l = 0; l <= nt_; l++)
+        element_minusconj<T, LARGESIZE>(size1_, lesptr(l), tvptr(l, 0));
+}
+/** \brief <b> Sets the `herm_matrix_tti` from a `herm_matrix`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Copies the Matsubara component and the left-mixing component of `G`, and takes the
+ * > real-time components at time difference \f$ t_l \f$ from the last time step
+ * > `n=G.nt()`: \f$ C^\mathrm{R}(t_l,0)=G^\mathrm{R}(t_n,t_{n-l})\f$,
+ * > \f$ C^<(0,t_l)=G^<(t_{n-l},t_n)\f$. If `G.nt() < nt`, only time steps up to
+ * > `G.nt()` are set.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix] A time-translation invariant contour function.
+ */
+template <typename T>
+void herm_matrix_tti<T>::set_from(herm_matrix<T> &G) {
+    int l, n = G.nt(), n1 = (G.nt() < nt_ ? G.nt() : nt_);
+    assert(G.ntau() == ntau_ && G.size1() == size1_ && G.size2() == size2_);
+    sig_ = G.sig();
+    std::copy(G.matptr(0), G.matptr(0) + (ntau_ + 1) * element_size_, matptr(0));
+    for (l = 0; l <= n1; l++) {
+        element_set<T, LARGESIZE>(size1_, retptr(l), G.retptr(n, n - l));
+        element_set<T, LARGESIZE>(size1_, lesptr(l), G.lesptr(n - l, n));
+    }
+    if (n1 >= 0)
+        std::copy(G.tvptr(0, 0), G.tvptr(0, 0) + (size_t)(n1 + 1) * (ntau_ + 1) * element_size_,
+                  tvptr(0, 0));
+}
+/** \brief <b> Converts to a `herm_matrix`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Sets all components of `G` for times up to `G.nt() <= nt`, with
+ * > \f$ G^\mathrm{R}(t_i,t_j) = C^\mathrm{R}(t_{i-j},0) \f$ and
+ * > \f$ G^<(t_j,t_i) = C^<(0,t_{i-j}) \f$. The result can be used as the
+ * > equilibrium initial state of a nonequilibrium calculation.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix] The contour function (output); `ntau` and `size1` must match.
+ */
+template <typename T>
+void herm_matrix_tti<T>::get_data(herm_matrix<T> &G) {
+    int i, j, nt = G.nt();
+    assert(nt <= nt_ && G.ntau() == ntau_ && G.size1() == size1_ && G.size2() == size2_);
+    G.set_sig(sig_);
+    std::copy(matptr(0), matptr(0) + (ntau_ + 1) * element_size_, G.matptr(0));
+    for (i = 0; i <= nt; i++) {
+        for (j = 0; j <= i; j++) {
+            element_set<T, LARGESIZE>(size1_, G.retptr(i, j), retptr(i - j));
+            element_set<T, LARGESIZE>(size1_, G.lesptr(j, i), lesptr(i - j));
+        }
+    }
+    if (nt >= 0)
+        std::copy(tvptr(0, 0), tvptr(0, 0) + (size_t)(nt + 1) * (ntau_ + 1) * element_size_,
+                  G.tvptr(0, 0));
+}
+
+/* #######################################################################################
+#
+#   RELAXED PRODUCT OF MATRIX SERIES
+#
+########################################################################################*/
+/// @private
+template <typename T>
+tti_relaxed_product<T>::tti_relaxed_product(int size1, int nch, int nmax, cplx *s, bool sleft) {
+    assert(size1 > 0 && nch > 0 && nmax >= 0);
+    size1_ = size1;
+    es_ = size1 * size1;
+    nch_ = nch;
+    nmax_ = nmax;
+    sleft_ = sleft;
+    s_.assign(s, s + (size_t)(nmax + 1) * es_);
+    x_.assign((size_t)(nmax + 1) * nch * es_, cplx(0.0, 0.0));
+    acc_.assign((size_t)(nmax + 1) * nch * es_, cplx(0.0, 0.0));
+}
+/// @private
+/** \brief <b> Passes the next element \f$ x_q \f$ of the relaxed product. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Stores \f$ x_q \f$ and adds the contributions of all blocks ending at \f$ q \f$ to
+ * > `acc(t)`, \f$ t>q \f$. Must be called for q=0,1,2,... in this order.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param q
+ * > [int] The index.
+ * @param x
+ * > [complex] Pointer to the first matrix of \f$ x_q \f$.
+ * @param chstride
+ * > [int] Distance between the matrices of the channels of \f$ x_q \f$.
+ */
+template <typename T>
+void tti_relaxed_product<T>::push(int q, cplx *x, int chstride) {
+    assert(0 <= q && q <= nmax_);
+    for (int ch = 0; ch < nch_; ch++)
+        element_set<T, LARGESIZE>(size1_, this->x(q) + ch * es_, x + (size_t)ch * chstride);
+    if (q + 1 > nmax_)
+        return;
+    for (int len = 1; len <= nmax_ && (q + 1) % len == 0; len *= 2) {
+        if (len < CNTR_TTI_FFT_MIN)
+            block_direct(q + 1 - len, len);
+        else
+            block_fft(q + 1 - len, len);
+    }
+}
+/// @private
+template <typename T>
+void tti_relaxed_product<T>::block_direct(int q0, int len) {
+    int ch, q, d;
+    cplx *c, *xq;
+    for (q = q0; q < q0 + len; q++) {
+        for (d = len; d < 2 * len && q + d <= nmax_; d++) {
+            for (ch = 0; ch < nch_; ch++) {
+                c = acc(q + d) + ch * es_;
+                xq = x(q) + ch * es_;
+                if (sleft_)
+                    element_incr<T, LARGESIZE>(size1_, c, s(d), xq);
+                else
+                    element_incr<T, LARGESIZE>(size1_, c, xq, s(d));
+            }
+        }
+    }
+}
+/// @private
+template <typename T>
+void tti_relaxed_product<T>::block_fft(int q0, int len) {
+    int nfft = 2 * len, t0 = q0 + len, lg = 0, r, e;
+    int nout = (2 * len - 1 < nmax_ - t0 + 1 ? 2 * len - 1 : nmax_ - t0 + 1);
+    while ((1 << lg) < len)
+        lg++;
+    if ((int)sfft_.size() <= lg) {
+        sfft_.resize(lg + 1);
+        plan_.resize(lg + 1);
+    }
+    std::vector<cplx> &sf = sfft_[lg];
+    if (sf.empty()) {
+        std::vector<cplx> buf(nfft);
+        plan_[lg] = fft_plan<T>(nfft);
+        sf.resize((size_t)nfft * es_);
+        for (e = 0; e < es_; e++) {
+            for (r = 0; r < nfft; r++)
+                buf[r] = (r < len && len + r <= nmax_ ? s_[(size_t)(len + r) * es_ + e] : 0.0);
+            plan_[lg].transform(buf.data(), -1);
+            for (r = 0; r < nfft; r++)
+                sf[(size_t)r * es_ + e] = buf[r];
+        }
+    }
+#if CNTR_USE_OMP == 1
+#pragma omp parallel private(r, e) if (nch_ > 1)
+#endif
+    {
+        std::vector<cplx> buf(nfft), xf((size_t)nfft * es_), yf((size_t)nfft * es_);
+        fft_plan<T> plan(plan_[lg]);
+#if CNTR_USE_OMP == 1
+#pragma omp for
+#endif
+        for (int ch = 0; ch < nch_; ch++) {
+            for (e = 0; e < es_; e++) {
+                for (r = 0; r < nfft; r++)
+                    buf[r] = (r < len ? x(q0 + r)[ch * es_ + e] : 0.0);
+                plan.transform(buf.data(), -1);
+                for (r = 0; r < nfft; r++)
+                    xf[(size_t)r * es_ + e] = buf[r];
+            }
+            for (r = 0; r < nfft; r++) {
+                if (sleft_)
+                    element_mult<T, LARGESIZE>(size1_, &yf[(size_t)r * es_],
+                                               &sf[(size_t)r * es_], &xf[(size_t)r * es_]);
+                else
+                    element_mult<T, LARGESIZE>(size1_, &yf[(size_t)r * es_],
+                                               &xf[(size_t)r * es_], &sf[(size_t)r * es_]);
+            }
+            for (e = 0; e < es_; e++) {
+                for (r = 0; r < nfft; r++)
+                    buf[r] = yf[(size_t)r * es_ + e];
+                plan.transform(buf.data(), 1);
+                for (r = 0; r < nout; r++)
+                    acc(t0 + r)[ch * es_ + e] += buf[r] / (T)nfft;
+            }
+        }
+    }
+}
+/// @private
+/** \brief <b> Adds the Gregory end corrections to the relaxed product. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > For \f$ t>2k \f$, the Gregory quadrature \f$ \sum_{q=0}^{t} w_{t,q} x_q s_{t-q} \f$
+ * > differs from the plain sum by
+ * > \f$ \sum_{q=0}^{k} (\omega_q-1) x_q s_{t-q} + \sum_{q=t-k}^{t} (\omega_{t-q}-1) x_q s_{t-q} \f$.
+ * > This adds the correction for \f$ q\le \f$ `qmax` to `res` (`nch` matrices).
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param t
+ * > [int] The index, \f$ t>2k \f$.
+ * @param qmax
+ * > [int] Last index of \f$ x \f$ to include, `t-1` or `t`.
+ * @param I
+ * > [Integrator] integrator class
+ * @param res
+ * > [complex] Pointer to `nch` matrices, incremented by the correction.
+ */
+template <typename T>
+void tti_relaxed_product<T>::add_gregory_correction(int t, int qmax,
+                                                    integration::Integrator<T> &I, cplx *res) {
+    int k = I.get_k(), q, ch;
+    cplx w;
+    assert(t > 2 * k && qmax <= t);
+    for (q = 0; q <= qmax; q++) {
+        if (q > k && q < t - k)
+            continue;
+        w = (q <= k ? I.gregory_omega(q) : I.gregory_omega(t - q)) - 1.0;
+        for (ch = 0; ch < nch_; ch++) {
+            if (sleft_)
+                element_incr<T, LARGESIZE>(size1_, res + ch * es_, w, s(t - q), x(q) + ch * es_);
+            else
+                element_incr<T, LARGESIZE>(size1_, res + ch * es_, w, x(q) + ch * es_, s(t - q));
+        }
+    }
+}
+
+/* #######################################################################################
+#
+#   SOLVERS
+#
+########################################################################################*/
+/// @private
+/** \brief <b> Mixing term \f$ h_\tau\int_0^\beta d\tau' A^\rceil(t_n,\tau') B^\mathrm{M}(\tau'-\tau) \f$
+ * for time steps n0 < n <= nt.</b>
+ */
+template <typename T>
+void tti_mixing_term(int n0, herm_matrix_tti<T> &C, herm_matrix_tti<T> &A,
+                     herm_matrix_tti<T> &B, integration::Integrator<T> &I, T beta) {
+    int ntau = C.ntau(), size1 = C.size1(), es = C.element_size();
+    T dtau = beta / ntau;
+#if CNTR_USE_OMP == 1
+#pragma omp parallel for
+#endif
+    for (int n = n0 + 1; n <= C.nt(); n++) {
+        std::vector<std::complex<T> > ctemp(es);
+        for (int m = 0; m <= ntau; m++) {
+            matsubara_integral_2<T, LARGESIZE>(size1, m, ntau, ctemp.data(), A.tvptr(n, 0),
+                                               B.matptr(0), I, B.sig());
+            for (int l = 0; l < es; l++)
+                C.tvptr(n, m)[l] = dtau * ctemp[l];
+        }
+    }
+}
+
+/** \brief <b> Solves the Dyson equation for a time-translation invariant Green's function. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *   \par Purpose
+ * <!-- ========= -->
+ *
+ * > Solves \f$ [ id/dt + \mu - H ] G(t,t^\prime) - [\Sigma*G](t,t^\prime) = \delta(t,t^\prime)\f$
+ * > for a time-independent \f$ H \f$ and a time-translation invariant \f$\Sigma\f$, with the
+ * > same discretization as `dyson`: `G.get_data` reproduces the retarded component of the
+ * > last time step of the two-time solution, and all left-mixing components, up to roundoff.
+ * > The Matsubara component and the first \f$ 2k+2 \f$ time steps are obtained from
+ * > `dyson` on a short `herm_matrix`. For larger time differences, the history integrals
+ * > \f$ \sum_q G^\mathrm{R}(t_q)\Sigma^\mathrm{R}(t_{l-q}) \f$ and
+ * > \f$ \sum_j \Sigma^\mathrm{R}(t_{n-j}) G^\rceil(t_j) \f$ are computed by a relaxed
+ * > FFT convolution, which gives \f$ O(nt\log^2 nt) \f$ operations instead of the
+ * > \f$ O(nt^3) \f$ of the two-time solver. The lesser component is obtained from
+ * > `set_les_from_tv`; it differs from the lesser component of `dyson` by the
+ * > discretization error (\f$ \sim 10^{-9} \f$ for `h=0.02`, `SolveOrder=5`).
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix_tti<T>] solution
+ * @param mu
+ * > [T] chemical potential
+ * @param H
+ * > [cdmatrix] time-independent Hamiltonian
+ * @param Sigma
+ * > [herm_matrix_tti<T>] self-energy
+ * @param beta
+ * > [double] inverse temperature
+ * @param h
+ * > [double] time interval
+ * @param SolveOrder
+ * > [int] integrator order
+ * @param matsubara_method
+ * > [int] Solution method on the Matsubara axis with 0: Fourier, 1: steep, 2: fixpoint, 3: FFT
+ * @param force_hermitian
+ * > [bool] force hermitian solution
+ */
+template <typename T>
+void dyson_tti(herm_matrix_tti<T> &G, T mu, cdmatrix &H, herm_matrix_tti<T> &Sigma, T beta,
+               T h, const int SolveOrder, const int matsubara_method,
+               const bool force_hermitian) {
+    typedef std::complex<T> cplx;
+    int k = SolveOrder, nt = G.nt(), ntau = G.ntau(), size1 = G.size1(), es = G.element_size();
+    int nt0 = (nt < 2 * k + 2 ? nt : 2 * k + 2);
+    int l, n, m, p, i, r, s;
+    cplx ih = cplx(0.0, 1.0 / h);
+    assert(Sigma.nt() >= nt && Sigma.ntau() == ntau && Sigma.size1() == size1);
+    assert(G.sig() == Sigma.sig());
+    assert(H.rows() == size1 && H.cols() == size1);
+    integration::Integrator<T> I(k);
+    // Matsubara component and first time steps from the two-time solver
+    {
+        herm_matrix<T> G1(nt0, ntau, size1, G.sig()), Sigma1(nt0, ntau, size1, G.sig());
+        function<T> H1(nt0, size1);
+        H1.set_constant(H);
+        Sigma.get_data(Sigma1);
+        dyson(G1, mu, H1, Sigma1, beta, h, k, matsubara_method, force_hermitian);
+        G.set_from(G1);
+    }
+    if (nt > nt0) {
+        std::vector<cplx> mm(es), minv(es), qq(es), qtv((ntau + 1) * es), diffw(k + 2);
+        for (p = 0; p <= k + 1; p++)
+            diffw[p] = ih * I.bd_weights(p); // use BD(k+1!!)
+        // RETARDED: G(l) [i/h bd(0) + mu - H^dagger - h w_0 Sigma(0)] = Q(l)
+        tti_relaxed_product<T> Pret(size1, 1, nt, Sigma.retptr(0), false);
+        for (l = 0; l <= nt0; l++)
+            Pret.push(l, G.retptr(l), es);
+        for (r = 0; r < size1; r++)
+            for (s = 0; s < size1; s++)
+                mm[r * size1 + s] = (r == s ? diffw[0] + mu : 0.0) - std::conj(H(s, r)) -
+                                    h * I.gregory_omega(0) * Sigma.retptr(0)[r * size1 + s];
+        element_inverse<T, LARGESIZE>(size1, minv.data(), mm.data());
+        for (l = nt0 + 1; l <= nt; l++) {
+            element_set<T, LARGESIZE>(size1, qq.data(), Pret.acc(l));
+            Pret.add_gregory_correction(l, l - 1, I, qq.data());
+            for (i = 0; i < es; i++) {
+                qq[i] *= h;
+                for (p = 1; p <= k + 1; p++)
+                    qq[i] -= diffw[p] * G.retptr(l - p)[i];
+            }
+            element_mult<T, LARGESIZE>(size1, G.retptr(l), qq.data(), minv.data());
+            Pret.push(l, G.retptr(l), es);
+        }
+        // LEFT-MIXING: [i/h bd(0) + mu - H - h w_0 Sigma(0)] G(n,m) = Q(n,m)
+        tti_mixing_term(nt0, G, Sigma, G, I, beta);
+        tti_relaxed_product<T> Ptv(size1, ntau + 1, nt, Sigma.retptr(0), true);
+        for (n = 0; n <= nt0; n++)
+            Ptv.push(n, G.tvptr(n, 0), es);
+        for (r = 0; r < size1; r++)
+            for (s = 0; s < size1; s++)
+                mm[r * size1 + s] = (r == s ? diffw[0] + mu : 0.0) - H(r, s) -
+                                    h * I.gregory_omega(0) * Sigma.retptr(0)[r * size1 + s];
+        element_inverse<T, LARGESIZE>(size1, minv.data(), mm.data());
+        for (n = nt0 + 1; n <= nt; n++) {
+            std::copy(Ptv.acc(n), Ptv.acc(n) + (ntau + 1) * es, qtv.begin());
+            Ptv.add_gregory_correction(n, n - 1, I, qtv.data());
+            for (m = 0; m <= ntau; m++) {
+                for (i = 0; i < es; i++) {
+                    qq[i] = G.tvptr(n, m)[i] + h * qtv[m * es + i];
+                    for (p = 1; p <= k + 1; p++)
+                        qq[i] -= diffw[p] * G.tvptr(n - p, m)[i];
+                }
+                element_mult<T, LARGESIZE>(size1, G.tvptr(n, m), minv.data(), qq.data());
+            }
+            Ptv.push(n, G.tvptr(n, 0), es);
+        }
+    }
+    G.set_les_from_tv();
+}
+
+/** \brief <b> VIE solver \f$(1+F)*G=Q\f$ for time-translation invariant functions. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *   \par Purpose
+ * <!-- ========= -->
+ *
+ * > Solves \f$(1+F)*G=Q\f$ as `vie2` for time-translation invariant \f$F\f$ and \f$Q\f$
+ * > and a hermitian solution \f$G\f$, whose lesser component is set by `set_les_from_tv`:
+ * > the first \f$ 2k+2 \f$ time steps and the Matsubara component are obtained from
+ * > `vie2` on a short `herm_matrix`, the remaining ones with a relaxed FFT convolution
+ * > as in `dyson_tti`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix_tti<T>] solution
+ * @param F
+ * > [herm_matrix_tti<T>] green's function on left-hand side
+ * @param Fcc
+ * > [herm_matrix_tti<T>] Complex conjugate of F
+ * @param Q
+ * > [herm_matrix_tti<T>] green's function on right-hand side
+ * @param beta
+ * > [double] inverse temperature
+ * @param h
+ * > [double] time interval
+ * @param SolveOrder
+ * > [int] integrator order
+ * @param matsubara_method
+ * > [int] Solution method on the Matsubara axis with 0: Fourier, 1: steep, 2: fixpoint
+ */
+template <typename T>
+void vie2_tti(herm_matrix_tti<T> &G, herm_matrix_tti<T> &F, herm_matrix_tti<T> &Fcc,
+              herm_matrix_tti<T> &Q, T beta, T h, const int SolveOrder,
+              const int matsubara_method) {
+    typedef std::complex<T> cplx;
+    int k = SolveOrder, nt = G.nt(), ntau = G.ntau(), size1 = G.size1(), es = G.element_size();
+    int nt0 = (nt < 2 * k + 2 ? nt : 2 * k + 2);
+    int l, n, m, i;
+    assert(F.nt() >= nt && F.ntau() == ntau && F.size1() == size1);
+    assert(Fcc.nt() >= nt && Fcc.ntau() == ntau && Fcc.size1() == size1);
+    assert(Q.nt() >= nt && Q.ntau() == ntau && Q.size1() == size1);
+    assert(G.sig() == F.sig());
+    integration::Integrator<T> I(k);
+    // Matsubara component and first time steps from the two-time solver
+    {
+        herm_matrix<T> G1(nt0, ntau, size1, G.sig()), F1(nt0, ntau, size1, G.sig());
+        herm_matrix<T> Fcc1(nt0, ntau, size1, G.sig()), Q1(nt0, ntau, size1, G.sig());
+        F.get_data(F1);
+        Fcc.get_data(Fcc1);
+        Q.get_data(Q1);
+        vie2(G1, F1, Fcc1, Q1, beta, h, k, matsubara_method);
+        G.set_from(G1);
+    }
+    if (nt > nt0) {
+        std::vector<cplx> mm(es), minv(es), qq(es), qtv((ntau + 1) * es);
+        // RETARDED: as in vie2, from G*(1+Fcc)=Q for the hermitian G
+        // G(l) [1 + h w_0 Fcc(0)] = Q(l) - h sum_q w_{l,q} G(q) Fcc(l-q)
+        element_set<T, LARGESIZE>(size1, mm.data(), Fcc.retptr(0));
+        element_smul<T, LARGESIZE>(size1, mm.data(), h * I.gregory_omega(0));
+        element_incr<T, LARGESIZE>(size1, mm.data(), cplx(1.0, 0.0));
+        element_inverse<T, LARGESIZE>(size1, minv.data(), mm.data());
+        tti_relaxed_product<T> Pret(size1, 1, nt, Fcc.retptr(0), false);
+        for (l = 0; l <= nt0; l++)
+            Pret.push(l, G.retptr(l), es);
+        for (l = nt0 + 1; l <= nt; l++) {
+            element_set<T, LARGESIZE>(size1, qq.data(), Pret.acc(l));
+            Pret.add_gregory_correction(l, l - 1, I, qq.data());
+            for (i = 0; i < es; i++)
+                qq[i] = Q.retptr(l)[i] - h * qq[i];
+            element_mult<T, LARGESIZE>(size1, G.retptr(l), qq.data(), minv.data());
+            Pret.push(l, G.retptr(l), es);
+        }
+        // LEFT-MIXING: [1 + h w_0 F(0)] G(n,m) = Q(n,m) - [F*G](n,m)
+        element_set<T, LARGESIZE>(size1, mm.data(), F.retptr(0));
+        element_smul<T, LARGESIZE>(size1, mm.data(), h * I.gregory_omega(0));
+        element_incr<T, LARGESIZE>(size1, mm.data(), cplx(1.0, 0.0));
+        element_inverse<T, LARGESIZE>(size1, minv.data(), mm.data());
+        tti_mixing_term(nt0, G, F, G, I, beta);
+        tti_relaxed_product<T> Ptv(size1, ntau + 1, nt, F.retptr(0), true);
+        for (n = 0; n <= nt0; n++)
+            Ptv.push(n, G.tvptr(n, 0), es);
+        for (n = nt0 + 1; n <= nt; n++) {
+            std::copy(Ptv.acc(n), Ptv.acc(n) + (ntau + 1) * es, qtv.begin());
+            Ptv.add_gregory_correction(n, n - 1, I, qtv.data());
+            for (m = 0; m <= ntau; m++) {
+                for (i = 0; i < es; i++)
+                    qq[i] = Q.tvptr(n, m)[i] - G.tvptr(n, m)[i] - h * qtv[m * es + i];
+                element_mult<T, LARGESIZE>(size1, G.tvptr(n, m), minv.data(), qq.data());
+            }
+            Ptv.push(n, G.tvptr(n, 0), es);
+        }
+    }
+    G.set_les_from_tv();
+}
+
+/** \brief <b> Convolution \f$C=A*B\f$ of time-translation invariant functions. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *   \par Purpose
+ * <!-- ========= -->
+ *
+ * > Computes \f$C=A*B\f$ as `convolution`, for time-translation invariant \f$A\f$
+ * > and \f$B\f$. The first \f$ 2k+2 \f$ time steps and the Matsubara component are
+ * > obtained from `convolution` on a short `herm_matrix`, the remaining ones with FFT
+ * > convolutions and Gregory end corrections. The lesser component is obtained from the
+ * > left-mixing component of \f$ C^\ddagger = B^\ddagger * A^\ddagger \f$ at \f$\tau=0\f$.
+ * > `C` must not be identical to `A` or `B`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param C
+ * > [herm_matrix_tti<T>] result
+ * @param A
+ * > [herm_matrix_tti<T>] contour function
+ * @param Acc
+ * > [herm_matrix_tti<T>] complex conjugate to A
+ * @param B
+ * > [herm_matrix_tti<T>] contour function
+ * @param Bcc
+ * > [herm_matrix_tti<T>] complex conjugate to B
+ * @param beta
+ * > [double] inverse temperature
+ * @param h
+ * > [double] time interval
+ * @param SolveOrder
+ * > [int] integrator order
+ */
+template <typename T>
+void convolution_tti(herm_matrix_tti<T> &C, herm_matrix_tti<T> &A, herm_matrix_tti<T> &Acc,
+                     herm_matrix_tti<T> &B, herm_matrix_tti<T> &Bcc, T beta, T h,
+                     const int SolveOrder) {
+    int k = SolveOrder, nt = C.nt(), ntau = C.ntau(), size1 = C.size1(), es = C.element_size();
+    int nt0 = (nt < 2 * k + 2 ? nt : 2 * k + 2);
+    int l, n, i;
+    assert(&C != &A && &C != &B);
+    assert(A.nt() >= nt && A.ntau() == ntau && A.size1() == size1);
+    assert(Acc.nt() >= nt && Acc.ntau() == ntau && Acc.size1() == size1);
+    assert(B.nt() >= nt && B.ntau() == ntau && B.size1() == size1);
+    assert(Bcc.nt() >= nt && Bcc.ntau() == ntau && Bcc.size1() == size1);
+    integration::Integrator<T> I(k);
+    // left-mixing component of Ccc = Bcc*Acc at tau=0, for the lesser component
+    std::vector<std::complex<T> > cctv((nt + 1) * es);
+    {
+        herm_matrix<T> C1(nt0, ntau, size1, C.sig()), A1(nt0, ntau, size1, A.sig());
+        herm_matrix<T> Acc1(nt0, ntau, size1, A.sig()), B1(nt0, ntau, size1, B.sig());
+        herm_matrix<T> Bcc1(nt0, ntau, size1, B.sig());
+        A.get_data(A1);
+        Acc.get_data(Acc1);
+        B.get_data(B1);
+        Bcc.get_data(Bcc1);
+        convolution(C1, A1, Acc1, B1, Bcc1, beta, h, k);
+        C.set_from(C1);
+        convolution(C1, Bcc1, B1, Acc1, A1, beta, h, k);
+        for (n = 0; n <= nt0; n++)
+            element_set<T, LARGESIZE>(size1, &cctv[n * es], C1.tvptr(n, 0));
+    }
+    if (nt > nt0) {
+        // RETARDED: sum_{q=0}^{l} w_{l,q} A(q) B(l-q)
+        tti_relaxed_product<T> Pret(size1, 1, nt, B.retptr(0), false);
+        for (l = 0; l <= nt; l++)
+            Pret.push(l, A.retptr(l), es);
+        for (l = nt0 + 1; l <= nt; l++) {
+            element_set<T, LARGESIZE>(size1, C.retptr(l), Pret.acc(l));
+            element_incr<T, LARGESIZE>(size1, C.retptr(l), A.retptr(l), B.retptr(0));
+            Pret.add_gregory_correction(l, l, I, C.retptr(l));
+            element_smul<T, LARGESIZE>(size1, C.retptr(l), h);
+        }
+        // LEFT-MIXING: sum_{j=0}^{n} w_{n,j} A(n-j) B(j,tau)
+        tti_mixing_term(nt0, C, A, B, I, beta);
+        tti_relaxed_product<T> Ptv(size1, ntau + 1, nt, A.retptr(0), true);
+        for (n = 0; n <= nt; n++)
+            Ptv.push(n, B.tvptr(n, 0), es);
+        for (n = nt0 + 1; n <= nt; n++) {
+            std::vector<std::complex<T> > qtv(Ptv.acc(n), Ptv.acc(n) + (ntau + 1) * es);
+            for (i = 0; i <= ntau; i++)
+                element_incr<T, LARGESIZE>(size1, &qtv[i * es], A.retptr(0), B.tvptr(n, i));
+            Ptv.add_gregory_correction(n, n, I, qtv.data());
+            for (i = 0; i < (ntau + 1) * es; i++)
+                C.tvptr(n, 0)[i] += h * qtv[i];
+        }
+        // Ccc(n,0) = sum_{j=0}^{n} w_{n,j} Bcc(n-j) Acc(j,0) + mixing term
+        std::vector<std::complex<T> > ctemp(es);
+        tti_relaxed_product<T> Pcc(size1, 1, nt, Bcc.retptr(0), true);
+        for (n = 0; n <= nt; n++)
+            Pcc.push(n, Acc.tvptr(n, 0), es);
+        for (n = nt0 + 1; n <= nt; n++) {
+            std::complex<T> *cc = &cctv[n * es];
+            element_set<T, LARGESIZE>(size1, cc, Pcc.acc(n));
+            element_incr<T, LARGESIZE>(size1, cc, Bcc.retptr(0), Acc.tvptr(n, 0));
+            Pcc.add_gregory_correction(n, n, I, cc);
+            element_smul<T, LARGESIZE>(size1, cc, h);
+            matsubara_integral_2<T, LARGESIZE>(size1, 0, ntau, ctemp.data(), Bcc.tvptr(n, 0),
+                                               Acc.matptr(0), I, Acc.sig());
+            element_incr<T, LARGESIZE>(size1, cc, beta / ntau, ctemp.data());
+        }
+    }
+    // C^<(0,t) = -[Ccc^<(t,0)]^dagger, with Ccc^<(t,0) = Ccc^tv(t,0)
+    for (l = 0; l <= nt; l++)
+        element_minusconj<T, LARGESIZE>(size1, C.lesptr(l), &cctv[l * es]);
+}
+
+}  // namespace cntr
+
+#endif  // CNTR_HERM_MATRIX_TTI_IMPL_H
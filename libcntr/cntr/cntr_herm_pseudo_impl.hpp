@@ -610,11 +610,12 @@ template <typename T> void herm_pseudo<T>::write_to_hdf5(hid_t group_id) {
         shape[0] = ((nt_ + 1) * (nt_ + 2)) / 2;
         // CHECK: implement store_cplx_array_to_hid with template typename T
         store_cplx_array_to_hid(group_id, std::string("ret"), retptr(0, 0), shape,
-                                len_shape);
+                                len_shape, nt_ + 1);
         store_cplx_array_to_hid(group_id, std::string("les"), lesptr(0, 0), shape,
-                                len_shape);
+                                len_shape, nt_ + 1);
         shape[0] = (nt_ + 1) * (ntau_ + 1);
-        store_cplx_array_to_hid(group_id, std::string("tv"), tvptr(0, 0), shape, len_shape);
+        store_cplx_array_to_hid(group_id, std::string("tv"), tvptr(0, 0), shape, len_shape,
+                                ntau_ + 1);
     }
 }
 /// @private
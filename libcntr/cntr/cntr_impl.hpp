@@ -34,10 +34,25 @@
 #include "cntr_bubble_impl.hpp"
 #include "cntr_distributed_array_impl.hpp"
 #include "cntr_distributed_timestep_array_impl.hpp"
+#include "cntr_lattice_convolution_impl.hpp"
+#include "cntr_hdf5_timestep_writer_impl.hpp"
+#include "cntr_hdf5_async_writer_impl.hpp"
+#include "cntr_hdf5_partial_impl.hpp"
+#include "cntr_checkpoint_impl.hpp"
+#include "cntr_snapshot_impl.hpp"
+#include "cntr_tavtrel_impl.hpp"
+#include "cntr_herm_matrix_hdf5_view_impl.hpp"
+#include "cntr_herm_matrix_tti_impl.hpp"
+#include "cntr_wigner_impl.hpp"
+#include "cntr_dlr_impl.hpp"
+#include "cntr_tau_grid_impl.hpp"
+#include "cntr_matsubara_fft_impl.hpp"
+#include "cntr_newton_krylov_impl.hpp"
 
 #include "cntr_getset_impl.hpp"
 #if CNTR_USE_MPI == 1
 #include "cntr_mpitools_impl.hpp"
+#include "cntr_hdf5_mpi_impl.hpp"
 #endif
 
 #endif  // CNTR_IMPL_H
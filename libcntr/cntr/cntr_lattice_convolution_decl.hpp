@@ -0,0 +1,111 @@
+#ifndef CNTR_LATTICE_CONVOLUTION_DECL_H
+#define CNTR_LATTICE_CONVOLUTION_DECL_H
+
+#include "cntr_global_settings.hpp"
+#include "cntr_distributed_timestep_array_decl.hpp"
+
+namespace cntr {
+
+/** \brief <b> Plan for a one-dimensional complex FFT of arbitrary length </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * Computes \f$ X_m = \sum_{j=0}^{n-1} e^{sign\, 2\pi i jm/n} x_j \f$ in place (no normalization).
+ * Powers of two use an iterative radix-2 transform; all other lengths are mapped onto a
+ * radix-2 transform of length \f$ \geq 2n-1\f$ by Bluestein's algorithm, so that the cost
+ * is \f$ O(n\log n)\f$ for every \f$ n \f$.
+ *
+ * `transform` uses a work space stored in the plan, so a plan must not be shared between
+ * threads: in an OpenMP region, each thread transforms with its own copy of the plan.
+ */
+template <typename T>
+class fft_plan {
+  public:
+    typedef std::complex<T> cplx;
+    fft_plan();
+    explicit fft_plan(int n);
+    int n(void) const { return n_; }
+    void transform(cplx *x, int sign);
+
+  private:
+    void radix2(cplx *x, int sign) const;
+    int n_;                          /*!< Length of the transform */
+    int m_;                          /*!< Length of the radix-2 transform (n_, or padded length for Bluestein) */
+    std::vector<int> bitrev_;        /*!< Bit reversal permutation of length m_ */
+    std::vector<cplx> twiddle_;      /*!< \f$ e^{2\pi i j/m} \f$, \f$ j < m/2 \f$ */
+    std::vector<cplx> chirp_;        /*!< Bluestein chirp \f$ e^{i\pi j^2/n} \f$ */
+    std::vector<cplx> chirp_fft_;    /*!< Radix-2 transforms of the conjugate chirp for sign=+1,-1 */
+    std::vector<cplx> work_;         /*!< Work space of length m_ */
+};
+
+/** \brief <b> Momentum-space convolutions of `distributed_timestep_array` objects by FFT </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * The blocks \f$ j=0,\ldots,N_k-1 \f$ of a `distributed_timestep_array` are interpreted as the points
+ * of a uniform momentum grid with dimensions `dims` (row-major, last index fastest). The
+ * momentum of block \f$ j \f$ along direction \f$ d \f$ is \f$ (j_d-o_d) \f$ in units of
+ * \f$ 2\pi/n_d \f$, where \f$ o_d \f$ is the index of the \f$ \Gamma\f$-point (`origin`).
+ * Lattice sums such as the GW self-energy or the polarization bubble,
+ *
+ * \f$ C_{ab}(k) = \frac{w}{N_k}\sum_{q} i A_{ab}(k-q;t,t') B_{ab}(q;t,t') \f$ (`Bubble2`),
+ *
+ * \f$ C_{ab}(q) = \frac{w}{N_k}\sum_{k} i A_{ab}(k-q;t,t') B_{ba}(k;t',t) \f$ (`Bubble1`),
+ *
+ * are evaluated on a timestep for all Keldysh components as a product in real space,
+ * at a cost of \f$ O(N_k \log N_k) \f$ instead of \f$ O(N_k^2) \f$.
+ *
+ * With MPI, every rank only needs the blocks it owns: the data are transposed such that each rank
+ * holds all momenta for a subset of the time arguments, transformed, multiplied and
+ * transposed back. On return, the owned blocks of `C` are set; use `C.mpi_bcast_all()`
+ * if all ranks need the full result.
+ */
+template <typename T>
+class lattice_convolution {
+  public:
+    typedef std::complex<T> cplx;
+    /* construction, destruction */
+    lattice_convolution();
+    explicit lattice_convolution(const std::vector<int> &dims);
+    lattice_convolution(const std::vector<int> &dims, const std::vector<int> &origin);
+    int nk(void) const { return nk_; }
+    const std::vector<int> &dims(void) const { return dims_; }
+    const std::vector<int> &origin(void) const { return origin_; }
+    int add_kpoints(int k1, int s1, int k2, int s2) const;
+    // lattice sums on a timestep
+    void Bubble1(int tstp, distributed_timestep_array<T> &C, distributed_timestep_array<T> &A,
+                 distributed_timestep_array<T> &B, T weight = 1.0);
+    void Bubble2(int tstp, distributed_timestep_array<T> &C, distributed_timestep_array<T> &A,
+                 distributed_timestep_array<T> &B, T weight = 1.0);
+
+  private:
+    void set_slices(int tstp, distributed_timestep_array<T> &A);
+    void to_lattice(distributed_timestep_array<T> &A, std::vector<cplx> &buf);
+    void to_blocks(std::vector<cplx> &buf, distributed_timestep_array<T> &C);
+    void fft_lattice(cplx *x, int sign);
+    void fft_rows(std::vector<cplx> &buf, int sign);
+
+    int nk_;                                  /*!< Number of momentum points */
+    std::vector<int> dims_;                   /*!< Grid dimensions */
+    std::vector<int> origin_;                 /*!< Index of the Gamma point along each direction */
+    std::vector<int> pos_;                    /*!< Block index -> position on the (origin-shifted) grid */
+    std::vector<int> neg_;                    /*!< Grid position R -> grid position -R */
+    std::vector<fft_plan<T> > plans_;         /*!< FFT plan for each direction */
+    std::vector<cplx> line_;                  /*!< Work space for one line of the grid */
+    // time slices on the current timestep
+    int tstp_;                                /*!< Timestep of the slice layout */
+    int ntau_;                                /*!< Number of imaginary time points */
+    int es_;                                  /*!< Element size */
+    std::vector<std::vector<int> > rank_offsets_; /*!< Block offsets of the slices handled by each rank */
+    std::vector<std::vector<int> > pairs_;    /*!< Local slices processed together: (type,slice1,slice2) */
+};
+
+}  // namespace cntr
+
+#endif  // CNTR_LATTICE_CONVOLUTION_DECL_H
@@ -0,0 +1,12 @@
+#include "cntr_lattice_convolution_extern_templates.hpp"
+#include "cntr_herm_matrix_timestep_view_impl.hpp"
+#include "cntr_distributed_array_impl.hpp"
+#include "cntr_distributed_timestep_array_impl.hpp"
+#include "cntr_lattice_convolution_impl.hpp"
+
+namespace cntr {
+
+  template class fft_plan<double>;
+  template class lattice_convolution<double>;
+
+}  // namespace cntr
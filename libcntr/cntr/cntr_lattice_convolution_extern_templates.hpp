@@ -0,0 +1,13 @@
+#ifndef CNTR_LATTICE_CONVOLUTION_EXTERN_TEMPLATES_H
+#define CNTR_LATTICE_CONVOLUTION_EXTERN_TEMPLATES_H
+
+#include "cntr_lattice_convolution_decl.hpp"
+
+namespace cntr {
+
+  extern template class fft_plan<double>;
+  extern template class lattice_convolution<double>;
+
+}  // namespace cntr
+
+#endif  // CNTR_LATTICE_CONVOLUTION_EXTERN_TEMPLATES_H
@@ -0,0 +1,693 @@
+#ifndef CNTR_LATTICE_CONVOLUTION_IMPL_H
+#define CNTR_LATTICE_CONVOLUTION_IMPL_H
+
+#include "cntr_lattice_convolution_decl.hpp"
+#include "cntr_distributed_array_decl.hpp"
+#include "cntr_distributed_timestep_array_decl.hpp"
+#if CNTR_USE_MPI == 1
+#include "cntr_mpitools_decl.hpp"
+#endif
+
+namespace cntr {
+
+/* #######################################################################################
+#
+#   FFT PLAN
+#
+########################################################################################*/
+
+template <typename T>
+fft_plan<T>::fft_plan() {
+    n_ = 0;
+    m_ = 0;
+}
+
+/** \brief <b> Initializes the FFT plan for length `n`. </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Precomputes the bit reversal, the twiddle factors and, if `n` is not a power of two,
+* > the Bluestein chirp and its transform.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param n
+* > Length of the transform (n>=1)
+*/
+template <typename T>
+fft_plan<T>::fft_plan(int n) {
+    assert(n >= 1);
+    int nbit = 0;
+    n_ = n;
+    m_ = 1;
+    while (m_ < n_)
+        m_ *= 2;
+    if (m_ != n_) {
+        m_ = 1;
+        while (m_ < 2 * n_ - 1)
+            m_ *= 2;
+    }
+    while ((1 << nbit) < m_)
+        nbit++;
+    bitrev_.resize(m_);
+    for (int j = 0; j < m_; j++) {
+        int r = 0;
+        for (int b = 0; b < nbit; b++)
+            if ((j >> b) & 1)
+                r |= 1 << (nbit - 1 - b);
+        bitrev_[j] = r;
+    }
+    twiddle_.resize(m_ / 2);
+    for (int j = 0; j < m_ / 2; j++)
+        twiddle_[j] = cplx(cos(2.0 * CNTR_PI * j / m_), sin(2.0 * CNTR_PI * j / m_));
+    if (m_ != n_) {
+        chirp_.resize(n_);
+        for (int j = 0; j < n_; j++) {
+            // j^2 mod 2n keeps the phase accurate for large n
+            long jj = ((long)j * (long)j) % (2 * (long)n_);
+            chirp_[j] = cplx(cos(CNTR_PI * jj / n_), sin(CNTR_PI * jj / n_));
+        }
+        chirp_fft_.assign(2 * m_, cplx(0.0, 0.0));
+        for (int s = 0; s < 2; s++) {
+            cplx *h = &chirp_fft_[s * m_];
+            for (int l = 0; l < n_; l++)
+                h[l] = (s == 0 ? std::conj(chirp_[l]) : chirp_[l]);
+            for (int l = 1; l < n_; l++)
+                h[m_ - l] = h[l];
+            radix2(h, -1);
+        }
+        work_.resize(m_);
+    }
+}
+
+/// @private
+template <typename T>
+void fft_plan<T>::radix2(cplx *x, int sign) const {
+    for (int j = 0; j < m_; j++) {
+        if (j < bitrev_[j])
+            std::swap(x[j], x[bitrev_[j]]);
+    }
+    for (int len = 2; len <= m_; len *= 2) {
+        int half = len / 2, step = m_ / len;
+        for (int i = 0; i < m_; i += len) {
+            for (int j = 0; j < half; j++) {
+                cplx w = (sign > 0 ? twiddle_[j * step] : std::conj(twiddle_[j * step]));
+                cplx u = x[i + j];
+                cplx v = x[i + j + half] * w;
+                x[i + j] = u + v;
+                x[i + j + half] = u - v;
+            }
+        }
+    }
+}
+
+/** \brief <b> In-place FFT \f$ X_m = \sum_j e^{sign\, 2\pi i jm/n} x_j \f$. </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Unnormalized discrete Fourier transform of `n()` complex numbers. Not thread-safe:
+* > the work space of the plan is overwritten.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param x
+* > [complex*] data of length n(), overwritten by the transform
+* @param sign
+* > sign of the exponent (+1 or -1)
+*/
+template <typename T>
+void fft_plan<T>::transform(cplx *x, int sign) {
+    assert(sign == 1 || sign == -1);
+    if (m_ == n_) {
+        radix2(x, sign);
+        return;
+    }
+    // Bluestein: jm = (j^2 + m^2 - (m-j)^2)/2
+    const cplx *h = &chirp_fft_[(sign > 0 ? 0 : 1) * m_];
+    for (int j = 0; j < n_; j++)
+        work_[j] = x[j] * (sign > 0 ? chirp_[j] : std::conj(chirp_[j]));
+    for (int j = n_; j < m_; j++)
+        work_[j] = 0.0;
+    radix2(&work_[0], -1);
+    for (int j = 0; j < m_; j++)
+        work_[j] *= h[j];
+    radix2(&work_[0], 1);
+    T scale = 1.0 / m_;
+    for (int j = 0; j < n_; j++)
+        x[j] = scale * work_[j] * (sign > 0 ? chirp_[j] : std::conj(chirp_[j]));
+}
+
+/* #######################################################################################
+#
+#   CONSTRUCTION
+#
+########################################################################################*/
+
+template <typename T>
+lattice_convolution<T>::lattice_convolution() {
+    nk_ = 0;
+    tstp_ = -2;
+    ntau_ = -1;
+    es_ = 0;
+}
+
+/** \brief <b> Initializes the `lattice_convolution` class for a grid with the Gamma point at index 0. </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Momentum grid with dimensions `dims`; block \f$ j \f$ of a `distributed_timestep_array` is the
+* > grid point with row-major multi-index \f$ (j_0,j_1,\ldots) \f$ and momentum \f$ 2\pi j_d/n_d \f$.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param dims
+* > Number of momentum points along each direction
+*/
+template <typename T>
+lattice_convolution<T>::lattice_convolution(const std::vector<int> &dims)
+    : lattice_convolution(dims, std::vector<int>(dims.size(), 0)) {}
+
+/** \brief <b> Initializes the `lattice_convolution` class. </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Momentum grid with dimensions `dims`; block \f$ j \f$ of a `distributed_timestep_array` is the
+* > grid point with row-major multi-index \f$ (j_0,j_1,\ldots) \f$ and momentum \f$ 2\pi (j_d-o_d)/n_d \f$.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param dims
+* > Number of momentum points along each direction
+* @param origin
+* > Index \f$ o_d \f$ of the Gamma point along each direction
+*/
+template <typename T>
+lattice_convolution<T>::lattice_convolution(const std::vector<int> &dims,
+                                            const std::vector<int> &origin) {
+    int d, nd = dims.size();
+    assert(nd >= 1 && (int)origin.size() == nd);
+    dims_ = dims;
+    origin_ = origin;
+    nk_ = 1;
+    for (d = 0; d < nd; d++) {
+        assert(dims_[d] >= 1 && 0 <= origin_[d] && origin_[d] < dims_[d]);
+        nk_ *= dims_[d];
+        plans_.push_back(fft_plan<T>(dims_[d]));
+    }
+    pos_.resize(nk_);
+    neg_.resize(nk_);
+    // pos_ is indexed by the block, neg_ by the grid position (multi-index jd read as R)
+    for (int k = 0; k < nk_; k++) {
+        int rest = k, stride = nk_, p = 0, pm = 0;
+        for (d = 0; d < nd; d++) {
+            stride /= dims_[d];
+            int jd = rest / stride;
+            rest -= jd * stride;
+            int sd = (jd - origin_[d] + dims_[d]) % dims_[d];
+            p += sd * stride;
+            pm += ((dims_[d] - jd) % dims_[d]) * stride;
+        }
+        pos_[k] = p;
+        neg_[k] = pm;
+    }
+    tstp_ = -2;
+    ntau_ = -1;
+    es_ = 0;
+}
+
+/** \brief <b> Returns the block index of \f$ s_1 k_1 + s_2 k_2 \f$. </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Adds two momenta on the grid (modulo reciprocal lattice vectors), e.g. `add_kpoints(k,1,q,-1)`
+* > is the block index of \f$ k-q \f$.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param k1
+* > block index of the first momentum
+* @param s1
+* > integer prefactor of the first momentum
+* @param k2
+* > block index of the second momentum
+* @param s2
+* > integer prefactor of the second momentum
+*/
+template <typename T>
+int lattice_convolution<T>::add_kpoints(int k1, int s1, int k2, int s2) const {
+    assert(0 <= k1 && k1 < nk_ && 0 <= k2 && k2 < nk_);
+    int nd = dims_.size(), stride = nk_, k12 = 0;
+    for (int d = 0; d < nd; d++) {
+        stride /= dims_[d];
+        int j1 = (k1 / stride) % dims_[d];
+        int j2 = (k2 / stride) % dims_[d];
+        int j12 = s1 * (j1 - origin_[d]) + s2 * (j2 - origin_[d]) + origin_[d];
+        j12 %= dims_[d];
+        if (j12 < 0)
+            j12 += dims_[d];
+        k12 += j12 * stride;
+    }
+    return k12;
+}
+
+/* #######################################################################################
+#
+#   DATA LAYOUT AND TRANSFORMS
+#
+########################################################################################*/
+
+/// @private
+// Each timestep is split into slices of element_size numbers: ret(tstp,m) and les(m,tstp)
+// are processed together, and so are tv(tstp,m) and tv(tstp,ntau-m) [mat(m),mat(ntau-m)],
+// which are coupled by Bubble1. The pairs are distributed over the ranks.
+template <typename T>
+void lattice_convolution<T>::set_slices(int tstp, distributed_timestep_array<T> &A) {
+    int ntasks = A.ntasks(), tid = A.tid(), m, r;
+    int es = A.size() * A.size(), ntau = A.ntau();
+    std::vector<std::vector<int> > units;
+    if (tstp == -1) {
+        for (m = 0; m <= ntau - m; m++) {
+            std::vector<int> u(3);
+            u[0] = 2;
+            u[1] = m * es;
+            u[2] = (ntau - m) * es;
+            units.push_back(u);
+        }
+    } else {
+        for (m = 0; m <= tstp; m++) {
+            std::vector<int> u(3);
+            u[0] = 0;
+            u[1] = m * es;
+            u[2] = (tstp + 1 + ntau + 1 + m) * es;
+            units.push_back(u);
+        }
+        for (m = 0; m <= ntau - m; m++) {
+            std::vector<int> u(3);
+            u[0] = 1;
+            u[1] = (tstp + 1 + m) * es;
+            u[2] = (tstp + 1 + ntau - m) * es;
+            units.push_back(u);
+        }
+    }
+    int total = 0, done = 0;
+    for (size_t i = 0; i < units.size(); i++)
+        total += (units[i][1] == units[i][2] ? 1 : 2);
+    tstp_ = tstp;
+    ntau_ = ntau;
+    es_ = es;
+    rank_offsets_.assign(ntasks, std::vector<int>());
+    pairs_.clear();
+    for (size_t i = 0; i < units.size(); i++) {
+        int nsl = (units[i][1] == units[i][2] ? 1 : 2);
+        r = (int)(((long)done * ntasks) / total);
+        done += nsl;
+        if (r == tid) {
+            std::vector<int> p(3);
+            p[0] = units[i][0];
+            p[1] = rank_offsets_[r].size();
+            p[2] = p[1] + nsl - 1;
+            pairs_.push_back(p);
+        }
+        rank_offsets_[r].push_back(units[i][1]);
+        if (nsl == 2)
+            rank_offsets_[r].push_back(units[i][2]);
+    }
+}
+
+/// @private
+// owned blocks of A -> buf[(slice*es+ab)*nk+pos]: all momenta of the slices of this rank
+template <typename T>
+void lattice_convolution<T>::to_lattice(distributed_timestep_array<T> &A,
+                                        std::vector<cplx> &buf) {
+    int ntasks = A.ntasks(), tid = A.tid(), k, l, ab, r;
+    const std::vector<int> &tid_map = A.data().tid_map();
+    const std::vector<int> &loc = rank_offsets_[tid];
+    int nloc = loc.size();
+    buf.resize(nloc * es_ * nk_);
+    if (ntasks == 1) {
+        for (k = 0; k < nk_; k++) {
+            const cplx *src = A.data().block(k);
+            for (l = 0; l < nloc; l++)
+                for (ab = 0; ab < es_; ab++)
+                    buf[(l * es_ + ab) * nk_ + pos_[k]] = src[loc[l] + ab];
+        }
+        return;
+    }
+#if CNTR_USE_MPI == 1
+    std::vector<int> nown(ntasks, 0), scount(ntasks), sdispl(ntasks), rcount(ntasks), rdispl(ntasks);
+    for (k = 0; k < nk_; k++)
+        nown[tid_map[k]]++;
+    int stot = 0, rtot = 0;
+    for (r = 0; r < ntasks; r++) {
+        scount[r] = nown[tid] * rank_offsets_[r].size() * es_;
+        rcount[r] = nown[r] * nloc * es_;
+        sdispl[r] = stot;
+        rdispl[r] = rtot;
+        stot += scount[r];
+        rtot += rcount[r];
+    }
+    std::vector<cplx> sendbuf(stot), recvbuf(rtot);
+    int i = 0;
+    for (r = 0; r < ntasks; r++) {
+        for (k = 0; k < nk_; k++) {
+            if (tid_map[k] != tid)
+                continue;
+            const cplx *src = A.data().block(k);
+            for (size_t s = 0; s < rank_offsets_[r].size(); s++)
+                for (ab = 0; ab < es_; ab++)
+                    sendbuf[i++] = src[rank_offsets_[r][s] + ab];
+        }
+    }
+    MPI_Alltoallv(sendbuf.data(), scount.data(), sdispl.data(), mpi_complex_datatype<T>(),
+                  recvbuf.data(), rcount.data(), rdispl.data(), mpi_complex_datatype<T>(),
+                  MPI_COMM_WORLD);
+    i = 0;
+    for (r = 0; r < ntasks; r++) {
+        for (k = 0; k < nk_; k++) {
+            if (tid_map[k] != r)
+                continue;
+            for (l = 0; l < nloc; l++)
+                for (ab = 0; ab < es_; ab++)
+                    buf[(l * es_ + ab) * nk_ + pos_[k]] = recvbuf[i++];
+        }
+    }
+#else
+    assert(ntasks == 1);
+#endif
+}
+
+/// @private
+// inverse of to_lattice: buf -> owned blocks of C
+template <typename T>
+void lattice_convolution<T>::to_blocks(std::vector<cplx> &buf,
+                                       distributed_timestep_array<T> &C) {
+    int ntasks = C.ntasks(), tid = C.tid(), k, l, ab, r;
+    const std::vector<int> &tid_map = C.data().tid_map();
+    const std::vector<int> &loc = rank_offsets_[tid];
+    int nloc = loc.size();
+    if (ntasks == 1) {
+        for (k = 0; k < nk_; k++) {
+            cplx *dst = C.block(k);
+            for (l = 0; l < nloc; l++)
+                for (ab = 0; ab < es_; ab++)
+                    dst[loc[l] + ab] = buf[(l * es_ + ab) * nk_ + pos_[k]];
+        }
+        return;
+    }
+#if CNTR_USE_MPI == 1
+    std::vector<int> nown(ntasks, 0), scount(ntasks), sdispl(ntasks), rcount(ntasks), rdispl(ntasks);
+    for (k = 0; k < nk_; k++)
+        nown[tid_map[k]]++;
+    int stot = 0, rtot = 0;
+    for (r = 0; r < ntasks; r++) {
+        scount[r] = nown[r] * nloc * es_;
+        rcount[r] = nown[tid] * rank_offsets_[r].size() * es_;
+        sdispl[r] = stot;
+        rdispl[r] = rtot;
+        stot += scount[r];
+        rtot += rcount[r];
+    }
+    std::vector<cplx> sendbuf(stot), recvbuf(rtot);
+    int i = 0;
+    for (r = 0; r < ntasks; r++) {
+        for (k = 0; k < nk_; k++) {
+            if (tid_map[k] != r)
+                continue;
+            for (l = 0; l < nloc; l++)
+                for (ab = 0; ab < es_; ab++)
+                    sendbuf[i++] = buf[(l * es_ + ab) * nk_ + pos_[k]];
+        }
+    }
+    MPI_Alltoallv(sendbuf.data(), scount.data(), sdispl.data(), mpi_complex_datatype<T>(),
+                  recvbuf.data(), rcount.data(), rdispl.data(), mpi_complex_datatype<T>(),
+                  MPI_COMM_WORLD);
+    i = 0;
+    for (r = 0; r < ntasks; r++) {
+        for (k = 0; k < nk_; k++) {
+            if (tid_map[k] != tid)
+                continue;
+            cplx *dst = C.block(k);
+            for (size_t s = 0; s < rank_offsets_[r].size(); s++)
+                for (ab = 0; ab < es_; ab++)
+                    dst[rank_offsets_[r][s] + ab] = recvbuf[i++];
+        }
+    }
+#else
+    assert(ntasks == 1);
+#endif
+}
+
+/// @private
+// multidimensional FFT of one function on the (row-major) grid
+template <typename T>
+void lattice_convolution<T>::fft_lattice(cplx *x, int sign) {
+    int nd = dims_.size(), stride = nk_;
+    for (int d = 0; d < nd; d++) {
+        int n = dims_[d];
+        stride /= n;
+        if (n == 1)
+            continue;
+        line_.resize(n);
+        for (int o = 0; o < nk_; o += n * stride) {
+            for (int i = 0; i < stride; i++) {
+                cplx *xx = x + o + i;
+                for (int j = 0; j < n; j++)
+                    line_[j] = xx[j * stride];
+                plans_[d].transform(&line_[0], sign);
+                for (int j = 0; j < n; j++)
+                    xx[j * stride] = line_[j];
+            }
+        }
+    }
+}
+
+/// @private
+template <typename T>
+void lattice_convolution<T>::fft_rows(std::vector<cplx> &buf, int sign) {
+    int nrow = buf.size() / nk_;
+    for (int i = 0; i < nrow; i++)
+        fft_lattice(&buf[i * nk_], sign);
+}
+
+/* #######################################################################################
+#
+#   LATTICE BUBBLES
+#
+########################################################################################*/
+
+/** \brief <b> Lattice sum \f$ C_{ab}(q;t,t') = \frac{w}{N_k}\sum_k i A_{ab}(k-q;t,t') B_{ba}(k;t',t) \f$ on a timestep. </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Evaluates the momentum sum of `cntr::Bubble1(tstp,C,a,b,A,a,b,B,a,b)` (for all orbital
+* > indices \f$ a,b \f$) by FFT. For instance, the polarization
+* > \f$ P(q) = -\frac{1}{N_k}\sum_k i G(k-q;t,t')G(k;t',t) \f$ is obtained with `weight=-1`.
+* > Every rank must pass the blocks it owns; the owned blocks of `C` are overwritten.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > [int] Timestep
+* @param C
+* > [distributed_timestep_array] Result
+* @param A
+* > [distributed_timestep_array] Function at momentum \f$ k-q \f$
+* @param B
+* > [distributed_timestep_array] Function at momentum \f$ k \f$
+* @param weight
+* > [T] Prefactor \f$ w \f$
+*/
+template <typename T>
+void lattice_convolution<T>::Bubble1(int tstp, distributed_timestep_array<T> &C,
+                                     distributed_timestep_array<T> &A,
+                                     distributed_timestep_array<T> &B, T weight) {
+    assert(A.n() == nk_ && B.n() == nk_ && C.n() == nk_);
+    assert(tstp == A.tstp() && tstp == B.tstp() && tstp == C.tstp());
+    assert(A.ntau() == B.ntau() && A.ntau() == C.ntau());
+    assert(A.size() == B.size() && A.size() == C.size());
+    assert(A.data().tid_map() == B.data().tid_map() && A.data().tid_map() == C.data().tid_map());
+    int size = A.size(), a, b, R;
+    T sigb = B.sig();
+    cplx ii(0.0, 1.0);
+    std::vector<cplx> abuf, bbuf;
+    set_slices(tstp, A);
+    to_lattice(A, abuf);
+    to_lattice(B, bbuf);
+    fft_rows(abuf, 1);
+    fft_rows(bbuf, 1);
+    std::vector<cplx> cbuf(abuf.size());
+    // both forward transforms are unnormalized
+    cplx fac = weight / ((T)nk_ * (T)nk_);
+    // real space: C(R) = ii * A(-R;t,t') * B(R;t',t), the conjugate partner of X(R) is X(-R)
+    for (size_t p = 0; p < pairs_.size(); p++) {
+        int type = pairs_[p][0], s1 = pairs_[p][1], s2 = pairs_[p][2];
+        for (a = 0; a < size; a++) {
+            for (b = 0; b < size; b++) {
+                int ab = a * size + b, ba = b * size + a;
+                if (type == 0) {
+                    // s1: ret(tstp,m), s2: les(m,tstp)
+                    const cplx *aret12 = &abuf[(s1 * es_ + ab) * nk_];
+                    const cplx *ales12 = &abuf[(s2 * es_ + ab) * nk_];
+                    const cplx *ales21 = &abuf[(s2 * es_ + ba) * nk_];
+                    const cplx *bret12 = &bbuf[(s1 * es_ + ab) * nk_];
+                    const cplx *bret21 = &bbuf[(s1 * es_ + ba) * nk_];
+                    const cplx *bles12 = &bbuf[(s2 * es_ + ab) * nk_];
+                    const cplx *bles21 = &bbuf[(s2 * es_ + ba) * nk_];
+                    cplx *cret = &cbuf[(s1 * es_ + ab) * nk_];
+                    cplx *cles = &cbuf[(s2 * es_ + ab) * nk_];
+                    for (R = 0; R < nk_; R++) {
+                        int mR = neg_[R];
+                        cplx bles21_tt1 = -std::conj(bles12[mR]);
+                        cplx bgtr21_tt1 = bret21[R] + bles21_tt1;
+                        cplx bles21_t1t = bles21[R];
+                        cplx bgtr21_t1t = -std::conj(bret12[mR]) + bles21_t1t;
+                        cplx ales12_tt1 = -std::conj(ales21[R]);
+                        cplx agtr12_tt1 = aret12[mR] + ales12_tt1;
+                        cret[R] = fac * ii * (agtr12_tt1 * bles21_t1t - ales12_tt1 * bgtr21_t1t);
+                        cles[R] = fac * ii * ales12[mR] * bgtr21_tt1;
+                    }
+                } else {
+                    // tv(m),tv(ntau-m) [type 1] or mat(m),mat(ntau-m) [type 2]
+                    for (int i = 0; i < 2; i++) {
+                        int sc = (i == 0 ? s1 : s2), sp = (i == 0 ? s2 : s1);
+                        if (i == 1 && s1 == s2)
+                            break;
+                        const cplx *ax = &abuf[(sc * es_ + ab) * nk_];
+                        cplx *cx = &cbuf[(sc * es_ + ab) * nk_];
+                        if (type == 1) {
+                            const cplx *btv = &bbuf[(sp * es_ + ab) * nk_];
+                            for (R = 0; R < nk_; R++)
+                                cx[R] = fac * ii * ax[neg_[R]] * (-sigb) * std::conj(btv[neg_[R]]);
+                        } else {
+                            const cplx *bmat = &bbuf[(sp * es_ + ba) * nk_];
+                            for (R = 0; R < nk_; R++)
+                                cx[R] = fac * (-sigb) * ax[neg_[R]] * bmat[R];
+                        }
+                    }
+                }
+            }
+        }
+    }
+    fft_rows(cbuf, -1);
+    to_blocks(cbuf, C);
+}
+
+/** \brief <b> Lattice sum \f$ C_{ab}(k;t,t') = \frac{w}{N_k}\sum_q i A_{ab}(k-q;t,t') B_{ab}(q;t,t') \f$ on a timestep. </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Evaluates the momentum sum of `cntr::Bubble2(tstp,C,a,b,A,a,b,B,a,b)` (for all orbital
+* > indices \f$ a,b \f$) by FFT. For instance, the GW self-energy
+* > \f$ \Sigma(k) = \frac{1}{N_k}\sum_q i G(k-q;t,t')W(q;t,t') \f$ is obtained with `weight=1`.
+* > Every rank must pass the blocks it owns; the owned blocks of `C` are overwritten.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > [int] Timestep
+* @param C
+* > [distributed_timestep_array] Result
+* @param A
+* > [distributed_timestep_array] Function at momentum \f$ k-q \f$
+* @param B
+* > [distributed_timestep_array] Function at momentum \f$ q \f$
+* @param weight
+* > [T] Prefactor \f$ w \f$
+*/
+template <typename T>
+void lattice_convolution<T>::Bubble2(int tstp, distributed_timestep_array<T> &C,
+                                     distributed_timestep_array<T> &A,
+                                     distributed_timestep_array<T> &B, T weight) {
+    assert(A.n() == nk_ && B.n() == nk_ && C.n() == nk_);
+    assert(tstp == A.tstp() && tstp == B.tstp() && tstp == C.tstp());
+    assert(A.ntau() == B.ntau() && A.ntau() == C.ntau());
+    assert(A.size() == B.size() && A.size() == C.size());
+    assert(A.data().tid_map() == B.data().tid_map() && A.data().tid_map() == C.data().tid_map());
+    int size = A.size(), a, b, R;
+    cplx ii(0.0, 1.0);
+    std::vector<cplx> abuf, bbuf;
+    set_slices(tstp, A);
+    to_lattice(A, abuf);
+    to_lattice(B, bbuf);
+    fft_rows(abuf, 1);
+    fft_rows(bbuf, 1);
+    std::vector<cplx> cbuf(abuf.size());
+    // both forward transforms are unnormalized
+    cplx fac = weight / ((T)nk_ * (T)nk_);
+    // real space: C(R) = ii * A(R;t,t') * B(R;t,t'), the conjugate partner of X(R) is X(-R)
+    for (size_t p = 0; p < pairs_.size(); p++) {
+        int type = pairs_[p][0], s1 = pairs_[p][1], s2 = pairs_[p][2];
+        for (a = 0; a < size; a++) {
+            for (b = 0; b < size; b++) {
+                int ab = a * size + b, ba = b * size + a;
+                if (type == 0) {
+                    // s1: ret(tstp,m), s2: les(m,tstp)
+                    const cplx *aret12 = &abuf[(s1 * es_ + ab) * nk_];
+                    const cplx *ales12 = &abuf[(s2 * es_ + ab) * nk_];
+                    const cplx *ales21 = &abuf[(s2 * es_ + ba) * nk_];
+                    const cplx *bret12 = &bbuf[(s1 * es_ + ab) * nk_];
+                    const cplx *bles12 = &bbuf[(s2 * es_ + ab) * nk_];
+                    const cplx *bles21 = &bbuf[(s2 * es_ + ba) * nk_];
+                    cplx *cret = &cbuf[(s1 * es_ + ab) * nk_];
+                    cplx *cles = &cbuf[(s2 * es_ + ab) * nk_];
+                    for (R = 0; R < nk_; R++) {
+                        int mR = neg_[R];
+                        cplx accles = std::conj(ales21[mR]);
+                        cplx bccles = std::conj(bles21[mR]);
+                        cplx agtr12_tt1 = aret12[R] - accles;
+                        cplx bgtr12_tt1 = bret12[R] - bccles;
+                        cret[R] = fac * ii * (agtr12_tt1 * bgtr12_tt1 - accles * bccles);
+                        cles[R] = fac * ii * ales12[R] * bles12[R];
+                    }
+                } else {
+                    // tv(m),tv(ntau-m) [type 1] or mat(m),mat(ntau-m) [type 2]
+                    for (int i = 0; i < 2; i++) {
+                        int sc = (i == 0 ? s1 : s2);
+                        if (i == 1 && s1 == s2)
+                            break;
+                        const cplx *ax = &abuf[(sc * es_ + ab) * nk_];
+                        const cplx *bx = &bbuf[(sc * es_ + ab) * nk_];
+                        cplx *cx = &cbuf[(sc * es_ + ab) * nk_];
+                        cplx f = (type == 1 ? fac * ii : -fac);
+                        for (R = 0; R < nk_; R++)
+                            cx[R] = f * ax[R] * bx[R];
+                    }
+                }
+            }
+        }
+    }
+    fft_rows(cbuf, -1);
+    to_blocks(cbuf, C);
+}
+
+}  // namespace cntr
+
+#endif  // CNTR_LATTICE_CONVOLUTION_IMPL_H
@@ -0,0 +1,79 @@
+#ifndef CNTR_MATSUBARA_FFT_DECL_H
+#define CNTR_MATSUBARA_FFT_DECL_H
+
+#include "cntr_global_settings.hpp"
+#include "cntr_lattice_convolution_decl.hpp"
+
+namespace cntr {
+
+template <typename T> class herm_matrix;
+template <typename T> class function;
+
+// default number of high-frequency moments fitted in matsubara_fft
+#define CNTR_MATSUBARA_FFT_ORDER 6
+
+/** \brief <b> Class `matsubara_fft` transforms Matsubara functions between the uniform
+ * imaginary-time grid and the Matsubara frequencies by FFT, with high-order tail fitting.</b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ *  For \f$ f(\tau) \f$ on \f$ \tau_r=r\beta/n_\tau \f$, the moments \f$ f_j \f$ of
+ *  \f$ f(i\omega_n)=\int_0^\beta d\tau e^{i\omega_n\tau}f(\tau)
+ *  \simeq \sum_{j\geq 1} f_j/(i\omega_n)^j \f$ are determined by the jumps
+ *  \f$ \sigma f^{(j-1)}(\beta)-f^{(j-1)}(0) \f$ of the derivatives, which are fitted by one-sided
+ *  finite differences. A sum of poles \f$ t(i\omega_n)=\sum_k c_k/(i\omega_n-\epsilon_k) \f$
+ *  with the moments \f$ f_1,\dots,f_p \f$ is subtracted, so that \f$ f-t \f$ is smooth and
+ *  (anti-)periodic to order \f$ p \f$ = `order()` and its trapezoidal FFT is accurate to
+ *  \f$ O(\omega_\mathrm{max}^{-p-1}) \f$. The inverse transform subtracts and adds back the
+ *  tail in the same way. Both directions cost \f$ O(n_\tau\log n_\tau) \f$ per matrix element
+ *  for any \f$ n_\tau \f$, see `fft_plan`.
+ *
+ *  The `ntau()` frequencies are stored in FFT order: index \f$ m \f$ corresponds to
+ *  \f$ \omega_n \f$ with \f$ n=m \f$ for \f$ m<n_\tau-n_\tau/2 \f$ and \f$ n=m-n_\tau \f$ otherwise;
+ *  values have layout `fw[m*size1*size1]`, moments `mom[(j-1)*size1*size1]`.
+ *  The object is immutable after construction and can be reused, e.g. in every iteration
+ *  of a self-consistency loop, see `dyson`.
+ */
+template <typename T>
+class matsubara_fft {
+  public:
+    typedef std::complex<T> cplx;
+    matsubara_fft();
+    matsubara_fft(int ntau, T beta, int sig, int size1, int order = CNTR_MATSUBARA_FFT_ORDER);
+    int ntau(void) const { return ntau_; }
+    T beta(void) const { return beta_; }
+    int sig(void) const { return sig_; }
+    int size1(void) const { return size1_; }
+    int order(void) const { return order_; }
+    /** \brief <b> Matsubara index \f$ n \f$ of the frequency stored at position `m` </b> */
+    int frequency_index(int m) const { return (m < ntau_ - ntau_ / 2 ? m : m - ntau_); }
+    T omega(int m) const;
+    void to_frequency(const cplx *ftau, cplx *fw, cplx *mom) const;
+    void to_tau(const cplx *fw, const cplx *mom, int nmom, cplx *ftau) const;
+    void dyson(herm_matrix<T> &G, T mu, cdmatrix &H, herm_matrix<T> &Sigma) const;
+
+  private:
+    void tail(const cplx *mom, int nmom, std::vector<T> &gtau, std::vector<cplx> &gw,
+              std::vector<cplx> &coef) const;
+    int ntau_;
+    T beta_;
+    int sig_;
+    int size1_;
+    int order_;
+    fft_plan<T> fft_;               /*!< FFT of length ntau, copied by each thread */
+    std::vector<T> dweight_;        /*!< one-sided derivative weights, [l*(order+3)+i] */
+};
+
+template <typename T>
+void dyson_mat_fft(herm_matrix<T> &G, herm_matrix<T> &Sigma, T mu, function<T> &H, T beta,
+                   int order = CNTR_MATSUBARA_FFT_ORDER);
+template <typename T>
+void dyson_mat_fft(herm_matrix<T> &G, herm_matrix<T> &Sigma, T mu, function<T> &H,
+                   function<T> &SigmaMF, T beta, int order = CNTR_MATSUBARA_FFT_ORDER);
+
+}  // namespace cntr
+
+#endif  // CNTR_MATSUBARA_FFT_DECL_H
@@ -0,0 +1,14 @@
+#include "cntr_matsubara_fft_extern_templates.hpp"
+#include "cntr_herm_matrix_impl.hpp"
+#include "cntr_function_impl.hpp"
+#include "cntr_matsubara_fft_impl.hpp"
+
+namespace cntr {
+
+  template class matsubara_fft<double>;
+  template void dyson_mat_fft<double>(herm_matrix<double> &G, herm_matrix<double> &Sigma,
+    double mu, function<double> &H, double beta, int order);
+  template void dyson_mat_fft<double>(herm_matrix<double> &G, herm_matrix<double> &Sigma,
+    double mu, function<double> &H, function<double> &SigmaMF, double beta, int order);
+
+}  // namespace cntr
@@ -0,0 +1,16 @@
+#ifndef CNTR_MATSUBARA_FFT_EXTERN_TEMPLATES_H
+#define CNTR_MATSUBARA_FFT_EXTERN_TEMPLATES_H
+
+#include "cntr_matsubara_fft_decl.hpp"
+
+namespace cntr {
+
+  extern template class matsubara_fft<double>;
+  extern template void dyson_mat_fft<double>(herm_matrix<double> &G, herm_matrix<double> &Sigma,
+    double mu, function<double> &H, double beta, int order);
+  extern template void dyson_mat_fft<double>(herm_matrix<double> &G, herm_matrix<double> &Sigma,
+    double mu, function<double> &H, function<double> &SigmaMF, double beta, int order);
+
+}  // namespace cntr
+
+#endif  // CNTR_MATSUBARA_FFT_EXTERN_TEMPLATES_H
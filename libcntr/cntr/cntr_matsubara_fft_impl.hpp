@@ -0,0 +1,422 @@
+#ifndef CNTR_MATSUBARA_FFT_IMPL_H
+#define CNTR_MATSUBARA_FFT_IMPL_H
+
+#include "cntr_matsubara_fft_decl.hpp"
+#include "cntr_elements.hpp"
+#include "cntr_herm_matrix_decl.hpp"
+#include "cntr_function_decl.hpp"
+#include "cntr_lattice_convolution_decl.hpp"
+
+namespace cntr {
+
+/// @private
+/** \brief <b> Finite-difference weights (Fornberg's algorithm). </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > \f$ f^{(l)}(z) \approx \sum_{i=0}^{n-1} c_{l,i} f(x_i) \f$ for \f$ l=0,\dots,nder-1 \f$,
+ * > exact for polynomials of degree \f$ n-1 \f$. On return `c[l*n+i]` \f$ = c_{l,i} \f$.
+ */
+template <typename T>
+void matsubara_fft_fd_weights(T z, int n, const T *x, int nder, T *c) {
+    int i, j, l, mn;
+    T c1 = 1.0, c2, c3, c4 = x[0] - z, c5;
+    for (l = 0; l < nder * n; l++)
+        c[l] = 0.0;
+    c[0] = 1.0;
+    for (i = 1; i < n; i++) {
+        mn = (i < nder - 1 ? i : nder - 1);
+        c2 = 1.0;
+        c5 = c4;
+        c4 = x[i] - z;
+        for (j = 0; j < i; j++) {
+            c3 = x[i] - x[j];
+            c2 *= c3;
+            if (j == i - 1) {
+                for (l = mn; l >= 1; l--)
+                    c[l * n + i] = c1 * (l * c[(l - 1) * n + i - 1] - c5 * c[l * n + i - 1]) / c2;
+                c[i] = -c1 * c5 * c[i - 1] / c2;
+            }
+            for (l = mn; l >= 1; l--)
+                c[l * n + j] = (c4 * c[l * n + j] - l * c[(l - 1) * n + j]) / c3;
+            c[j] = c4 * c[j] / c3;
+        }
+        c1 = c2;
+    }
+}
+
+template <typename T>
+matsubara_fft<T>::matsubara_fft() {
+    ntau_ = 0;
+    beta_ = 0.0;
+    sig_ = -1;
+    size1_ = 0;
+    order_ = 0;
+}
+/** \brief <b> Initializes the transforms for a given grid. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Precomputes the one-sided derivative weights (\f$ p+3 \f$ points) and the FFT plan.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param ntau
+ * > [int] Number of imaginary-time intervals, `ntau >= order+3`.
+ * @param beta
+ * > [T] Inverse temperature.
+ * @param sig
+ * > [int] Bose (1) or Fermi (-1) statistics.
+ * @param size1
+ * > [int] Matrix size.
+ * @param order
+ * > [int] Number \f$ p \f$ of fitted moments.
+ */
+template <typename T>
+matsubara_fft<T>::matsubara_fft(int ntau, T beta, int sig, int size1, int order) {
+    int np = order + 3, i;
+    assert(sig * sig == 1 && size1 > 0 && beta > 0.0);
+    assert(order >= 1 && ntau >= np && "ntau >= order+3");
+    ntau_ = ntau;
+    beta_ = beta;
+    sig_ = sig;
+    size1_ = size1;
+    order_ = order;
+    // one-sided derivatives at x=0 from the points 0,...,np-1
+    std::vector<T> x(np);
+    for (i = 0; i < np; i++)
+        x[i] = i;
+    dweight_.resize(order * np);
+    matsubara_fft_fd_weights<T>(0.0, np, x.data(), order, dweight_.data());
+    fft_ = fft_plan<T>(ntau);
+}
+/** \brief <b> Matsubara frequency \f$ \omega_n \f$ stored at position `m` </b> */
+template <typename T>
+T matsubara_fft<T>::omega(int m) const {
+    return CNTR_PI / beta_ * (2 * frequency_index(m) + (sig_ == -1 ? 1 : 0));
+}
+/// @private
+/** \brief <b> Sum-of-poles tail with given moments. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Determines \f$ t(\tau)=\sum_{k} c_k g_k(\tau) \f$, \f$ k=1,\dots,nmom \f$, where
+ * > \f$ g_k(i\omega_n)=1/(i\omega_n-\epsilon_k) \f$ has the moments \f$ \epsilon_k^{j-1} \f$
+ * > and \f$ \sum_k c_k\epsilon_k^{j-1}=f_j \f$. The poles are Chebyshev nodes in
+ * > \f$ [-W,W] \f$, with \f$ W \f$ estimated from the growth of the moments. Unlike
+ * > polynomials in \f$ \tau \f$, the \f$ g_k \f$ are bounded by 1 for any \f$ \beta \f$.
+ * > On return `gtau[k*(ntau+1)+r]` \f$ =g_k(\tau_r) \f$ (with \f$ \tau_{n_\tau}=\beta^- \f$),
+ * > `gw[k*ntau+m]` \f$ =g_k(i\omega_m) \f$, and `coef[k*size1*size1]` \f$ =c_k \f$.
+ */
+template <typename T>
+void matsubara_fft<T>::tail(const cplx *mom, int nmom, std::vector<T> &gtau,
+                            std::vector<cplx> &gw, std::vector<cplx> &coef) const {
+    typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> rmat;
+    typedef Eigen::Matrix<cplx, Eigen::Dynamic, Eigen::Dynamic> vmat;
+    int es = size1_ * size1_, N = ntau_, k, j, e, r, m;
+    gtau.resize(nmom * (N + 1));
+    gw.resize(nmom * N);
+    coef.resize(nmom * es);
+    if (nmom == 0)
+        return;
+    // scale of the poles
+    std::vector<T> norm(nmom, 0.0);
+    for (j = 0; j < nmom; j++)
+        for (e = 0; e < es; e++)
+            norm[j] += std::norm(mom[j * es + e]);
+    T w = CNTR_PI / beta_;
+    for (j = 1; j < nmom; j++)
+        if (norm[0] > 0.0)
+            w = std::max(w, (T)pow(sqrt(norm[j] / norm[0]), 1.0 / j));
+    // Chebyshev nodes of an even number of points, so that no pole is at zero
+    int neven = nmom + nmom % 2;
+    std::vector<T> eps(nmom);
+    rmat vander(nmom, nmom);
+    for (k = 0; k < nmom; k++) {
+        eps[k] = w * cos(CNTR_PI * (k + 0.5) / neven);
+        for (j = 0; j < nmom; j++)
+            vander(j, k) = pow(eps[k], j);
+        for (r = 0; r <= N; r++) {
+            T tau = beta_ * r / N, x;
+            // -exp(-eps tau)/(1-sig exp(-eps beta)), written without overflow
+            if (eps[k] >= 0.0)
+                x = -exp(-eps[k] * tau) / (1.0 - sig_ * exp(-eps[k] * beta_));
+            else
+                x = -exp(eps[k] * (beta_ - tau)) / (exp(eps[k] * beta_) - sig_);
+            gtau[k * (N + 1) + r] = x;
+        }
+        for (m = 0; m < N; m++)
+            gw[k * N + m] = 1.0 / cplx(-eps[k], omega(m));
+    }
+    vmat rhs(nmom, es);
+    for (j = 0; j < nmom; j++)
+        for (e = 0; e < es; e++)
+            rhs(j, e) = mom[j * es + e];
+    vmat c = vander.template cast<cplx>().fullPivLu().solve(rhs);
+    for (k = 0; k < nmom; k++)
+        for (e = 0; e < es; e++)
+            coef[k * es + e] = c(k, e);
+}
+/** \brief <b> Transforms \f$ f(\tau) \f$ to the Matsubara frequencies. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Computes \f$ f(i\omega_n)=\int_0^\beta d\tau e^{i\omega_n\tau}f(\tau) \f$ for the `ntau()`
+ * > frequencies and the moments \f$ f_1,\dots,f_p \f$.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param ftau
+ * > [complex<T>*] \f$ f(\tau_r) \f$, layout `ftau[r*size1*size1]`, \f$ r=0,\dots,n_\tau \f$,
+ * > e.g. `G.matptr(0)`.
+ * @param fw
+ * > [complex<T>*] On return, \f$ f(i\omega_n) \f$.
+ * @param mom
+ * > [complex<T>*] On return, the moments \f$ f_j \f$, \f$ j=1,\dots,p \f$.
+ */
+template <typename T>
+void matsubara_fft<T>::to_frequency(const cplx *ftau, cplx *fw, cplx *mom) const {
+    int es = size1_ * size1_, np = order_ + 3, N = ntau_, p = order_;
+    T dtau = beta_ / N;
+    std::vector<T> gtau;
+    std::vector<cplx> gw, coef, phase(N);
+    for (int r = 0; r < N; r++)
+        phase[r] = dtau * std::polar((T)1.0, (T)(sig_ == -1 ? CNTR_PI * r / N : 0.0));
+    // moments from the jumps of the derivatives
+#if CNTR_USE_OMP == 1
+#pragma omp parallel for
+#endif
+    for (int e = 0; e < es; e++) {
+        T scale = 1.0;
+        for (int l = 0; l < p; l++) {
+            cplx d0 = 0.0, d1 = 0.0;
+            for (int i = 0; i < np; i++) {
+                d0 += dweight_[l * np + i] * ftau[i * es + e];
+                d1 += dweight_[l * np + i] * ftau[(N - i) * es + e];
+            }
+            // points beta-i*dtau: d/dtau = -d/dx
+            if (l % 2 == 1)
+                d1 = -d1;
+            mom[l * es + e] = (l % 2 == 1 ? -scale : scale) * (((T)sig_) * d1 - d0);
+            scale /= dtau;
+        }
+    }
+    tail(mom, p, gtau, gw, coef);
+    // trapezoidal FFT of f-t
+#if CNTR_USE_OMP == 1
+#pragma omp parallel
+#endif
+    {
+        std::vector<cplx> x(N);
+        fft_plan<T> fft(fft_);
+#if CNTR_USE_OMP == 1
+#pragma omp for
+#endif
+        for (int e = 0; e < es; e++) {
+            cplx gN = ftau[N * es + e];
+            for (int k = 0; k < p; k++)
+                gN -= coef[k * es + e] * gtau[k * (N + 1) + N];
+            for (int r = 0; r < N; r++) {
+                cplx g = ftau[r * es + e];
+                for (int k = 0; k < p; k++)
+                    g -= coef[k * es + e] * gtau[k * (N + 1) + r];
+                x[r] = (r == 0 ? 0.5 * (g + ((T)sig_) * gN) : g) * phase[r];
+            }
+            fft.transform(x.data(), 1);
+            for (int m = 0; m < N; m++) {
+                cplx z = x[m];
+                for (int k = 0; k < p; k++)
+                    z += coef[k * es + e] * gw[k * N + m];
+                fw[m * es + e] = z;
+            }
+        }
+    }
+}
+/** \brief <b> Transforms \f$ f(i\omega_n) \f$ to imaginary time. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Computes \f$ f(\tau_r)=\frac{1}{\beta}\sum_n e^{-i\omega_n\tau_r} f(i\omega_n) \f$, where a
+ * > tail with the moments \f$ f_1,\dots,f_{nmom} \f$ is summed over all frequencies exactly
+ * > and the remainder over the `ntau()` stored frequencies.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param fw
+ * > [complex<T>*] \f$ f(i\omega_n) \f$.
+ * @param mom
+ * > [complex<T>*] The moments \f$ f_j \f$, \f$ j=1,\dots,nmom \f$.
+ * @param nmom
+ * > [int] Number of moments, at most `order()+1`.
+ * @param ftau
+ * > [complex<T>*] On return, \f$ f(\tau_r) \f$, \f$ r=0,\dots,n_\tau \f$.
+ */
+template <typename T>
+void matsubara_fft<T>::to_tau(const cplx *fw, const cplx *mom, int nmom, cplx *ftau) const {
+    int es = size1_ * size1_, N = ntau_;
+    assert(nmom >= 0 && nmom <= order_ + 1 && "nmom <= order+1");
+    std::vector<T> gtau;
+    std::vector<cplx> gw, coef, phase(N);
+    for (int r = 0; r < N; r++)
+        phase[r] = std::polar((T)(1.0 / beta_), (T)(sig_ == -1 ? -CNTR_PI * r / N : 0.0));
+    tail(mom, nmom, gtau, gw, coef);
+#if CNTR_USE_OMP == 1
+#pragma omp parallel
+#endif
+    {
+        std::vector<cplx> x(N);
+        fft_plan<T> fft(fft_);
+#if CNTR_USE_OMP == 1
+#pragma omp for
+#endif
+        for (int e = 0; e < es; e++) {
+            for (int m = 0; m < N; m++) {
+                cplx z = fw[m * es + e];
+                for (int k = 0; k < nmom; k++)
+                    z -= coef[k * es + e] * gw[k * N + m];
+                x[m] = z;
+            }
+            fft.transform(x.data(), -1);
+            for (int r = 0; r <= N; r++) {
+                cplx z = (r < N ? x[r] * phase[r] : ((T)sig_) * x[0] / beta_);
+                for (int k = 0; k < nmom; k++)
+                    z += coef[k * es + e] * gtau[k * (N + 1) + r];
+                ftau[r * es + e] = z;
+            }
+        }
+    }
+}
+/** \brief <b> Solves the Matsubara Dyson equation in frequency space. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Computes \f$ G(i\omega_n)=[i\omega_n+\mu-H-\Sigma(i\omega_n)]^{-1} \f$ for all stored
+ * > frequencies (in parallel, one LU decomposition per frequency in a per-thread workspace)
+ * > and transforms back with the moments \f$ g_1=1 \f$,
+ * > \f$ g_{j+1}=(H-\mu)g_j+\sum_{l=1}^{j-1}\Sigma_l g_{j-l} \f$, \f$ j\leq p \f$, of \f$ G \f$.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix] On return, the Matsubara component of the solution.
+ * @param mu
+ * > [T] Chemical potential.
+ * @param H
+ * > [cdmatrix] Hamiltonian, including the mean-field self-energy.
+ * @param Sigma
+ * > [herm_matrix] Self-energy.
+ */
+template <typename T>
+void matsubara_fft<T>::dyson(herm_matrix<T> &G, T mu, cdmatrix &H, herm_matrix<T> &Sigma) const {
+    typedef Eigen::Matrix<cplx, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> rmatrix;
+    typedef Eigen::Map<rmatrix> rmap;
+    int es = size1_ * size1_, N = ntau_, p = order_;
+    assert(G.ntau() == N && Sigma.ntau() == N && "ntau");
+    assert(G.size1() == size1_ && Sigma.size1() == size1_ && "size1");
+    assert(G.sig() == sig_ && Sigma.sig() == sig_ && "sig");
+    assert(H.rows() == size1_ && H.cols() == size1_ && "size of H");
+    std::vector<cplx> sw(N * es), gw(N * es), smom(p * es), gmom((p + 1) * es);
+    rmatrix A = H - mu * cdmatrix::Identity(size1_, size1_);
+    to_frequency(Sigma.matptr(0), sw.data(), smom.data());
+    rmap(&gmom[0], size1_, size1_) = rmatrix::Identity(size1_, size1_);
+    for (int j = 1; j <= p; j++) {
+        rmap gj(&gmom[j * es], size1_, size1_);
+        gj = A * rmap(&gmom[(j - 1) * es], size1_, size1_);
+        for (int l = 1; l < j; l++)
+            gj += rmap(&smom[(l - 1) * es], size1_, size1_) *
+                  rmap(&gmom[(j - l - 1) * es], size1_, size1_);
+    }
+#if CNTR_USE_OMP == 1
+#pragma omp parallel
+#endif
+    {
+        rmatrix M(size1_, size1_);
+        Eigen::PartialPivLU<rmatrix> lu(size1_);
+#if CNTR_USE_OMP == 1
+#pragma omp for
+#endif
+        for (int m = 0; m < N; m++) {
+            M = -A - rmap(&sw[m * es], size1_, size1_);
+            M.diagonal().array() += cplx(0.0, omega(m));
+            lu.compute(M);
+            rmap(&gw[m * es], size1_, size1_) = lu.inverse();
+        }
+    }
+    to_tau(gw.data(), gmom.data(), p + 1, G.matptr(0));
+}
+
+/// @private
+/** \brief <b> Matsubara Dyson solver by FFT with tail fitting (`CNTR_MAT_FFT`). </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Solves the same equation as `dyson_mat_fourier` with \f$ O(n_\tau \log n_\tau) \f$
+ * > operations, see `matsubara_fft::dyson`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix] On return, the Matsubara component of the solution.
+ * @param Sigma
+ * > [herm_matrix] Self-energy.
+ * @param mu
+ * > [T] Chemical potential.
+ * @param H
+ * > [function] Hamiltonian; only \f$ H(-1) \f$ is used.
+ * @param beta
+ * > [T] Inverse temperature.
+ * @param order
+ * > [int] Number of fitted moments of \f$ \Sigma \f$.
+ */
+template <typename T>
+void dyson_mat_fft(herm_matrix<T> &G, herm_matrix<T> &Sigma, T mu, function<T> &H, T beta,
+                   int order) {
+    cdmatrix h0;
+    H.get_value(-1, h0);
+    matsubara_fft<T> plan(G.ntau(), beta, G.sig(), G.size1(), order);
+    plan.dyson(G, mu, h0, Sigma);
+}
+/// @private
+/** \brief <b> Matsubara Dyson solver by FFT with tail fitting (`CNTR_MAT_FFT`), with a
+ * mean-field self-energy. </b>
+ */
+template <typename T>
+void dyson_mat_fft(herm_matrix<T> &G, herm_matrix<T> &Sigma, T mu, function<T> &H,
+                   function<T> &SigmaMF, T beta, int order) {
+    cdmatrix h0, smf;
+    H.get_value(-1, h0);
+    SigmaMF.get_value(-1, smf);
+    h0 += smf;
+    matsubara_fft<T> plan(G.ntau(), beta, G.sig(), G.size1(), order);
+    plan.dyson(G, mu, h0, Sigma);
+}
+
+}  // namespace cntr
+
+#endif  // CNTR_MATSUBARA_FFT_IMPL_H
@@ -9,6 +9,15 @@ namespace cntr {
 	template <typename T> class herm_matrix;
 	template <typename T> class herm_matrix_timestep;
 	template <typename T> class herm_matrix_timestep_view;
+	template <typename T> class function;
+
+	/// @private
+	/** \brief <b> Native MPI datatype for `std::complex<T>`. </b> */
+	template <typename T> inline MPI_Datatype mpi_complex_datatype(void);
+	/// @private
+	template <> inline MPI_Datatype mpi_complex_datatype<double>(void) { return MPI_C_DOUBLE_COMPLEX; }
+	/// @private
+	template <> inline MPI_Datatype mpi_complex_datatype<float>(void) { return MPI_C_FLOAT_COMPLEX; }
 
 	template <typename T> void Reduce_timestep(int tstp, int root, herm_matrix_timestep<T> &Gred, 
 		herm_matrix_timestep<T> &G);
@@ -24,6 +33,29 @@ namespace cntr {
 		herm_matrix<T> &G);
 	template <typename T> void Reduce_timestep(int tstp, int root, herm_matrix<T> &Gred, 
 		herm_matrix<T> &G);
+
+	template <typename T> void Allreduce_timestep(int tstp, herm_matrix_timestep<T> &G);
+	template <typename T> void Allreduce_timestep(int tstp, herm_matrix_timestep_view<T> &G);
+	template <typename T> void Allreduce_timestep(int tstp, herm_matrix<T> &G);
+	template <typename T> void Allreduce_timestep(int tstp, function<T> &f);
+
+	template <typename T> void Iallreduce_timestep(int tstp, herm_matrix_timestep<T> &G,
+		std::vector<MPI_Request> &requests);
+	template <typename T> void Iallreduce_timestep(int tstp, herm_matrix_timestep_view<T> &G,
+		std::vector<MPI_Request> &requests);
+	template <typename T> void Iallreduce_timestep(int tstp, herm_matrix<T> &G,
+		std::vector<MPI_Request> &requests);
+	template <typename T> void Iallreduce_timestep(int tstp, function<T> &f,
+		std::vector<MPI_Request> &requests);
+
+	template <typename T> void Reduce_scatter_timestep(int tstp, std::vector<herm_matrix_timestep_view<T> > &G,
+		const std::vector<int> &tid_map);
+	template <typename T> void Reduce_scatter_timestep(int tstp, std::vector<herm_matrix_timestep<T> > &G,
+		const std::vector<int> &tid_map);
+	template <typename T> void Reduce_scatter_timestep(int tstp, std::vector<herm_matrix<T> > &G,
+		const std::vector<int> &tid_map);
+	template <typename T> void Reduce_scatter_timestep(int tstp, std::vector<function<T> > &f,
+		const std::vector<int> &tid_map);
 #endif 
 }
 
@@ -24,6 +24,38 @@ namespace cntr{
 	///@private
 	template void Reduce_timestep<double>(int tstp, int root, herm_matrix<double> &Gred, 
 		herm_matrix<double> &G);
+	///@private
+	template void Allreduce_timestep<double>(int tstp, herm_matrix_timestep<double> &G);
+	///@private
+	template void Allreduce_timestep<double>(int tstp, herm_matrix_timestep_view<double> &G);
+	///@private
+	template void Allreduce_timestep<double>(int tstp, herm_matrix<double> &G);
+	///@private
+	template void Allreduce_timestep<double>(int tstp, function<double> &f);
+	///@private
+	template void Iallreduce_timestep<double>(int tstp, herm_matrix_timestep<double> &G,
+		std::vector<MPI_Request> &requests);
+	///@private
+	template void Iallreduce_timestep<double>(int tstp, herm_matrix_timestep_view<double> &G,
+		std::vector<MPI_Request> &requests);
+	///@private
+	template void Iallreduce_timestep<double>(int tstp, herm_matrix<double> &G,
+		std::vector<MPI_Request> &requests);
+	///@private
+	template void Iallreduce_timestep<double>(int tstp, function<double> &f,
+		std::vector<MPI_Request> &requests);
+	///@private
+	template void Reduce_scatter_timestep<double>(int tstp, std::vector<herm_matrix_timestep_view<double> > &G,
+		const std::vector<int> &tid_map);
+	///@private
+	template void Reduce_scatter_timestep<double>(int tstp, std::vector<herm_matrix_timestep<double> > &G,
+		const std::vector<int> &tid_map);
+	///@private
+	template void Reduce_scatter_timestep<double>(int tstp, std::vector<herm_matrix<double> > &G,
+		const std::vector<int> &tid_map);
+	///@private
+	template void Reduce_scatter_timestep<double>(int tstp, std::vector<function<double> > &f,
+		const std::vector<int> &tid_map);
 #endif
 
 } // namespace cntr
\ No newline at end of file
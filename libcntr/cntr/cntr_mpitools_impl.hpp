@@ -6,6 +6,7 @@
 #include "cntr_herm_matrix_timestep_decl.hpp"
 #include "cntr_herm_matrix_timestep_view_decl.hpp"
 #include "cntr_herm_matrix_timestep_view_impl.hpp"
+#include "cntr_function_decl.hpp"
 
 namespace cntr{
 
@@ -43,16 +44,10 @@ template <typename T> void Reduce_timestep(int tstp, int root, herm_matrix_times
 		assert(G.size2() == Gred.size2());
 	}
 
-	int len = 2 * (2 * (tstp + 1) + G.ntau() + 1) * G.size1() * G.size2();
+	int len = (2 * (tstp + 1) + G.ntau() + 1) * G.size1() * G.size2();
 
-	if (sizeof(T) == sizeof(double)) {
-		MPI_Reduce((double *)G.data_, (double *)Gred.data_, len, MPI_DOUBLE_PRECISION, MPI_SUM, root,
-           MPI_COMM_WORLD);
-   } else {
-      if (taskid == root) std::cerr << "herm_matrix_timestep<T>::MPI_Reduce only for double " << std::endl;
-      MPI_Finalize();
-      exit(0);
-   }
+	MPI_Reduce(G.data_, Gred.data_, len, mpi_complex_datatype<T>(), MPI_SUM, root,
+		MPI_COMM_WORLD);
 
 }
 
@@ -91,27 +86,17 @@ template <typename T> void Reduce_timestep(int tstp, int root, herm_matrix_times
 		assert(G.size2() == Gred.size2());
 	}
 
-	int len_rt = 2 * (tstp + 1) * G.size1() * G.size2();
-	int len_it = 2 * (G.ntau() + 1) * G.size1() * G.size2();
-
-	if (sizeof(T) == sizeof(double)) {
-		if(tstp == -1){
-			MPI_Reduce((double *)G.mat_, (double *)Gred.mat_, len_it, MPI_DOUBLE_PRECISION, MPI_SUM, root,
-            	MPI_COMM_WORLD);
-		} else{
-			MPI_Reduce((double *)G.les_, (double *)Gred.les_, len_rt, MPI_DOUBLE_PRECISION, MPI_SUM, root,
-            	MPI_COMM_WORLD);
-			MPI_Reduce((double *)G.ret_, (double *)Gred.ret_, len_rt, MPI_DOUBLE_PRECISION, MPI_SUM, root,
-            	MPI_COMM_WORLD);
-			MPI_Reduce((double *)G.tv_, (double *)Gred.tv_, len_it, MPI_DOUBLE_PRECISION, MPI_SUM, root,
-            	MPI_COMM_WORLD);
-		}
-		
-   } else {
-   	  if (taskid == root) std::cerr << "herm_matrix_timestep_view<T>::MPI_Reduce only for double " << std::endl;
-   	  MPI_Finalize();
-      exit(0);
-   }
+	int len_rt = (tstp + 1) * G.size1() * G.size2();
+	int len_it = (G.ntau() + 1) * G.size1() * G.size2();
+	MPI_Datatype dtype = mpi_complex_datatype<T>();
+
+	if(tstp == -1){
+		MPI_Reduce(G.mat_, Gred.mat_, len_it, dtype, MPI_SUM, root, MPI_COMM_WORLD);
+	} else{
+		MPI_Reduce(G.les_, Gred.les_, len_rt, dtype, MPI_SUM, root, MPI_COMM_WORLD);
+		MPI_Reduce(G.ret_, Gred.ret_, len_rt, dtype, MPI_SUM, root, MPI_COMM_WORLD);
+		MPI_Reduce(G.tv_, Gred.tv_, len_it, dtype, MPI_SUM, root, MPI_COMM_WORLD);
+	}
 
 }
 
@@ -330,6 +315,474 @@ template <typename T> void Reduce_timestep(int tstp, int root, herm_matrix<T> &G
 
 
 
+/* #######################################################################################
+#
+#   ALLREDUCE / REDUCE_SCATTER
+#
+########################################################################################*/
+
+/** \brief <b> In-place MPI allreduce for the `herm_matrix_timestep_view` </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > In-place MPI allreduce (sum) of the data pointed to by the `herm_matrix_timestep_view`.
+* > After the call, every rank holds the sum over all ranks. The data is reduced
+* > with the native MPI complex datatype, so both `float` and `double` are supported.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > time step
+* @param G
+* > The `herm_matrix_timestep_view` on the individual ranks; overwritten by the sum.
+*/
+template <typename T> void Allreduce_timestep(int tstp, herm_matrix_timestep_view<T> &G){
+	assert(tstp == G.tstp());
+	int len_rt = (tstp + 1) * G.size1() * G.size2();
+	int len_it = (G.ntau() + 1) * G.size1() * G.size2();
+	MPI_Datatype dtype = mpi_complex_datatype<T>();
+
+	if(tstp == -1){
+		MPI_Allreduce(MPI_IN_PLACE, G.mat_, len_it, dtype, MPI_SUM, MPI_COMM_WORLD);
+	} else{
+		MPI_Allreduce(MPI_IN_PLACE, G.les_, len_rt, dtype, MPI_SUM, MPI_COMM_WORLD);
+		MPI_Allreduce(MPI_IN_PLACE, G.ret_, len_rt, dtype, MPI_SUM, MPI_COMM_WORLD);
+		MPI_Allreduce(MPI_IN_PLACE, G.tv_, len_it, dtype, MPI_SUM, MPI_COMM_WORLD);
+	}
+}
+
+
+/** \brief <b> In-place MPI allreduce for the `herm_matrix_timestep` </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > In-place MPI allreduce (sum) of the `herm_matrix_timestep`. The contiguous
+* > storage is reduced with a single collective call.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > time step
+* @param G
+* > The `herm_matrix_timestep` on the individual ranks; overwritten by the sum.
+*/
+template <typename T> void Allreduce_timestep(int tstp, herm_matrix_timestep<T> &G){
+	assert(tstp == G.tstp());
+	int len = (2 * (tstp + 1) + G.ntau() + 1) * G.size1() * G.size2();
+	MPI_Allreduce(MPI_IN_PLACE, G.data_, len, mpi_complex_datatype<T>(), MPI_SUM, MPI_COMM_WORLD);
+}
+
+
+/** \brief <b> In-place MPI allreduce for the `herm_matrix` at a given time step </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > In-place MPI allreduce (sum) of the time step `tstp` of the `herm_matrix`.
+* > The reduction works directly on the storage of `G`; no temporary copy is made.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > time step
+* @param G
+* > The `herm_matrix` on the individual ranks; time step `tstp` is overwritten by the sum.
+*/
+template <typename T> void Allreduce_timestep(int tstp, herm_matrix<T> &G){
+	assert(tstp <= G.nt());
+	herm_matrix_timestep_view<T> Gtemp(tstp, G);
+	Allreduce_timestep(tstp, Gtemp);
+}
+
+
+/** \brief <b> In-place MPI allreduce for the `function` at a given time step </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > In-place MPI allreduce (sum) of the value of the `function` at time step `tstp`.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > time step
+* @param f
+* > The `function` on the individual ranks; the value at `tstp` is overwritten by the sum.
+*/
+template <typename T> void Allreduce_timestep(int tstp, function<T> &f){
+	assert(-1 <= tstp && tstp <= f.nt());
+	MPI_Allreduce(MPI_IN_PLACE, f.ptr(tstp), f.element_size(), mpi_complex_datatype<T>(),
+		MPI_SUM, MPI_COMM_WORLD);
+}
+
+
+/** \brief <b> Non-blocking in-place MPI allreduce for the `herm_matrix_timestep_view` </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Starts a non-blocking in-place MPI allreduce (sum) of the data pointed to by the
+* > `herm_matrix_timestep_view`. The MPI requests are appended to `requests`; the data
+* > must not be accessed before the requests are completed, e.g. by
+* > `MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE)`.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > time step
+* @param G
+* > The `herm_matrix_timestep_view` on the individual ranks; overwritten by the sum.
+* @param requests
+* > The MPI requests of the started reductions are appended to this vector.
+*/
+template <typename T> void Iallreduce_timestep(int tstp, herm_matrix_timestep_view<T> &G,
+	std::vector<MPI_Request> &requests){
+	assert(tstp == G.tstp());
+	int len_rt = (tstp + 1) * G.size1() * G.size2();
+	int len_it = (G.ntau() + 1) * G.size1() * G.size2();
+	MPI_Datatype dtype = mpi_complex_datatype<T>();
+	MPI_Request req;
+
+	if(tstp == -1){
+		MPI_Iallreduce(MPI_IN_PLACE, G.mat_, len_it, dtype, MPI_SUM, MPI_COMM_WORLD, &req);
+		requests.push_back(req);
+	} else{
+		MPI_Iallreduce(MPI_IN_PLACE, G.les_, len_rt, dtype, MPI_SUM, MPI_COMM_WORLD, &req);
+		requests.push_back(req);
+		MPI_Iallreduce(MPI_IN_PLACE, G.ret_, len_rt, dtype, MPI_SUM, MPI_COMM_WORLD, &req);
+		requests.push_back(req);
+		MPI_Iallreduce(MPI_IN_PLACE, G.tv_, len_it, dtype, MPI_SUM, MPI_COMM_WORLD, &req);
+		requests.push_back(req);
+	}
+}
+
+
+/** \brief <b> Non-blocking in-place MPI allreduce for the `herm_matrix_timestep` </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Starts a non-blocking in-place MPI allreduce (sum) of the `herm_matrix_timestep`.
+* > The MPI request is appended to `requests`.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > time step
+* @param G
+* > The `herm_matrix_timestep` on the individual ranks; overwritten by the sum.
+* @param requests
+* > The MPI request of the started reduction is appended to this vector.
+*/
+template <typename T> void Iallreduce_timestep(int tstp, herm_matrix_timestep<T> &G,
+	std::vector<MPI_Request> &requests){
+	assert(tstp == G.tstp());
+	int len = (2 * (tstp + 1) + G.ntau() + 1) * G.size1() * G.size2();
+	MPI_Request req;
+	MPI_Iallreduce(MPI_IN_PLACE, G.data_, len, mpi_complex_datatype<T>(), MPI_SUM,
+		MPI_COMM_WORLD, &req);
+	requests.push_back(req);
+}
+
+
+/** \brief <b> Non-blocking in-place MPI allreduce for the `herm_matrix` at a given time step </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Starts a non-blocking in-place MPI allreduce (sum) of the time step `tstp` of
+* > the `herm_matrix`. The MPI requests are appended to `requests`.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > time step
+* @param G
+* > The `herm_matrix` on the individual ranks; time step `tstp` is overwritten by the sum.
+* @param requests
+* > The MPI requests of the started reductions are appended to this vector.
+*/
+template <typename T> void Iallreduce_timestep(int tstp, herm_matrix<T> &G,
+	std::vector<MPI_Request> &requests){
+	assert(tstp <= G.nt());
+	herm_matrix_timestep_view<T> Gtemp(tstp, G);
+	Iallreduce_timestep(tstp, Gtemp, requests);
+}
+
+
+/** \brief <b> Non-blocking in-place MPI allreduce for the `function` at a given time step </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Starts a non-blocking in-place MPI allreduce (sum) of the value of the `function`
+* > at time step `tstp`. The MPI request is appended to `requests`.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > time step
+* @param f
+* > The `function` on the individual ranks; the value at `tstp` is overwritten by the sum.
+* @param requests
+* > The MPI request of the started reduction is appended to this vector.
+*/
+template <typename T> void Iallreduce_timestep(int tstp, function<T> &f,
+	std::vector<MPI_Request> &requests){
+	assert(-1 <= tstp && tstp <= f.nt());
+	MPI_Request req;
+	MPI_Iallreduce(MPI_IN_PLACE, f.ptr(tstp), f.element_size(), mpi_complex_datatype<T>(),
+		MPI_SUM, MPI_COMM_WORLD, &req);
+	requests.push_back(req);
+}
+
+
+/// @private
+template <typename T> int timestep_buffer_size(herm_matrix_timestep_view<T> &G){
+	int es = G.size1() * G.size2();
+	if(G.tstp() == -1) return (G.ntau() + 1) * es;
+	return (2 * (G.tstp() + 1) + G.ntau() + 1) * es;
+}
+
+/// @private
+template <typename T> void pack_timestep(herm_matrix_timestep_view<T> &G, std::complex<T> *buf){
+	int es = G.size1() * G.size2();
+	if(G.tstp() == -1){
+		memcpy(buf, G.mat_, sizeof(std::complex<T>) * (G.ntau() + 1) * es);
+	} else{
+		int len_rt = (G.tstp() + 1) * es;
+		memcpy(buf, G.ret_, sizeof(std::complex<T>) * len_rt);
+		memcpy(buf + len_rt, G.les_, sizeof(std::complex<T>) * len_rt);
+		memcpy(buf + 2 * len_rt, G.tv_, sizeof(std::complex<T>) * (G.ntau() + 1) * es);
+	}
+}
+
+/// @private
+template <typename T> void unpack_timestep(herm_matrix_timestep_view<T> &G, std::complex<T> *buf){
+	int es = G.size1() * G.size2();
+	if(G.tstp() == -1){
+		memcpy(G.mat_, buf, sizeof(std::complex<T>) * (G.ntau() + 1) * es);
+	} else{
+		int len_rt = (G.tstp() + 1) * es;
+		memcpy(G.ret_, buf, sizeof(std::complex<T>) * len_rt);
+		memcpy(G.les_, buf + len_rt, sizeof(std::complex<T>) * len_rt);
+		memcpy(G.tv_, buf + 2 * len_rt, sizeof(std::complex<T>) * (G.ntau() + 1) * es);
+	}
+}
+
+
+/** \brief <b> MPI reduce-scatter for a set of `herm_matrix_timestep_view` </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Every rank holds partial contributions to all objects `G[j]`, j=0,...,n-1
+* > (for instance a self-energy for every k-point). After the call, `G[j]` on the
+* > rank `tid_map[j]` holds the sum over all ranks, while `G[j]` on the other ranks
+* > is left unchanged. The ownership `tid_map` has the same meaning as in
+* > `distributed_array::tid_map()`. All objects must have the same layout.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > time step
+* @param G
+* > The set of `herm_matrix_timestep_view`.
+* @param tid_map
+* > `tid_map[j]` is the rank which receives the reduced `G[j]`.
+*/
+template <typename T> void Reduce_scatter_timestep(int tstp, std::vector<herm_matrix_timestep_view<T> > &G,
+	const std::vector<int> &tid_map){
+	int ntasks, taskid;
+	MPI_Comm_size(MPI_COMM_WORLD, &ntasks);
+	MPI_Comm_rank(MPI_COMM_WORLD, &taskid);
+	int n = G.size();
+	assert(n == (int) tid_map.size());
+	if(n == 0) return;
+	for(int j = 0; j < n; j++){
+		assert(tstp == G[j].tstp());
+		assert(0 <= tid_map[j] && tid_map[j] < ntasks);
+	}
+
+	int blocksize = timestep_buffer_size(G[0]);
+	std::vector<int> recvcount(ntasks, 0);
+	for(int j = 0; j < n; j++) recvcount[tid_map[j]] += blocksize;
+
+	// pack the blocks ordered by the receiving rank
+	std::vector<std::complex<T> > sendbuf((size_t) n * blocksize);
+	std::vector<std::complex<T> > recvbuf(recvcount[taskid]);
+	size_t offset = 0;
+	for(int rank = 0; rank < ntasks; rank++){
+		for(int j = 0; j < n; j++){
+			if(tid_map[j] == rank){
+				pack_timestep(G[j], sendbuf.data() + offset);
+				offset += blocksize;
+			}
+		}
+	}
+
+	MPI_Reduce_scatter(sendbuf.data(), recvbuf.data(), recvcount.data(), mpi_complex_datatype<T>(),
+		MPI_SUM, MPI_COMM_WORLD);
+
+	offset = 0;
+	for(int j = 0; j < n; j++){
+		if(tid_map[j] == taskid){
+			unpack_timestep(G[j], recvbuf.data() + offset);
+			offset += blocksize;
+		}
+	}
+}
+
+
+/** \brief <b> MPI reduce-scatter for a set of `herm_matrix_timestep` </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Reduce-scatter of a set of `herm_matrix_timestep`: `G[j]` on rank `tid_map[j]`
+* > receives the sum over all ranks. See the `herm_matrix_timestep_view` variant.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > time step
+* @param G
+* > The set of `herm_matrix_timestep`.
+* @param tid_map
+* > `tid_map[j]` is the rank which receives the reduced `G[j]`.
+*/
+template <typename T> void Reduce_scatter_timestep(int tstp, std::vector<herm_matrix_timestep<T> > &G,
+	const std::vector<int> &tid_map){
+	std::vector<herm_matrix_timestep_view<T> > Gview;
+	Gview.reserve(G.size());
+	for(size_t j = 0; j < G.size(); j++) Gview.push_back(herm_matrix_timestep_view<T>(tstp, G[j]));
+	Reduce_scatter_timestep(tstp, Gview, tid_map);
+}
+
+
+/** \brief <b> MPI reduce-scatter for a set of `herm_matrix` at a given time step </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Reduce-scatter of the time step `tstp` of a set of `herm_matrix`: `G[j]` on rank
+* > `tid_map[j]` receives the sum over all ranks. See the `herm_matrix_timestep_view` variant.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > time step
+* @param G
+* > The set of `herm_matrix`.
+* @param tid_map
+* > `tid_map[j]` is the rank which receives the reduced `G[j]`.
+*/
+template <typename T> void Reduce_scatter_timestep(int tstp, std::vector<herm_matrix<T> > &G,
+	const std::vector<int> &tid_map){
+	std::vector<herm_matrix_timestep_view<T> > Gview;
+	Gview.reserve(G.size());
+	for(size_t j = 0; j < G.size(); j++) Gview.push_back(herm_matrix_timestep_view<T>(tstp, G[j]));
+	Reduce_scatter_timestep(tstp, Gview, tid_map);
+}
+
+
+/** \brief <b> MPI reduce-scatter for a set of `function` at a given time step </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*  \par Purpose
+* <!-- ========= -->
+*
+* > Reduce-scatter of the value at time step `tstp` of a set of `function`: `f[j]` on rank
+* > `tid_map[j]` receives the sum over all ranks. All functions must have the same size.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > time step
+* @param f
+* > The set of `function`.
+* @param tid_map
+* > `tid_map[j]` is the rank which receives the reduced `f[j]`.
+*/
+template <typename T> void Reduce_scatter_timestep(int tstp, std::vector<function<T> > &f,
+	const std::vector<int> &tid_map){
+	int ntasks, taskid;
+	MPI_Comm_size(MPI_COMM_WORLD, &ntasks);
+	MPI_Comm_rank(MPI_COMM_WORLD, &taskid);
+	int n = f.size();
+	assert(n == (int) tid_map.size());
+	if(n == 0) return;
+
+	int blocksize = f[0].element_size();
+	std::vector<int> recvcount(ntasks, 0);
+	for(int j = 0; j < n; j++){
+		assert(f[j].element_size() == blocksize);
+		recvcount[tid_map[j]] += blocksize;
+	}
+
+	std::vector<std::complex<T> > sendbuf((size_t) n * blocksize);
+	std::vector<std::complex<T> > recvbuf(recvcount[taskid]);
+	size_t offset = 0;
+	for(int rank = 0; rank < ntasks; rank++){
+		for(int j = 0; j < n; j++){
+			if(tid_map[j] == rank){
+				memcpy(sendbuf.data() + offset, f[j].ptr(tstp), sizeof(std::complex<T>) * blocksize);
+				offset += blocksize;
+			}
+		}
+	}
+
+	MPI_Reduce_scatter(sendbuf.data(), recvbuf.data(), recvcount.data(), mpi_complex_datatype<T>(),
+		MPI_SUM, MPI_COMM_WORLD);
+
+	offset = 0;
+	for(int j = 0; j < n; j++){
+		if(tid_map[j] == taskid){
+			memcpy(f[j].ptr(tstp), recvbuf.data() + offset, sizeof(std::complex<T>) * blocksize);
+			offset += blocksize;
+		}
+	}
+}
+
+
+
 } // namespace cntr
 
 
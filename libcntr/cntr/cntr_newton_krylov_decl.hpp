@@ -0,0 +1,29 @@
+#ifndef CNTR_NEWTON_KRYLOV_DECL_H
+#define CNTR_NEWTON_KRYLOV_DECL_H
+
+#include "cntr_global_settings.hpp"
+
+#if __cplusplus >= 201103L
+
+#include <functional>
+
+namespace cntr {
+
+template <typename T> class herm_matrix;
+template <typename T> class function;
+
+// default dimension of the Krylov space in dyson_mat_newton_krylov
+#define CNTR_NEWTON_KRYLOV_DIM 20
+
+template <typename T>
+T dyson_mat_newton_krylov(herm_matrix<T> &G, herm_matrix<T> &Sigma, T mu, function<T> &H,
+                          const std::function<void(herm_matrix<T> &, herm_matrix<T> &)> &sigma,
+                          T beta, T tol, int maxiter = 20, const int SolveOrder = MAX_SOLVE_ORDER,
+                          const int method = CNTR_MAT_FIXPOINT,
+                          int krylov_dim = CNTR_NEWTON_KRYLOV_DIM);
+
+}  // namespace cntr
+
+#endif  // __cplusplus >= 201103L
+
+#endif  // CNTR_NEWTON_KRYLOV_DECL_H
@@ -0,0 +1,20 @@
+#include "cntr_newton_krylov_extern_templates.hpp"
+#include "cntr_herm_matrix_impl.hpp"
+#include "cntr_function_impl.hpp"
+#include "cntr_dyson_impl.hpp"
+#include "cntr_utilities_impl.hpp"
+#include "cntr_newton_krylov_impl.hpp"
+
+#if __cplusplus >= 201103L
+
+namespace cntr {
+
+  template double dyson_mat_newton_krylov<double>(herm_matrix<double> &G,
+    herm_matrix<double> &Sigma, double mu, function<double> &H,
+    const std::function<void(herm_matrix<double> &, herm_matrix<double> &)> &sigma,
+    double beta, double tol, int maxiter, const int SolveOrder, const int method,
+    int krylov_dim);
+
+}  // namespace cntr
+
+#endif  // __cplusplus >= 201103L
@@ -0,0 +1,20 @@
+#ifndef CNTR_NEWTON_KRYLOV_EXTERN_TEMPLATES_H
+#define CNTR_NEWTON_KRYLOV_EXTERN_TEMPLATES_H
+
+#include "cntr_newton_krylov_decl.hpp"
+
+#if __cplusplus >= 201103L
+
+namespace cntr {
+
+  extern template double dyson_mat_newton_krylov<double>(herm_matrix<double> &G,
+    herm_matrix<double> &Sigma, double mu, function<double> &H,
+    const std::function<void(herm_matrix<double> &, herm_matrix<double> &)> &sigma,
+    double beta, double tol, int maxiter, const int SolveOrder, const int method,
+    int krylov_dim);
+
+}  // namespace cntr
+
+#endif  // __cplusplus >= 201103L
+
+#endif  // CNTR_NEWTON_KRYLOV_EXTERN_TEMPLATES_H
@@ -0,0 +1,201 @@
+#ifndef CNTR_NEWTON_KRYLOV_IMPL_H
+#define CNTR_NEWTON_KRYLOV_IMPL_H
+
+#include "cntr_newton_krylov_decl.hpp"
+#include "cntr_herm_matrix_decl.hpp"
+#include "cntr_function_decl.hpp"
+#include "cntr_dyson_decl.hpp"
+#include "cntr_utilities_decl.hpp"
+
+#if __cplusplus >= 201103L
+
+namespace cntr {
+
+/// @private
+/** \brief <b> Residual \f$ F(x)=D[\Sigma[x]]-x \f$ of the Matsubara self-consistency. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > \f$ x \f$ holds the real and imaginary parts of the Matsubara component. On return,
+ * > `Sigma` \f$ =\Sigma[x] \f$, `G` \f$ =D[\Sigma[x]] \f$ is the solution of the Dyson
+ * > equation, `G0` \f$ =x \f$, and the return value is `distance_norm2(-1,G,G0)`.
+ */
+template <typename T>
+T newton_krylov_residual(const T *x, T *f, herm_matrix<T> &G, herm_matrix<T> &G0,
+                         herm_matrix<T> &Sigma, T mu, function<T> &H,
+                         const std::function<void(herm_matrix<T> &, herm_matrix<T> &)> &sigma,
+                         T beta, const int SolveOrder, const int method) {
+    typedef std::complex<T> cplx;
+    int i, n = (G.ntau() + 1) * G.element_size();
+    cplx *g0 = G0.matptr(0), *g = G.matptr(0);
+    for (i = 0; i < n; i++)
+        g0[i] = cplx(x[2 * i], x[2 * i + 1]);
+    G.set_timestep(-1, G0);
+    sigma(G, Sigma);
+    dyson_mat(G, mu, H, Sigma, beta, SolveOrder, method);
+    for (i = 0; i < n; i++) {
+        f[2 * i] = g[i].real() - x[2 * i];
+        f[2 * i + 1] = g[i].imag() - x[2 * i + 1];
+    }
+    return distance_norm2(-1, G, G0);
+}
+
+/** \brief <b> Solves the Matsubara self-consistency \f$ G=D[\Sigma[G]] \f$ by a
+ * Jacobian-free Newton-Krylov method. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > \f$ D[\Sigma] \f$ is the solution of the Matsubara Dyson equation,
+ * > `dyson_mat(G,mu,H,Sigma,beta,SolveOrder,method)`, and the self-energy functional
+ * > \f$ \Sigma[G] \f$ is given by the callback `sigma(G,Sigma)`, which sets the Matsubara
+ * > component of `Sigma` from that of `G`. Instead of the fixed-point iteration
+ * > \f$ G\to D[\Sigma[G]] \f$, whose convergence becomes slow when its Jacobian has
+ * > eigenvalues close to one (strong coupling, low temperature), the root of
+ * > \f$ F(G)=D[\Sigma[G]]-G \f$ is found by Newton's method. Each Newton step solves
+ * > \f$ J\delta=-F \f$ by GMRES, where the Jacobian acts as the finite difference
+ * > \f$ J v\approx[F(G+\epsilon v)-F(G)]/\epsilon \f$ (one evaluation of \f$ \Sigma \f$ and
+ * > of the Dyson equation per Krylov vector), followed by a backtracking line search.
+ * > Real and imaginary parts are independent variables, so that `sigma` need not be
+ * > complex-analytic in \f$ G \f$.
+ * >
+ * > Iterates until `distance_norm2(-1,G,G0)` \f$ <tol \f$ for the last input \f$ G_0 \f$,
+ * > as in the usual fixed-point loop. A Newton step is rejected if GMRES breaks down
+ * > without a descent direction or the line search finds no sufficient decrease of
+ * > \f$ |F| \f$ in 8 halvings; the iteration then stops at the last accepted \f$ G_0 \f$,
+ * > and the returned error is above `tol`, as after `maxiter` steps. On return, `Sigma`
+ * > \f$ =\Sigma[G_0] \f$ and `G` \f$ =D[\Sigma[G_0]] \f$. A mean-field term can be included
+ * > by updating `H` in `sigma`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix] On input, the initial guess; on return, the solution (Matsubara component).
+ * @param Sigma
+ * > [herm_matrix] On return, the self-energy of the solution.
+ * @param mu
+ * > [T] Chemical potential.
+ * @param H
+ * > [function] Hamiltonian; only \f$ H(-1) \f$ is used.
+ * @param sigma
+ * > [std::function] Self-energy functional, `sigma(G,Sigma)`.
+ * @param beta
+ * > [T] Inverse temperature.
+ * @param tol
+ * > [T] Convergence threshold for the self-consistency error.
+ * @param maxiter
+ * > [int] Maximal number of Newton steps.
+ * @param SolveOrder
+ * > [int] Integration order of `dyson_mat`.
+ * @param method
+ * > [int] Solution method of `dyson_mat`.
+ * @param krylov_dim
+ * > [int] Maximal dimension of the Krylov space per Newton step.
+ *
+ * @return The self-consistency error `distance_norm2(-1,G,G0)` of the last iterate, above `tol` if the iteration did not converge.
+ */
+template <typename T>
+T dyson_mat_newton_krylov(herm_matrix<T> &G, herm_matrix<T> &Sigma, T mu, function<T> &H,
+                          const std::function<void(herm_matrix<T> &, herm_matrix<T> &)> &sigma,
+                          T beta, T tol, int maxiter, const int SolveOrder, const int method,
+                          int krylov_dim) {
+    typedef Eigen::Matrix<T, Eigen::Dynamic, 1> rvec;
+    typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> rmat;
+    int ntau = G.ntau(), size1 = G.size1(), n = 2 * (ntau + 1) * G.element_size();
+    int iter, i, j, k, m = krylov_dim;
+    assert(Sigma.ntau() == ntau && Sigma.size1() == size1 && Sigma.sig() == G.sig());
+    assert(krylov_dim > 0 && maxiter >= 0);
+    herm_matrix<T> G0(-1, ntau, size1, G.sig());
+    rvec x(n), f(n), xnew(n), fnew(n), w(n), d(n);
+    rmat V(n, m + 1), Hk(m + 1, m);
+    rvec g(m + 1), cs(m), sn(m), y;
+    const std::complex<T> *gm = G.matptr(0);
+    for (i = 0; i < n / 2; i++) {
+        x(2 * i) = gm[i].real();
+        x(2 * i + 1) = gm[i].imag();
+    }
+    T err = newton_krylov_residual(x.data(), f.data(), G, G0, Sigma, mu, H, sigma, beta,
+                                   SolveOrder, method);
+    for (iter = 0; iter < maxiter && err > tol; iter++) {
+        // GMRES for J d = -f, relative tolerance eta
+        T fnorm = f.norm(), eta = (fnorm < 0.1 ? fnorm : 0.1);
+        T eps = sqrt(std::numeric_limits<T>::epsilon()) * (1.0 + x.norm());
+        V.col(0) = -f / fnorm;
+        Hk.setZero();
+        g.setZero();
+        g(0) = fnorm;
+        for (k = 0; k < m;) {
+            j = k;
+            // J v_j by finite differences
+            xnew = x + eps * V.col(j);
+            newton_krylov_residual(xnew.data(), fnew.data(), G, G0, Sigma, mu, H, sigma, beta,
+                                   SolveOrder, method);
+            w = (fnew - f) / eps;
+            for (i = 0; i <= j; i++) {
+                Hk(i, j) = w.dot(V.col(i));
+                w -= Hk(i, j) * V.col(i);
+            }
+            T hnext = w.norm();
+            Hk(j + 1, j) = hnext;
+            if (hnext > 0.0)
+                V.col(j + 1) = w / hnext;
+            // Givens rotations
+            for (i = 0; i < j; i++) {
+                T h0 = cs(i) * Hk(i, j) + sn(i) * Hk(i + 1, j);
+                Hk(i + 1, j) = -sn(i) * Hk(i, j) + cs(i) * Hk(i + 1, j);
+                Hk(i, j) = h0;
+            }
+            T r = sqrt(Hk(j, j) * Hk(j, j) + Hk(j + 1, j) * Hk(j + 1, j));
+            // breakdown: J is singular on the Krylov space, use the first j vectors
+            if (r == 0.0)
+                break;
+            cs(j) = Hk(j, j) / r;
+            sn(j) = Hk(j + 1, j) / r;
+            Hk(j, j) = r;
+            Hk(j + 1, j) = 0.0;
+            g(j + 1) = -sn(j) * g(j);
+            g(j) = cs(j) * g(j);
+            k++;
+            if (std::abs(g(k)) <= eta * fnorm || hnext == 0.0)
+                break;
+        }
+        // backtracking line search
+        bool accepted = false;
+        if (k > 0) {
+            y = Hk.topLeftCorner(k, k).template triangularView<Eigen::Upper>().solve(g.head(k));
+            d = V.leftCols(k) * y;
+            T lambda = 1.0;
+            for (i = 0; i < 8 && !accepted; i++) {
+                xnew = x + lambda * d;
+                T errnew = newton_krylov_residual(xnew.data(), fnew.data(), G, G0, Sigma, mu, H,
+                                                  sigma, beta, SolveOrder, method);
+                if (fnew.norm() < (1.0 - 1.0e-4 * lambda) * fnorm) {
+                    accepted = true;
+                    err = errnew;
+                }
+                lambda *= 0.5;
+            }
+        }
+        if (!accepted) {
+            // no descent direction, or no sufficient decrease: stop at the last iterate
+            err = newton_krylov_residual(x.data(), f.data(), G, G0, Sigma, mu, H, sigma, beta,
+                                         SolveOrder, method);
+            break;
+        }
+        x = xnew;
+        f = fnew;
+    }
+    return err;
+}
+
+}  // namespace cntr
+
+#endif  // __cplusplus >= 201103L
+
+#endif  // CNTR_NEWTON_KRYLOV_IMPL_H
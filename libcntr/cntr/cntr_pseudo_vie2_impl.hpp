@@ -353,7 +353,7 @@ void pseudo_vie2_timestep_new_dispatch(int tstp, GG &B, CPLX alpha, GG &A, GG &A
     Q.get_timestep(tstp, Qtstp);
     B.set_timestep_zero(tstp);
     if (func) {
-        ftcc = new CPLX[sc * n1];
+        ftcc = new CPLX[sc * (n1 + 1)];
         f0cc = new CPLX[sc];
         element_conj<T, SIZE1>(size1, f0cc, f0);
         for (n = 0; n <= n1; n++)
@@ -508,7 +508,7 @@ void pseudo_vie2_timestep_omp_dispatch(int omp_num_threads, int tstp, GG &B, CPL
     Q.get_timestep(tstp, Qtstp);
     B.set_timestep_zero(tstp);
     if (func) {
-        ftcc = new CPLX[sc * n1];
+        ftcc = new CPLX[sc * (n1 + 1)];
         f0cc = new CPLX[sc];
         element_conj<T, SIZE1>(size1, f0cc, f0);
         for (int n = 0; n <= n1; n++)
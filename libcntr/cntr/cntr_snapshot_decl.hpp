@@ -0,0 +1,128 @@
+#ifndef CNTR_SNAPSHOT_DECL_H
+#define CNTR_SNAPSHOT_DECL_H
+
+#include "cntr_global_settings.hpp"
+#include <stdint.h>
+
+namespace cntr {
+
+template <typename T> class function;
+template <typename T> class herm_matrix;
+template <typename T> class herm_matrix_timestep;
+template <typename T> class herm_matrix_timestep_view;
+
+#define CNTR_SNAPSHOT_VERSION 1
+// alignment (bytes) of the arrays in the file, and thus in the mapping
+#define CNTR_SNAPSHOT_ALIGN 64
+
+// snapshot files are memory mapped on POSIX systems, read into memory elsewhere
+#ifndef CNTR_SNAPSHOT_MMAP
+#if defined(__unix__) || defined(__APPLE__)
+#define CNTR_SNAPSHOT_MMAP 1
+#else
+#define CNTR_SNAPSHOT_MMAP 0
+#endif
+#endif
+
+#define CNTR_SNAPSHOT_HERM_MATRIX 0
+#define CNTR_SNAPSHOT_HERM_MATRIX_TIMESTEP 1
+#define CNTR_SNAPSHOT_FUNCTION 2
+
+/// @private
+/** \brief <b> File header of a binary snapshot. </b> */
+struct snapshot_header {
+    char magic[8];         /*!< "CNTRSNAP" */
+    int32_t version;       /*!< CNTR_SNAPSHOT_VERSION */
+    int32_t kind;          /*!< CNTR_SNAPSHOT_HERM_MATRIX, ..._TIMESTEP or ..._FUNCTION */
+    int32_t scalar_size;   /*!< sizeof(T) */
+    int32_t nt;            /*!< nt, or tstp of a herm_matrix_timestep */
+    int32_t ntau;
+    int32_t size1;
+    int32_t size2;
+    int32_t sig;
+    uint64_t offset[4];    /*!< Byte offsets of mat, ret, les, tv (function: values in [0]) */
+    uint64_t length[4];    /*!< Number of complex entries of each array */
+    uint64_t checksum;     /*!< 64-bit FNV-1a over the arrays, word by word */
+};
+
+/** \brief <b> Memory-mapped binary snapshot of a `herm_matrix`, `herm_matrix_timestep` or `function`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > A snapshot file, written by `write_snapshot`, holds a versioned header (dimensions,
+ * > sign and checksum) followed by the raw component arrays in the memory layout of the
+ * > object, each aligned to CNTR_SNAPSHOT_ALIGN bytes. The class maps the file
+ * > (copy-on-write: changes to the mapped data never reach the file) and gives zero-copy
+ * > access through `herm_matrix_timestep_view` objects, or copies the data into an object
+ * > with `get_data`. The checksum is verified on opening unless `check=false`, in which
+ * > case only the pages that are accessed are read from disk. Without `mmap`
+ * > (CNTR_SNAPSHOT_MMAP=0) the whole file is read into memory instead.
+ * >
+ * > Files that cannot be opened, mapped or written, and files with an invalid header
+ * > or checksum, raise `std::runtime_error`.
+ * >
+ * > Views returned by `get_timestep` and pointers returned by `ptr` are valid until the
+ * > snapshot is closed. Snapshot files do not depend on HDF5; they are not portable
+ * > between platforms of different byte order.
+ */
+template <typename T>
+class snapshot {
+  public:
+    typedef std::complex<T> cplx;
+    /* construction, destruction */
+    snapshot();
+    explicit snapshot(const char *filename, bool check = true);
+    ~snapshot();
+    void open(const char *filename, bool check = true);
+    void close(void);
+    bool is_open(void) const { return map_ != 0; }
+    bool verify(void) const;
+    int kind(void) const { return header_.kind; }
+    /** \brief nt of a `herm_matrix` or `function`, tstp of a `herm_matrix_timestep` */
+    int nt(void) const { return header_.nt; }
+    int ntau(void) const { return header_.ntau; }
+    int size1(void) const { return header_.size1; }
+    int size2(void) const { return header_.size2; }
+    int sig(void) const { return header_.sig; }
+    // zero-copy access
+    void get_timestep(int tstp, herm_matrix_timestep_view<T> &G);
+    cplx *ptr(int t);
+    // copy into an object, resized if necessary
+    void get_data(herm_matrix<T> &G);
+    void get_data(herm_matrix_timestep<T> &G);
+    void get_data(function<T> &f);
+
+  private:
+    /// @private
+    snapshot(const snapshot &s);
+    /// @private
+    snapshot &operator=(const snapshot &s);
+    /// @private
+    cplx *array(int c) { return (cplx *)((char *)map_ + header_.offset[c]); }
+    /// @private
+    void fail(const char *filename, const char *what);
+    void *map_;                 /*!< Start of the mapping, 0 if closed */
+    char *buffer_;              /*!< Storage of the file without mmap, else 0 */
+    size_t map_size_;           /*!< Length of the mapping in bytes */
+    snapshot_header header_;    /*!< Copy of the file header */
+};
+
+template <typename T>
+void write_snapshot(const char *filename, herm_matrix<T> &G);
+template <typename T>
+void write_snapshot(const char *filename, herm_matrix_timestep<T> &G);
+template <typename T>
+void write_snapshot(const char *filename, function<T> &f);
+template <typename T>
+void read_snapshot(const char *filename, herm_matrix<T> &G);
+template <typename T>
+void read_snapshot(const char *filename, herm_matrix_timestep<T> &G);
+template <typename T>
+void read_snapshot(const char *filename, function<T> &f);
+
+}  // namespace cntr
+
+#endif  // CNTR_SNAPSHOT_DECL_H
@@ -0,0 +1,18 @@
+#include "cntr_snapshot_extern_templates.hpp"
+#include "cntr_function_impl.hpp"
+#include "cntr_herm_matrix_impl.hpp"
+#include "cntr_herm_matrix_timestep_impl.hpp"
+#include "cntr_herm_matrix_timestep_view_impl.hpp"
+#include "cntr_snapshot_impl.hpp"
+
+namespace cntr {
+
+  template class snapshot<double>;
+  template void write_snapshot<double>(const char *filename, herm_matrix<double> &G);
+  template void write_snapshot<double>(const char *filename, herm_matrix_timestep<double> &G);
+  template void write_snapshot<double>(const char *filename, function<double> &f);
+  template void read_snapshot<double>(const char *filename, herm_matrix<double> &G);
+  template void read_snapshot<double>(const char *filename, herm_matrix_timestep<double> &G);
+  template void read_snapshot<double>(const char *filename, function<double> &f);
+
+}  // namespace cntr
@@ -0,0 +1,18 @@
+#ifndef CNTR_SNAPSHOT_EXTERN_TEMPLATES_H
+#define CNTR_SNAPSHOT_EXTERN_TEMPLATES_H
+
+#include "cntr_snapshot_decl.hpp"
+
+namespace cntr {
+
+  extern template class snapshot<double>;
+  extern template void write_snapshot<double>(const char *filename, herm_matrix<double> &G);
+  extern template void write_snapshot<double>(const char *filename, herm_matrix_timestep<double> &G);
+  extern template void write_snapshot<double>(const char *filename, function<double> &f);
+  extern template void read_snapshot<double>(const char *filename, herm_matrix<double> &G);
+  extern template void read_snapshot<double>(const char *filename, herm_matrix_timestep<double> &G);
+  extern template void read_snapshot<double>(const char *filename, function<double> &f);
+
+}  // namespace cntr
+
+#endif  // CNTR_SNAPSHOT_EXTERN_TEMPLATES_H
@@ -0,0 +1,575 @@
+#ifndef CNTR_SNAPSHOT_IMPL_H
+#define CNTR_SNAPSHOT_IMPL_H
+
+#include "cntr_snapshot_decl.hpp"
+#include "cntr_function_decl.hpp"
+#include "cntr_herm_matrix_decl.hpp"
+#include "cntr_herm_matrix_timestep_decl.hpp"
+#include "cntr_herm_matrix_timestep_view_decl.hpp"
+
+#include <stdexcept>
+#if CNTR_SNAPSHOT_MMAP == 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cntr {
+
+/// @private
+// 64-bit FNV-1a, applied to 64-bit words (bytes must be a multiple of 8)
+inline uint64_t snapshot_checksum(uint64_t h, const void *data, uint64_t bytes) {
+    const uint64_t *w = (const uint64_t *)data;
+    for (uint64_t i = 0; i < bytes / 8; i++)
+        h = (h ^ w[i]) * 1099511628211ULL;
+    return h;
+}
+
+/// @private
+inline uint64_t snapshot_align(uint64_t n) {
+    return ((n + CNTR_SNAPSHOT_ALIGN - 1) / CNTR_SNAPSHOT_ALIGN) * CNTR_SNAPSHOT_ALIGN;
+}
+
+/// @private
+// Array lengths implied by the dimensions in the header; false for invalid dimensions
+inline bool snapshot_expected_length(const snapshot_header &h, uint64_t length[4]) {
+    if (h.ntau < 0 || h.size1 < 0 || h.size2 < 0 || h.nt < -1)
+        return false;
+    uint64_t es = (uint64_t)h.size1 * h.size2, nt1 = h.nt + 1, ntau1 = h.ntau + 1;
+    length[0] = length[1] = length[2] = length[3] = 0;
+    if (h.kind == CNTR_SNAPSHOT_HERM_MATRIX) {
+        length[0] = ntau1 * es;
+        length[1] = length[2] = (nt1 * (nt1 + 1)) / 2 * es;
+        length[3] = nt1 * ntau1 * es;
+    } else if (h.kind == CNTR_SNAPSHOT_HERM_MATRIX_TIMESTEP) {
+        if (h.nt == -1) {
+            length[0] = ntau1 * es;
+        } else {
+            length[1] = length[2] = nt1 * es;
+            length[3] = ntau1 * es;
+        }
+    } else if (h.kind == CNTR_SNAPSHOT_FUNCTION) {
+        length[0] = (nt1 + 1) * es;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/// @private
+template <typename T>
+void snapshot_write(const char *filename, int kind, int nt, int ntau, int size1, int size2,
+                    int sig, const std::complex<T> *const arr[4], const uint64_t length[4]) {
+    snapshot_header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, "CNTRSNAP", 8);
+    h.version = CNTR_SNAPSHOT_VERSION;
+    h.kind = kind;
+    h.scalar_size = sizeof(T);
+    h.nt = nt;
+    h.ntau = ntau;
+    h.size1 = size1;
+    h.size2 = size2;
+    h.sig = sig;
+    h.checksum = 14695981039346656037ULL;
+    uint64_t pos = snapshot_align(sizeof(h));
+    for (int c = 0; c < 4; c++) {
+        h.offset[c] = pos;
+        h.length[c] = length[c];
+        pos = snapshot_align(pos + length[c] * sizeof(std::complex<T>));
+        h.checksum = snapshot_checksum(h.checksum, arr[c], length[c] * sizeof(std::complex<T>));
+    }
+
+    static const char zeros[CNTR_SNAPSHOT_ALIGN] = {0};
+    std::ofstream out(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.good())
+        throw std::runtime_error(std::string("write_snapshot: cannot open ") + filename);
+    out.write((const char *)&h, sizeof(h));
+    pos = sizeof(h);
+    for (int c = 0; c < 4; c++) {
+        if (length[c] == 0)
+            continue;
+        out.write(zeros, h.offset[c] - pos);
+        out.write((const char *)arr[c], length[c] * sizeof(std::complex<T>));
+        pos = h.offset[c] + length[c] * sizeof(std::complex<T>);
+    }
+    out.close();
+    if (out.fail())
+        throw std::runtime_error(std::string("write_snapshot: error writing ") + filename);
+}
+
+/** \brief <b> Writes a `herm_matrix` to a binary snapshot file. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Writes the header and the arrays `mat`, `ret`, `les`, `tv` in the packed layout
+ * > of the `herm_matrix`; the file can be mapped by `snapshot`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [char*] The name of the snapshot file (overwritten).
+ * @param G
+ * > [herm_matrix] The `herm_matrix` to be stored.
+ */
+template <typename T>
+void write_snapshot(const char *filename, herm_matrix<T> &G) {
+    int es = G.size1() * G.size2(), nt = G.nt(), ntau = G.ntau();
+    const std::complex<T> *arr[4] = {G.matptr(0), 0, 0, 0};
+    uint64_t length[4] = {(uint64_t)(ntau + 1) * es, 0, 0, 0};
+    if (nt >= 0) {
+        arr[1] = G.retptr(0, 0);
+        arr[2] = G.lesptr(0, 0);
+        arr[3] = G.tvptr(0, 0);
+        length[1] = length[2] = (uint64_t)(nt + 1) * (nt + 2) / 2 * es;
+        length[3] = (uint64_t)(nt + 1) * (ntau + 1) * es;
+    }
+    snapshot_write<T>(filename, CNTR_SNAPSHOT_HERM_MATRIX, nt, ntau, G.size1(), G.size2(),
+                      G.sig(), arr, length);
+}
+/** \brief <b> Writes a `herm_matrix_timestep` to a binary snapshot file. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Writes the header and the components of the time step (`mat` for `tstp=-1`,
+ * > otherwise `ret`, `les` and `tv`); the file can be mapped by `snapshot`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [char*] The name of the snapshot file (overwritten).
+ * @param G
+ * > [herm_matrix_timestep] The time step to be stored.
+ */
+template <typename T>
+void write_snapshot(const char *filename, herm_matrix_timestep<T> &G) {
+    int es = G.size1() * G.size2(), tstp = G.tstp(), ntau = G.ntau();
+    const std::complex<T> *arr[4] = {0, 0, 0, 0};
+    uint64_t length[4] = {0, 0, 0, 0};
+    if (tstp == -1) {
+        arr[0] = G.matptr(0);
+        length[0] = (uint64_t)(ntau + 1) * es;
+    } else {
+        arr[1] = G.retptr(0);
+        arr[2] = G.lesptr(0);
+        arr[3] = G.tvptr(0);
+        length[1] = length[2] = (uint64_t)(tstp + 1) * es;
+        length[3] = (uint64_t)(ntau + 1) * es;
+    }
+    snapshot_write<T>(filename, CNTR_SNAPSHOT_HERM_MATRIX_TIMESTEP, tstp, ntau, G.size1(),
+                      G.size2(), G.sig(), arr, length);
+}
+/** \brief <b> Writes a `function` to a binary snapshot file. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Writes the header and the values \f$ f(t) \f$, \f$ t=-1,...,nt \f$;
+ * > the file can be mapped by `snapshot`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [char*] The name of the snapshot file (overwritten).
+ * @param f
+ * > [function] The `function` to be stored.
+ */
+template <typename T>
+void write_snapshot(const char *filename, function<T> &f) {
+    const std::complex<T> *arr[4] = {f.ptr(-1), 0, 0, 0};
+    uint64_t length[4] = {(uint64_t)(f.nt() + 2) * f.element_size(), 0, 0, 0};
+    snapshot_write<T>(filename, CNTR_SNAPSHOT_FUNCTION, f.nt(), 0, f.size1(), f.size2(), 0,
+                      arr, length);
+}
+
+/** \brief <b> Reads a `herm_matrix` from a binary snapshot file. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Maps the file, verifies the checksum and copies the data into `G`,
+ * > which is resized if necessary.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [char*] The name of the snapshot file.
+ * @param G
+ * > [herm_matrix] The `herm_matrix` to be read.
+ */
+template <typename T>
+void read_snapshot(const char *filename, herm_matrix<T> &G) {
+    snapshot<T> s(filename);
+    s.get_data(G);
+}
+/** \brief <b> Reads a `herm_matrix_timestep` from a binary snapshot file. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Maps the file, verifies the checksum and copies the data into `G`,
+ * > which is resized if necessary.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [char*] The name of the snapshot file.
+ * @param G
+ * > [herm_matrix_timestep] The time step to be read.
+ */
+template <typename T>
+void read_snapshot(const char *filename, herm_matrix_timestep<T> &G) {
+    snapshot<T> s(filename);
+    s.get_data(G);
+}
+/** \brief <b> Reads a `function` from a binary snapshot file. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Maps the file, verifies the checksum and copies the data into `f`,
+ * > which is resized if necessary.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [char*] The name of the snapshot file.
+ * @param f
+ * > [function] The `function` to be read.
+ */
+template <typename T>
+void read_snapshot(const char *filename, function<T> &f) {
+    snapshot<T> s(filename);
+    s.get_data(f);
+}
+
+template <typename T>
+snapshot<T>::snapshot() : map_(0), buffer_(0), map_size_(0) {
+    memset(&header_, 0, sizeof(header_));
+}
+/** \brief <b> Maps a binary snapshot file. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Constructs the `snapshot` and opens the file, see `open`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [char*] The name of the snapshot file.
+ * @param check
+ * > [bool] Verify the checksum of the data.
+ */
+template <typename T>
+snapshot<T>::snapshot(const char *filename, bool check)
+    : map_(0), buffer_(0), map_size_(0) {
+    memset(&header_, 0, sizeof(header_));
+    open(filename, check);
+}
+template <typename T>
+snapshot<T>::~snapshot() {
+    close();
+}
+/** \brief <b> Maps a binary snapshot file. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Maps the file copy-on-write and checks the header (magic, version, scalar type,
+ * > array lengths and file length). With `check=true` the checksum of the data is
+ * > verified, which reads the whole file; otherwise pages are read on first access only.
+ * > Throws `std::runtime_error` if the file cannot be opened or mapped, or if a check
+ * > fails; the snapshot is closed then.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [char*] The name of the snapshot file.
+ * @param check
+ * > [bool] Verify the checksum of the data.
+ */
+template <typename T>
+void snapshot<T>::open(const char *filename, bool check) {
+    close();
+#if CNTR_SNAPSHOT_MMAP == 1
+    int fd = ::open(filename, O_RDONLY);
+    if (fd < 0)
+        fail(filename, "cannot open");
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(snapshot_header)) {
+        ::close(fd);
+        fail(filename, "not a snapshot file");
+    }
+    void *map = mmap(0, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        fail(filename, "cannot map");
+    map_ = map;
+    map_size_ = st.st_size;
+#else
+    std::ifstream in(filename, std::ios::in | std::ios::binary);
+    if (!in.good())
+        fail(filename, "cannot open");
+    in.seekg(0, std::ios::end);
+    std::streamoff size = in.tellg();
+    if (size < (std::streamoff)sizeof(snapshot_header))
+        fail(filename, "not a snapshot file");
+    in.seekg(0, std::ios::beg);
+    // keep the arrays aligned to CNTR_SNAPSHOT_ALIGN in memory
+    buffer_ = new char[size + CNTR_SNAPSHOT_ALIGN];
+    map_ = buffer_ + (CNTR_SNAPSHOT_ALIGN - (size_t)buffer_ % CNTR_SNAPSHOT_ALIGN);
+    map_size_ = size;
+    in.read((char *)map_, size);
+    if (in.fail())
+        fail(filename, "error reading");
+#endif
+    memcpy(&header_, map_, sizeof(header_));
+    if (memcmp(header_.magic, "CNTRSNAP", 8) != 0)
+        fail(filename, "not a snapshot file");
+    if (header_.version != CNTR_SNAPSHOT_VERSION)
+        fail(filename, "unsupported snapshot version");
+    if (header_.scalar_size != (int32_t)sizeof(T))
+        fail(filename, "scalar type of snapshot does not match");
+    uint64_t length[4];
+    if (!snapshot_expected_length(header_, length))
+        fail(filename, "invalid snapshot dimensions");
+    for (int c = 0; c < 4; c++) {
+        if (header_.length[c] != length[c] || header_.offset[c] % CNTR_SNAPSHOT_ALIGN != 0)
+            fail(filename, "invalid snapshot layout");
+        if (length[c] > 0 && (header_.offset[c] > map_size_ ||
+                              length[c] > (map_size_ - header_.offset[c]) / sizeof(cplx)))
+            fail(filename, "truncated snapshot file");
+    }
+    if (check && !verify())
+        fail(filename, "snapshot checksum mismatch");
+}
+/// @private
+template <typename T>
+void snapshot<T>::fail(const char *filename, const char *what) {
+    close();
+    memset(&header_, 0, sizeof(header_));
+    throw std::runtime_error(std::string("snapshot: ") + what + ": " + filename);
+}
+/** \brief <b> Unmaps the snapshot file. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Unmaps the file; views and pointers into the snapshot become invalid.
+ */
+template <typename T>
+void snapshot<T>::close(void) {
+#if CNTR_SNAPSHOT_MMAP == 1
+    if (map_ != 0)
+        munmap(map_, map_size_);
+#else
+    delete[] buffer_;
+#endif
+    buffer_ = 0;
+    map_ = 0;
+    map_size_ = 0;
+}
+/** \brief <b> Verifies the checksum of the snapshot data. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Recomputes the checksum of the mapped arrays and compares with the header.
+ * > Returns `true` if they agree.
+ */
+template <typename T>
+bool snapshot<T>::verify(void) const {
+    assert(map_ != 0 && "snapshot not open");
+    uint64_t h = 14695981039346656037ULL;
+    for (int c = 0; c < 4; c++) {
+        h = snapshot_checksum(h, (const char *)map_ + header_.offset[c],
+                              header_.length[c] * sizeof(cplx));
+    }
+    return h == header_.checksum;
+}
+/** \brief <b> Zero-copy view of a time step in the snapshot. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Sets `G` to point to the time step `tstp` of the mapped `herm_matrix`
+ * > (or to the stored `herm_matrix_timestep`, then `tstp` must be its time step).
+ * > The data are not copied; changes through the view stay in memory.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tstp
+ * > [int] The time step.
+ * @param G
+ * > [herm_matrix_timestep_view] On return, the view of the time step.
+ */
+template <typename T>
+void snapshot<T>::get_timestep(int tstp, herm_matrix_timestep_view<T> &G) {
+    assert(map_ != 0 && "snapshot not open");
+    int es = header_.size1 * header_.size2, ntau = header_.ntau;
+    G = herm_matrix_timestep_view<T>(tstp, ntau, header_.size1, header_.size2, header_.sig);
+    if (header_.kind == CNTR_SNAPSHOT_HERM_MATRIX) {
+        assert(tstp >= -1 && tstp <= header_.nt && "tstp >= -1 && tstp <= nt");
+        if (tstp == -1) {
+            G.mat_ = array(0);
+        } else {
+            G.ret_ = array(1) + (size_t)tstp * (tstp + 1) / 2 * es;
+            G.les_ = array(2) + (size_t)tstp * (tstp + 1) / 2 * es;
+            G.tv_ = array(3) + (size_t)tstp * (ntau + 1) * es;
+        }
+    } else if (header_.kind == CNTR_SNAPSHOT_HERM_MATRIX_TIMESTEP) {
+        assert(tstp == header_.nt && "tstp does not match the stored time step");
+        if (tstp == -1) {
+            G.mat_ = array(0);
+        } else {
+            G.ret_ = array(1);
+            G.les_ = array(2);
+            G.tv_ = array(3);
+        }
+    } else {
+        assert(0 && "snapshot does not hold a herm_matrix");
+    }
+}
+/** \brief <b> Zero-copy pointer to a value of the stored `function`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Returns a pointer to \f$ f(t) \f$ in the mapping, as `function::ptr`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param t
+ * > [int] The time step, -1 <= t <= nt.
+ */
+template <typename T>
+typename snapshot<T>::cplx *snapshot<T>::ptr(int t) {
+    assert(map_ != 0 && header_.kind == CNTR_SNAPSHOT_FUNCTION && "snapshot does not hold a function");
+    assert(t >= -1 && t <= header_.nt && "t >= -1 && t <= nt");
+    return array(0) + (size_t)(t + 1) * header_.size1 * header_.size2;
+}
+/** \brief <b> Copies the stored `herm_matrix` into `G`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Copies all components; `G` is resized to the stored dimensions if necessary.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix] The `herm_matrix` to be read.
+ */
+template <typename T>
+void snapshot<T>::get_data(herm_matrix<T> &G) {
+    assert(map_ != 0 && header_.kind == CNTR_SNAPSHOT_HERM_MATRIX && "snapshot does not hold a herm_matrix");
+    const snapshot_header &h = header_;
+    if (G.nt() != h.nt || G.ntau() != h.ntau || G.size1() != h.size1 || G.size2() != h.size2)
+        G = herm_matrix<T>(h.nt, h.ntau, h.size1, h.size2, h.sig);
+    G.set_sig(h.sig);
+    memcpy(G.matptr(0), array(0), h.length[0] * sizeof(cplx));
+    if (h.nt >= 0) {
+        memcpy(G.retptr(0, 0), array(1), h.length[1] * sizeof(cplx));
+        memcpy(G.lesptr(0, 0), array(2), h.length[2] * sizeof(cplx));
+        memcpy(G.tvptr(0, 0), array(3), h.length[3] * sizeof(cplx));
+    }
+}
+/** \brief <b> Copies the stored `herm_matrix_timestep` into `G`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Copies the time step; `G` is resized to the stored dimensions if necessary.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix_timestep] The time step to be read.
+ */
+template <typename T>
+void snapshot<T>::get_data(herm_matrix_timestep<T> &G) {
+    assert(map_ != 0 && header_.kind == CNTR_SNAPSHOT_HERM_MATRIX_TIMESTEP &&
+           "snapshot does not hold a herm_matrix_timestep");
+    const snapshot_header &h = header_;
+    if (G.tstp() != h.nt || G.ntau() != h.ntau || G.size1() != h.size1 ||
+        G.size2() != h.size2 || G.sig() != h.sig)
+        G = herm_matrix_timestep<T>(h.nt, h.ntau, h.size1, h.size2, h.sig);
+    if (h.nt == -1) {
+        memcpy(G.matptr(0), array(0), h.length[0] * sizeof(cplx));
+    } else {
+        memcpy(G.retptr(0), array(1), h.length[1] * sizeof(cplx));
+        memcpy(G.lesptr(0), array(2), h.length[2] * sizeof(cplx));
+        memcpy(G.tvptr(0), array(3), h.length[3] * sizeof(cplx));
+    }
+}
+/** \brief <b> Copies the stored `function` into `f`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Copies all values; `f` is resized to the stored dimensions if necessary.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param f
+ * > [function] The `function` to be read.
+ */
+template <typename T>
+void snapshot<T>::get_data(function<T> &f) {
+    assert(map_ != 0 && header_.kind == CNTR_SNAPSHOT_FUNCTION && "snapshot does not hold a function");
+    const snapshot_header &h = header_;
+    if (f.nt() != h.nt || f.size1() != h.size1 || f.size2() != h.size2)
+        f = function<T>(h.nt, h.size1, h.size2);
+    memcpy(f.ptr(-1), array(0), h.length[0] * sizeof(cplx));
+}
+
+}  // namespace cntr
+
+#endif  // CNTR_SNAPSHOT_IMPL_H
@@ -0,0 +1,102 @@
+#ifndef CNTR_TAU_GRID_DECL_H
+#define CNTR_TAU_GRID_DECL_H
+
+#include "cntr_global_settings.hpp"
+
+namespace cntr {
+
+template <typename T> class herm_matrix;
+template <typename T> class function;
+
+// types of imaginary-time grids
+#define CNTR_TAU_UNIFORM 0
+#define CNTR_TAU_TANH 1
+
+/** \brief <b> Class `tau_grid` describes a (non-uniform) imaginary-time grid.</b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ *  The grid points are \f$ \tau_m = \beta u(m/n_\tau) \f$, \f$ m=0,\dots,n_\tau \f$, for a smooth
+ *  monotonous map \f$ u:[0,1]\to[0,1] \f$ with \f$ u(1-x)=1-u(x) \f$:
+ *  - `CNTR_TAU_UNIFORM`: \f$ u(x)=x \f$, the grid of `herm_matrix`,
+ *  - `CNTR_TAU_TANH`: \f$ u(x)=\frac12[1+\tanh(c(2x-1))/\tanh(c)] \f$, which is dense near
+ *    \f$ \tau=0,\beta \f$; the ratio of the largest and smallest spacing is
+ *    \f$ \cosh^2(c) \f$.
+ *
+ *  Integrals are evaluated as \f$ \int d\tau f(\tau) = \int dx\, \tau'(x) f(\tau(x)) \f$ with the
+ *  Gregory weights in \f$ x \f$, values between grid points by local polynomial interpolation
+ *  of order `k`. A `herm_matrix` with `ntau()` imaginary-time points holds the Matsubara and
+ *  left-mixing components at \f$ \tau_m \f$ instead of \f$ m\beta/n_\tau \f$; the
+ *  functions `convolution_mat_grid`, `convolution_timestep_tv_grid`, `vie2_*_grid` and
+ *  `dyson_*_grid` operate on such objects. Because the grid is symmetric,
+ *  \f$ \beta-\tau_m=\tau_{n_\tau-m} \f$ as for the uniform grid.
+ */
+template <typename T>
+class tau_grid {
+  public:
+    typedef std::complex<T> cplx;
+    tau_grid();
+    tau_grid(int ntau, T beta, int type = CNTR_TAU_UNIFORM, T c = 0.0);
+    int ntau(void) const { return ntau_; }
+    T beta(void) const { return beta_; }
+    int type(void) const { return type_; }
+    T c(void) const { return c_; }
+    /** \brief <b> Grid point \f$ \tau_m \f$ </b> */
+    T tau(int m) const { return tau_[m]; }
+    /** \brief <b> \f$ \tau'(x_m)/n_\tau \f$, the local grid spacing at \f$ \tau_m \f$ </b> */
+    T dtau(int m) const { return dtau_[m]; }
+    T index(T tau) const;
+    T weight(int m, int k) const;
+    void stencil(T tau, int k, int &j0, T *c) const;
+    void interpolate(int size1, T tau, const cplx *f, cplx *val, int k) const;
+
+  private:
+    int ntau_;
+    T beta_;
+    int type_;
+    T c_;
+    std::vector<T> tau_;
+    std::vector<T> dtau_;
+};
+
+template <typename T>
+void green_from_H(herm_matrix<T> &G, T mu, cdmatrix &H, const tau_grid<T> &grid, T h);
+
+template <typename T>
+void convolution_mat_grid(herm_matrix<T> &C, herm_matrix<T> &A, herm_matrix<T> &B,
+                          const tau_grid<T> &grid, const int SolveOrder = MAX_SOLVE_ORDER);
+template <typename T>
+void convolution_timestep_tv_grid(int n, herm_matrix<T> &C, herm_matrix<T> &A,
+                                  herm_matrix<T> &Acc, herm_matrix<T> &B, herm_matrix<T> &Bcc,
+                                  const tau_grid<T> &grid, T h,
+                                  const int SolveOrder = MAX_SOLVE_ORDER);
+
+template <typename T>
+void vie2_mat_grid(herm_matrix<T> &G, herm_matrix<T> &F, herm_matrix<T> &Q,
+                   const tau_grid<T> &grid, const int SolveOrder = MAX_SOLVE_ORDER);
+template <typename T>
+void vie2_start_tv_grid(herm_matrix<T> &G, herm_matrix<T> &F, herm_matrix<T> &Fcc,
+                        herm_matrix<T> &Q, const tau_grid<T> &grid, T h,
+                        const int SolveOrder = MAX_SOLVE_ORDER);
+template <typename T>
+void vie2_timestep_tv_grid(int n, herm_matrix<T> &G, herm_matrix<T> &F, herm_matrix<T> &Fcc,
+                           herm_matrix<T> &Q, const tau_grid<T> &grid, T h,
+                           const int SolveOrder = MAX_SOLVE_ORDER);
+
+template <typename T>
+void dyson_mat_grid(herm_matrix<T> &G, T mu, function<T> &H, herm_matrix<T> &Sigma,
+                    const tau_grid<T> &grid, const int SolveOrder = MAX_SOLVE_ORDER);
+template <typename T>
+void dyson_start_tv_grid(herm_matrix<T> &G, T mu, function<T> &H, herm_matrix<T> &Sigma,
+                         const tau_grid<T> &grid, T h, const int SolveOrder = MAX_SOLVE_ORDER);
+template <typename T>
+void dyson_timestep_tv_grid(int n, herm_matrix<T> &G, T mu, function<T> &H,
+                            herm_matrix<T> &Sigma, const tau_grid<T> &grid, T h,
+                            const int SolveOrder = MAX_SOLVE_ORDER);
+
+}  // namespace cntr
+
+#endif  // CNTR_TAU_GRID_DECL_H
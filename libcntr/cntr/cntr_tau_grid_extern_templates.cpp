@@ -0,0 +1,37 @@
+#include "cntr_tau_grid_extern_templates.hpp"
+#include "cntr_herm_matrix_impl.hpp"
+#include "cntr_function_impl.hpp"
+#include "cntr_equilibrium_impl.hpp"
+#include "cntr_tau_grid_impl.hpp"
+
+namespace cntr {
+
+  template class tau_grid<double>;
+  template void green_from_H<double>(herm_matrix<double> &G, double mu, cdmatrix &H,
+    const tau_grid<double> &grid, double h);
+  template void convolution_mat_grid<double>(herm_matrix<double> &C,
+    herm_matrix<double> &A, herm_matrix<double> &B, const tau_grid<double> &grid,
+    const int SolveOrder);
+  template void convolution_timestep_tv_grid<double>(int n, herm_matrix<double> &C,
+    herm_matrix<double> &A, herm_matrix<double> &Acc, herm_matrix<double> &B,
+    herm_matrix<double> &Bcc, const tau_grid<double> &grid, double h, const int SolveOrder);
+  template void vie2_mat_grid<double>(herm_matrix<double> &G, herm_matrix<double> &F,
+    herm_matrix<double> &Q, const tau_grid<double> &grid, const int SolveOrder);
+  template void vie2_start_tv_grid<double>(herm_matrix<double> &G,
+    herm_matrix<double> &F, herm_matrix<double> &Fcc, herm_matrix<double> &Q,
+    const tau_grid<double> &grid, double h, const int SolveOrder);
+  template void vie2_timestep_tv_grid<double>(int n, herm_matrix<double> &G,
+    herm_matrix<double> &F, herm_matrix<double> &Fcc, herm_matrix<double> &Q,
+    const tau_grid<double> &grid, double h, const int SolveOrder);
+  template void dyson_mat_grid<double>(herm_matrix<double> &G, double mu,
+    function<double> &H, herm_matrix<double> &Sigma, const tau_grid<double> &grid,
+    const int SolveOrder);
+  template void dyson_start_tv_grid<double>(herm_matrix<double> &G, double mu,
+    function<double> &H, herm_matrix<double> &Sigma, const tau_grid<double> &grid, double h,
+    const int SolveOrder);
+  template void dyson_timestep_tv_grid<double>(int n, herm_matrix<double> &G, double mu,
+    function<double> &H, herm_matrix<double> &Sigma, const tau_grid<double> &grid, double h,
+    const int SolveOrder);
+
+}  // namespace cntr
+
@@ -0,0 +1,37 @@
+#ifndef CNTR_TAU_GRID_EXTERN_TEMPLATES_H
+#define CNTR_TAU_GRID_EXTERN_TEMPLATES_H
+
+#include "cntr_tau_grid_decl.hpp"
+
+namespace cntr {
+
+  extern template class tau_grid<double>;
+  extern template void green_from_H<double>(herm_matrix<double> &G, double mu, cdmatrix &H,
+    const tau_grid<double> &grid, double h);
+  extern template void convolution_mat_grid<double>(herm_matrix<double> &C,
+    herm_matrix<double> &A, herm_matrix<double> &B, const tau_grid<double> &grid,
+    const int SolveOrder);
+  extern template void convolution_timestep_tv_grid<double>(int n, herm_matrix<double> &C,
+    herm_matrix<double> &A, herm_matrix<double> &Acc, herm_matrix<double> &B,
+    herm_matrix<double> &Bcc, const tau_grid<double> &grid, double h, const int SolveOrder);
+  extern template void vie2_mat_grid<double>(herm_matrix<double> &G, herm_matrix<double> &F,
+    herm_matrix<double> &Q, const tau_grid<double> &grid, const int SolveOrder);
+  extern template void vie2_start_tv_grid<double>(herm_matrix<double> &G,
+    herm_matrix<double> &F, herm_matrix<double> &Fcc, herm_matrix<double> &Q,
+    const tau_grid<double> &grid, double h, const int SolveOrder);
+  extern template void vie2_timestep_tv_grid<double>(int n, herm_matrix<double> &G,
+    herm_matrix<double> &F, herm_matrix<double> &Fcc, herm_matrix<double> &Q,
+    const tau_grid<double> &grid, double h, const int SolveOrder);
+  extern template void dyson_mat_grid<double>(herm_matrix<double> &G, double mu,
+    function<double> &H, herm_matrix<double> &Sigma, const tau_grid<double> &grid,
+    const int SolveOrder);
+  extern template void dyson_start_tv_grid<double>(herm_matrix<double> &G, double mu,
+    function<double> &H, herm_matrix<double> &Sigma, const tau_grid<double> &grid, double h,
+    const int SolveOrder);
+  extern template void dyson_timestep_tv_grid<double>(int n, herm_matrix<double> &G, double mu,
+    function<double> &H, herm_matrix<double> &Sigma, const tau_grid<double> &grid, double h,
+    const int SolveOrder);
+
+}  // namespace cntr
+
+#endif  // CNTR_TAU_GRID_EXTERN_TEMPLATES_H
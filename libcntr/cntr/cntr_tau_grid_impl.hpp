@@ -0,0 +1,805 @@
+#ifndef CNTR_TAU_GRID_IMPL_H
+#define CNTR_TAU_GRID_IMPL_H
+
+#include "cntr_tau_grid_decl.hpp"
+#include "cntr_elements.hpp"
+#include "cntr_herm_matrix_decl.hpp"
+#include "cntr_function_decl.hpp"
+#include "cntr_equilibrium_decl.hpp"
+#include "integration.hpp"
+
+namespace cntr {
+
+template <typename T>
+tau_grid<T>::tau_grid() {
+    ntau_ = 0;
+    beta_ = 0.0;
+    type_ = CNTR_TAU_UNIFORM;
+    c_ = 0.0;
+}
+/** \brief <b> Initializes the imaginary-time grid. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Computes the grid points \f$ \tau_m \f$ and the spacings \f$ \tau'(x_m)/n_\tau \f$.
+ * > The end points are exactly \f$ 0 \f$ and \f$ \beta \f$, and
+ * > \f$ \tau_{n_\tau-m}=\beta-\tau_m \f$ holds exactly.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param ntau
+ * > [int] Number of intervals.
+ * @param beta
+ * > [T] Inverse temperature.
+ * @param type
+ * > [int] `CNTR_TAU_UNIFORM` or `CNTR_TAU_TANH`.
+ * @param c
+ * > [T] Compression \f$ c>0 \f$ of the tanh grid; not used for the uniform grid.
+ */
+template <typename T>
+tau_grid<T>::tau_grid(int ntau, T beta, int type, T c) {
+    assert(ntau > 0 && beta > 0.0 && "ntau > 0, beta > 0");
+    assert((type == CNTR_TAU_UNIFORM || (type == CNTR_TAU_TANH && c > 0.0)) && "grid type");
+    ntau_ = ntau;
+    beta_ = beta;
+    type_ = type;
+    c_ = (type == CNTR_TAU_UNIFORM ? 0.0 : c);
+    tau_.resize(ntau + 1);
+    dtau_.resize(ntau + 1);
+    for (int m = 0; m <= ntau; m++) {
+        T x = ((T)m) / ntau;
+        if (type == CNTR_TAU_UNIFORM) {
+            tau_[m] = beta * x;
+            dtau_[m] = beta / ntau;
+        } else {
+            T tc = tanh(c), y = tanh(c * (2.0 * x - 1.0));
+            tau_[m] = 0.5 * beta * (1.0 + y / tc);
+            dtau_[m] = beta * c * (1.0 - y * y) / (tc * ntau);
+        }
+    }
+    for (int m = 0; 2 * m <= ntau; m++)
+        tau_[ntau - m] = beta - tau_[m];
+    tau_[0] = 0.0;
+    tau_[ntau] = beta;
+}
+/** \brief <b> Fractional index \f$ n_\tau x \f$ of \f$ \tau \in [0,\beta] \f$, i.e. the inverse
+ * of \f$ m \to \tau_m \f$. </b>
+ */
+template <typename T>
+T tau_grid<T>::index(T tau) const {
+    T u = tau / beta_;
+    u = (u < 0.0 ? 0.0 : (u > 1.0 ? 1.0 : u));
+    if (type_ == CNTR_TAU_UNIFORM)
+        return u * ntau_;
+    return 0.5 * (1.0 + atanh((2.0 * u - 1.0) * tanh(c_)) / c_) * ntau_;
+}
+/** \brief <b> Weight of \f$ \tau_m \f$ in the Gregory quadrature of order `k` of
+ * \f$ \int_0^\beta d\tau f(\tau) \f$. </b>
+ */
+template <typename T>
+T tau_grid<T>::weight(int m, int k) const {
+    assert(ntau_ >= k && "ntau >= k");
+    return integration::I<T>(k).gregory_weights(ntau_, m) * dtau_[m];
+}
+/** \brief <b> Lagrange interpolation of order `k` at \f$ \tau \f$. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > \f$ f(\tau) \approx \sum_{i=0}^{k} c_i f(\tau_{j_0+i}) \f$ with the \f$ k+1 \f$ grid points
+ * > around \f$ \tau \f$. For \f$ \tau \f$ outside \f$ [0,\beta] \f$ the stencil is the first or
+ * > last one, i.e. \f$ f \f$ is extrapolated smoothly.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tau
+ * > [T] The argument.
+ * @param k
+ * > [int] The order; requires `ntau() >= k`.
+ * @param j0
+ * > [int] On return, the first point of the stencil.
+ * @param c
+ * > [T*] On return, the \f$ k+1 \f$ coefficients.
+ */
+template <typename T>
+void tau_grid<T>::stencil(T tau, int k, int &j0, T *c) const {
+    assert(ntau_ >= k && "ntau >= k");
+    j0 = (int)floor(index(tau)) - k / 2;
+    j0 = (j0 < 0 ? 0 : (j0 > ntau_ - k ? ntau_ - k : j0));
+    for (int i = 0; i <= k; i++) {
+        c[i] = 1.0;
+        for (int l = 0; l <= k; l++)
+            if (l != i)
+                c[i] *= (tau - tau_[j0 + l]) / (tau_[j0 + i] - tau_[j0 + l]);
+    }
+}
+/** \brief <b> Interpolates the matrix-valued \f$ f \f$, layout `f[m*size1*size1]`, at
+ * \f$ \tau \f$, see `stencil`. </b>
+ */
+template <typename T>
+void tau_grid<T>::interpolate(int size1, T tau, const cplx *f, cplx *val, int k) const {
+    int j0, es = size1 * size1;
+    std::vector<T> c(k + 1);
+    stencil(tau, k, j0, c.data());
+    for (int l = 0; l < es; l++)
+        val[l] = 0.0;
+    for (int i = 0; i <= k; i++) {
+        const cplx *fi = f + (j0 + i) * es;
+        for (int l = 0; l < es; l++)
+            val[l] += c[i] * fi[l];
+    }
+}
+
+/// @private
+/** \brief <b> Quadrature kernel of a Matsubara convolution on a `tau_grid`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Computes matrices \f$ w_j \f$ with \f$ \int_0^\beta d\tau' f(s(\tau_m-\tau')) X(\tau')
+ * > \approx \sum_j w_j X(\tau_j) \f$ (\f$ s=1 \f$), or \f$ \int_0^\beta d\tau' X(\tau')
+ * > f(s(\tau_m-\tau')) \approx \sum_j X(\tau_j) w_j \f$ (\f$ s=-1 \f$), for \f$ f \f$ given on
+ * > the grid. The integral is split at \f$ \tau_m \f$, negative arguments of \f$ f \f$ are
+ * > mapped by \f$ f(\tau-\beta)=\sigma f(\tau) \f$. Each piece is integrated with the
+ * > Gregory weights in \f$ x \f$; short pieces (less than `k` intervals) use points beyond
+ * > \f$ \tau_m \f$, where the smooth continuation of \f$ f \f$ is extrapolated.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param size1
+ * > [int] Matrix size.
+ * @param m
+ * > [int] The index of \f$ \tau_m \f$.
+ * @param s
+ * > [int] \f$ \pm 1 \f$, see above.
+ * @param sig
+ * > [int] Bose (1) or Fermi (-1) periodicity of \f$ f \f$.
+ * @param grid
+ * > [tau_grid] The grid.
+ * @param I
+ * > [Integrator] Integrator class.
+ * @param f
+ * > [complex<T>*] \f$ f(\tau_j) \f$, layout `f[j*size1*size1]`.
+ * @param w
+ * > [complex<T>*] On return, \f$ w_j \f$, layout `w[j*size1*size1]`, \f$ j=0,\dots,n_\tau \f$.
+ */
+template <typename T>
+void tau_grid_kernel(int size1, int m, int s, int sig, const tau_grid<T> &grid,
+                     integration::Integrator<T> &I, const std::complex<T> *f,
+                     std::complex<T> *w) {
+    typedef std::complex<T> cplx;
+    int k = I.get_k(), ntau = grid.ntau(), es = size1 * size1;
+    T beta = grid.beta(), taum = grid.tau(m);
+    std::vector<cplx> fx(es);
+    for (int l = 0; l < (ntau + 1) * es; l++)
+        w[l] = 0.0;
+    // [0,tau_m]: tau' at points j=0,1,..., f(tau_m-tau') if s=1, sig*f(beta+tau'-tau_m) if s=-1
+    if (m > 0) {
+        for (int j = 0; j <= (m > k ? m : k); j++) {
+            T d = s * (taum - grid.tau(j));
+            T wt = I.gregory_weights(m, j) * grid.dtau(j) * (s == 1 ? 1 : sig);
+            grid.interpolate(size1, (s == 1 ? d : beta + d), f, fx.data(), k);
+            for (int l = 0; l < es; l++)
+                w[j * es + l] += wt * fx[l];
+        }
+    }
+    // [tau_m,beta]: tau' at points j=ntau,ntau-1,...
+    int len = ntau - m;
+    if (len > 0) {
+        for (int i = 0; i <= (len > k ? len : k); i++) {
+            int j = ntau - i;
+            T d = s * (taum - grid.tau(j));
+            T wt = I.gregory_weights(len, i) * grid.dtau(j) * (s == 1 ? sig : 1);
+            grid.interpolate(size1, (s == 1 ? beta + d : d), f, fx.data(), k);
+            for (int l = 0; l < es; l++)
+                w[j * es + l] += wt * fx[l];
+        }
+    }
+}
+/// @private
+// ctv(tau_m) = int_0^beta dtau' atv(tau') bmat(tau'-tau_m) for all m
+template <typename T>
+void tau_grid_tv_integral(int size1, int sig, const tau_grid<T> &grid,
+                          integration::Integrator<T> &I, std::complex<T> *atv,
+                          std::complex<T> *bmat, std::complex<T> *ctv) {
+    int ntau = grid.ntau(), es = size1 * size1;
+    std::vector<std::complex<T> > w((ntau + 1) * es);
+    for (int m = 0; m <= ntau; m++) {
+        tau_grid_kernel(size1, m, -1, sig, grid, I, bmat, w.data());
+        element_set_zero<T, LARGESIZE>(size1, ctv + m * es);
+        for (int j = 0; j <= ntau; j++)
+            element_incr<T, LARGESIZE>(size1, ctv + m * es, atv + j * es, &w[j * es]);
+    }
+}
+/// @private
+// G^M(tau_m) = -V diag(g(eps,tau_m)) V^dagger, eps the eigenvalues of H-mu
+template <typename T>
+void tau_grid_green_mat(herm_matrix<T> &G, T mu, cdmatrix &H, const tau_grid<T> &grid) {
+    int size1 = G.size1(), sig = G.sig();
+    T beta = grid.beta();
+    Eigen::SelfAdjointEigenSolver<cdmatrix> eig(H - mu * cdmatrix::Identity(size1, size1));
+    cdmatrix V = eig.eigenvectors(), value;
+    dvector g(size1);
+    for (int m = 0; m <= grid.ntau(); m++) {
+        T tau = grid.tau(m);
+        for (int i = 0; i < size1; i++) {
+            T e = eig.eigenvalues()(i);
+            assert((sig == -1 || e != 0.0) && "bosonic zero mode");
+            if (e >= 0.0)
+                g(i) = exp(-e * tau) / (1.0 - sig * exp(-beta * e));
+            else
+                g(i) = -sig * exp(e * (beta - tau)) / (1.0 - sig * exp(beta * e));
+        }
+        value = -V * g.asDiagonal() * V.adjoint();
+        G.set_mat(m, value);
+    }
+}
+/// @private
+/** \brief <b> Left-mixing convolution at a time step on a `tau_grid`, result written to `ctv`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > As `convolution_timestep_tv`, with the \f$ \tau \f$-integral evaluated on the grid.
+ */
+template <typename T>
+void tau_grid_convolution_tv(int n, std::complex<T> *ctv, herm_matrix<T> &A,
+                             herm_matrix<T> &Acc, herm_matrix<T> &B, const tau_grid<T> &grid,
+                             integration::Integrator<T> &I, T h) {
+    typedef std::complex<T> cplx;
+    int k = I.get_k(), n1 = (n > k ? n : k), ntau = grid.ntau();
+    int size1 = A.size1(), es = size1 * size1;
+    std::vector<cplx> atemp(es);
+    tau_grid_tv_integral(size1, B.sig(), grid, I, A.tvptr(n, 0), B.matptr(0), ctv);
+    for (int j = 0; j <= n1; j++) {
+        T weight = I.gregory_weights(n, j);
+        if (n < j) {
+            element_conj<T, LARGESIZE>(size1, atemp.data(), Acc.retptr(j, n));
+            element_smul<T, LARGESIZE>(size1, atemp.data(), -1);
+        } else {
+            element_set<T, LARGESIZE>(size1, atemp.data(), A.retptr(n, j));
+        }
+        element_smul<T, LARGESIZE>(size1, atemp.data(), h * weight);
+        for (int m = 0; m <= ntau; m++)
+            element_incr<T, LARGESIZE>(size1, ctv + m * es, atemp.data(), B.tvptr(j, m));
+    }
+}
+
+/** \brief <b> Equilibrium Green's function of a constant Hamiltonian on a `tau_grid`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > As `green_from_H` for a constant \f$ H \f$, with the Matsubara and left-mixing components
+ * > at the points \f$ \tau_m \f$ of the grid.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix] On return, the Green's function; `G.ntau()==grid.ntau()`.
+ * @param mu
+ * > [T] Chemical potential.
+ * @param H
+ * > [cdmatrix] Hamiltonian.
+ * @param grid
+ * > [tau_grid] The imaginary-time grid.
+ * @param h
+ * > [T] Time step.
+ */
+template <typename T>
+void green_from_H(herm_matrix<T> &G, T mu, cdmatrix &H, const tau_grid<T> &grid, T h) {
+    typedef std::complex<T> cplx;
+    int ntau = grid.ntau(), sig = G.sig();
+    assert(G.ntau() == ntau && "G.ntau() == grid.ntau()");
+    assert(H.rows() == G.size1() && H.cols() == G.size1() && "size of H");
+    cdmatrix u, gm, value;
+    // retarded and lesser components do not depend on the tau grid
+    green_from_H(G, mu, H, grid.beta(), h);
+    tau_grid_green_mat(G, mu, H, grid);
+    // G^tv(t,tau) = U(t) G^tv(0,tau), U(t) = i G^R(t,0), G^tv(0,tau) = i sig G^M(beta-tau)
+    for (int n = 0; n <= G.nt(); n++) {
+        G.get_ret(n, 0, u);
+        u *= cplx(0.0, 1.0);
+        for (int m = 0; m <= ntau; m++) {
+            G.get_mat(ntau - m, gm);
+            value = cplx(0.0, (T)sig) * u * gm;
+            G.set_tv(n, m, value);
+        }
+    }
+}
+/** \brief <b> Matsubara convolution \f$ C=A*B \f$ on a `tau_grid`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Computes \f$ C^\mathrm{M}(\tau_m)=\int_0^\beta d\tau' A^\mathrm{M}(\tau_m-\tau')
+ * > B^\mathrm{M}(\tau') \f$ at the grid points, with \f$ A^\mathrm{M} \f$ interpolated between
+ * > them. The cost is \f$ O(n_\tau^2) \f$ as for `convolution_matsubara`, but the grid can be
+ * > much coarser for functions that vary rapidly near \f$ \tau=0,\beta \f$.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param C
+ * > [herm_matrix] On return, the Matsubara component of the convolution.
+ * @param A
+ * > [herm_matrix] Contour function.
+ * @param B
+ * > [herm_matrix] Contour function.
+ * @param grid
+ * > [tau_grid] The imaginary-time grid of `A`, `B`, `C`.
+ * @param SolveOrder
+ * > [int] Integration order.
+ */
+template <typename T>
+void convolution_mat_grid(herm_matrix<T> &C, herm_matrix<T> &A, herm_matrix<T> &B,
+                          const tau_grid<T> &grid, const int SolveOrder) {
+    int ntau = grid.ntau(), size1 = C.size1(), es = size1 * size1;
+    integration::Integrator<T> &I = integration::I<T>(SolveOrder);
+    assert(A.ntau() == ntau && B.ntau() == ntau && C.ntau() == ntau && "ntau");
+    assert(A.size1() == size1 && B.size1() == size1 && "size1");
+    assert(A.sig() == B.sig() && "sig");
+    assert(ntau >= SolveOrder && "ntau >= SolveOrder");
+    std::vector<std::complex<T> > w((ntau + 1) * es);
+    for (int m = 0; m <= ntau; m++) {
+        tau_grid_kernel(size1, m, 1, A.sig(), grid, I, A.matptr(0), w.data());
+        element_set_zero<T, LARGESIZE>(size1, C.matptr(m));
+        for (int j = 0; j <= ntau; j++)
+            element_incr<T, LARGESIZE>(size1, C.matptr(m), &w[j * es], B.matptr(j));
+    }
+}
+/** \brief <b> Left-mixing convolution \f$ C=A*B \f$ at a time step on a `tau_grid`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Computes \f$ C^\rceil(t_n,\tau_m)=\int_0^\beta d\tau' A^\rceil(t_n,\tau')
+ * > B^\mathrm{M}(\tau'-\tau_m) + \int_0^{t_n} ds A^\mathrm{R}(t_n,s) B^\rceil(s,\tau_m) \f$,
+ * > as `convolution_timestep` does for the left-mixing component.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param n
+ * > [int] Time step, \f$ n \geq 0 \f$.
+ * @param C
+ * > [herm_matrix] On return, \f$ C^\rceil \f$ at time step `n`.
+ * @param A
+ * > [herm_matrix] Contour function.
+ * @param Acc
+ * > [herm_matrix] Hermitian conjugate of `A`.
+ * @param B
+ * > [herm_matrix] Contour function.
+ * @param Bcc
+ * > [herm_matrix] Hermitian conjugate of `B`.
+ * @param grid
+ * > [tau_grid] The imaginary-time grid.
+ * @param h
+ * > [T] Time step.
+ * @param SolveOrder
+ * > [int] Integration order.
+ */
+template <typename T>
+void convolution_timestep_tv_grid(int n, herm_matrix<T> &C, herm_matrix<T> &A,
+                                  herm_matrix<T> &Acc, herm_matrix<T> &B, herm_matrix<T> &Bcc,
+                                  const tau_grid<T> &grid, T h, const int SolveOrder) {
+    int ntau = grid.ntau(), size1 = C.size1(), n1 = (n > SolveOrder ? n : SolveOrder);
+    integration::Integrator<T> &I = integration::I<T>(SolveOrder);
+    assert(n >= 0 && C.nt() >= n && "0 <= n <= C.nt()");
+    assert(A.nt() >= n1 && Acc.nt() >= n1 && B.nt() >= n1 && Bcc.nt() >= n1 && "nt");
+    assert(A.ntau() == ntau && B.ntau() == ntau && C.ntau() == ntau && "ntau");
+    assert(A.size1() == size1 && Acc.size1() == size1 && B.size1() == size1 && "size1");
+    assert(ntau >= SolveOrder && "ntau >= SolveOrder");
+    tau_grid_convolution_tv(n, C.tvptr(n, 0), A, Acc, B, grid, I, h);
+}
+
+/** \brief <b> Solves the Matsubara VIE \f$ G+F*G=Q \f$ on a `tau_grid`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > The discretized equation \f$ G(\tau_m)+\sum_j w_{mj}[F] G(\tau_j) = Q(\tau_m) \f$, with the
+ * > weights of `convolution_mat_grid`, is solved directly as a dense linear system of
+ * > dimension \f$ (n_\tau+1) \f$`size1`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix] On return, the Matsubara component of the solution.
+ * @param F
+ * > [herm_matrix] Kernel.
+ * @param Q
+ * > [herm_matrix] Source term.
+ * @param grid
+ * > [tau_grid] The imaginary-time grid.
+ * @param SolveOrder
+ * > [int] Integration order.
+ */
+template <typename T>
+void vie2_mat_grid(herm_matrix<T> &G, herm_matrix<T> &F, herm_matrix<T> &Q,
+                   const tau_grid<T> &grid, const int SolveOrder) {
+    int ntau = grid.ntau(), size1 = G.size1(), es = size1 * size1, dim = (ntau + 1) * size1;
+    integration::Integrator<T> &I = integration::I<T>(SolveOrder);
+    assert(F.ntau() == ntau && G.ntau() == ntau && Q.ntau() == ntau && "ntau");
+    assert(F.size1() == size1 && Q.size1() == size1 && "size1");
+    assert(F.sig() == G.sig() && "sig");
+    assert(ntau >= SolveOrder && "ntau >= SolveOrder");
+    std::vector<std::complex<T> > w((ntau + 1) * es);
+    cdmatrix M = cdmatrix::Identity(dim, dim), q(dim, size1), x;
+    for (int m = 0; m <= ntau; m++) {
+        tau_grid_kernel(size1, m, 1, F.sig(), grid, I, F.matptr(0), w.data());
+        for (int j = 0; j <= ntau; j++)
+            for (int a = 0; a < size1; a++)
+                for (int b = 0; b < size1; b++)
+                    M(m * size1 + a, j * size1 + b) += w[j * es + a * size1 + b];
+        for (int a = 0; a < size1; a++)
+            for (int b = 0; b < size1; b++)
+                q(m * size1 + a, b) = Q.matptr(m)[a * size1 + b];
+    }
+    x = M.partialPivLu().solve(q);
+    for (int m = 0; m <= ntau; m++)
+        for (int a = 0; a < size1; a++)
+            for (int b = 0; b < size1; b++)
+                G.matptr(m)[a * size1 + b] = x(m * size1 + a, b);
+}
+/** \brief <b> Solves the left-mixing VIE \f$ G+F*G=Q \f$ for the first `SolveOrder` time steps
+ * on a `tau_grid`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > As `vie2_start` for the left-mixing component, with \f$ \tau \f$-integrals on the grid.
+ * > Requires \f$ G^\mathrm{M} \f$, e.g. from `vie2_mat_grid`, and \f$ G^\mathrm{R} \f$ is not used.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix] On return, \f$ G^\rceil \f$ at time steps \f$ 0,\dots,k \f$.
+ * @param F
+ * > [herm_matrix] Kernel.
+ * @param Fcc
+ * > [herm_matrix] Hermitian conjugate of `F`.
+ * @param Q
+ * > [herm_matrix] Source term.
+ * @param grid
+ * > [tau_grid] The imaginary-time grid.
+ * @param h
+ * > [T] Time step.
+ * @param SolveOrder
+ * > [int] Integration order \f$ k \f$.
+ */
+template <typename T>
+void vie2_start_tv_grid(herm_matrix<T> &G, herm_matrix<T> &F, herm_matrix<T> &Fcc,
+                        herm_matrix<T> &Q, const tau_grid<T> &grid, T h, const int SolveOrder) {
+    typedef std::complex<T> cplx;
+    int k = SolveOrder, k1 = k + 1, ntau = grid.ntau(), size1 = G.size1(), sg = size1 * size1;
+    integration::Integrator<T> &I = integration::I<T>(SolveOrder);
+    assert(F.nt() >= k && Fcc.nt() >= k && G.nt() >= k && Q.nt() >= k && "nt >= SolveOrder");
+    assert(F.ntau() == ntau && G.ntau() == ntau && Q.ntau() == ntau && "ntau");
+    assert(G.sig() == F.sig() && "sig");
+    assert(ntau >= SolveOrder && "ntau >= SolveOrder");
+    std::vector<cplx> mm(k1 * k1 * sg), qq(k1 * sg), gtemp(k1 * sg), stemp(sg), one(sg);
+    element_set<T, LARGESIZE>(size1, one.data(), 1.0);
+    // -int dtau F^tv(n,tau) G^mat(tau-tau_m) ---> Gtv(n,m)
+    for (int n = 0; n <= k; n++) {
+        tau_grid_tv_integral(size1, G.sig(), grid, I, F.tvptr(n, 0), G.matptr(0), G.tvptr(n, 0));
+        for (int l = 0; l < (ntau + 1) * sg; l++)
+            G.tvptr(n, 0)[l] = -G.tvptr(n, 0)[l];
+    }
+    for (int m = 0; m <= ntau; m++) {
+        std::fill(mm.begin(), mm.end(), 0.0);
+        std::fill(qq.begin(), qq.end(), 0.0);
+        for (int n = 0; n <= k; n++) {
+            element_incr<T, LARGESIZE>(size1, &mm[sg * (n * k1 + n)], one.data());
+            for (int j = 0; j <= k; j++) {
+                cplx cweight = h * I.gregory_weights(n, j);
+                if (n >= j) {
+                    element_set<T, LARGESIZE>(size1, stemp.data(), F.retptr(n, j));
+                } else {
+                    element_conj<T, LARGESIZE>(size1, stemp.data(), Fcc.retptr(j, n));
+                    element_smul<T, LARGESIZE>(size1, stemp.data(), -1);
+                }
+                for (int l = 0; l < sg; l++)
+                    mm[sg * (n * k1 + j) + l] += cweight * stemp[l];
+            }
+            element_incr<T, LARGESIZE>(size1, &qq[n * sg], G.tvptr(n, m));
+            element_incr<T, LARGESIZE>(size1, &qq[n * sg], Q.tvptr(n, m));
+        }
+        element_linsolve_right<T, LARGESIZE>(size1, k1, gtemp.data(), mm.data(), qq.data());
+        for (int n = 0; n <= k; n++)
+            element_set<T, LARGESIZE>(size1, G.tvptr(n, m), &gtemp[n * sg]);
+    }
+}
+/** \brief <b> Solves the left-mixing VIE \f$ G+F*G=Q \f$ at a time step on a `tau_grid`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > As `vie2_timestep` for the left-mixing component, with \f$ \tau \f$-integrals on the grid.
+ * > Requires \f$ n > k \f$ and \f$ G^\rceil \f$ at the earlier time steps.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param n
+ * > [int] Time step.
+ * @param G
+ * > [herm_matrix] On return, \f$ G^\rceil \f$ at time step `n`.
+ * @param F
+ * > [herm_matrix] Kernel.
+ * @param Fcc
+ * > [herm_matrix] Hermitian conjugate of `F`.
+ * @param Q
+ * > [herm_matrix] Source term.
+ * @param grid
+ * > [tau_grid] The imaginary-time grid.
+ * @param h
+ * > [T] Time step.
+ * @param SolveOrder
+ * > [int] Integration order \f$ k \f$.
+ */
+template <typename T>
+void vie2_timestep_tv_grid(int n, herm_matrix<T> &G, herm_matrix<T> &F, herm_matrix<T> &Fcc,
+                           herm_matrix<T> &Q, const tau_grid<T> &grid, T h,
+                           const int SolveOrder) {
+    typedef std::complex<T> cplx;
+    int ntau = grid.ntau(), size1 = G.size1(), sg = size1 * size1;
+    integration::Integrator<T> &I = integration::I<T>(SolveOrder);
+    assert(n > SolveOrder && "n > SolveOrder");
+    assert(F.nt() >= n && G.nt() >= n && Q.nt() >= n && "nt >= n");
+    assert(F.ntau() == ntau && G.ntau() == ntau && Q.ntau() == ntau && "ntau");
+    assert(G.sig() == F.sig() && "sig");
+    assert(ntau >= SolveOrder && "ntau >= SolveOrder");
+    std::vector<cplx> mm(sg), qq(sg), ctv((ntau + 1) * sg);
+    // F*G with G^tv(n) = 0
+    for (int m = 0; m <= ntau; m++)
+        element_set_zero<T, LARGESIZE>(size1, G.tvptr(n, m));
+    tau_grid_convolution_tv(n, ctv.data(), F, Fcc, G, grid, I, h);
+    // [ 1 + h w(n,n) F(n,n) ] G(n,m) = Q(n,m) - [F*G](n,m)
+    element_set<T, LARGESIZE>(size1, mm.data(), F.retptr(n, n));
+    element_smul<T, LARGESIZE>(size1, mm.data(), h * I.gregory_weights(n, n));
+    for (int i = 0; i < size1; i++)
+        mm[i * size1 + i] += 1.0;
+    for (int m = 0; m <= ntau; m++) {
+        for (int l = 0; l < sg; l++)
+            qq[l] = Q.tvptr(n, m)[l] - ctv[m * sg + l];
+        element_linsolve_right<T, LARGESIZE>(size1, G.tvptr(n, m), mm.data(), qq.data());
+    }
+}
+
+/** \brief <b> Solves the Matsubara Dyson equation on a `tau_grid`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Solves \f$ [-\partial_\tau + \mu - H] G^\mathrm{M}(\tau) - [\Sigma^\mathrm{M}*G^\mathrm{M}](\tau)
+ * > = \delta(\tau) \f$ as the VIE \f$ G + F*G = G_0 \f$, \f$ F=-G_0*\Sigma \f$, with the free
+ * > \f$ G_0 \f$ evaluated exactly at the grid points, see `vie2_mat_grid`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix] On return, the Matsubara component of the solution.
+ * @param mu
+ * > [T] Chemical potential.
+ * @param H
+ * > [function] Hamiltonian; only \f$ H(-1) \f$ is used.
+ * @param Sigma
+ * > [herm_matrix] Self-energy.
+ * @param grid
+ * > [tau_grid] The imaginary-time grid.
+ * @param SolveOrder
+ * > [int] Integration order.
+ */
+template <typename T>
+void dyson_mat_grid(herm_matrix<T> &G, T mu, function<T> &H, herm_matrix<T> &Sigma,
+                    const tau_grid<T> &grid, const int SolveOrder) {
+    int ntau = grid.ntau(), size1 = G.size1();
+    assert(Sigma.ntau() == ntau && G.ntau() == ntau && "ntau");
+    assert(Sigma.size1() == size1 && H.size1() == size1 && "size1");
+    assert(G.sig() == Sigma.sig() && "sig");
+    herm_matrix<T> G0(-1, ntau, size1, G.sig()), F(-1, ntau, size1, G.sig());
+    cdmatrix h0;
+    H.get_value(-1, h0);
+    tau_grid_green_mat(G0, mu, h0, grid);
+    convolution_mat_grid(F, G0, Sigma, grid, SolveOrder);
+    F.smul(-1, -1.0);
+    vie2_mat_grid(G, F, G0, grid, SolveOrder);
+}
+/** \brief <b> Solves the left-mixing Dyson equation for the first `SolveOrder` time steps on a
+ * `tau_grid`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > As `dyson_start` for the left-mixing component, with \f$ \tau \f$-integrals on the grid.
+ * > Requires \f$ G^\mathrm{M} \f$, e.g. from `dyson_mat_grid`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix] On return, \f$ G^\rceil \f$ at time steps \f$ 0,\dots,k \f$.
+ * @param mu
+ * > [T] Chemical potential.
+ * @param H
+ * > [function] Hamiltonian.
+ * @param Sigma
+ * > [herm_matrix] Self-energy.
+ * @param grid
+ * > [tau_grid] The imaginary-time grid.
+ * @param h
+ * > [T] Time step.
+ * @param SolveOrder
+ * > [int] Integration order \f$ k \f$.
+ */
+template <typename T>
+void dyson_start_tv_grid(herm_matrix<T> &G, T mu, function<T> &H, herm_matrix<T> &Sigma,
+                         const tau_grid<T> &grid, T h, const int SolveOrder) {
+    typedef std::complex<T> cplx;
+    int k = SolveOrder, ntau = grid.ntau(), size1 = G.size1(), sg = size1 * size1, p, q;
+    integration::Integrator<T> &I = integration::I<T>(SolveOrder);
+    cplx cweight, cplx_i = cplx(0.0, 1.0);
+    assert(Sigma.nt() >= k && G.nt() >= k && H.nt() >= k && "nt >= SolveOrder");
+    assert(Sigma.ntau() == ntau && G.ntau() == ntau && "ntau");
+    assert(G.sig() == Sigma.sig() && "sig");
+    assert(ntau >= SolveOrder && "ntau >= SolveOrder");
+    std::vector<cplx> mm(k * k * sg), qq(k * sg), gtemp(k * sg), stemp(sg), one(sg);
+    element_set<T, LARGESIZE>(size1, one.data(), 1.0);
+    // G^tv(0,tau_m) = i sig G^mat(beta-tau_m) = i sig G^mat(tau_{ntau-m})
+    for (int m = 0; m <= ntau; m++)
+        for (int l = 0; l < sg; l++)
+            G.tvptr(0, m)[l] = ((T)G.sig()) * cplx_i * G.matptr(ntau - m)[l];
+    // int dtau Sigma^tv(n,tau) G^mat(tau-tau_m) ---> Gtv(n,m)
+    for (int n = 1; n <= k; n++)
+        tau_grid_tv_integral(size1, G.sig(), grid, I, Sigma.tvptr(n, 0), G.matptr(0),
+                             G.tvptr(n, 0));
+    for (int m = 0; m <= ntau; m++) {
+        std::fill(mm.begin(), mm.end(), 0.0);
+        std::fill(qq.begin(), qq.end(), 0.0);
+        for (int n = 1; n <= k; n++) {
+            p = n - 1;
+            // derivative id/dt Gtv(n,m)
+            for (int j = 0; j <= k; j++) {
+                cweight = cplx_i / h * I.poly_differentiation(n, j);
+                if (j == 0) {
+                    for (int l = 0; l < sg; l++)
+                        qq[p * sg + l] -= cweight * G.tvptr(0, m)[l];
+                } else {
+                    q = j - 1;
+                    for (int l = 0; l < sg; l++)
+                        mm[sg * (p * k + q) + l] += cweight * one[l];
+                }
+            }
+            // mu - H(n)
+            element_set<T, LARGESIZE>(size1, gtemp.data(), H.ptr(n));
+            element_smul<T, LARGESIZE>(size1, gtemp.data(), -1.0);
+            for (int l = 0; l < sg; l++)
+                gtemp[l] += mu * one[l];
+            element_incr<T, LARGESIZE>(size1, &mm[sg * (p * k + p)], gtemp.data());
+            // integral 0..n
+            for (int j = 0; j <= k; j++) {
+                cweight = h * I.gregory_weights(n, j);
+                if (j == 0) {
+                    element_incr<T, LARGESIZE>(size1, &qq[p * sg], cweight, Sigma.retptr(n, 0),
+                                               G.tvptr(0, m));
+                } else {
+                    q = j - 1;
+                    if (n >= j) {
+                        element_set<T, LARGESIZE>(size1, stemp.data(), Sigma.retptr(n, j));
+                    } else {
+                        element_conj<T, LARGESIZE>(size1, stemp.data(), Sigma.retptr(j, n));
+                        element_smul<T, LARGESIZE>(size1, stemp.data(), -1);
+                    }
+                    for (int l = 0; l < sg; l++)
+                        mm[sg * (p * k + q) + l] += -cweight * stemp[l];
+                }
+            }
+            element_incr<T, LARGESIZE>(size1, &qq[p * sg], G.tvptr(n, m));
+        }
+        element_linsolve_right<T, LARGESIZE>(size1, k, gtemp.data(), mm.data(), qq.data());
+        for (int n = 1; n <= k; n++)
+            element_set<T, LARGESIZE>(size1, G.tvptr(n, m), &gtemp[(n - 1) * sg]);
+    }
+}
+/** \brief <b> Solves the left-mixing Dyson equation at a time step on a `tau_grid`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > As `dyson_timestep` for the left-mixing component, with \f$ \tau \f$-integrals on the grid.
+ * > Requires \f$ n > k \f$ and \f$ G^\rceil \f$ at the earlier time steps.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param n
+ * > [int] Time step.
+ * @param G
+ * > [herm_matrix] On return, \f$ G^\rceil \f$ at time step `n`.
+ * @param mu
+ * > [T] Chemical potential.
+ * @param H
+ * > [function] Hamiltonian.
+ * @param Sigma
+ * > [herm_matrix] Self-energy.
+ * @param grid
+ * > [tau_grid] The imaginary-time grid.
+ * @param h
+ * > [T] Time step.
+ * @param SolveOrder
+ * > [int] Integration order \f$ k \f$.
+ */
+template <typename T>
+void dyson_timestep_tv_grid(int n, herm_matrix<T> &G, T mu, function<T> &H,
+                            herm_matrix<T> &Sigma, const tau_grid<T> &grid, T h,
+                            const int SolveOrder) {
+    typedef std::complex<T> cplx;
+    int k = SolveOrder, ntau = grid.ntau(), size1 = G.size1(), sg = size1 * size1;
+    integration::Integrator<T> &I = integration::I<T>(SolveOrder);
+    cplx ih = cplx(0.0, 1.0 / h);
+    assert(n > SolveOrder && "n > SolveOrder");
+    assert(Sigma.nt() >= n && G.nt() >= n && H.nt() >= n && "nt >= n");
+    assert(Sigma.ntau() == ntau && G.ntau() == ntau && "ntau");
+    assert(G.sig() == Sigma.sig() && "sig");
+    assert(ntau >= SolveOrder && "ntau >= SolveOrder");
+    std::vector<cplx> mm(sg), qq(sg), htemp(sg), ctv((ntau + 1) * sg);
+    // Sigma*G with G^tv(n) = 0
+    for (int m = 0; m <= ntau; m++)
+        element_set_zero<T, LARGESIZE>(size1, G.tvptr(n, m));
+    tau_grid_convolution_tv(n, ctv.data(), Sigma, Sigma, G, grid, I, h);
+    // contribution to id/dt G(t,tau_m) from t=jh, j=n-k-1..n-1 (BD(k+1))
+    for (int j = n - k - 1; j < n; j++) {
+        cplx cweight = ih * I.bd_weights(n - j);
+        for (int l = 0; l < (ntau + 1) * sg; l++)
+            ctv[l] -= cweight * G.tvptr(j, 0)[l];
+    }
+    // [ i/h bd(0) + mu - H - h w(n,n) Sigma(n,n) ] G(n,m) = Q(m)
+    element_set<T, LARGESIZE>(size1, mm.data(), Sigma.retptr(n, n));
+    element_smul<T, LARGESIZE>(size1, mm.data(), -h * I.gregory_weights(n, n));
+    element_set<T, LARGESIZE>(size1, htemp.data(), H.ptr(n));
+    for (int l = 0; l < sg; l++)
+        mm[l] -= htemp[l];
+    for (int i = 0; i < size1; i++)
+        mm[i * size1 + i] += ih * I.bd_weights(0) + mu;
+    for (int m = 0; m <= ntau; m++)
+        element_linsolve_right<T, LARGESIZE>(size1, G.tvptr(n, m), mm.data(), &ctv[m * sg]);
+}
+
+}  // namespace cntr
+
+#endif  // CNTR_TAU_GRID_IMPL_H
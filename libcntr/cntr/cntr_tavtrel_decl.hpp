@@ -0,0 +1,47 @@
+#ifndef CNTR_TAVTREL_DECL_H
+#define CNTR_TAVTREL_DECL_H
+
+#include "cntr_global_settings.hpp"
+
+namespace cntr {
+
+template <typename T> class herm_matrix;
+
+// size of the buffer (bytes) of lines transformed between two HDF5 writes
+#define CNTR_TAVTREL_BLOCK_BYTES (1 << 26)
+
+/* /////////////////////////////////////////////////////////////////////////////
+// Transforms of the real-time components to the average/relative-time
+// representation and to time slices, read directly from the packed storage.
+// Each call fills C^<(.) and C^>(.) as contiguous arrays of size1 x size2
+// matrices (row-major, as the herm_matrix storage).
+///////////////////////////////////////////////////////////////////////////// */
+/// number of relative-time points trel/2 = 0..len of line tav: len = min(tav, nt-tav)
+inline int tavtrel_length(int tav, int nt) { return (tav <= nt - tav ? tav : nt - tav); }
+// C(tav+r, tav-r), r = 0..tavtrel_length(tav, nt)
+template <typename T>
+void get_tavtrel(int tav, herm_matrix<T> &G, std::complex<T> *les, std::complex<T> *gtr);
+// C(t, t), t = 0..nt
+template <typename T>
+void get_equal_time(herm_matrix<T> &G, std::complex<T> *les, std::complex<T> *gtr);
+// C(t, tp), t = 0..nt
+template <typename T>
+void get_fixed_tp(int tp, herm_matrix<T> &G, std::complex<T> *les, std::complex<T> *gtr);
+
+#if CNTR_USE_HDF5 == 1
+template <typename T>
+void write_tavtrel_to_hdf5(hid_t group_id, herm_matrix<T> &G, int dt);
+template <typename T>
+void write_equal_time_to_hdf5(hid_t group_id, herm_matrix<T> &G);
+template <typename T>
+void write_equal_time_to_hdf5(const char *filename, const char *groupname, herm_matrix<T> &G);
+template <typename T>
+void write_fixed_tp_to_hdf5(hid_t group_id, herm_matrix<T> &G, int dt);
+template <typename T>
+void write_fixed_tp_to_hdf5(const char *filename, const char *groupname, herm_matrix<T> &G,
+                            int dt);
+#endif  // CNTR_USE_HDF5
+
+}  // namespace cntr
+
+#endif  // CNTR_TAVTREL_DECL_H
@@ -0,0 +1,23 @@
+#include "cntr_tavtrel_extern_templates.hpp"
+#include "cntr_herm_matrix_impl.hpp"
+#include "cntr_tavtrel_impl.hpp"
+
+namespace cntr {
+
+  template void get_tavtrel<double>(int tav, herm_matrix<double> &G,
+    std::complex<double> *les, std::complex<double> *gtr);
+  template void get_equal_time<double>(herm_matrix<double> &G,
+    std::complex<double> *les, std::complex<double> *gtr);
+  template void get_fixed_tp<double>(int tp, herm_matrix<double> &G,
+    std::complex<double> *les, std::complex<double> *gtr);
+#if CNTR_USE_HDF5 == 1
+  template void write_tavtrel_to_hdf5<double>(hid_t group_id, herm_matrix<double> &G, int dt);
+  template void write_equal_time_to_hdf5<double>(hid_t group_id, herm_matrix<double> &G);
+  template void write_equal_time_to_hdf5<double>(const char *filename, const char *groupname,
+    herm_matrix<double> &G);
+  template void write_fixed_tp_to_hdf5<double>(hid_t group_id, herm_matrix<double> &G, int dt);
+  template void write_fixed_tp_to_hdf5<double>(const char *filename, const char *groupname,
+    herm_matrix<double> &G, int dt);
+#endif  // CNTR_USE_HDF5
+
+}  // namespace cntr
@@ -0,0 +1,26 @@
+#ifndef CNTR_TAVTREL_EXTERN_TEMPLATES_H
+#define CNTR_TAVTREL_EXTERN_TEMPLATES_H
+
+#include "cntr_tavtrel_decl.hpp"
+
+namespace cntr {
+
+  extern template void get_tavtrel<double>(int tav, herm_matrix<double> &G,
+    std::complex<double> *les, std::complex<double> *gtr);
+  extern template void get_equal_time<double>(herm_matrix<double> &G,
+    std::complex<double> *les, std::complex<double> *gtr);
+  extern template void get_fixed_tp<double>(int tp, herm_matrix<double> &G,
+    std::complex<double> *les, std::complex<double> *gtr);
+#if CNTR_USE_HDF5 == 1
+  extern template void write_tavtrel_to_hdf5<double>(hid_t group_id, herm_matrix<double> &G, int dt);
+  extern template void write_equal_time_to_hdf5<double>(hid_t group_id, herm_matrix<double> &G);
+  extern template void write_equal_time_to_hdf5<double>(const char *filename, const char *groupname,
+    herm_matrix<double> &G);
+  extern template void write_fixed_tp_to_hdf5<double>(hid_t group_id, herm_matrix<double> &G, int dt);
+  extern template void write_fixed_tp_to_hdf5<double>(const char *filename, const char *groupname,
+    herm_matrix<double> &G, int dt);
+#endif  // CNTR_USE_HDF5
+
+}  // namespace cntr
+
+#endif  // CNTR_TAVTREL_EXTERN_TEMPLATES_H
@@ -0,0 +1,371 @@
+#ifndef CNTR_TAVTREL_IMPL_H
+#define CNTR_TAVTREL_IMPL_H
+
+#include "cntr_tavtrel_decl.hpp"
+#include "cntr_herm_matrix_decl.hpp"
+
+namespace cntr {
+
+/// @private
+// out = x, for a dim x dim matrix
+template <typename T>
+inline void tavtrel_copy(int dim, const std::complex<T> *x, std::complex<T> *out) {
+    memcpy(out, x, sizeof(std::complex<T>) * dim * dim);
+}
+/// @private
+// out = -x^\dagger
+template <typename T>
+inline void tavtrel_minus_conj(int dim, const std::complex<T> *x, std::complex<T> *out) {
+    for (int r = 0; r < dim; r++) {
+        for (int s = 0; s < dim; s++) {
+            const std::complex<T> &w = x[s * dim + r];
+            out[r * dim + s] = std::complex<T>(-w.real(), w.imag());
+        }
+    }
+}
+/// @private
+// gtr = ret + les, with ret = x (sign=1) or ret = -x^\dagger (sign=-1)
+template <typename T>
+inline void tavtrel_gtr(int dim, int sign, const std::complex<T> *x, const std::complex<T> *les,
+                        std::complex<T> *gtr) {
+    for (int r = 0; r < dim; r++) {
+        for (int s = 0; s < dim; s++) {
+            if (sign == 1) {
+                gtr[r * dim + s] = x[r * dim + s] + les[r * dim + s];
+            } else {
+                const std::complex<T> &w = x[s * dim + r];
+                gtr[r * dim + s] = std::complex<T>(-w.real(), w.imag()) + les[r * dim + s];
+            }
+        }
+    }
+}
+
+/** \brief <b> Lesser and greater components along a line of constant average time. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Computes \f$ C^\gtrless(t_{av}+r,t_{av}-r) \f$ for \f$ r=0,...,len \f$,
+ * > \f$ len=\min(t_{av},nt-t_{av}) \f$, directly from the packed storage
+ * > (\f$ C^< \f$ from the stored upper triangle, \f$ C^> = C^\mathrm{R} + C^< \f$),
+ * > without temporary matrices. The values agree with `get_les` and `get_gtr`.
+ * > Works for square-matrix contour functions.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tav
+ * > [int] Average time index, 0 <= tav <= nt.
+ * @param G
+ * > [herm_matrix] The contour function.
+ * @param les
+ * > [complex<T>*] On return, the lesser component; (len+1)*element_size entries.
+ * @param gtr
+ * > [complex<T>*] On return, the greater component; (len+1)*element_size entries.
+ */
+template <typename T>
+void get_tavtrel(int tav, herm_matrix<T> &G, std::complex<T> *les, std::complex<T> *gtr) {
+    int nt = G.nt(), dim = G.size1(), es = G.element_size();
+    assert(tav >= 0 && tav <= nt && "tav >= 0 && tav <= nt");
+    assert(G.size1() == G.size2() && "G.size1() == G.size2()");
+    int len = tavtrel_length(tav, nt);
+    tavtrel_copy(dim, G.lesptr(tav, tav), les);
+    tavtrel_gtr(dim, 1, G.retptr(tav, tav), les, gtr);
+    for (int r = 1; r <= len; r++) {
+        tavtrel_minus_conj(dim, G.lesptr(tav - r, tav + r), les + r * es);
+        tavtrel_gtr(dim, 1, G.retptr(tav + r, tav - r), les + r * es, gtr + r * es);
+    }
+}
+/** \brief <b> Equal-time lesser and greater components. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Computes \f$ C^\gtrless(t,t) \f$ for \f$ t=0,...,nt \f$ directly from the packed storage.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix] The contour function.
+ * @param les
+ * > [complex<T>*] On return, the lesser component; (nt+1)*element_size entries.
+ * @param gtr
+ * > [complex<T>*] On return, the greater component; (nt+1)*element_size entries.
+ */
+template <typename T>
+void get_equal_time(herm_matrix<T> &G, std::complex<T> *les, std::complex<T> *gtr) {
+    int dim = G.size1(), es = G.element_size();
+    assert(G.size1() == G.size2() && "G.size1() == G.size2()");
+    for (int t = 0; t <= G.nt(); t++) {
+        tavtrel_copy(dim, G.lesptr(t, t), les + t * es);
+        tavtrel_gtr(dim, 1, G.retptr(t, t), les + t * es, gtr + t * es);
+    }
+}
+/** \brief <b> Lesser and greater components at a fixed second time argument. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Computes \f$ C^\gtrless(t,t^\prime) \f$ for \f$ t=0,...,nt \f$ at fixed \f$ t^\prime \f$
+ * > directly from the packed storage. For \f$ t\leq t^\prime \f$ the lesser component is the
+ * > contiguous column `lesptr(0,tp)`. The values agree with `get_les` and `get_gtr`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param tp
+ * > [int] The time \f$ t^\prime \f$, 0 <= tp <= nt.
+ * @param G
+ * > [herm_matrix] The contour function.
+ * @param les
+ * > [complex<T>*] On return, the lesser component; (nt+1)*element_size entries.
+ * @param gtr
+ * > [complex<T>*] On return, the greater component; (nt+1)*element_size entries.
+ */
+template <typename T>
+void get_fixed_tp(int tp, herm_matrix<T> &G, std::complex<T> *les, std::complex<T> *gtr) {
+    int nt = G.nt(), dim = G.size1(), es = G.element_size();
+    assert(tp >= 0 && tp <= nt && "tp >= 0 && tp <= nt");
+    assert(G.size1() == G.size2() && "G.size1() == G.size2()");
+    memcpy(les, G.lesptr(0, tp), sizeof(std::complex<T>) * (tp + 1) * es);
+    for (int t = 0; t < tp; t++)
+        tavtrel_gtr(dim, -1, G.retptr(tp, t), les + t * es, gtr + t * es);
+    for (int t = tp; t <= nt; t++) {
+        if (t > tp)
+            tavtrel_minus_conj(dim, G.lesptr(tp, t), les + t * es);
+        tavtrel_gtr(dim, 1, G.retptr(t, tp), les + t * es, gtr + t * es);
+    }
+}
+
+#if CNTR_USE_HDF5 == 1
+
+/// @private
+// Stores les/<t> and gtr/<t> for the lines t in `lines`: tav lines (fixed_tp=false) or
+// fixed-t' slices. Lines are computed in parallel, in blocks of at most
+// CNTR_TAVTREL_BLOCK_BYTES, and each block is written before the next is computed.
+template <typename T>
+void tavtrel_write_lines(hid_t group_id, herm_matrix<T> &G, const std::vector<int> &lines,
+                         bool fixed_tp) {
+    int nt = G.nt(), es = G.element_size();
+    int nlines = lines.size();
+    size_t max_block = CNTR_TAVTREL_BLOCK_BYTES / (2 * sizeof(std::complex<T>));
+    std::vector<std::complex<T> > les, gtr;
+    std::vector<size_t> offset;
+    char name[100];
+    hid_t group_id_les = create_group(group_id, std::string("les"));
+    hid_t group_id_gtr = create_group(group_id, std::string("gtr"));
+    hsize_t len_shape = 3, shape[3];
+    shape[1] = G.size1();
+    shape[2] = G.size2();
+    int i0 = 0;
+    while (i0 < nlines) {
+        int i1 = i0;
+        offset.assign(1, 0);
+        while (i1 < nlines) {
+            size_t n = (fixed_tp ? nt : tavtrel_length(lines[i1], nt)) + 1;
+            if (i1 > i0 && offset.back() + n * es > max_block)
+                break;
+            offset.push_back(offset.back() + n * es);
+            i1++;
+        }
+        les.resize(offset.back());
+        gtr.resize(offset.back());
+#if CNTR_USE_OMP == 1
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int i = i0; i < i1; i++) {
+            if (fixed_tp)
+                get_fixed_tp(lines[i], G, &les[offset[i - i0]], &gtr[offset[i - i0]]);
+            else
+                get_tavtrel(lines[i], G, &les[offset[i - i0]], &gtr[offset[i - i0]]);
+        }
+        for (int i = i0; i < i1; i++) {
+            std::sprintf(name, "%d", lines[i]);
+            shape[0] = (offset[i - i0 + 1] - offset[i - i0]) / es;
+            store_cplx_array_to_hid(group_id_les, std::string(name), &les[offset[i - i0]],
+                                    shape, len_shape);
+            store_cplx_array_to_hid(group_id_gtr, std::string(name), &gtr[offset[i - i0]],
+                                    shape, len_shape);
+        }
+        i0 = i1;
+    }
+    close_group(group_id_les);
+    close_group(group_id_gtr);
+}
+/// @private
+template <typename T>
+void tavtrel_write_attributes(hid_t group_id, herm_matrix<T> &G) {
+    store_int_attribute_to_hid(group_id, std::string("nt"), G.nt());
+    store_int_attribute_to_hid(group_id, std::string("size1"), G.size1());
+    store_int_attribute_to_hid(group_id, std::string("size2"), G.size2());
+    store_int_attribute_to_hid(group_id, std::string("element_size"), G.element_size());
+}
+
+/** \brief <b> Stores the average/relative-time representation of `herm_matrix` to a given HDF5 group handle. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Stores \f$ \widetilde{C}^\gtrless(T,t) = C^\gtrless(T+t/2,T-t/2)\f$ for every `dt`-th
+ * > average time as datasets `les/<tav>` and `gtr/<tav>` of shape (len+1, size1, size2),
+ * > see `get_tavtrel`. This is the engine behind `herm_matrix::write_to_hdf5_tavtrel`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param group_id
+ * > [hid_t] The HDF5 group handle.
+ * @param G
+ * > [herm_matrix] The contour function.
+ * @param dt
+ * > [int] Store every `dt`-th average time.
+ */
+template <typename T>
+void write_tavtrel_to_hdf5(hid_t group_id, herm_matrix<T> &G, int dt) {
+    assert(dt >= 1);
+    if (G.nt() < 0)
+        return;
+    tavtrel_write_attributes(group_id, G);
+    std::vector<int> lines;
+    for (int tav = 0; tav <= G.nt(); tav += dt)
+        lines.push_back(tav);
+    tavtrel_write_lines(group_id, G, lines, false);
+}
+/** \brief <b> Stores the equal-time components of `herm_matrix` to a given HDF5 group handle. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Stores \f$ C^\gtrless(t,t) \f$, \f$ t=0,...,nt \f$, as datasets `les` and `gtr`
+ * > of shape (nt+1, size1, size2).
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param group_id
+ * > [hid_t] The HDF5 group handle.
+ * @param G
+ * > [herm_matrix] The contour function.
+ */
+template <typename T>
+void write_equal_time_to_hdf5(hid_t group_id, herm_matrix<T> &G) {
+    if (G.nt() < 0)
+        return;
+    tavtrel_write_attributes(group_id, G);
+    std::vector<std::complex<T> > les((G.nt() + 1) * G.element_size());
+    std::vector<std::complex<T> > gtr((G.nt() + 1) * G.element_size());
+    get_equal_time(G, les.data(), gtr.data());
+    hsize_t len_shape = 3, shape[3];
+    shape[0] = G.nt() + 1;
+    shape[1] = G.size1();
+    shape[2] = G.size2();
+    store_cplx_array_to_hid(group_id, std::string("les"), les.data(), shape, len_shape);
+    store_cplx_array_to_hid(group_id, std::string("gtr"), gtr.data(), shape, len_shape);
+}
+/** \brief <b> Stores the equal-time components of `herm_matrix` to a given HDF5 file under a given group name. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Stores \f$ C^\gtrless(t,t) \f$, \f$ t=0,...,nt \f$, see `write_equal_time_to_hdf5(group_id, G)`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [char*] The name of the output HDF5 file.
+ * @param groupname
+ * > [char*] The name of the HDF5 group.
+ * @param G
+ * > [herm_matrix] The contour function.
+ */
+template <typename T>
+void write_equal_time_to_hdf5(const char *filename, const char *groupname, herm_matrix<T> &G) {
+    hid_t file_id = open_hdf5_file(filename);
+    hid_t group_id = create_group(file_id, groupname);
+    write_equal_time_to_hdf5(group_id, G);
+    close_group(group_id);
+    close_hdf5_file(file_id);
+}
+/** \brief <b> Stores slices at fixed second time argument of `herm_matrix` to a given HDF5 group handle. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Stores \f$ C^\gtrless(t,t^\prime) \f$, \f$ t=0,...,nt \f$, for every `dt`-th
+ * > \f$ t^\prime \f$ as datasets `les/<tp>` and `gtr/<tp>` of shape (nt+1, size1, size2),
+ * > see `get_fixed_tp`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param group_id
+ * > [hid_t] The HDF5 group handle.
+ * @param G
+ * > [herm_matrix] The contour function.
+ * @param dt
+ * > [int] Store every `dt`-th slice.
+ */
+template <typename T>
+void write_fixed_tp_to_hdf5(hid_t group_id, herm_matrix<T> &G, int dt) {
+    assert(dt >= 1);
+    if (G.nt() < 0)
+        return;
+    tavtrel_write_attributes(group_id, G);
+    std::vector<int> lines;
+    for (int tp = 0; tp <= G.nt(); tp += dt)
+        lines.push_back(tp);
+    tavtrel_write_lines(group_id, G, lines, true);
+}
+/** \brief <b> Stores slices at fixed second time argument of `herm_matrix` to a given HDF5 file under a given group name. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Stores \f$ C^\gtrless(t,t^\prime) \f$ for every `dt`-th \f$ t^\prime \f$,
+ * > see `write_fixed_tp_to_hdf5(group_id, G, dt)`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [char*] The name of the output HDF5 file.
+ * @param groupname
+ * > [char*] The name of the HDF5 group.
+ * @param G
+ * > [herm_matrix] The contour function.
+ * @param dt
+ * > [int] Store every `dt`-th slice.
+ */
+template <typename T>
+void write_fixed_tp_to_hdf5(const char *filename, const char *groupname, herm_matrix<T> &G,
+                            int dt) {
+    hid_t file_id = open_hdf5_file(filename);
+    hid_t group_id = create_group(file_id, groupname);
+    write_fixed_tp_to_hdf5(group_id, G, dt);
+    close_group(group_id);
+    close_hdf5_file(file_id);
+}
+
+#endif  // CNTR_USE_HDF5
+
+}  // namespace cntr
+
+#endif  // CNTR_TAVTREL_IMPL_H
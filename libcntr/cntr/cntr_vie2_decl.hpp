@@ -109,6 +109,22 @@ namespace cntr {
 
 #endif // CNTR_USE_OMP
 
+/* /////////////////////////////////////////////////////////////////////////////////////////
+// MPI
+///////////////////////////////////////////////////////////////////////////////////////// */
+
+#if CNTR_USE_MPI == 1
+  template <typename T>
+  void vie2_timestep_mpi(int tstp, herm_matrix<T> &G, herm_matrix<T> &F, herm_matrix<T> &Fcc,
+       herm_matrix<T> &Q, T beta, T h, const int SolveOrder=MAX_SOLVE_ORDER,
+       const int matsubara_method=CNTR_MAT_FIXPOINT);
+
+  template <typename T>
+  void vie2_mpi(herm_matrix<T> &G, herm_matrix<T> &F, herm_matrix<T> &Fcc,
+    herm_matrix<T> &Q, T beta, T h, const int SolveOrder=MAX_SOLVE_ORDER,
+    const int matsubara_method=CNTR_MAT_FIXPOINT);
+#endif // CNTR_USE_MPI
+
 } // namespace cntr
 
 #endif  // CNTR_VIE2_DECL_H
@@ -67,4 +67,13 @@ namespace cntr {
 
 #endif // CNTR_USE_OMP
 
+#if CNTR_USE_MPI == 1
+  template void vie2_timestep_mpi<double>(int tstp, herm_matrix<double> &G, herm_matrix<double> &F,
+            herm_matrix<double> &Fcc, herm_matrix<double> &Q, double beta, double h,
+            const int SolveOrder, const int matsubara_method);
+  template void vie2_mpi<double>(herm_matrix<double> &G, herm_matrix<double> &F,
+            herm_matrix<double> &Fcc, herm_matrix<double> &Q, double beta, double h,
+            const int SolveOrder, const int matsubara_method);
+#endif // CNTR_USE_MPI
+
 }  // namespace cntr
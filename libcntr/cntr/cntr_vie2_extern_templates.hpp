@@ -79,6 +79,15 @@ namespace cntr {
                             herm_matrix<double> &Q,function<double> &Qsin,double beta,double h, const int SolveOrder);
 #endif // CNTR_USE_OMP
 
+#if CNTR_USE_MPI == 1
+  extern template void vie2_timestep_mpi<double>(int tstp, herm_matrix<double> &G, herm_matrix<double> &F,
+            herm_matrix<double> &Fcc, herm_matrix<double> &Q, double beta, double h,
+            const int SolveOrder, const int matsubara_method);
+  extern template void vie2_mpi<double>(herm_matrix<double> &G, herm_matrix<double> &F,
+            herm_matrix<double> &Fcc, herm_matrix<double> &Q, double beta, double h,
+            const int SolveOrder, const int matsubara_method);
+#endif // CNTR_USE_MPI
+
 }  // namespace cntr
 
 #endif  // CNTR_VIE2_EXTERN_TEMPLATES_H
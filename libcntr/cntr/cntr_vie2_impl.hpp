@@ -1863,7 +1863,7 @@ void vie2_timestep_omp_dispatch(int omp_num_threads, int tstp, GG &B, CPLX alpha
     Q.get_timestep(tstp, Qtstp);
     B.set_timestep_zero(tstp);
     if (func) {
-        ftcc = new CPLX[sc * n1];
+        ftcc = new CPLX[sc * (n1 + 1)];
         f0cc = new CPLX[sc];
         element_conj<T, SIZE1>(size1, f0cc, f0);
         for (int n = 0; n <= n1; n++)
@@ -2517,6 +2517,274 @@ void vie2_omp(int omp_num_threads, herm_matrix<T> &G, herm_matrix<T> &F, herm_ma
 
 #endif // CNTR_USE_OMP
 
+#if CNTR_USE_MPI == 1
+/// @private
+/** \brief <b> One step VIE solver \f$(1+\alpha A*f)*B=Q\f$ at a given timestep. MPI parallelized </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*   \par Purpose
+* <!-- ========= -->
+*
+* > Same algorithm as `vie2_timestep_omp_dispatch`, with the threads replaced by the MPI ranks:
+* > every rank solves a contiguous range of \f$B^R(t,t^\prime)\f$, \f$B^<(t^\prime,t)\f$, \f$t^\prime<t\f$,
+* > and \f$B^\rceil(t,\tau)\f$ (see `mpi_timestep_ranges`), and the timestep is allgathered.
+* > \f$B^<(t,t)\f$ depends on all other components and is computed afterwards on every rank.
+* > All arguments must be identical on all ranks.
+*/
+template <typename T, class GG, int SIZE1>
+void vie2_timestep_mpi_dispatch(int tstp, GG &B, CPLX alpha, GG &A, GG &Acc, CPLX *f0, CPLX *ft,
+                                GG &Q, integration::Integrator<T> &I, T beta, T h) {
+    int kt = I.get_k();
+    int ntau = A.ntau();
+    int size1 = A.size1();
+    int sc = size1 * size1;
+    bool func = (ft == NULL ? false : true);
+    int n1 = (tstp == -1 || tstp > kt ? tstp : kt);
+    int taskid, i, n, m;
+    T wt;
+    CPLX *ftcc, *f0cc;
+    std::vector<int> ret_first, tv_first;
+    herm_matrix_timestep<T> Qtstp(tstp, ntau, size1);
+    MPI_Comm_rank(MPI_COMM_WORLD, &taskid);
+    mpi_timestep_ranges(tstp, ntau, ret_first, tv_first);
+    // save Q
+    Q.get_timestep(tstp, Qtstp);
+    B.set_timestep_zero(tstp);
+    if (func) {
+        ftcc = new CPLX[sc * (n1 + 1)];
+        f0cc = new CPLX[sc];
+        element_conj<T, SIZE1>(size1, f0cc, f0);
+        for (n = 0; n <= n1; n++)
+            element_conj<T, SIZE1>(size1, ftcc + n * sc, ft + n * sc);
+    } else {
+        ftcc = NULL;
+        f0cc = NULL;
+    }
+    CPLX *mtemp = new CPLX[sc];
+    CPLX *one = new CPLX[sc];
+    CPLX *mm = new CPLX[sc];
+    // mtemp= A.retptr(tstp,tstp)*ft(tstp)*alpha*h  [NB1 x NB1]
+    if (func) {
+        element_mult<T, SIZE1>(size1, mtemp, A.retptr(tstp, tstp), ft + sc * tstp);
+        element_smul<T, SIZE1>(size1, mtemp, h * alpha);
+    } else {
+        element_set<T, SIZE1>(size1, mtemp, A.retptr(tstp, tstp));
+        element_smul<T, SIZE1>(size1, mtemp, h * alpha);
+    }
+    // one = diag(1)  [NB1 x NB1]
+    element_set<T, SIZE1>(size1, one, CPLX(1, 0));
+    std::vector<bool> mask_tv(ntau + 1, false);
+    std::vector<bool> mask_ret(tstp + 1, false);
+    std::vector<bool> mask_les(tstp + 1, false);
+    for (i = tv_first[taskid]; i < tv_first[taskid + 1]; i++)
+        mask_tv[i] = true;
+    for (i = ret_first[taskid]; i < ret_first[taskid + 1]; i++) {
+        mask_ret[i] = true;
+        mask_les[tstp - i] = true;
+    }
+    mask_les[tstp] = false; // computed separately at the end
+    // retarded part:
+    // Q1 = Q - alpha*A*ft*B, with Bret(tstp,n)=0
+    incr_convolution_ret<T, GG, SIZE1>(tstp, mask_ret, -alpha, Q, A, Acc, ft, B, B, I, h);
+    for (n = 0; n <= tstp; n++) {
+        if (mask_ret[n]) {
+            wt = (tstp < kt ? I.poly_integration(n, tstp, tstp) : I.gregory_weights(tstp - n, 0));
+            element_set<T, SIZE1>(size1, mm, one);
+            element_incr<T, SIZE1>(size1, mm, wt, mtemp);
+            element_linsolve_right<T, SIZE1>(size1, 1, B.retptr(tstp, n), mm, Q.retptr(tstp, n));
+        }
+    }
+    // tv part:
+    // Q -> Q - alpha*A*ft*B, with Btv(tstp,n)=0
+    incr_convolution_tv<T, GG, SIZE1>(tstp, mask_tv, -alpha, Q, A, Acc, f0, ft, B, B, I, beta, h);
+    for (m = 0; m <= ntau; m++) {
+        if (mask_tv[m]) {
+            wt = I.gregory_weights(tstp, tstp);
+            element_set<T, SIZE1>(size1, mm, one);
+            element_incr<T, SIZE1>(size1, mm, wt, mtemp);
+            element_linsolve_right<T, SIZE1>(size1, 1, B.tvptr(tstp, m), mm, Q.tvptr(tstp, m));
+        }
+    }
+    // les part:
+    // Q -> Q - conj(alpha)*B*ftcc*Acc, with Bles(n,tstp)=0, n=0...tstp-1
+    incr_convolution_les<T, GG, SIZE1>(tstp, mask_les, -conj(alpha), Q, B, B, f0cc, ftcc, Acc, A,
+                                       I, beta, h);
+    for (n = 0; n < tstp; n++) {
+        if (mask_les[n]) {
+            wt = I.gregory_weights(tstp, tstp);
+            element_set<T, SIZE1>(size1, mm, one);
+            element_incr<T, SIZE1>(size1, mm, wt, mtemp);
+            element_conj<T, SIZE1>(size1, mm);
+            element_linsolve_left<T, SIZE1>(size1, 1, B.lesptr(n, tstp), mm, Q.lesptr(n, tstp));
+        }
+    }
+    mpi_allgather_timestep_ranges(tstp, B, ret_first, tv_first);
+    // Bles(tstp,tstp) (Bles(n<tstp,tstp) etc. enters the convolution!)
+    n = tstp;
+    mask_les.assign(tstp + 1, false);
+    mask_les[n] = true;
+    incr_convolution_les<T, GG, SIZE1>(tstp, mask_les, -conj(alpha), Q, B, B, f0cc, ftcc, Acc, A,
+                                       I, beta, h);
+    wt = I.gregory_weights(tstp, tstp);
+    element_set<T, SIZE1>(size1, mm, one);
+    element_incr<T, SIZE1>(size1, mm, wt, mtemp);
+    element_conj<T, SIZE1>(size1, mm);
+    element_linsolve_left<T, SIZE1>(size1, 1, B.lesptr(n, tstp), mm, Q.lesptr(n, tstp));
+    delete[] mm;
+    delete[] one;
+    delete[] mtemp;
+    if (func) {
+        delete[] f0cc;
+        delete[] ftcc;
+    }
+    // restore Q
+    Q.set_timestep(tstp, Qtstp);
+}
+
+/** \brief <b> One step VIE solver \f$(1+F)*G=Q\f$ for Green's function for given timestep. MPI parallelized </b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*   \par Purpose
+* <!-- ========= -->
+*
+* > MPI version of 'vie2_timestep'. All arguments must be identical on all ranks. For `tstp` \f$>\f$ `SolveOrder`,
+* > the second time argument of \f$G^R\f$, \f$G^<\f$ and the imaginary time argument of \f$G^\rceil\f$
+* > are split into contiguous ranges over the ranks, and the timestep is then allgathered, so
+* > that it is known on all ranks on return. The Matsubara component and the starting
+* > timesteps are solved redundantly on every rank.
+*
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param tstp
+* > [int] time step
+* @param &G
+* > [herm_matrix<T>] solution
+* @param &F
+* > [herm_matrix<T>] green's function  on left-hand side
+* @param &Fcc
+* > [herm_matrix<T>] Complex conjugate of F
+* @param &Q
+* > [herm_matrix<T>] green's function  on right-hand side
+* @param beta
+* > [double] inverse temperature
+* @param h
+* > [double] time interval
+* @param SolveOrder
+* > [int] integrator order
+* @param matsubara_method
+* > [const] Solution method on the Matsubara axis with 0: Fourier, 1: steep, 2: fixpoint
+*/
+template <typename T>
+void vie2_timestep_mpi(int tstp, herm_matrix<T> &G, herm_matrix<T> &F, herm_matrix<T> &Fcc,
+                       herm_matrix<T> &Q, T beta, T h, const int SolveOrder,
+                       const int matsubara_method) {
+    int ntau = G.ntau();
+    int size1 = G.size1();
+    int n1 = (tstp >= SolveOrder ? tstp : SolveOrder);
+
+    assert(tstp >= -1);
+    assert(ntau > 0);
+    assert(SolveOrder > 0 && SolveOrder <= 5);
+    assert(SolveOrder <= 2 * ntau + 2);
+    assert(ntau == Fcc.ntau());
+    assert(ntau == F.ntau());
+    assert(ntau == Q.ntau());
+    assert(F.sig()== G.sig());
+    assert(Fcc.sig()== G.sig());
+    assert(Q.sig()== G.sig());
+    assert(F.size1()== size1);
+    assert(Fcc.size1()== size1);
+    assert(Q.size1()== size1);
+    assert(n1 <= F.nt());
+    assert(n1 <= Fcc.nt());
+    assert(n1 <= G.nt());
+    assert(n1 <= Q.nt());
+
+    if (tstp==-1){
+        vie2_mat(G, F, Fcc, Q, beta, integration::I<T>(SolveOrder), matsubara_method);
+    }else if(tstp<=SolveOrder){
+        vie2_start(G,F,Fcc,Q,integration::I<T>(tstp),beta,h);
+    }else{
+        switch (size1){
+        case 1:
+            vie2_timestep_mpi_dispatch<T, herm_matrix<T>, 1>(
+            tstp, G, CPLX(1, 0), F, Fcc, NULL, NULL, Q, integration::I<T>(SolveOrder), beta, h);
+        break;
+        case 2:
+            vie2_timestep_mpi_dispatch<T, herm_matrix<T>, 2>(
+            tstp, G, CPLX(1, 0), F, Fcc, NULL, NULL, Q, integration::I<T>(SolveOrder), beta, h);
+        break;
+        case 3:
+            vie2_timestep_mpi_dispatch<T, herm_matrix<T>, 3>(
+            tstp, G, CPLX(1, 0), F, Fcc, NULL, NULL, Q, integration::I<T>(SolveOrder), beta, h);
+        break;
+        case 4:
+            vie2_timestep_mpi_dispatch<T, herm_matrix<T>, 4>(
+            tstp, G, CPLX(1, 0), F, Fcc, NULL, NULL, Q, integration::I<T>(SolveOrder), beta, h);
+        break;
+        case 5:
+            vie2_timestep_mpi_dispatch<T, herm_matrix<T>, 5>(
+            tstp, G, CPLX(1, 0), F, Fcc, NULL, NULL, Q, integration::I<T>(SolveOrder), beta, h);
+        break;
+        case 8:
+            vie2_timestep_mpi_dispatch<T, herm_matrix<T>, 8>(
+            tstp, G, CPLX(1, 0), F, Fcc, NULL, NULL, Q, integration::I<T>(SolveOrder), beta, h);
+        break;
+        default:
+            vie2_timestep_mpi_dispatch<T, herm_matrix<T>, LARGESIZE>(
+            tstp, G, CPLX(1, 0), F, Fcc, NULL, NULL, Q, integration::I<T>(SolveOrder), beta, h);
+        break;
+        }
+    }
+}
+
+  /** \brief <b> VIE solver \f$(1+F)*G=Q\f$ for a Green's function \f$G\f$. MPI parallelized</b>
+  *
+  * <!-- ====== DOCUMENTATION ====== -->
+  *
+  *   \par Purpose
+  * <!-- ========= -->
+  *
+  * > MPI version of 'vie2', calling 'vie2_timestep_mpi' for all timesteps.
+  *
+  *
+  * <!-- ARGUMENTS
+  *      ========= -->
+  *
+  * @param &G
+  * > [herm_matrix<T>] solution
+  * @param &F
+  * > [herm_matrix<T>] green's function  on left-hand side
+  * @param &Fcc
+  * > [herm_matrix<T>] Complex conjugate of F
+  * @param &Q
+  * > [herm_matrix<T>] green's function  on right-hand side
+  * @param beta
+  * > [double] inverse temperature
+  * @param h
+  * > [double] time interval
+  * @param SolveOrder
+  * > [int] integrator order
+  * @param matsubara_method
+  * > [const] Solution method on the Matsubara axis with 0: Fourier, 1: steep, 2: fixpoint
+  */
+template <typename T>
+void vie2_mpi(herm_matrix<T> &G, herm_matrix<T> &F, herm_matrix<T> &Fcc,
+              herm_matrix<T> &Q, T beta, T h, const int SolveOrder, const int matsubara_method) {
+    int tstp;
+    vie2_mat(G, F, Fcc, Q, beta, SolveOrder, matsubara_method);
+    if (G.nt() >= 0)
+        vie2_start(G, F, Fcc, Q, beta, h, SolveOrder);
+    for (tstp = SolveOrder + 1; tstp <= G.nt(); tstp++)
+        vie2_timestep_mpi(tstp, G, F, Fcc, Q, beta, h, SolveOrder);
+}
+
+#endif // CNTR_USE_MPI
+
 #undef CPLX
 
 } // namespace cntr
@@ -0,0 +1,40 @@
+#ifndef CNTR_WIGNER_DECL_H
+#define CNTR_WIGNER_DECL_H
+
+#include "cntr_global_settings.hpp"
+
+namespace cntr {
+
+template <typename T> class herm_matrix;
+
+// window functions along the relative time for wigner_transform
+#define CNTR_WINDOW_NONE 0
+#define CNTR_WINDOW_GAUSS 1
+#define CNTR_WINDOW_HANN 2
+// below this number of relative-time steps, lines are integrated by the trapezoidal rule
+#define CNTR_WIGNER_MIN_CUBIC 8
+
+/* /////////////////////////////////////////////////////////////////////////////
+// Wigner transforms of the real-time components along lines of constant average
+// time, C(w,tav) = int dt e^{iwt} W(t) C(tav+t/2,tav-t/2), on a uniform frequency
+// grid w_k = wmin + k*(wmax-wmin)/(nw-1), k=0..nw-1. Results are stored as
+// [tav][w][size1 x size2] (row-major matrices, as the herm_matrix storage).
+///////////////////////////////////////////////////////////////////////////// */
+template <typename T>
+void wigner_transform(herm_matrix<T> &G, T h, const std::vector<int> &tav, T wmin, T wmax,
+                      int nw, std::complex<T> *ret, std::complex<T> *les,
+                      int window = CNTR_WINDOW_NONE, T width = 0.0);
+
+#if CNTR_USE_HDF5 == 1
+template <typename T>
+void write_wigner_to_hdf5(hid_t group_id, herm_matrix<T> &G, T h, const std::vector<int> &tav,
+                          T wmin, T wmax, int nw, int window = CNTR_WINDOW_NONE, T width = 0.0);
+template <typename T>
+void write_wigner_to_hdf5(const char *filename, const char *groupname, herm_matrix<T> &G, T h,
+                          const std::vector<int> &tav, T wmin, T wmax, int nw,
+                          int window = CNTR_WINDOW_NONE, T width = 0.0);
+#endif  // CNTR_USE_HDF5
+
+}  // namespace cntr
+
+#endif  // CNTR_WIGNER_DECL_H
@@ -0,0 +1,20 @@
+#include "cntr_wigner_extern_templates.hpp"
+#include "cntr_herm_matrix_impl.hpp"
+#include "cntr_tavtrel_impl.hpp"
+#include "cntr_wigner_impl.hpp"
+
+namespace cntr {
+
+  template void wigner_transform<double>(herm_matrix<double> &G, double h,
+    const std::vector<int> &tav, double wmin, double wmax, int nw,
+    std::complex<double> *ret, std::complex<double> *les, int window, double width);
+#if CNTR_USE_HDF5 == 1
+  template void write_wigner_to_hdf5<double>(hid_t group_id, herm_matrix<double> &G,
+    double h, const std::vector<int> &tav, double wmin, double wmax, int nw, int window,
+    double width);
+  template void write_wigner_to_hdf5<double>(const char *filename, const char *groupname,
+    herm_matrix<double> &G, double h, const std::vector<int> &tav, double wmin, double wmax,
+    int nw, int window, double width);
+#endif  // CNTR_USE_HDF5
+
+}  // namespace cntr
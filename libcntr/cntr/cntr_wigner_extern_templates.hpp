@@ -0,0 +1,22 @@
+#ifndef CNTR_WIGNER_EXTERN_TEMPLATES_H
+#define CNTR_WIGNER_EXTERN_TEMPLATES_H
+
+#include "cntr_wigner_decl.hpp"
+
+namespace cntr {
+
+  extern template void wigner_transform<double>(herm_matrix<double> &G, double h,
+    const std::vector<int> &tav, double wmin, double wmax, int nw,
+    std::complex<double> *ret, std::complex<double> *les, int window, double width);
+#if CNTR_USE_HDF5 == 1
+  extern template void write_wigner_to_hdf5<double>(hid_t group_id, herm_matrix<double> &G,
+    double h, const std::vector<int> &tav, double wmin, double wmax, int nw, int window,
+    double width);
+  extern template void write_wigner_to_hdf5<double>(const char *filename, const char *groupname,
+    herm_matrix<double> &G, double h, const std::vector<int> &tav, double wmin, double wmax,
+    int nw, int window, double width);
+#endif  // CNTR_USE_HDF5
+
+}  // namespace cntr
+
+#endif  // CNTR_WIGNER_EXTERN_TEMPLATES_H
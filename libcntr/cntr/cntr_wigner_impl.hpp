@@ -0,0 +1,344 @@
+#ifndef CNTR_WIGNER_IMPL_H
+#define CNTR_WIGNER_IMPL_H
+
+#include "cntr_wigner_decl.hpp"
+#include "cntr_tavtrel_decl.hpp"
+#include "cntr_herm_matrix_decl.hpp"
+#include "cntr_lattice_convolution_decl.hpp"
+#include "fourier.hpp"
+
+namespace cntr {
+
+/// @private
+// window W(t) along the relative time t in [0,tmax]
+template <typename T>
+inline T wigner_window(int window, T t, T tmax, T width) {
+    if (window == CNTR_WINDOW_GAUSS) {
+        return exp(-0.5 * t * t / (width * width));
+    } else if (window == CNTR_WINDOW_HANN) {
+        T l = (width > 0.0 ? width : tmax);
+        if (t >= l)
+            return 0.0;
+        T c = cos(0.5 * PI * t / l);
+        return c * c;
+    }
+    return 1.0;
+}
+
+/// @private
+/** \brief <b> Chirp-z transform of sampled lines to a uniform frequency grid. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Computes \f$ I_k = \int_0^{n\delta} dt\, e^{i\omega_k t} f(t) \f$,
+ * > \f$ \omega_k = \omega_0 + k\Delta\omega \f$, from \f$ f_j = f(j\delta) \f$, j=0,...,n,
+ * > by the cubically corrected DFT (see `dft_cplx`). The sum \f$ \sum_j f_j e^{i\omega_k j\delta} \f$
+ * > is evaluated for all \f$ k \f$ at once as a convolution with the chirp
+ * > \f$ e^{-i\Delta\omega\delta m^2/2} \f$ (Bluestein), i.e., with two FFTs of length
+ * > \f$ N\ge n+n_\omega \f$. The kernel and the correction factors depend only on the
+ * > grid and are computed once for all lines up to `nmax`; `transform` is const and
+ * > may be called from several threads, each with its own `fft_plan` of length `nfft()`.
+ */
+template <typename T>
+class wigner_chirp {
+  public:
+    typedef std::complex<T> cplx;
+    wigner_chirp(int nmax, T delta, T wmin, T dw, int nw) {
+        int k, m;
+        cplx ii(0.0, 1.0);
+        nmax_ = nmax;
+        nw_ = nw;
+        delta_ = delta;
+        wmin_ = wmin;
+        dw_ = dw;
+        for (nfft_ = 1; nfft_ < nmax + nw; nfft_ *= 2) {}
+        T phi = dw * delta;
+        pre_.resize(nmax + 1);
+        for (m = 0; m <= nmax; m++)
+            pre_[m] = std::exp(ii * (0.5 * phi * ((T)m * m) + wmin * delta * m));
+        post_.resize(nw);
+        for (k = 0; k < nw; k++)
+            post_[k] = std::exp(ii * (0.5 * phi * ((T)k * k))) / ((T)nfft_);
+        kernel_.assign(nfft_, 0.0);
+        for (m = -nmax; m < nw; m++)
+            kernel_[(m + nfft_) % nfft_] = std::exp(-ii * (0.5 * phi * ((T)m * m)));
+        fft_plan<T> plan(nfft_);
+        plan.transform(kernel_.data(), -1);
+        corfac_.resize(nw);
+        alpha_.resize(4 * nw);
+        for (k = 0; k < nw; k++)
+            fourier::get_dftcorr_cubic((wmin + k * dw) * delta, &corfac_[k], &alpha_[4 * k]);
+    }
+    int nfft(void) const { return nfft_; }
+    // f: (n+1) samples with stride `stride`, result: nw values with stride `stride`,
+    // work: nfft elements, plan: of length nfft
+    void transform(int n, const cplx *f, int stride, cplx *result, cplx *work,
+                   fft_plan<T> &plan) const {
+        int j, k;
+        assert(n >= 0 && n <= nmax_);
+        if (n == 0) {
+            for (k = 0; k < nw_; k++)
+                result[k * stride] = 0.0;
+            return;
+        }
+        for (j = 0; j <= n; j++)
+            work[j] = f[j * stride] * pre_[j];
+        for (j = n + 1; j < nfft_; j++)
+            work[j] = 0.0;
+        plan.transform(work, -1);
+        for (j = 0; j < nfft_; j++)
+            work[j] *= kernel_[j];
+        plan.transform(work, 1);
+        for (k = 0; k < nw_; k++) {
+            T w = wmin_ + k * dw_;
+            cplx eb = std::exp(cplx(0.0, w * delta_ * n)), res;
+            if (n < CNTR_WIGNER_MIN_CUBIC) {
+                // trapezoidal rule
+                res = work[k] * post_[k] - 0.5 * (f[0] + eb * f[n * stride]);
+            } else {
+                const cplx *alpha = &alpha_[4 * k];
+                res = corfac_[k] * work[k] * post_[k];
+                for (j = 0; j <= 3; j++)
+                    res += alpha[j] * f[j * stride] + eb * std::conj(alpha[j]) * f[(n - j) * stride];
+            }
+            result[k * stride] = delta_ * res;
+        }
+    }
+
+  private:
+    int nmax_;
+    int nw_;
+    int nfft_;
+    T delta_;
+    T wmin_;
+    T dw_;
+    std::vector<cplx> pre_;
+    std::vector<cplx> post_;
+    std::vector<cplx> kernel_;
+    std::vector<T> corfac_;
+    std::vector<cplx> alpha_;
+};
+
+/** \brief <b> Windowed Wigner transform of the retarded and lesser components of `herm_matrix`. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > For each average time \f$ T=t_{av}h \f$ in `tav` and each frequency
+ * > \f$ \omega_k = \omega_{min}+k(\omega_{max}-\omega_{min})/(n_\omega-1) \f$, computes
+ * > \f[ C^\mathrm{R}(\omega,T) = \int_0^{t_{max}} dt\, e^{i\omega t} W(t)\, C^\mathrm{R}(T+t/2,T-t/2), \f]
+ * > \f[ C^<(\omega,T) = \int_{-t_{max}}^{t_{max}} dt\, e^{i\omega t} W(|t|)\, C^<(T+t/2,T-t/2), \f]
+ * > where \f$ t_{max}=2h\,\min(t_{av},nt-t_{av}) \f$ is the longest relative time on the grid.
+ * > The negative relative times of \f$ C^< \f$ follow from the hermitian symmetry.
+ * > For a hermitian \f$ C \f$, the spectral function is
+ * > \f$ A(\omega,T) = -\frac{1}{\pi}\mathrm{Im}\, C^\mathrm{R}(\omega,T) \f$, and the occupied
+ * > part is \f$ \mathrm{Im}\, C^<(\omega,T)/(2\pi) \f$ (diagonal elements).
+ * > The window \f$ W(t) \f$ is
+ * >   - CNTR_WINDOW_NONE: \f$ W=1 \f$,
+ * >   - CNTR_WINDOW_GAUSS: \f$ W=e^{-t^2/(2\,\mathrm{width}^2)} \f$,
+ * >   - CNTR_WINDOW_HANN: \f$ W=\cos^2(\pi t/(2L)) \f$ for \f$ t<L \f$ and zero otherwise,
+ * >     \f$ L=\mathrm{width} \f$, or \f$ L=t_{max} \f$ for width<=0.
+ * >
+ * > Each line is read with `get_tavtrel` and transformed with the cubically corrected DFT,
+ * > evaluated for all frequencies by FFTs (chirp-z transform), i.e., with
+ * > \f$ O((nt+n_\omega)\log(nt+n_\omega)) \f$ operations per line and matrix element instead
+ * > of \f$ O(nt\, n_\omega) \f$. The lines are distributed over OpenMP threads.
+ * > The frequencies should satisfy \f$ |\omega| < \pi/(2h) \f$. Works for square-matrix
+ * > contour functions.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param G
+ * > [herm_matrix] The contour function.
+ * @param h
+ * > [T] Time step.
+ * @param tav
+ * > [std::vector<int>] Average time indices, 0 <= tav[i] <= nt.
+ * @param wmin
+ * > [T] Lowest frequency.
+ * @param wmax
+ * > [T] Highest frequency.
+ * @param nw
+ * > [int] Number of frequencies (nw>=1; for nw=1 only wmin is used).
+ * @param ret
+ * > [complex<T>*] On return, \f$ C^\mathrm{R}(\omega_k,T_i) \f$ at `ret[(i*nw+k)*element_size]`;
+ * > tav.size()*nw*element_size entries. Not computed if NULL.
+ * @param les
+ * > [complex<T>*] On return, \f$ C^<(\omega_k,T_i) \f$, same layout. Not computed if NULL.
+ * @param window
+ * > [int] Window function (default CNTR_WINDOW_NONE).
+ * @param width
+ * > [T] Width of the window (required for CNTR_WINDOW_GAUSS).
+ */
+template <typename T>
+void wigner_transform(herm_matrix<T> &G, T h, const std::vector<int> &tav, T wmin, T wmax,
+                      int nw, std::complex<T> *ret, std::complex<T> *les, int window, T width) {
+    typedef std::complex<T> cplx;
+    int nt = G.nt(), dim = G.size1(), es = G.element_size(), ntav = tav.size(), nmax = 0;
+    assert(G.size1() == G.size2() && "G.size1() == G.size2()");
+    assert(nw >= 1 && "nw >= 1");
+    assert((window != CNTR_WINDOW_GAUSS || width > 0.0) && "width > 0");
+    for (int i = 0; i < ntav; i++) {
+        assert(tav[i] >= 0 && tav[i] <= nt && "tav >= 0 && tav <= nt");
+        nmax = std::max(nmax, tavtrel_length(tav[i], nt));
+    }
+    if (ntav == 0 || (ret == NULL && les == NULL))
+        return;
+    T dw = (nw > 1 ? (wmax - wmin) / (nw - 1) : 0.0);
+    wigner_chirp<T> chirp(nmax, 2.0 * h, wmin, dw, nw);
+#if CNTR_USE_OMP == 1
+#pragma omp parallel if (ntav > 1)
+#endif
+    {
+        std::vector<cplx> fles((nmax + 1) * es), fgtr((nmax + 1) * es), res(nw * es);
+        std::vector<cplx> work(chirp.nfft());
+        fft_plan<T> plan(chirp.nfft());
+#if CNTR_USE_OMP == 1
+#pragma omp for schedule(dynamic)
+#endif
+        for (int i = 0; i < ntav; i++) {
+            int n = tavtrel_length(tav[i], nt);
+            T tmax = 2.0 * h * n;
+            get_tavtrel(tav[i], G, fles.data(), fgtr.data());
+            for (int r = 0; r <= n; r++) {
+                T wr = wigner_window(window, 2.0 * h * r, tmax, width);
+                for (int e = 0; e < es; e++) {
+                    fgtr[r * es + e] = wr * (fgtr[r * es + e] - fles[r * es + e]);  // ret
+                    fles[r * es + e] *= wr;
+                }
+            }
+            if (ret != NULL) {
+                for (int e = 0; e < es; e++)
+                    chirp.transform(n, fgtr.data() + e, es, ret + (size_t)i * nw * es + e,
+                                    work.data(), plan);
+            }
+            if (les != NULL) {
+                // C^<(w) = F - F^\dagger, F the transform over positive relative times
+                for (int e = 0; e < es; e++)
+                    chirp.transform(n, fles.data() + e, es, res.data() + e, work.data(), plan);
+                cplx *out = les + (size_t)i * nw * es;
+                for (int k = 0; k < nw; k++) {
+                    for (int r = 0; r < dim; r++)
+                        for (int s = 0; s < dim; s++)
+                            out[k * es + r * dim + s] =
+                                res[k * es + r * dim + s] - std::conj(res[k * es + s * dim + r]);
+                }
+            }
+        }
+    }
+}
+
+#if CNTR_USE_HDF5 == 1
+/** \brief <b> Stores windowed Wigner transforms of `herm_matrix` to a given HDF5 group handle. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > Computes \f$ C^\mathrm{R}(\omega,T) \f$ and \f$ C^<(\omega,T) \f$ with `wigner_transform`
+ * > and stores them as datasets `ret` and `les` of shape (tav.size(), nw, size1, size2),
+ * > together with the average times `tav` (\f$ t_{av}h \f$) and frequencies `w`.
+ * > The raw real-time data are not written.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param group_id
+ * > [hid_t] The HDF5 group handle.
+ * @param G
+ * > [herm_matrix] The contour function.
+ * @param h
+ * > [T] Time step.
+ * @param tav
+ * > [std::vector<int>] Average time indices.
+ * @param wmin
+ * > [T] Lowest frequency.
+ * @param wmax
+ * > [T] Highest frequency.
+ * @param nw
+ * > [int] Number of frequencies.
+ * @param window
+ * > [int] Window function, see `wigner_transform`.
+ * @param width
+ * > [T] Width of the window.
+ */
+template <typename T>
+void write_wigner_to_hdf5(hid_t group_id, herm_matrix<T> &G, T h, const std::vector<int> &tav,
+                          T wmin, T wmax, int nw, int window, T width) {
+    int ntav = tav.size(), es = G.element_size();
+    std::vector<std::complex<T> > ret((size_t)ntav * nw * es), les((size_t)ntav * nw * es);
+    std::vector<double> t(ntav), w(nw);
+    wigner_transform(G, h, tav, wmin, wmax, nw, ret.data(), les.data(), window, width);
+    for (int i = 0; i < ntav; i++)
+        t[i] = tav[i] * h;
+    for (int k = 0; k < nw; k++)
+        w[k] = wmin + (nw > 1 ? k * (wmax - wmin) / (nw - 1) : 0.0);
+    tavtrel_write_attributes(group_id, G);
+    store_int_attribute_to_hid(group_id, std::string("window"), window);
+    store_double_attribute_to_hid(group_id, std::string("width"), width);
+    store_double_attribute_to_hid(group_id, std::string("h"), h);
+    store_real_data_to_hid(group_id, std::string("tav"), t.data(), ntav);
+    store_real_data_to_hid(group_id, std::string("w"), w.data(), nw);
+    hsize_t len_shape = 4, shape[4];
+    shape[0] = ntav;
+    shape[1] = nw;
+    shape[2] = G.size1();
+    shape[3] = G.size2();
+    store_cplx_array_to_hid(group_id, std::string("ret"), ret.data(), shape, len_shape);
+    store_cplx_array_to_hid(group_id, std::string("les"), les.data(), shape, len_shape);
+}
+/** \brief <b> Stores windowed Wigner transforms of `herm_matrix` to a given HDF5 file under a given group name. </b>
+ *
+ * <!-- ====== DOCUMENTATION ====== -->
+ *
+ *  \par Purpose
+ * <!-- ========= -->
+ *
+ * > See `write_wigner_to_hdf5(group_id, G, h, tav, wmin, wmax, nw, window, width)`.
+ *
+ * <!-- ARGUMENTS
+ *      ========= -->
+ *
+ * @param filename
+ * > [char*] The name of the output HDF5 file.
+ * @param groupname
+ * > [char*] The name of the HDF5 group.
+ * @param G
+ * > [herm_matrix] The contour function.
+ * @param h
+ * > [T] Time step.
+ * @param tav
+ * > [std::vector<int>] Average time indices.
+ * @param wmin
+ * > [T] Lowest frequency.
+ * @param wmax
+ * > [T] Highest frequency.
+ * @param nw
+ * > [int] Number of frequencies.
+ * @param window
+ * > [int] Window function, see `wigner_transform`.
+ * @param width
+ * > [T] Width of the window.
+ */
+template <typename T>
+void write_wigner_to_hdf5(const char *filename, const char *groupname, herm_matrix<T> &G, T h,
+                          const std::vector<int> &tav, T wmin, T wmax, int nw, int window,
+                          T width) {
+    hid_t file_id = open_hdf5_file(filename);
+    hid_t group_id = create_group(file_id, groupname);
+    write_wigner_to_hdf5(group_id, G, h, tav, wmin, wmax, nw, window, width);
+    close_group(group_id);
+    close_hdf5_file(file_id);
+}
+#endif  // CNTR_USE_HDF5
+
+}  // namespace cntr
+
+#endif  // CNTR_WIGNER_IMPL_H
@@ -1,4 +1,5 @@
 #include <eigen3/Eigen/Dense>
+#include <eigen3/Eigen/Sparse>
 #include <complex>
 
 
@@ -9,6 +10,7 @@
 #define imatrix MatrixXi
 #define dmatrix MatrixXd
 #define cdmatrix MatrixXcd
+#define cdspmatrix SparseMatrix<std::complex<double> >
 
 
 using Eigen::VectorXi;
@@ -18,3 +20,4 @@ using Eigen::VectorXcd;
 using Eigen::MatrixXi;
 using Eigen::MatrixXd;
 using Eigen::MatrixXcd;
+using Eigen::SparseMatrix;
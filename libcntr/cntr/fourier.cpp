@@ -340,4 +340,184 @@ void dft_cplx(double w,int n,double a,double b,cplx *f,cplx &res,cplx &err)
   err=res-res2;
 }
 
+/** \brief <b> Returns the weights \f$c_j\f$ of the cubically corrected DFT, such that
+	\f$I(\omega) = \sum_{j=0}^n c_j f(t_j)\f$.</b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*   \par Purpose
+* <!-- ========= -->
+*
+* > Same integral as in `dft_cplx` (without error estimate), written as a linear
+* > combination of the function values \f$f(t_j)\f$, \f$t_j=a+j h\f$, \f$h=(b-a)/n\f$:
+* > \f$c_j = h e^{i\omega a}[W(\theta) e^{ij\theta} + \alpha_j(\theta)
+* > + e^{i\omega(b-a)}\alpha^*_{n-j}(\theta)]\f$, where the boundary terms vanish
+* > for \f$3<j<n-3\f$. Useful if the same frequency is applied to many functions.
+*
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param w
+* > [double] frequency \f$\omega\f$
+* @param n
+* > [int] number of time points \f$t_j=a+j h, j=0,\dots,n\f$
+* @param a
+* > [double] starting point of interval
+* @param b
+* > [double] end point of interval
+* @param c
+* > [complex] pointer to the n+1 weights (output)
+*/
+void dft_cubic_weights(double w,int n,double a,double b,cplx *c)
+{
+  double delta=(b-a)/((double) n),theta=w*delta,corfac;
+  cplx alpha[4],pre,expb;
+  int j;
+  if(n<=16  || (n/2)*2!=n  || b<=a) {std::cerr << "dft_cubic_weights: wrong input"  << std::endl;abort();}
+  get_dftcorr_cubic(theta,&corfac,alpha);
+  pre=delta*cplx(cos(w*a),sin(w*a));
+  expb=cplx(cos(w*(b-a)),sin(w*(b-a)));
+  for(j=0;j<=n;j++) c[j]=pre*corfac*cplx(cos(j*theta),sin(j*theta));
+  for(j=0;j<=3;j++){
+    c[j] += pre*alpha[j];
+    c[n-j] += pre*expb*std::conj(alpha[j]);
+  }
+}
+
+/** \brief <b> Fourier integral \f$I(\omega)\f$ of the sampled function, with error estimate.</b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*   \par Purpose
+* <!-- ========= -->
+*
+* > Sum of `dft_cplx` over all intervals; identical to `adft_func::dft`.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param w
+* > [double] frequency \f$\omega\f$
+* @param result
+* > [complex] Fourier integral \f$I(\omega)\f$
+* @param err
+* > [complex] sum of the error estimates of all intervals
+*/
+void sampled_function::dft(double w,cplx &result,cplx &err) const
+{
+  cplx res1,err1;
+  result=0;
+  err=0;
+  for(int i=0;i<intervals();i++){
+    dft_cplx(w,n_,a_[i],b_[i],const_cast<cplx*>(interval_data(i)),res1,err1);
+    result+=res1;
+    err+=err1;
+  }
+}
+
+/** \brief <b> Fourier integral \f$I(\omega)\f$ of the sampled function.</b> */
+cplx sampled_function::dft(double w) const
+{
+  cplx res;
+  dft(1,&w,&res);
+  return res;
+}
+
+/** \brief <b> Fourier integrals \f$I(\omega_k)\f$ of the sampled function for a batch of frequencies.</b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*   \par Purpose
+* <!-- ========= -->
+*
+* > Cubically corrected DFT on every interval as in `dft_cplx`, without error estimate.
+* > The frequencies are processed in blocks, and the phases \f$e^{ij\theta}\f$ are obtained by
+* > recursion, so that the loop over a block is vectorized. Parallelized with OpenMP over
+* > the blocks.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param nw
+* > [int] number of frequencies
+* @param w
+* > [double] pointer to the frequencies \f$\omega_k\f$, \f$k=0,\dots,nw-1\f$
+* @param result
+* > [complex] pointer to the Fourier integrals \f$I(\omega_k)\f$ (output)
+*/
+void sampled_function::dft(int nw,const double *w,cplx *result) const
+{
+  const int nb=32;
+  int nblock=(nw+nb-1)/nb;
+#if CNTR_USE_OMP == 1
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for(int ib=0;ib<nblock;ib++){
+    int k0=ib*nb,m=std::min(nb,nw-k0),k,j;
+    double zr[nb],zi[nb],sr[nb],si[nb],accr[nb],acci[nb],resr[nb],resi[nb];
+    for(k=0;k<m;k++) resr[k]=resi[k]=0.0;
+    for(int i=0;i<intervals();i++){
+      double a=a_[i],b=b_[i],delta=(b-a)/((double) n_);
+      const cplx *f=interval_data(i);
+      for(k=0;k<m;k++){
+        double theta=w[k0+k]*delta;
+        zr[k]=1.0;
+        zi[k]=0.0;
+        sr[k]=cos(theta);
+        si[k]=sin(theta);
+        accr[k]=acci[k]=0.0;
+      }
+      for(j=0;j<=n_;j++){
+        double fr=f[j].real(),fi=f[j].imag();
+        for(k=0;k<m;k++){
+          double tr=zr[k]*sr[k]-zi[k]*si[k];
+          accr[k]+=zr[k]*fr-zi[k]*fi;
+          acci[k]+=zr[k]*fi+zi[k]*fr;
+          zi[k]=zr[k]*si[k]+zi[k]*sr[k];
+          zr[k]=tr;
+        }
+      }
+      for(k=0;k<m;k++){
+        double wk=w[k0+k],corfac;
+        cplx alpha[4],endcor=0.0,endcorb=0.0,res;
+        get_dftcorr_cubic(wk*delta,&corfac,alpha);
+        for(j=0;j<=3;j++){
+          endcor+=alpha[j]*f[j];
+          endcorb+=std::conj(alpha[j])*f[n_-j];
+        }
+        endcor+=cplx(cos(wk*(b-a)),sin(wk*(b-a)))*endcorb;
+        res=(corfac*cplx(accr[k],acci[k])+endcor)*delta*cplx(cos(wk*a),sin(wk*a));
+        resr[k]+=res.real();
+        resi[k]+=res.imag();
+      }
+    }
+    for(k=0;k<m;k++) result[k0+k]=cplx(resr[k],resi[k]);
+  }
+}
+
+/** \brief <b> Weights \f$c_l\f$ of all samples, such that \f$I(\omega)=\sum_l c_l f_l\f$.</b>
+*
+* <!-- ====== DOCUMENTATION ====== -->
+*
+*   \par Purpose
+* <!-- ========= -->
+*
+* > `dft_cubic_weights` for every interval; the weights have the layout of the samples
+* > (interval i at i*(points()+1)), and `c` must hold size() elements. The weights depend
+* > only on the intervals, so they can be applied to other functions sampled on the same points.
+*
+* <!-- ARGUMENTS
+*      ========= -->
+*
+* @param w
+* > [double] frequency \f$\omega\f$
+* @param c
+* > [complex] pointer to the size() weights (output)
+*/
+void sampled_function::weights(double w,cplx *c) const
+{
+  for(int i=0;i<intervals();i++) dft_cubic_weights(w,n_,a_[i],b_[i],c+i*(n_+1));
+}
+
 } //namespace
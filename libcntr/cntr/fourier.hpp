@@ -7,6 +7,7 @@
 #include <iostream>
 #include <complex>
 #include <vector>
+#include <algorithm>
 #include <stdlib.h>
 
 
@@ -20,6 +21,7 @@ void complex_dftcor_cubic(double w, double delta,double a,double b,
   std::complex<double> *endpts,std::complex<double> *endcor,double *corfac);
 void dft_cplx(double w,int n,double a,double b,std::complex<double> *f,
   std::complex<double> &res, std::complex<double> &err);
+void dft_cubic_weights(double w,int n,double a,double b,std::complex<double> *c);
 
 
 #define PI 3.14159265358979323846
@@ -38,6 +40,8 @@ void dft_cplx(double w,int n,double a,double b,std::complex<double> *f,
    *  \f$I(\omega) = \int^b_a dt\, e^{i \omega t} f(t)\f$, cubically corrected DFT (see dft_cplx)
    *  is used. From the error estimate of dft_cplx, the integration interval \f$[a,b]\f$ can be split further
    *  until the error is below a given threshold for all interval.
+   *  The sampling buffers are reused by `sample`, so an object cannot be shared between
+   *  threads; see `sampled_function` for an immutable version.
    */
 class adft_func{
  public:
@@ -445,6 +449,132 @@ class adft_func{
 };
 
 
+  /** \brief <b> Class `sampled_function` holds a function sampled once on adaptive intervals,
+    for computing Fourier integrals at many frequencies. </b>
+   *
+   * <!-- ====== DOCUMENTATION ====== -->
+   *
+   *  \par Purpose
+   * <!-- ========= -->
+   *
+   *  The constructor samples \f$f(x)\f$ on \f$[a,b]\f$ with the same adaptive splitting of
+   *  intervals as `adft_func::sample`, reusing the values of a split interval. The object is
+   *  immutable afterwards: all member functions are const and may be called concurrently,
+   *  e.g. from OpenMP threads, and copies can be shared. The Fourier integral
+   *  \f$I(\omega) = \int^b_a dx\, e^{i \omega x} f(x)\f$ is computed by the cubically
+   *  corrected DFT (see dft_cplx) for a single \f$\omega\f$, or for a batch of frequencies,
+   *  vectorized over the frequencies.
+   */
+class sampled_function{
+ public:
+   typedef  std::complex<double> cplx;
+   sampled_function(){
+      n_=0;
+   }
+   /** \brief <b> Samples a function on adaptively split intervals. </b>
+    *
+    * <!-- ====== DOCUMENTATION ====== -->
+    *
+    *  \par Purpose
+    * <!-- ========= -->
+    *
+    * The interval \f$[a,b]\f$ is iteratively split (at most `limit-1` intervals of `n`
+    * points), always splitting the interval with the largest error estimate of the
+    * Fourier integral at frequency \f$\omega\f$, as in `adft_func::sample`.
+    *
+    * <!-- ARGUMENTS
+    *      ========= -->
+    *
+    * @param a
+    * > lower interval bound
+    * @param b
+    * > upper interval bound
+    * @param fz
+    * > [template class function] scalar complex function
+    * @param n
+    * > number of points in each interval
+    * @param limit
+    * > max number of intervals
+    * @param w
+    * > frequency \f$\omega\f$ used for the error estimate (default: 0)
+    */
+   template <class function>
+   sampled_function(double a,double b,function &fz,int n,int limit,double w=0.0){
+      int i;
+      double dx;
+      std::vector<double> err(1,0.0);
+      if(n<ADFT_MINPTS || n%2!=0){ std::cerr << "sampled_function: n<16 || n%2!=0" << std::endl; abort();}
+      if(limit<1){std::cerr << "sampled_function: limit<1" << std::endl; abort();}
+      if(a>=b){ std::cerr << "sampled_function: a>=b" << std::endl;abort();}
+      n_=n;
+      a_.assign(1,a);
+      b_.assign(1,b);
+      data_.resize(n+1);
+      dx=(b-a)/((double) n);
+      for(i=0;i<=n;i++) data_[i]=fz(a+i*dx);
+      if(limit==1) return;
+      split(0,fz,w,err);
+      while(intervals()+1<limit){
+         split(std::max_element(err.begin(),err.end())-err.begin(),fz,w,err);
+      }
+   }
+   /** \brief <b> Number of intervals </b> */
+   int intervals(void) const { return a_.size(); }
+   /** \brief <b> Number of steps in each interval (points: n+1) </b> */
+   int points(void) const { return n_; }
+   /** \brief <b> Number of samples, intervals()*(points()+1) </b> */
+   int size(void) const { return data_.size(); }
+   double lower(int i) const { return a_[i]; }
+   double upper(int i) const { return b_[i]; }
+   /// @private
+   const cplx *interval_data(int i) const { return &data_[i*(n_+1)]; }
+   void dft(double w,cplx &result,cplx &err) const;
+   cplx dft(double w) const;
+   void dft(int nw,const double *w,cplx *result) const;
+   void weights(double w,cplx *c) const;
+ private:
+   /// @private
+   /** \brief <b> Splits interval i in two, evaluating fz only at the new points. </b> */
+   template <class function>
+   void split(int i,function &fz,double w,std::vector<double> &err){
+      int j,n=n_;
+      double a0=a_[i],b0=b_[i],mid=(a0+b0)/2.0,dx=(b0-a0)/(2.0*n);
+      cplx res,e;
+      std::vector<cplx> f0(data_.begin()+i*(n+1),data_.begin()+(i+1)*(n+1)),f1(n+1);
+      cplx *fl=&data_[i*(n+1)];
+      for(j=0;j<=n;j++){
+        if(j%2==0){
+          fl[j]=f0[j/2];
+          f1[j]=f0[n/2+j/2];
+        }else{
+          fl[j]=fz(a0+dx*j);
+          f1[j]=fz(mid+dx*j);
+        }
+      }
+      b_[i]=mid;
+      a_.insert(a_.begin()+i+1,mid);
+      b_.insert(b_.begin()+i+1,b0);
+      data_.insert(data_.begin()+(i+1)*(n+1),f1.begin(),f1.end());
+      fourier::dft_cplx(w,n,a0,mid,&data_[i*(n+1)],res,e);
+      err[i]=std::abs(e);
+      fourier::dft_cplx(w,n,mid,b0,&data_[(i+1)*(n+1)],res,e);
+      err.insert(err.begin()+i+1,std::abs(e));
+   }
+   /// @private
+   /** \brief <b> number of steps in each interval </b> */
+   int n_;
+   /// @private
+   /** \brief <b> left endpoints of the intervals </b> */
+   std::vector<double> a_;
+   /// @private
+   /** \brief <b> right endpoints of the intervals </b> */
+   std::vector<double> b_;
+   /// @private
+   /** \brief <b> function values, interval i at i*(n+1) </b> */
+   std::vector<cplx> data_;
+};
+
+
 
 } // namespace
 
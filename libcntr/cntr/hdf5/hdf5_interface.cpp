@@ -6,9 +6,106 @@
 
 #include <complex>
 #include <iostream>
+#include <cmath>
 
 // ********************************************************************
 #include "hdf5_interface.hpp"
+// ********************************************************************
+hdf5_storage_policy::hdf5_storage_policy() :
+  chunked(false), timesteps_per_chunk(1), shuffle(false), deflate(0),
+  filter(-1), tolerance(0.0) {}
+
+// ********************************************************************
+hdf5_storage_policy hdf5_storage_contiguous(void) {
+  return hdf5_storage_policy();
+}
+
+// ********************************************************************
+hdf5_storage_policy hdf5_storage_compressed(int deflate, double tolerance) {
+  hdf5_storage_policy policy;
+  policy.chunked = true;
+  policy.shuffle = true;
+  policy.deflate = deflate;
+  policy.tolerance = tolerance;
+  return policy;
+}
+
+// ********************************************************************
+static hdf5_storage_policy storage_policy;
+
+void set_hdf5_storage_policy(const hdf5_storage_policy &policy) {
+  assert(policy.timesteps_per_chunk >= 1);
+  assert(policy.deflate >= 0 && policy.deflate <= 9);
+  assert(policy.tolerance >= 0.0);
+  storage_policy = policy;
+}
+
+// ********************************************************************
+const hdf5_storage_policy &get_hdf5_storage_policy(void) {
+  return storage_policy;
+}
+
+// ********************************************************************
+// Dataset creation property list for an array of given shape under the current policy;
+// extendible arrays (unlimited first axis) are always chunked
+static hid_t create_storage_plist(hsize_t * shape, hsize_t len_shape,
+  size_t type_size, hsize_t chunk_rows, bool extendible=false) {
+
+  hid_t plist_id = H5Pcreate(H5P_DATASET_CREATE);
+  hsize_t npoints = 1;
+  for(hsize_t d = (extendible ? 1 : 0); d < len_shape; d++) npoints *= shape[d];
+  if((!storage_policy.chunked && !extendible) || npoints == 0) return plist_id;
+
+  // chunks span whole timesteps along the first axis; stay far below the 4GB chunk limit
+  std::vector<hsize_t> chunk(shape, shape + len_shape);
+  if(extendible)
+    chunk[0] = (chunk_rows > 0 ? chunk_rows : 1) * storage_policy.timesteps_per_chunk;
+  else if(chunk_rows > 0 && chunk_rows * storage_policy.timesteps_per_chunk < shape[0])
+    chunk[0] = chunk_rows * storage_policy.timesteps_per_chunk;
+  hsize_t row_bytes = type_size;
+  for(hsize_t d = 1; d < len_shape; d++) row_bytes *= shape[d];
+  while(chunk[0] > 1 && chunk[0] * row_bytes > (hsize_t(1) << 26))
+    chunk[0] = (chunk[0] + 1) / 2;
+  H5Pset_chunk(plist_id, len_shape, chunk.data());
+
+  if(storage_policy.shuffle) H5Pset_shuffle(plist_id);
+  if(storage_policy.filter >= 0) {
+    if(H5Zfilter_avail(storage_policy.filter) > 0) {
+      H5Pset_filter(plist_id, storage_policy.filter, H5Z_FLAG_OPTIONAL,
+        storage_policy.filter_params.size(), storage_policy.filter_params.data());
+    } else {
+      std::cerr << "hdf5_storage_policy: filter " << storage_policy.filter
+                << " not available, ignored" << std::endl;
+    }
+  }
+  if(storage_policy.deflate > 0) H5Pset_deflate(plist_id, storage_policy.deflate);
+  return plist_id;
+}
+
+// ********************************************************************
+// Lossy storage: round to a multiple of a power of two q <= 2*tolerance,
+// which clears the low mantissa bits for the compressor
+static std::complex<double> * round_to_tolerance(std::complex<double> * data_ptr,
+  hsize_t npoints, std::vector<std::complex<double> > & rounded) {
+
+  if(storage_policy.tolerance <= 0.0) return data_ptr;
+  double q = std::ldexp(1.0, (int) std::floor(std::log2(2.0 * storage_policy.tolerance)));
+  rounded.resize(npoints);
+  for(hsize_t i = 0; i < npoints; i++) {
+    rounded[i] = std::complex<double>(q * std::nearbyint(data_ptr[i].real() / q),
+                                      q * std::nearbyint(data_ptr[i].imag() / q));
+  }
+  return rounded.data();
+}
+
+// ********************************************************************
+static hid_t create_complex_type(void) {
+  hid_t type_id = H5Tcreate(H5T_COMPOUND, sizeof(double)*2);
+  H5Tinsert(type_id, "r", 0, H5T_NATIVE_DOUBLE);
+  H5Tinsert(type_id, "i", sizeof(double), H5T_NATIVE_DOUBLE);
+  return type_id;
+}
+
 // ********************************************************************
 hid_t open_hdf5_file(std::string filename) {
   hid_t file_id = H5Fcreate(filename.c_str(), 
@@ -51,13 +148,14 @@ void close_group(hid_t group_id) {
 
 // ********************************************************************
 void store_array_to_hid(hid_t file_id, std::string label, 
-  void * data_ptr, hsize_t * shape, hsize_t len_shape, hid_t type_id) {
+  void * data_ptr, hsize_t * shape, hsize_t len_shape, hid_t type_id,
+  hid_t dcpl_id) {
 
   //hsize_t len_shape=1, shape[1]; shape[0] = data_size;
   hid_t space_id = H5Screate_simple(len_shape, shape, NULL);  
 
   hid_t data_id = H5Dcreate(file_id, label.c_str(),
-    type_id, space_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    type_id, space_id, H5P_DEFAULT, dcpl_id, H5P_DEFAULT);
 
   // Error handling?
   herr_t status;
@@ -119,15 +217,74 @@ void store_attribute_to_hid(hid_t file_id, std::string label,
 // ********************************************************************
 void store_cplx_array_to_hid(
   hid_t file_id, std::string label, 
-  std::complex<double> * data_ptr, hsize_t * shape, hsize_t len_shape) {
+  std::complex<double> * data_ptr, hsize_t * shape, hsize_t len_shape,
+  hsize_t chunk_rows) {
 
   // -- COMPLEX COMPOUND HDF5 TYPE
-  hid_t H5T_COMPLEX = H5Tcreate(H5T_COMPOUND, sizeof(double)*2);
-  H5Tinsert(H5T_COMPLEX, "r", 0, H5T_NATIVE_DOUBLE);
-  H5Tinsert(H5T_COMPLEX, "i", sizeof(double), H5T_NATIVE_DOUBLE);
-  
+  hid_t H5T_COMPLEX = create_complex_type();
+
+  std::vector<std::complex<double> > rounded;
+  hsize_t npoints = 1;
+  for(hsize_t d = 0; d < len_shape; d++) npoints *= shape[d];
+  data_ptr = round_to_tolerance(data_ptr, npoints, rounded);
+
+  hid_t plist_id = create_storage_plist(shape, len_shape, sizeof(double)*2, chunk_rows);
   store_array_to_hid(file_id, label, (void *) data_ptr,
-		     shape, len_shape, H5T_COMPLEX);
+		     shape, len_shape, H5T_COMPLEX, plist_id);
+  H5Pclose(plist_id);
+  H5Tclose(H5T_COMPLEX);
+}
+
+// ********************************************************************
+hid_t create_extendible_cplx_array(
+  hid_t group_id, std::string label, hsize_t * shape, hsize_t len_shape,
+  hsize_t chunk_rows) {
+
+  std::vector<hsize_t> dims(shape, shape + len_shape), maxdims(shape, shape + len_shape);
+  dims[0] = 0;
+  maxdims[0] = H5S_UNLIMITED;
+  hid_t space_id = H5Screate_simple(len_shape, dims.data(), maxdims.data());
+  hid_t H5T_COMPLEX = create_complex_type();
+  hid_t plist_id = create_storage_plist(dims.data(), len_shape, sizeof(double)*2,
+    chunk_rows, true);
+  hid_t data_id = H5Dcreate(group_id, label.c_str(),
+    H5T_COMPLEX, space_id, H5P_DEFAULT, plist_id, H5P_DEFAULT);
+  H5Pclose(plist_id);
+  H5Tclose(H5T_COMPLEX);
+  H5Sclose(space_id);
+  return data_id;
+}
+
+// ********************************************************************
+void append_cplx_array_to_hid(
+  hid_t data_id, std::complex<double> * data_ptr, hsize_t rows) {
+
+  hid_t space_id = H5Dget_space(data_id);
+  int len_shape = H5Sget_simple_extent_ndims(space_id);
+  std::vector<hsize_t> dims(len_shape), start(len_shape, 0), count(len_shape);
+  H5Sget_simple_extent_dims(space_id, dims.data(), NULL);
+  H5Sclose(space_id);
+  if(rows == 0) return;
+
+  hsize_t npoints = rows;
+  for(int d = 1; d < len_shape; d++) npoints *= dims[d];
+  std::vector<std::complex<double> > rounded;
+  data_ptr = round_to_tolerance(data_ptr, npoints, rounded);
+
+  // extend by rows and write them as a hyperslab at the end
+  start[0] = dims[0];
+  count = dims;
+  count[0] = rows;
+  dims[0] += rows;
+  H5Dset_extent(data_id, dims.data());
+  space_id = H5Dget_space(data_id);
+  H5Sselect_hyperslab(space_id, H5S_SELECT_SET, start.data(), NULL, count.data(), NULL);
+  hid_t mem_id = H5Screate_simple(len_shape, count.data(), NULL);
+  hid_t H5T_COMPLEX = create_complex_type();
+  H5Dwrite(data_id, H5T_COMPLEX, mem_id, space_id, H5P_DEFAULT, data_ptr);
+  H5Tclose(H5T_COMPLEX);
+  H5Sclose(mem_id);
+  H5Sclose(space_id);
 }
 
 // ********************************************************************
@@ -178,12 +335,24 @@ void store_double_attribute_to_hid(
 			 data_size, H5T_NATIVE_DOUBLE);
 }
 
+// ********************************************************************
+void update_int_attribute_in_hid(
+  hid_t file_id, std::string label, int data) {
+
+  hid_t data_id = H5Dopen(file_id, label.c_str(), H5P_DEFAULT);
+  H5Dwrite(data_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, &data);
+  H5Dclose(data_id);
+}
+
 // ********************************************************************
 void read_data_to_buff(hid_t group_id, std::string name, hsize_t buff_size, void * buff) {
 
   hid_t data_id = H5Dopen(group_id, name.c_str(), H5P_DEFAULT);
   hid_t type_id = H5Dget_type(data_id);
-  hsize_t data_size = H5Dget_storage_size(data_id);
+  // logical size: the storage size differs for compressed datasets
+  hid_t space_id = H5Dget_space(data_id);
+  hsize_t data_size = H5Sget_simple_extent_npoints(space_id) * H5Tget_size(type_id);
+  H5Sclose(space_id);
 
   assert(data_size == buff_size && "Mismatch in data and buffer size");
 
@@ -194,3 +363,33 @@ void read_data_to_buff(hid_t group_id, std::string name, hsize_t buff_size, void
 }
 
 // ********************************************************************
+
+// ********************************************************************
+void read_cplx_rows_from_hid(hid_t group_id, std::string name, hsize_t first,
+  hsize_t rows, std::complex<double> * buff, int i1, int i2) {
+
+  if(rows == 0) return;
+  hid_t data_id = H5Dopen(group_id, name.c_str(), H5P_DEFAULT);
+  hid_t file_space = H5Dget_space(data_id);
+  assert(H5Sget_simple_extent_ndims(file_space) == 3 && "Dataset is not a (n, size1, size2) array");
+  hsize_t shape[3];
+  H5Sget_simple_extent_dims(file_space, shape, NULL);
+  assert(first + rows <= shape[0] && "Rows out of range");
+
+  hsize_t start[3] = {first, 0, 0}, count[3] = {rows, shape[1], shape[2]};
+  if(i1 >= 0) {
+    assert((hsize_t) i1 < shape[1] && i2 >= 0 && (hsize_t) i2 < shape[2] && "Element out of range");
+    start[1] = i1; start[2] = i2;
+    count[1] = count[2] = 1;
+  }
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  hid_t mem_space = H5Screate_simple(3, count, NULL);
+  hid_t type_id = create_complex_type();
+
+  H5Dread(data_id, type_id, mem_space, file_space, H5P_DEFAULT, buff);
+
+  H5Tclose(type_id);
+  H5Sclose(mem_space);
+  H5Sclose(file_space);
+  H5Dclose(data_id);
+}
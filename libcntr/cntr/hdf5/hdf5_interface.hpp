@@ -19,6 +19,31 @@
 
 // ********************************************************************
 
+// Dataset creation policy for the complex arrays written by store_cplx_array_to_hid
+// (herm_matrix, herm_matrix_timestep, herm_pseudo, function, ...). The default is the
+// original contiguous, uncompressed layout. Compressed datasets are read back
+// transparently by read_data_to_buff and by h5py.
+struct hdf5_storage_policy {
+  hdf5_storage_policy();
+  bool chunked;           // chunked layout; required for all filters
+  int timesteps_per_chunk; // chunk extent along the first axis, in units of the timestep hint
+  bool shuffle;           // byte shuffle filter before compression
+  int deflate;            // gzip level 1..9, 0 = off
+  H5Z_filter_t filter;    // optional registered filter (e.g. a float compressor plugin), -1 = none
+  std::vector<unsigned int> filter_params; // client data for filter
+  double tolerance;       // > 0: lossy, round data to a multiple of 2^k <= 2*tolerance
+};
+
+// contiguous and uncompressed
+hdf5_storage_policy hdf5_storage_contiguous(void);
+// chunked, shuffle + deflate; lossless for tolerance=0
+hdf5_storage_policy hdf5_storage_compressed(int deflate=4, double tolerance=0.0);
+
+void set_hdf5_storage_policy(const hdf5_storage_policy &policy);
+const hdf5_storage_policy &get_hdf5_storage_policy(void);
+
+// ********************************************************************
+
 hid_t open_hdf5_file(std::string filename);
 hid_t read_hdf5_file(std::string filename);
 void close_hdf5_file(hid_t file_id);
@@ -28,7 +53,8 @@ hid_t open_group(hid_t file_id, std::string label);
 void close_group(hid_t group_id);
 
 void store_array_to_hid(hid_t file_id, std::string label, 
-  void * data_ptr, hsize_t * shape, hsize_t len_shape, hid_t type_id);
+  void * data_ptr, hsize_t * shape, hsize_t len_shape, hid_t type_id,
+  hid_t dcpl_id=H5P_DEFAULT);
 
 void store_data_to_hid(hid_t file_id, std::string label, 
   void * data_ptr, size_t data_size, hid_t typie_id);
@@ -36,13 +62,23 @@ void store_data_to_hid(hid_t file_id, std::string label,
 void store_attribute_to_hid(hid_t file_id, std::string label, 
   void * data_ptr, size_t data_size, hid_t type_id);
 
+// chunk_rows: extent of one timestep along shape[0] (0: the whole array), used for chunking
 void store_cplx_array_to_hid(
   hid_t file_id, std::string label, 
-  std::complex<double> * data_ptr, hsize_t * shape, hsize_t len_shape);
+  std::complex<double> * data_ptr, hsize_t * shape, hsize_t len_shape,
+  hsize_t chunk_rows=0);
   
 void store_cplx_data_to_hid(hid_t file_id, std::string label, 
   std::complex<double> * data_ptr, size_t data_size);
 
+// Extendible complex array of shape (0, shape[1], ...) with unlimited first axis, always
+// chunked (chunk_rows per chunk along the first axis); returns the open dataset handle
+hid_t create_extendible_cplx_array(hid_t group_id, std::string label,
+  hsize_t * shape, hsize_t len_shape, hsize_t chunk_rows);
+// Appends rows along the first axis of an extendible array
+void append_cplx_array_to_hid(hid_t data_id,
+  std::complex<double> * data_ptr, hsize_t rows);
+
 void store_real_data_to_hid(hid_t file_id, std::string label, 
   double * data_ptr, size_t data_size);
 
@@ -53,8 +89,15 @@ void store_int_attribute_to_hid(
   hid_t file_id, std::string label, int data);
 void store_double_attribute_to_hid(
   hid_t file_id, std::string label, double data);
+// overwrites an attribute stored by store_int_attribute_to_hid
+void update_int_attribute_in_hid(
+  hid_t file_id, std::string label, int data);
 
 void read_data_to_buff(hid_t group_id, std::string name, hsize_t buff_size, void * buff);
+// Reads rows [first, first+rows) along the first axis of a complex array of shape
+// (n, size1, size2) through a hyperslab; with i1 >= 0 only the element (i1,i2) of each row
+void read_cplx_rows_from_hid(hid_t group_id, std::string name, hsize_t first,
+  hsize_t rows, std::complex<double> * buff, int i1=-1, int i2=-1);
 
 // ********************************************************************
 template<typename T>
@@ -115,14 +158,14 @@ void store_herm_greens_function(hid_t group_id, T & g) {
 
   shape[0] = (g.nt()+1)*(g.nt()+2)/2;
   store_cplx_array_to_hid(group_id, std::string("ret"),
-			  g.retptr(0,0), shape, len_shape);
+			  g.retptr(0,0), shape, len_shape, g.nt()+1);
 
   store_cplx_array_to_hid(group_id, std::string("les"),
-			  g.lesptr(0,0), shape, len_shape);
+			  g.lesptr(0,0), shape, len_shape, g.nt()+1);
 
   shape[0] = (g.nt()+1)*(g.ntau()+1);
   store_cplx_array_to_hid(group_id, std::string("tv"),
-			  g.tvptr(0,0), shape, len_shape);
+			  g.tvptr(0,0), shape, len_shape, g.ntau()+1);
 
 }
 
@@ -8,6 +8,8 @@
 #include <complex>
 #include <vector>
 #include <string>
+#include <map>
+#include <sstream>
 #include "string.h"
 
 #include <eigen3/Eigen/Dense>
@@ -20,7 +22,7 @@
 // ROUTINES FOR INTERPRETING THE INPUT FILE (LIKE F0R LAYER)
 // ... interpreting input file: 
 #define INPUT_LINELEN 1024
-void uncomment_line(char *line,int len){
+inline void uncomment_line(char *line,int len){
    int i;
    int len1=strlen(line);
    for(i=0;i<len1;i++){
@@ -31,7 +33,7 @@ void uncomment_line(char *line,int len){
    }
 }
 // read n consecutive double numbers from file:
-void read_vector_from_file(char *file,std::vector<double> &data,int n){
+inline void read_vector_from_file(char *file,std::vector<double> &data,int n){
     int j=-1;
 	std::ifstream in;
 	try{
@@ -56,7 +58,7 @@ void read_vector_from_file(char *file,std::vector<double> &data,int n){
 	}
 }
 // read first line in file containing the string flag
-char* find_line_with_flag(char *file,const char *flag,char *line){
+inline char* find_line_with_flag(char *file,const char *flag,char *line){
 	std::ifstream in;
 	char *pch=0;
 	try{
@@ -78,7 +80,7 @@ char* find_line_with_flag(char *file,const char *flag,char *line){
 }
 // split line into n words, separated bt characters in delim
 // delim-characters in line are replaced by \0
-int strtok(char *line,std::vector<char*> &words,const char *delim){
+inline int strtok(char *line,std::vector<char*> &words,const char *delim){
 	char *pch;
     int n=0;
 	words.resize(0);
@@ -186,7 +188,7 @@ int find_line_with_fields(char *file,char *line,std::vector<char*> &words,const
 
 
 // READ A PARAMETER FROM A SEQUENCE OF WORDS words[m],words[m+1],...
-void read_param(std::vector<char*> &words,int m,double &data){
+inline void read_param(std::vector<char*> &words,int m,double &data){
 	try{
 		if((int)words.size()<m+1) throw("read_param: too few words in line");			
 		if(!(std::stringstream(words[m]) >> data)) 
@@ -197,7 +199,7 @@ void read_param(std::vector<char*> &words,int m,double &data){
 		throw;
 	}
 }
-void read_param(std::vector<char*> &words,int m,int &data){
+inline void read_param(std::vector<char*> &words,int m,int &data){
 	try{
 		if((int)words.size()<m+1) throw("read_param: too few words in line");			
 		if(!(std::stringstream(words[m]) >> data)) 
@@ -209,7 +211,7 @@ void read_param(std::vector<char*> &words,int m,int &data){
 	}
 }
 
-void read_param(std::vector<char*> &words,int m,bool &data){
+inline void read_param(std::vector<char*> &words,int m,bool &data){
 	try{			
 	  if(!(std::stringstream(words[m]) >> std::boolalpha >> data)) 
 			throw("read_param_tvector: cannot interpret arg");
@@ -220,7 +222,7 @@ void read_param(std::vector<char*> &words,int m,bool &data){
 	}
 }
 
-void read_param(std::vector<char*> &words,int m,CPLX &data){
+inline void read_param(std::vector<char*> &words,int m,CPLX &data){
   double real, imag;
       try{
 		if((int)words.size()<m+2) throw("read_param: too few words in line");			
@@ -238,7 +240,7 @@ void read_param(std::vector<char*> &words,int m,CPLX &data){
       data.real(real);
       data.imag(imag);
 }
-void read_param(std::vector<char*> &words,int m,dvector &data,int dim){
+inline void read_param(std::vector<char*> &words,int m,dvector &data,int dim){
 	try{
 	    data=dvector(dim);
 		if((int)words.size()<m+dim) throw("read_param: too few words in line");			
@@ -253,7 +255,7 @@ void read_param(std::vector<char*> &words,int m,dvector &data,int dim){
 	}
 }
 
-void read_param(std::vector<char*> &words,int m,std::vector<double> &data,int dim){
+inline void read_param(std::vector<char*> &words,int m,std::vector<double> &data,int dim){
 	try{
 	    // std::vector<double> data(dim);
 		if((int)words.size()<m+dim) throw("read_param: too few words in line");			
@@ -268,58 +270,10 @@ void read_param(std::vector<char*> &words,int m,std::vector<double> &data,int di
 	}
 }
 
-// fine the first line containing "flag", and read the following number
-template<typename T> void find_param(char *file,const char *flag,T &x){
-	try{
-		char line[INPUT_LINELEN],*pch;
-		std::vector<char*> words;
-		find_line_with_flag(file,flag,line);
-		pch=strstr(line,flag);
-		strtok(pch+strlen(flag),words," \t");
-		read_param(words,0,x);
-	}
-	catch(...){
-		std::cerr << "error in find_param(x) " << std::endl;
-		throw;
-	}
-}
-
-void find_param(char *file,const char *flag,dvector &x,int dim){
-	try{
-
-		char line[INPUT_LINELEN],*pch;
-		std::vector<char*> words;
-		find_line_with_flag(file,flag,line);
-		pch=strstr(line,flag);
-		strtok(pch+strlen(flag),words," \t");
-		read_param(words,0,x,dim);
-	}
-	catch(...){
-		std::cerr << "error in find_param(x) " << std::endl;
-		throw;
-	}
-}
-
-void find_param(char *file,const char *flag,std::vector<double> &x,int dim){
-	try{
-		x.resize(dim);
-		char line[INPUT_LINELEN],*pch;
-		std::vector<char*> words;
-		find_line_with_flag(file,flag,line);
-		pch=strstr(line,flag);
-		strtok(pch+strlen(flag),words," \t");
-		read_param(words,0,x,dim);
-	}
-	catch(...){
-		std::cerr << "error in find_param(x) " << std::endl;
-		throw;
-	}
-}
-
 // READ a time-dependent function A SEQUENCE OF WORDS words[m],words[m+1],...
 // if words[m] is of the form --FILENAME, read funtion from file
 // otherwise, a time-independent value is read from words[m], words[m+1], ...
-void read_param_tvector(std::vector<char*> &words,int m,std::vector<dvector> &data,int dim,int nt){
+inline void read_param_tvector(std::vector<char*> &words,int m,std::vector<dvector> &data,int dim,int nt){
 	char *pch;
 	int i1,tstp;
 	try{
@@ -346,7 +300,7 @@ void read_param_tvector(std::vector<char*> &words,int m,std::vector<dvector> &da
 		throw;
 	}
 }
-void read_param_tvector(std::vector<char*> &words,int m,std::vector<CPLX> &data,int nt){
+inline void read_param_tvector(std::vector<char*> &words,int m,std::vector<CPLX> &data,int nt){
 	char *pch;
 	int tstp;
 	try{
@@ -370,7 +324,7 @@ void read_param_tvector(std::vector<char*> &words,int m,std::vector<CPLX> &data,
 		throw;
 	}
 }
-void read_param_tvector(std::vector<char*> &words,int m,std::vector<double> &data,int nt){
+inline void read_param_tvector(std::vector<char*> &words,int m,std::vector<double> &data,int nt){
 	char *pch;
 	int tstp;
 	try{
@@ -395,53 +349,230 @@ void read_param_tvector(std::vector<char*> &words,int m,std::vector<double> &dat
 	}
 }
 ///
-void read_param_tvector(char *line,std::vector<dvector> &data,int dim,int nt){
+inline void read_param_tvector(char *line,std::vector<dvector> &data,int dim,int nt){
 	std::vector<char*> words;
     strtok(line,words," \t");
 	read_param_tvector(words,0,data,dim,nt);
 }
-void read_param_tvector(char *line,std::vector<CPLX> &data,int nt){
+inline void read_param_tvector(char *line,std::vector<CPLX> &data,int nt){
 	std::vector<char*> words;
     strtok(line,words," \t");
 	read_param_tvector(words,0,data,nt);
 }
-void read_param_tvector(char *line,std::vector<double> &data,int nt){
+inline void read_param_tvector(char *line,std::vector<double> &data,int nt){
 	std::vector<char*> words;
     strtok(line,words," \t");
 	read_param_tvector(words,0,data,nt);
 }
 
 
-void find_param_tvector(char *file,const char *flag,std::vector<dvector> &data,int dim,int nt){
+/////////////////////////////////////////////////////////////////////////////////////////////
+// SINGLE-PASS PARSER: the file is read once into a registry of lines, indexed by key
+// (the first word of a line, up to and including '=' if it contains one, e.g. "__Nt=").
+// A flag that is not a key is looked up as in find_line_with_flag: first line containing it.
+// Accessors throw, as find_param, if the flag is missing or cannot be interpreted.
+class inputfile_registry{
+public:
+	inputfile_registry(){}
+	explicit inputfile_registry(const char *file){ read(file); }
+	void read(const char *file){
+		std::ifstream in;
+		std::string line;
+		lines_.clear();
+		values_.clear();
+		index_.clear();
+		duplicates_.clear();
+		used_.clear();
+		in.open(file,std::ios::in);
+		if(!in.good()){
+			std::cerr << __FUNCTION__ << ": cannot open file " << file << std::endl;
+			throw(1);
+		}
+		while(std::getline(in,line)){
+			size_t pos=line.find('#');
+			if(pos!=std::string::npos) line.erase(pos);
+			size_t k0=line.find_first_not_of(" \t\r");
+			if(k0==std::string::npos) continue;
+			size_t k1=line.find_first_of(" \t\r",k0);
+			size_t eq=line.find('=',k0);
+			if(eq!=std::string::npos && (k1==std::string::npos || eq<k1)) k1=eq+1;
+			if(k1==std::string::npos) k1=line.size();
+			std::string key=line.substr(k0,k1-k0);
+			if(index_.count(key)) duplicates_.push_back(key);
+			else index_[key]=lines_.size();
+			lines_.push_back(line);
+			values_.push_back(line.substr(k1));
+		}
+		in.close();
+		used_.assign(lines_.size(),false);
+	}
+	bool has(const char *flag) const{
+		return find(flag,0)>=0;
+	}
+	// scalars: int, double, bool, CPLX
+	template<typename T> void get(const char *flag,T &x) const{
+		std::vector<char> buf;
+		std::vector<char*> words;
+		tokenize(flag,buf,words);
+		read_param(words,0,x);
+	}
+	// as get, but x is left unchanged if the flag is missing
+	template<typename T> bool get_optional(const char *flag,T &x) const{
+		if(!has(flag)) return false;
+		get(flag,x);
+		return true;
+	}
+	void get(const char *flag,dvector &x,int dim) const{
+		std::vector<char> buf;
+		std::vector<char*> words;
+		tokenize(flag,buf,words);
+		read_param(words,0,x,dim);
+	}
+	void get(const char *flag,std::vector<double> &x,int dim) const{
+		std::vector<char> buf;
+		std::vector<char*> words;
+		x.resize(dim);
+		tokenize(flag,buf,words);
+		read_param(words,0,x,dim);
+	}
+	// time-dependent values -1..nt: constant, or --FILENAME (see read_param_tvector)
+	void get_tvector(const char *flag,std::vector<dvector> &data,int dim,int nt) const{
+		std::vector<char> buf;
+		std::vector<char*> words;
+		tokenize(flag,buf,words);
+		read_param_tvector(words,0,data,dim,nt);
+	}
+	void get_tvector(const char *flag,std::vector<CPLX> &data,int nt) const{
+		std::vector<char> buf;
+		std::vector<char*> words;
+		tokenize(flag,buf,words);
+		read_param_tvector(words,0,data,nt);
+	}
+	void get_tvector(const char *flag,std::vector<double> &data,int nt) const{
+		std::vector<char> buf;
+		std::vector<char*> words;
+		tokenize(flag,buf,words);
+		read_param_tvector(words,0,data,nt);
+	}
+	// validation: keys defined more than once (the first one is used),
+	// and keys never read by an accessor (e.g. misspelled parameters)
+	const std::vector<std::string> &duplicate_keys(void) const{ return duplicates_; }
+	std::vector<std::string> unused_keys(void) const{
+		std::vector<std::string> keys;
+		for(std::map<std::string,size_t>::const_iterator it=index_.begin();it!=index_.end();it++){
+			if(!used_[it->second]) keys.push_back(it->first);
+		}
+		return keys;
+	}
+	// registry of a file, read on first use: backend of find_param and find_param_tvector
+	static inputfile_registry &cached(const char *file){
+		std::map<std::string,inputfile_registry> &cache=file_cache();
+		std::map<std::string,inputfile_registry>::iterator it=cache.find(file);
+		if(it==cache.end()){
+			it=cache.insert(std::make_pair(std::string(file),inputfile_registry())).first;
+			try{
+				it->second.read(file);
+			}
+			catch(...){
+				cache.erase(it);
+				throw;
+			}
+		}
+		return it->second;
+	}
+	// forget cached files, e.g. after an input file has been rewritten
+	static void clear_cache(void){ file_cache().clear(); }
+private:
+	static std::map<std::string,inputfile_registry> &file_cache(void){
+		static std::map<std::string,inputfile_registry> cache;
+		return cache;
+	}
+	// line holding flag (-1 if none), *value: text following flag
+	long find(const char *flag,const char **value) const{
+		std::map<std::string,size_t>::const_iterator it=index_.find(flag);
+		if(it!=index_.end()){
+			if(value) *value=values_[it->second].c_str();
+			return it->second;
+		}
+		for(size_t l=0;l<lines_.size();l++){
+			const char *pch=strstr(lines_[l].c_str(),flag);
+			if(pch){
+				if(value) *value=pch+strlen(flag);
+				return l;
+			}
+		}
+		return -1;
+	}
+	void tokenize(const char *flag,std::vector<char> &buf,std::vector<char*> &words) const{
+		const char *value;
+		long l=find(flag,&value);
+		if(l<0){
+			std::cerr << "inputfile_registry: no line with " << flag << std::endl;
+			throw("inputfile_registry: flag not found");
+		}
+		used_[l]=true;
+		buf.assign(value,value+strlen(value)+1);
+		strtok(&buf[0],words," \t\r");
+	}
+	std::vector<std::string> lines_;
+	std::vector<std::string> values_;
+	std::map<std::string,size_t> index_;
+	std::vector<std::string> duplicates_;
+	mutable std::vector<bool> used_;
+};
+
+// find the line with "flag" (read once per file, see inputfile_registry), and read the following number
+template<typename T> void find_param(char *file,const char *flag,T &x){
+	try{
+		inputfile_registry::cached(file).get(flag,x);
+	}
+	catch(...){
+		std::cerr << "error in find_param(x) " << std::endl;
+		throw;
+	}
+}
+
+inline void find_param(char *file,const char *flag,dvector &x,int dim){
+	try{
+		inputfile_registry::cached(file).get(flag,x,dim);
+	}
+	catch(...){
+		std::cerr << "error in find_param(x) " << std::endl;
+		throw;
+	}
+}
+
+inline void find_param(char *file,const char *flag,std::vector<double> &x,int dim){
+	try{
+		inputfile_registry::cached(file).get(flag,x,dim);
+	}
+	catch(...){
+		std::cerr << "error in find_param(x) " << std::endl;
+		throw;
+	}
+}
+
+inline void find_param_tvector(char *file,const char *flag,std::vector<dvector> &data,int dim,int nt){
 	try{
-		char line[INPUT_LINELEN],*pch;
-		find_line_with_flag(file,flag,line);
-		pch=strstr(line,flag);
-		read_param_tvector(pch+strlen(flag),data,dim,nt);
+		inputfile_registry::cached(file).get_tvector(flag,data,dim,nt);
 	}
 	catch(...){
 		std::cerr << "error in find_param(x) " << std::endl;
 		throw;
 	}
 }
-void find_param_tvector(char *file,const char *flag,std::vector<CPLX> &data,int nt){
+inline void find_param_tvector(char *file,const char *flag,std::vector<CPLX> &data,int nt){
 	try{
-		char line[INPUT_LINELEN],*pch;
-		find_line_with_flag(file,flag,line);
-		pch=strstr(line,flag);
-		read_param_tvector(pch+strlen(flag),data,nt);
+		inputfile_registry::cached(file).get_tvector(flag,data,nt);
 	}
 	catch(...){
 		std::cerr << "error in find_param(x) " << std::endl;
 		throw;
 	}
 }
-void find_param_tvector(char *file,const char *flag,std::vector<double> &data,int nt){
+inline void find_param_tvector(char *file,const char *flag,std::vector<double> &data,int nt){
 	try{
-		char line[INPUT_LINELEN],*pch;
-		find_line_with_flag(file,flag,line);
-		pch=strstr(line,flag);
-		read_param_tvector(pch+strlen(flag),data,nt);
+		inputfile_registry::cached(file).get_tvector(flag,data,nt);
 	}
 	catch(...){
 		std::cerr << "error in find_param(x) " << std::endl;
@@ -0,0 +1,119 @@
+#include "cntr.hpp"
+
+using namespace std;
+#define GREEN cntr::herm_matrix<double>
+#define GREEN_TSTP cntr::herm_matrix_timestep<double>
+#define GREEN_VIEW cntr::herm_matrix_timestep_view<double>
+
+TEST_CASE("Allreduce_timestep","[Allreduce_timestep]"){
+  int ntasks,taskid;
+  
+  int size=2;
+  int nt=30, ntau=50;
+  double eps=1e-6;
+  double dt=0.01, mu=0.0, beta=10.0;
+  double eps1=-0.4,eps2=0.6,lam1=0.1;
+  std::complex<double> I(0.0,1.0);
+  cdmatrix h1(size,size);
+  cdmatrix iden(size,size);
+  iden = MatrixXcd::Identity(size, size);
+
+  MPI_Comm_size(MPI_COMM_WORLD, &ntasks);
+  MPI_Comm_rank(MPI_COMM_WORLD, &taskid);
+
+  h1(0,0) = eps1;
+  h1(1,1) = eps2;
+  h1(0,1) = I*lam1;
+  h1(1,0) = -I*lam1;
+
+  // reference: sum of the rank-dependent propagators, known on every rank
+  GREEN Gloc_ref(nt,ntau,size,-1);
+  for(int tstp=-1; tstp<=nt; tstp++) Gloc_ref.set_timestep_zero(tstp);
+  {
+    GREEN Gtmp(nt,ntau,size,-1);
+    for(int tid=0; tid<ntasks; tid++){
+      cdmatrix hk = h1 + (double)tid * iden;
+      cntr::green_from_H(Gtmp,mu,hk,beta,dt);
+      for(int tstp=-1; tstp<=nt; tstp++) Gloc_ref.incr_timestep(tstp, Gtmp);
+    }
+  }
+
+  GREEN Gk(nt,ntau,size,-1);
+  cdmatrix hk = h1 + (double)taskid * iden;
+  cntr::green_from_H(Gk,mu,hk,beta,dt);
+
+  SECTION("Allreduce_timestep: herm_matrix"){
+    double err=0.0;
+    GREEN G(Gk);
+    for(int tstp=-1; tstp<=nt; tstp++){
+      cntr::Allreduce_timestep(tstp, G);
+      err += cntr::distance_norm2(tstp, G, Gloc_ref);
+    }
+    REQUIRE(err < eps);
+  }
+
+  SECTION("Allreduce_timestep: herm_matrix_timestep"){
+    double err=0.0;
+    for(int tstp=-1; tstp<=nt; tstp++){
+      GREEN_TSTP G_step(tstp,ntau,size);
+      Gk.get_timestep(tstp, G_step);
+      cntr::Allreduce_timestep(tstp, G_step);
+      err += cntr::distance_norm2(tstp, G_step, Gloc_ref);
+    }
+    REQUIRE(err < eps);
+  }
+
+  SECTION("Iallreduce_timestep: herm_matrix_timestep_view"){
+    double err=0.0;
+    GREEN G(Gk);
+    std::vector<MPI_Request> requests;
+    for(int tstp=-1; tstp<=nt; tstp++){
+      GREEN_VIEW G_step(tstp, G);
+      cntr::Iallreduce_timestep(tstp, G_step, requests);
+    }
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    for(int tstp=-1; tstp<=nt; tstp++) err += cntr::distance_norm2(tstp, G, Gloc_ref);
+    REQUIRE(err < eps);
+  }
+
+  SECTION("Allreduce_timestep: function"){
+    double err=0.0;
+    cntr::function<double> f(nt,size), fref(nt,size);
+    cdmatrix ftmp(size,size);
+    for(int tstp=-1; tstp<=nt; tstp++){
+      ftmp = (double)(taskid+1) * (h1 + (double)tstp * iden);
+      f.set_value(tstp, ftmp);
+      ftmp = 0.5 * ntasks * (ntasks+1) * (h1 + (double)tstp * iden);
+      fref.set_value(tstp, ftmp);
+    }
+    for(int tstp=-1; tstp<=nt; tstp++){
+      cntr::Allreduce_timestep(tstp, f);
+      cdmatrix a,b;
+      f.get_value(tstp,a);
+      fref.get_value(tstp,b);
+      err += (a-b).norm();
+    }
+    REQUIRE(err < eps);
+  }
+
+  SECTION("Reduce_scatter_timestep: herm_matrix"){
+    // every rank contributes to all nblock objects, each block is owned by one rank
+    int nblock=3;
+    double err=0.0;
+    cntr::distributed_array<double> dummy(nblock,1,true);
+    std::vector<int> tid_map=dummy.tid_map();
+    for(int tstp=-1; tstp<=nt; tstp++){
+      std::vector<GREEN> G(nblock, Gk);
+      for(int j=0; j<nblock; j++) G[j].smul(tstp, (double)(j+1));
+      cntr::Reduce_scatter_timestep(tstp, G, tid_map);
+      for(int j=0; j<nblock; j++){
+        if(tid_map[j]==taskid){
+          GREEN Gref(Gloc_ref);
+          Gref.smul(tstp, (double)(j+1));
+          err += cntr::distance_norm2(tstp, G[j], Gref);
+        }
+      }
+    }
+    REQUIRE(err < eps);
+  }
+}
@@ -0,0 +1,151 @@
+#include "catch.hpp"
+#include "cntr.hpp"
+#include <cstdio>
+#include <stdexcept>
+#include <sys/stat.h>
+
+#define GREEN cntr::herm_matrix<double>
+#define CFUNC cntr::function<double>
+
+#if CNTR_USE_HDF5 == 1
+
+// Self-consistent embedding Sigma(t,t') = lam^2 G(t,t'): one step of the propagation
+static void checkpoint_timestep(int tstp,GREEN &G,GREEN &Sigma,CFUNC &hfunc,CFUNC &n,
+	double lam,double mu,double beta,double h,int SolveOrder){
+	cntr::extrapolate_timestep(tstp-1,G,SolveOrder);
+	for(int iter=0;iter<3;iter++){
+		Sigma.set_timestep(tstp,G);
+		Sigma.smul(tstp,lam*lam);
+		cntr::dyson_timestep(tstp,G,mu,hfunc,Sigma,beta,h,SolveOrder);
+	}
+	cdmatrix rho(G.size1(),G.size1());
+	G.density_matrix(tstp,rho);
+	n.set_value(tstp,rho);
+}
+
+TEST_CASE("checkpoint/restart","[checkpoint]"){
+	int nt=40;
+	int ntau=100;
+	int SolveOrder=MAX_SOLVE_ORDER;
+	double beta=5.0;
+	double h=0.02;
+	double mu=0.1;
+	double lam=0.3;
+	cdmatrix h1x1(1,1);
+	h1x1(0,0)=-0.5;
+	CFUNC hfunc(nt,1);
+	hfunc.set_constant(h1x1);
+
+	// reference: uninterrupted run
+	GREEN G0(nt,ntau,1,FERMION),Sigma(nt,ntau,1,FERMION);
+	CFUNC n0(nt,1);
+	cntr::green_from_H(G0,mu,h1x1,beta,h);
+	for(int tstp=-1;tstp<=SolveOrder;tstp++){
+		Sigma.set_timestep(tstp,G0);
+		Sigma.smul(tstp,lam*lam);
+	}
+	cntr::dyson_mat(G0,mu,hfunc,Sigma,beta,SolveOrder);
+	cntr::dyson_start(G0,mu,hfunc,Sigma,beta,h,SolveOrder);
+	for(int tstp=-1;tstp<=SolveOrder;tstp++){
+		cdmatrix rho(1,1);
+		G0.density_matrix(tstp,rho);
+		n0.set_value(tstp,rho);
+	}
+	GREEN Gstart(G0),Sigmastart(Sigma);
+	CFUNC nstart(n0);
+	for(int tstp=SolveOrder+1;tstp<=nt;tstp++){
+		checkpoint_timestep(tstp,G0,Sigma,hfunc,n0,lam,mu,beta,h,SolveOrder);
+	}
+
+	// interrupted run: checkpoints every 10 steps, stops after timestep 27
+	{
+		GREEN G(Gstart),S(Sigmastart);
+		CFUNC n(nstart);
+		int count=0;
+		double mu1=mu;
+		cntr::checkpoint<double> chk("checkpoint.h5",10);
+		chk.add("G",G);
+		chk.add("Sigma",S);
+		chk.add("n",n);
+		chk.add("count",count);
+		chk.add("mu",mu1);
+		for(int tstp=SolveOrder+1;tstp<=27;tstp++){
+			checkpoint_timestep(tstp,G,S,hfunc,n,lam,mu1,beta,h,SolveOrder);
+			count++;
+			if(chk.due(tstp)) chk.write(tstp);
+		}
+		REQUIRE(chk.version()==2);
+		REQUIRE(chk.tstp()==20);
+	}
+
+	// restart from scratch, continue to nt
+	GREEN G(nt,ntau,1,FERMION),S(nt,ntau,1,FERMION);
+	CFUNC n(nt,1);
+	int count=0;
+	double mu1=0.0;
+	{
+		cntr::checkpoint<double> chk("checkpoint.h5",10);
+		chk.add("G",G);
+		chk.add("Sigma",S);
+		chk.add("n",n);
+		chk.add("count",count);
+		chk.add("mu",mu1);
+		int tstp0=chk.restore();
+		REQUIRE(tstp0==20);
+		REQUIRE(count==20-SolveOrder);
+		REQUIRE(mu1==mu);
+		for(int tstp=tstp0+1;tstp<=nt;tstp++){
+			checkpoint_timestep(tstp,G,S,hfunc,n,lam,mu1,beta,h,SolveOrder);
+			count++;
+			if(chk.due(tstp)) chk.write(tstp);
+		}
+		REQUIRE(chk.version()==4);
+	}
+	double err=0.0;
+	for(int tstp=-1;tstp<=nt;tstp++){
+		cdmatrix n1,n2;
+		n0.get_value(tstp,n1);
+		n.get_value(tstp,n2);
+		err+=cntr::distance_norm2(tstp,G0,G)+cntr::distance_norm2(tstp,Sigma,S)+(n1-n2).norm();
+	}
+	REQUIRE(err==0.0);
+
+	// a second restart reads all four segments
+	{
+		GREEN G2(nt,ntau,1,FERMION),S2(nt,ntau,1,FERMION);
+		CFUNC n2(nt,1);
+		cntr::checkpoint<double> chk("checkpoint.h5");
+		chk.add("G",G2);
+		chk.add("Sigma",S2);
+		chk.add("n",n2);
+		REQUIRE(chk.restore()==nt);
+		err=0.0;
+		for(int tstp=-1;tstp<=nt;tstp++){
+			err+=cntr::distance_norm2(tstp,G0,G2)+cntr::distance_norm2(tstp,Sigma,S2);
+		}
+		REQUIRE(err==0.0);
+	}
+}
+
+
+TEST_CASE("checkpoint manifest failure","[checkpoint]"){
+	// the manifest cannot replace a non-empty directory of the same name
+	const char *name="checkpoint_blocked.h5";
+	std::string dummy=std::string(name)+"/file";
+	mkdir(name,0755);
+	std::FILE *fp=std::fopen(dummy.c_str(),"w");
+	REQUIRE(fp!=NULL);
+	std::fclose(fp);
+	GREEN G(5,10,1,FERMION);
+	cntr::checkpoint<double> chk(name);
+	chk.add("G",G);
+	REQUIRE_THROWS_AS(chk.write(2),std::runtime_error);
+	REQUIRE(chk.version()==0);
+	REQUIRE(chk.tstp()==-2);
+	std::remove(dummy.c_str());
+	std::remove(name);
+	std::remove((std::string(name)+".1").c_str());
+	std::remove((std::string(name)+".tmp").c_str());
+}
+
+#endif
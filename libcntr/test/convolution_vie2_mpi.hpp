@@ -0,0 +1,68 @@
+#include "cntr.hpp"
+
+#define GREEN cntr::herm_matrix<double>
+#define CFUNC cntr::function<double>
+
+TEST_CASE("MPI distributed convolution and vie2","[convolution_vie2_mpi]"){
+  int ntasks,taskid;
+  int nt=20, ntau=40, size=2, SolveOrder=5;
+  double beta=5.0, h=0.02;
+  double eps=1e-12;
+  std::complex<double> I(0.0,1.0);
+
+  MPI_Comm_size(MPI_COMM_WORLD, &ntasks);
+  MPI_Comm_rank(MPI_COMM_WORLD, &taskid);
+
+  cdmatrix h0(size,size),hs(size,size);
+  h0(0,0)=-0.4; h0(1,1)=0.6; h0(0,1)=0.2*I; h0(1,0)=-0.2*I;
+  hs(0,0)=1.0; hs(1,1)=-0.5; hs(0,1)=0.3; hs(1,0)=0.3;
+
+  GREEN G0(nt,ntau,size,FERMION),Sigma(nt,ntau,size,FERMION);
+  cntr::green_from_H(G0,0.0,h0,beta,h);
+  cntr::green_from_H(Sigma,0.0,hs,beta,h);
+  for(int tstp=-1;tstp<=nt;tstp++) Sigma.smul(tstp,0.25);
+  CFUNC ft(nt,size);
+  for(int tstp=-1;tstp<=nt;tstp++){
+    cdmatrix f(size,size);
+    f(0,0)=1.0+0.1*tstp; f(1,1)=0.5; f(0,1)=0.2*I; f(1,0)=-0.2*I;
+    ft.set_value(tstp,f);
+  }
+
+  SECTION("convolution_timestep_mpi"){
+    GREEN C(nt,ntau,size,FERMION),Cref(nt,ntau,size,FERMION);
+    GREEN Cf(nt,ntau,size,FERMION),Cfref(nt,ntau,size,FERMION);
+    double err=0.0;
+    for(int tstp=-1;tstp<=nt;tstp++){
+      cntr::convolution_timestep(tstp,Cref,G0,G0,Sigma,Sigma,beta,h,SolveOrder);
+      cntr::convolution_timestep_mpi(tstp,C,G0,G0,Sigma,Sigma,beta,h,SolveOrder);
+      cntr::convolution_timestep(tstp,Cfref,G0,ft,Sigma,beta,h,SolveOrder);
+      cntr::convolution_timestep_mpi(tstp,Cf,G0,ft,Sigma,beta,h,SolveOrder);
+      err+=cntr::distance_norm2(tstp,C,Cref);
+      err+=cntr::distance_norm2(tstp,Cf,Cfref);
+    }
+    REQUIRE(err<eps);
+  }
+
+  SECTION("vie2_timestep_mpi"){
+    GREEN F(nt,ntau,size,FERMION),Fcc(nt,ntau,size,FERMION);
+    GREEN G(nt,ntau,size,FERMION),Gref(nt,ntau,size,FERMION);
+    for(int tstp=-1;tstp<=nt;tstp++){
+      cntr::convolution_timestep(tstp,F,G0,Sigma,beta,h,SolveOrder);
+      cntr::convolution_timestep(tstp,Fcc,Sigma,G0,beta,h,SolveOrder);
+      F.smul(tstp,-1.0);
+      Fcc.smul(tstp,-1.0);
+    }
+    cntr::vie2(Gref,F,Fcc,G0,beta,h,SolveOrder);
+    cntr::vie2_mpi(G,F,Fcc,G0,beta,h,SolveOrder);
+    // same algorithm as vie2_omp, which differs from vie2 on the level of the discretization error
+    double err=0.0;
+    for(int tstp=-1;tstp<=nt;tstp++) err+=cntr::distance_norm2(tstp,G,Gref);
+    REQUIRE(err<1e-5);
+#if CNTR_USE_OMP == 1
+    cntr::vie2_omp(1,Gref,F,Fcc,G0,beta,h,SolveOrder);
+    err=0.0;
+    for(int tstp=-1;tstp<=nt;tstp++) err+=cntr::distance_norm2(tstp,G,Gref);
+    REQUIRE(err<eps);
+#endif
+  }
+}
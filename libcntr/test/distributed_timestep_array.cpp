@@ -0,0 +1,112 @@
+#include "catch.hpp"
+#include "cntr.hpp"
+#include <chrono>
+
+#define GREEN cntr::herm_matrix<double>
+#define GREEN_TSTP_VIEW cntr::herm_matrix_timestep_view<double>
+#define DIST_TIMESTEP cntr::distributed_timestep_array<double>
+
+TEST_CASE("distributed_timestep_array accessors","[distributed_timestep_array]"){
+	int nk=8;
+	int nt=20;
+	int ntau=100;
+	int size=2;
+	int tstp=5;
+	double eps=1e-10;
+	double beta=5.0;
+	double h=0.01;
+
+	GREEN G(nt,ntau,size,-1);
+	cdmatrix hk(size,size);
+	hk.setZero();
+	hk(0,1)=0.3;
+	hk(1,0)=0.3;
+	cntr::green_from_H(G,0.0,hk,beta,h);
+
+	DIST_TIMESTEP A(nk,nt,ntau,size,-1,false);
+	A.reset_tstp(tstp);
+	for(int k=0;k<nk;k++) A.G(k).get_data(G);
+
+	SECTION("references"){
+		// all accessors refer to the same storage
+		REQUIRE(&A.G() == &A.G());
+		REQUIRE(&A.data() == &A.data());
+		REQUIRE(&A.data().tid_map() == &A.data().tid_map());
+		for(int k=0;k<nk;k++){
+			REQUIRE(&A.G()[k] == &A.G(k));
+			REQUIRE(A.G(k).retptr(0) == A.data().block(k));
+			REQUIRE(A.block(k) == A.data().block(k));
+			REQUIRE(A.rank_owns(k));
+		}
+		int k=0;
+		for(DIST_TIMESTEP::const_iterator it=A.begin();it!=A.end();it++,k++){
+			REQUIRE(&(*it) == &A.G(k));
+		}
+		REQUIRE(k == nk);
+		A.reset_tstp(-1);
+		for(k=0;k<nk;k++) REQUIRE(A.block(k) == A.data().block(k));
+	}
+
+	SECTION("copy and move"){
+		DIST_TIMESTEP B(A);
+		REQUIRE(B.data().data() != A.data().data());
+		for(int k=0;k<nk;k++){
+			REQUIRE(B.G(k).retptr(0) == B.data().block(k));
+			REQUIRE(cntr::distance_norm2(tstp,B.G(k),G) < eps);
+		}
+		const std::complex<double> *ptr=B.data().data();
+		DIST_TIMESTEP C(std::move(B));
+		REQUIRE(C.data().data() == ptr);
+		REQUIRE(B.data().data() == nullptr);
+		DIST_TIMESTEP D;
+		D=std::move(C);
+		REQUIRE(D.data().data() == ptr);
+		REQUIRE(D.n() == nk);
+		for(int k=0;k<nk;k++){
+			REQUIRE(D.G(k).retptr(0) == D.data().block(k));
+			REQUIRE(cntr::distance_norm2(tstp,D.G(k),G) < eps);
+		}
+	}
+}
+
+// Hidden benchmark (run with: runtest "[.benchmark]"). Compares the k-loop
+// access pattern of the GW example with the former by-value accessors, which
+// copied the vector of views (and the full data for data().tid_map()) per call.
+TEST_CASE("distributed_timestep_array k-loop benchmark","[.benchmark]"){
+	int nk=400;
+	int nt=10;
+	int ntau=200;
+	int size=2;
+	int tstp=nt;
+
+	DIST_TIMESTEP A(nk,nt,ntau,size,-1,false);
+	A.reset_tstp(tstp);
+
+	cdmatrix rho(size,size),tmp(size,size);
+	std::chrono::high_resolution_clock::time_point t0,t1;
+
+	rho.setZero();
+	t0=std::chrono::high_resolution_clock::now();
+	for(int k=0;k<nk;k++){
+		std::vector<GREEN_TSTP_VIEW> Gcopy(A.G()); // former G() returned by value
+		cntr::distributed_array<std::complex<double> > dcopy(A.data()); // former data() returned by value
+		if(dcopy.rank_owns(k)) Gcopy[k].density_matrix(tstp,tmp);
+		rho+=tmp;
+	}
+	t1=std::chrono::high_resolution_clock::now();
+	double time_copy=std::chrono::duration<double>(t1-t0).count();
+	cdmatrix rho_copy=rho;
+
+	rho.setZero();
+	t0=std::chrono::high_resolution_clock::now();
+	for(int k=0;k<nk;k++){
+		if(A.data().rank_owns(k)) A.G(k).density_matrix(tstp,tmp);
+		rho+=tmp;
+	}
+	t1=std::chrono::high_resolution_clock::now();
+	double time_ref=std::chrono::duration<double>(t1-t0).count();
+
+	// timings are reported, not asserted
+	WARN("k-loop (nk=" << nk << "): by value " << time_copy << "s, by reference " << time_ref << "s");
+	REQUIRE((rho-rho_copy).norm() < 1e-12);
+}
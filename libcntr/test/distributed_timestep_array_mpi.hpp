@@ -49,17 +49,52 @@ TEST_CASE("distributed_timestep_array MPI","[distributed_timestep_array_mpi]"){
       for(int i=0;i<npoints;i++){
         if(taskid==mpi_pid[i]){
           cdmatrix mat;
-          Gall.G()[i].get_data(Gvec[i]);
+          Gall.G(i).get_data(Gvec[i]);
         }
       }
 
       Gall.mpi_bcast_all();
 
       for(int i=0;i<npoints;i++){
-          err+=distance_norm2(tstp,Gall.G()[i],Gvec[i]);
+          err+=distance_norm2(tstp,Gall.G(i),Gvec[i]);
 
       }
     }
     REQUIRE(err<eps);
   }
+
+  /*
+    Same as above, but with the reduced-size wire formats. With CNTR_WIRE_DELTA
+    the first exchange sends the full data, the second exchange on the same
+    timestep only the (small) change, and unchanged blocks are skipped.
+  */
+  SECTION("BcastAll wire formats"){
+    double eps_float=1e-5;
+    cntr::distributed_timestep_array<double> Gall(npoints,nt,ntau,size,-1,true);
+    double err_float=0.0,err_delta=0.0;
+
+    for(int tstp=-1;tstp<=nt;tstp++){
+      Gall.reset_tstp(tstp);
+      for(int i=0;i<npoints;i++){
+        if(Gall.rank_owns(i)) Gall.G(i).get_data(Gvec[i]);
+      }
+      Gall.mpi_bcast_all(CNTR_WIRE_FLOAT);
+      for(int i=0;i<npoints;i++) err_float+=distance_norm2(tstp,Gall.G(i),Gvec[i]);
+
+      for(int iter=0;iter<3;iter++){
+        // "iteration": the data changes slightly in the first two iterations
+        Gall.reset_tstp(tstp);
+        for(int i=0;i<npoints;i++){
+          if(Gall.rank_owns(i)){
+            Gall.G(i).get_data(Gvec[i]);
+            if(iter<2) Gall.G(i).smul(1.0+1e-3*iter);
+          }
+        }
+        Gall.mpi_bcast_all(CNTR_WIRE_DELTA);
+      }
+      for(int i=0;i<npoints;i++) err_delta+=distance_norm2(tstp,Gall.G(i),Gvec[i]);
+    }
+    REQUIRE(err_float/(nt+2)<eps_float);
+    REQUIRE(err_delta/(nt+2)<eps_float);
+  }
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "catch.hpp"
+#include "cntr.hpp"
+
+#define GREEN cntr::herm_matrix<double>
+#define CPLX std::complex<double>
+#define CFUNC cntr::function<double>
+
+// maximal deviation of the Matsubara components
+static double mat_deviation(GREEN &A, GREEN &B){
+	cdmatrix a,b;
+	double err=0.0;
+	for(int m=0;m<=A.ntau();m++){
+		A.get_mat(m,a);
+		B.get_mat(m,b);
+		err=std::max(err,(a-b).norm());
+	}
+	return err;
+}
+
+TEST_CASE("Discrete Lehmann representation","[dlr]"){
+	int nt=20,ntau=400,size=2,es=size*size,k=5;
+	double beta=10.0,h=0.02,mu=0.1,lam=0.5;
+	CPLX ii(0.0,1.0);
+	cdmatrix H(size,size),Hbath(size,size);
+	H << -1.0, 0.3*ii, -0.3*ii, 0.5;
+	Hbath << 1.5, 0.2, 0.2, -0.7;
+	CFUNC Hfunc(nt,size);
+	Hfunc.set_constant(H);
+	GREEN G0(nt,ntau,size,FERMION),Sigma(nt,ntau,size,FERMION);
+	cntr::green_from_H(G0,mu,H,beta,h);
+	cntr::green_from_H(Sigma,mu,Hbath,beta,h);
+	for(int tstp=-1;tstp<=nt;tstp++) Sigma.smul(tstp,lam*lam);
+	cntr::dlr_basis<double> basis(beta,100.0,1e-12,FERMION,ntau);
+	int r=basis.rank();
+	std::vector<CPLX> g0(r*es),sigma(r*es),g(r*es),x(r*es);
+	cntr::dlr_get_mat(G0,basis,g0.data());
+	cntr::dlr_get_mat(Sigma,basis,sigma.data());
+
+	SECTION("representation"){
+		double err=0.0;
+		REQUIRE(r<ntau/4);
+		GREEN G1(nt,ntau,size,FERMION);
+		cntr::dlr_set_mat(G1,basis,g0.data());
+		REQUIRE(mat_deviation(G0,G1)<1e-10);
+		// precomputed fit on the uniform grid, compared with the fit without it
+		cntr::dlr_basis<double> basis1(beta,100.0,1e-12,FERMION);
+		REQUIRE(basis.ntau()==ntau);
+		REQUIRE(basis1.ntau()==-1);
+		REQUIRE(basis1.rank()==r);
+		cntr::dlr_get_mat(G0,basis1,g.data());
+		cntr::dlr_set_mat(G1,basis1,g.data());
+		REQUIRE(mat_deviation(G0,G1)<1e-10);
+		// Matsubara nodes: G0(iw)=(iw+mu-H)^{-1}
+		basis.matsubara_from_coeffs(size,g0.data(),x.data());
+		for(int l=0;l<r;l++){
+			double w=M_PI/beta*(2*basis.matsubara_index(l)+1);
+			cdmatrix z=((ii*w+mu)*cdmatrix::Identity(size,size)-H).inverse();
+			Eigen::Map<cdmatrix> gw(&x[l*es],size,size);
+			err=std::max(err,(gw.transpose()-z).norm());
+		}
+		REQUIRE(err<1e-10);
+		// tau nodes
+		basis.tau_from_coeffs(size,g0.data(),x.data());
+		basis.coeffs_from_tau(size,x.data(),g.data());
+		cntr::dlr_set_mat(G1,basis,g.data());
+		REQUIRE(mat_deviation(G0,G1)<1e-10);
+	}
+
+	SECTION("dyson and vie2"){
+		GREEN G(nt,ntau,size,FERMION),G1(nt,ntau,size,FERMION);
+		cntr::dyson_mat(G,mu,Hfunc,Sigma,beta,k,CNTR_MAT_FIXPOINT);
+		cntr::dyson_mat_dlr(g.data(),mu,H,sigma.data(),basis);
+		cntr::dlr_set_mat(G1,basis,g.data());
+		REQUIRE(mat_deviation(G,G1)<1e-8);
+		// G+F*G=Q with F=-G0*Sigma, Q=G0
+		std::vector<CPLX> f(r*es);
+		cntr::convolution_mat_dlr(f.data(),g0.data(),sigma.data(),size,basis);
+		for(int i=0;i<r*es;i++) f[i]=-f[i];
+		cntr::vie2_mat_dlr(x.data(),f.data(),g0.data(),size,basis);
+		cntr::dlr_set_mat(G1,basis,x.data());
+		REQUIRE(mat_deviation(G,G1)<1e-8);
+	}
+
+	SECTION("tv convolution"){
+		GREEN C(nt,ntau,size,FERMION),C1(nt,ntau,size,FERMION);
+		cntr::convolution(C,G0,G0,Sigma,Sigma,beta,h,k);
+		std::vector<CPLX> atv((nt+1)*r*es),btv((nt+1)*r*es),ctv(r*es);
+		for(int j=0;j<=nt;j++){
+			cntr::dlr_get_tv(j,G0,basis,&atv[j*r*es]);
+			cntr::dlr_get_tv(j,Sigma,basis,&btv[j*r*es]);
+		}
+		cntr::dlr_tv_kernel<double> Smat(basis,size,sigma.data());
+		double err=0.0;
+		for(int n=0;n<=nt;n++){
+			cntr::convolution_timestep_tv_dlr(n,ctv.data(),G0,G0,atv.data(),btv.data(),Smat,h,k);
+			cntr::dlr_set_tv(n,C1,basis,ctv.data());
+			for(int m=0;m<=ntau;m++){
+				cdmatrix a,b;
+				C.get_tv(n,m,a);
+				C1.get_tv(n,m,b);
+				err=std::max(err,(a-b).norm());
+			}
+		}
+		REQUIRE(err<1e-8);
+	}
+}
@@ -451,3 +451,166 @@ TEST_CASE("Non-interacting","[Herm_matrix_noniteracting]"){
 
 
 
+
+TEST_CASE("equilibrium from dos","[equilibrium]"){
+  int nt=60;
+  int ntau=80;
+  double h=0.05;
+  double eps=1e-7;
+
+  SECTION("bethe (fast)"){
+    double beta[2]={2.0,20.0};
+    double mu[2]={0.0,0.3};
+    for(int i=0;i<2;i++){
+      GREEN G1(nt,ntau,1,FERMION),G2(nt,ntau,1,FERMION);
+      cntr::green_equilibrium_bethe(G1,beta[i],h,100,20,mu[i]);
+      cntr::green_equilibrium_bethe_fast(G2,beta[i],h,100,20,mu[i]);
+      double err=0.0;
+      for(int tstp=-1;tstp<=nt;tstp++) err+=cntr::distance_norm2(tstp,G1,G2);
+      REQUIRE(err<eps);
+    }
+  }
+
+  SECTION("matsubara only (fast)"){
+    GREEN G1(-1,ntau,2,FERMION),G2(-1,ntau,2,FERMION);
+    cntr::green_equilibrium_mat_bethe(G1,10.0,100,20,0.1);
+    cntr::green_equilibrium_bethe_fast(G2,10.0,h,100,20,0.1);
+    double err=cntr::distance_norm2(-1,G1,G2);
+    REQUIRE(err<eps);
+  }
+
+  SECTION("user dos, bosons (fast)"){
+    cntr::ohmic dos(1.0);
+    GREEN G1(nt,ntau,1,BOSON),G2(nt,ntau,1,BOSON);
+    cntr::green_equilibrium(G1,dos,5.0,h,0.0);
+    cntr::green_equilibrium_fast(G2,dos,5.0,h,0.0);
+    double err=0.0;
+    for(int tstp=-1;tstp<=nt;tstp++) err+=cntr::distance_norm2(tstp,G1,G2);
+    REQUIRE(err<eps);
+  }
+}
+
+/// @private
+struct batch_test_hamiltonian{
+	std::vector<cntr::function<double> > *eps;
+	void operator()(int k,int tstp,cdmatrix &H){
+		(*eps)[k].get_value(tstp,H);
+	}
+};
+
+TEST_CASE("green_from_H batch","[equilibrium]"){
+	int nt=40,ntau=50,size=2,nk=5,kt=5;
+	double beta=5.0,h=0.02,mu=0.3,eps=1e-10;
+	for(int sig=-1;sig<=1;sig+=2){
+		std::vector<cntr::function<double> > epsk(nk,cntr::function<double>(nt,size));
+		std::vector<GREEN> G(nk,GREEN(nt,ntau,size,sig)),G1(nk,GREEN(nt,ntau,size,sig));
+		for(int k=0;k<nk;k++){
+			double ek=-1.0+0.5*k;
+			for(int tstp=-1;tstp<=nt;tstp++){
+				double t=(tstp<0 ? 0.0 : tstp*h);
+				cdmatrix H(size,size);
+				H(0,0)=ek+(sig==1 ? 2.0 : 0.0);
+				H(1,1)=-ek+0.5*sin(t)+(sig==1 ? 3.0 : 0.0);
+				H(0,1)=CPLX(0.3,0.1*t);
+				H(1,0)=std::conj(H(0,1));
+				epsk[k].set_value(tstp,H);
+			}
+		}
+		for(int cf_order=2;cf_order<=4;cf_order+=2){
+			double err=0.0;
+			for(int k=0;k<nk;k++) cntr::green_from_H(G[k],mu,epsk[k],beta,h,kt,cf_order);
+			cntr::green_from_H_batch(G1,mu,epsk,beta,h,kt,cf_order);
+			for(int k=0;k<nk;k++) for(int tstp=-1;tstp<=nt;tstp++) err+=cntr::distance_norm2(tstp,G[k],G1[k]);
+			REQUIRE(err<eps);
+
+			batch_test_hamiltonian H;
+			H.eps=&epsk;
+			err=0.0;
+			cntr::green_from_H_batch(G1,mu,H,beta,h,kt,cf_order);
+			for(int k=0;k<nk;k++) for(int tstp=-1;tstp<=nt;tstp++) err+=cntr::distance_norm2(tstp,G[k],G1[k]);
+			REQUIRE(err<eps);
+
+			cntr::distributed_timestep_array<double> Gk(nk,nt,ntau,size,sig,false);
+			for(int tstp=-1;tstp<=nt;tstp+=7){
+				err=0.0;
+				Gk.reset_tstp(tstp);
+				cntr::green_from_H_batch(tstp,Gk,mu,epsk,beta,h,kt,cf_order);
+				for(int k=0;k<nk;k++){
+					cntr::herm_matrix_timestep_view<double> Gtv(tstp,G[k]);
+					err+=cntr::distance_norm2(tstp,Gk.G(k),Gtv);
+				}
+				REQUIRE(err<eps);
+			}
+		}
+	}
+}
+
+TEST_CASE("green_from_H krylov","[equilibrium]"){
+	int nt=10,ntau=10,n=CNTR_KRYLOV_MIN_SIZE,kt=5;
+	double beta=2.0,h=0.05,mu=0.2,eps=1e-8;
+
+	SECTION("krylov_exp_apply"){
+		cdspmatrix H(n,n);
+		cdmatrix U=cdmatrix::Identity(n,n),U1;
+		std::vector<Eigen::Triplet<CPLX> > tr;
+		for(int i=0;i<n;i++){
+			tr.push_back(Eigen::Triplet<CPLX>(i,i,0.1*(i%3)));
+			tr.push_back(Eigen::Triplet<CPLX>(i,(i+1)%n,CPLX(-1.0,0.2)));
+			tr.push_back(Eigen::Triplet<CPLX>((i+1)%n,i,CPLX(-1.0,-0.2)));
+		}
+		H.setFromTriplets(tr.begin(),tr.end());
+		cntr::krylov_exp_apply<double>(H,0.7,U);
+		U1=(CPLX(0.0,-0.7)*cdmatrix(H)).exp();
+		REQUIRE((U-U1).norm()<eps);
+	}
+
+	SECTION("chain"){
+		// tight-binding chain in a field, H(t)_{i,i+1}=-exp(i A(t))
+		// reference: the dense exponential for W H W^+ with a dense unitary W (discrete Fourier
+		// transform), transformed back, G = W^+ G' W
+		cntr::function<double> epst(nt,n),epsd(nt,n),Wf(nt,n),Wdf(nt,n);
+		std::vector<cdspmatrix> epss(nt+2,cdspmatrix(n,n));
+		cdmatrix H0=cdmatrix::Zero(n,n),W(n,n),Wd;
+		for(int i=0;i<n;i++) for(int j=0;j<n;j++) W(i,j)=std::polar(1.0/sqrt(n),2.0*M_PI*i*j/n);
+		Wd=W.adjoint();
+		for(int tstp=-1;tstp<=nt;tstp++){
+			double A=(tstp<0 ? 0.0 : sin(tstp*h));
+			cdmatrix H=cdmatrix::Zero(n,n);
+			for(int i=0;i<n-1;i++){
+				H(i,i+1)=-CPLX(cos(A),sin(A));
+				H(i+1,i)=std::conj(H(i,i+1));
+			}
+			if(tstp==-1) H0=H;
+			epst.set_value(tstp,H);
+			epss[tstp+1]=H.sparseView();
+			cdmatrix Hd=W*H*Wd;
+			cdspmatrix Hds=Hd.sparseView();
+			REQUIRE(Hds.nonZeros()>CNTR_KRYLOV_MAX_FILL*n*n);
+			epsd.set_value(tstp,Hd);
+			Wf.set_value(tstp,W);
+			Wdf.set_value(tstp,Wd);
+		}
+		GREEN G(nt,ntau,n,-1),G1(nt,ntau,n,-1),G2(nt,ntau,n,-1);
+		double err=0.0;
+		cntr::green_from_H(G,mu,epst,beta,h,kt,4);
+		cntr::green_from_H(G1,mu,epss,beta,h,kt,4);
+		cntr::green_from_H(G2,mu,epsd,beta,h,kt,4);
+		for(int tstp=-1;tstp<=nt;tstp++){
+			G2.left_multiply(tstp,Wdf);
+			G2.right_multiply(tstp,Wf);
+		}
+		for(int tstp=-1;tstp<=nt;tstp++){
+			err+=cntr::distance_norm2(tstp,G,G2);
+			err+=cntr::distance_norm2(tstp,G1,G2);
+		}
+		REQUIRE(err<eps);
+
+		// time-independent: exact diagonalization
+		for(int tstp=-1;tstp<=nt;tstp++) epst.set_value(tstp,H0);
+		err=0.0;
+		cntr::green_from_H(G,mu,epst,beta,h,kt,4);
+		cntr::green_from_H(G1,mu,H0,beta,h);
+		for(int tstp=-1;tstp<=nt;tstp++) err+=cntr::distance_norm2(tstp,G,G1);
+		REQUIRE(err<eps);
+	}
+}
@@ -0,0 +1,73 @@
+#include "catch.hpp"
+#include "cntr.hpp"
+
+#define CPLX std::complex<double>
+
+struct fourier_test_function{
+	int calls;
+	fourier_test_function(){ calls=0; }
+	CPLX operator()(double x){
+		calls++;
+		return CPLX(exp(-x*x),x*exp(-x*x));
+	}
+};
+
+TEST_CASE("sampled function","[fourier]"){
+	double eps=1e-10;
+	int nn=20,limit=40,nw=101;
+	fourier_test_function fz;
+	fourier::sampled_function f(-8.0,8.0,fz,nn,limit);
+	fourier::adft_func adft;
+	fourier_test_function fz1;
+	adft.sample(0.0,-8.0,8.0,fz1,nn,limit);
+
+	SECTION("sampling"){
+		// split intervals reuse the values of their parent
+		REQUIRE(f.intervals()==limit-1);
+		REQUIRE(f.size()==f.intervals()*(nn+1));
+		REQUIRE(fz.calls==nn+1+(f.intervals()-1)*nn);
+	}
+
+	SECTION("dft"){
+		std::vector<double> w(nw);
+		std::vector<CPLX> res(nw);
+		double err=0.0,err_adft=0.0,err_batch=0.0;
+		for(int k=0;k<nw;k++) w[k]=-10.0+0.2*k;
+		f.dft(nw,w.data(),res.data());
+		for(int k=0;k<nw;k++){
+			CPLX r1,e1,r2,e2;
+			CPLX exact=sqrt(PI)*exp(-w[k]*w[k]/4.0)*(1.0-w[k]/2.0);
+			f.dft(w[k],r1,e1);
+			adft.dft(w[k],r2,e2);
+			err=std::max(err,std::abs(r1-exact));
+			err_adft=std::max(err_adft,std::abs(r1-r2));
+			err_batch=std::max(err_batch,std::abs(res[k]-r1));
+		}
+		REQUIRE(err<1e-7);
+		REQUIRE(err_adft<eps);
+		REQUIRE(err_batch<eps);
+	}
+
+	SECTION("weights"){
+		double w=1.7;
+		std::vector<CPLX> c(f.size());
+		CPLX res=0.0;
+		f.weights(w,c.data());
+		for(int i=0;i<f.intervals();i++){
+			for(int j=0;j<=nn;j++) res+=c[i*(nn+1)+j]*f.interval_data(i)[j];
+		}
+		REQUIRE(std::abs(res-f.dft(w))<eps);
+	}
+
+	SECTION("shared between threads"){
+		int n=64;
+		std::vector<CPLX> res(n),res1(n);
+		fourier::sampled_function g(f);
+#if CNTR_USE_OMP == 1
+#pragma omp parallel for
+#endif
+		for(int k=0;k<n;k++) res[k]=g.dft(0.1*k);
+		for(int k=0;k<n;k++) res1[k]=f.dft(0.1*k);
+		for(int k=0;k<n;k++) REQUIRE(res[k]==res1[k]);
+	}
+}
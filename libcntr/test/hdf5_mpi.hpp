@@ -0,0 +1,95 @@
+#include "cntr.hpp"
+
+using namespace std;
+#define GREEN cntr::herm_matrix<double>
+
+#if CNTR_USE_HDF5 == 1
+
+TEST_CASE("collective HDF5 I/O","[hdf5_mpi]"){
+  int ntasks,taskid;
+  int size=2;
+  int nt=10, ntau=20;
+  int npoints=5;
+  double dt=0.01, mu=0.0, beta=10.0;
+  double lam=0.1;
+  std::complex<double> I(0.0,1.0);
+  cdmatrix h1(2,2);
+
+  MPI_Comm_size(MPI_COMM_WORLD, &ntasks);
+  MPI_Comm_rank(MPI_COMM_WORLD, &taskid);
+
+  std::vector<GREEN> Gvec(npoints);
+  for(int i=0;i<npoints;i++){
+    h1(0,0) = 0.3*i;
+    h1(1,1) = -0.2*i;
+    h1(0,1) = I*lam;
+    h1(1,0) = -I*lam;
+    Gvec[i]=GREEN(nt,ntau,size,-1);
+    cntr::green_from_H(Gvec[i],mu,h1,beta,dt);
+  }
+
+  SECTION("distributed_timestep_array"){
+    double err=0.0;
+    cntr::distributed_timestep_array<double> Gall(npoints,nt,ntau,size,-1,true);
+    cntr::distributed_timestep_array<double> Gread(npoints,nt,ntau,size,-1,true);
+    for(int tstp=-1;tstp<=nt;tstp+=3){
+      Gall.reset_tstp(tstp);
+      for(int i=0;i<npoints;i++){
+        if(Gall.rank_owns(i)) Gall.G(i).get_data(Gvec[i]);
+      }
+      cntr::write_to_hdf5_mpi("hdf5_mpi_tstp.h5","G",Gall);
+      Gread.clear();
+      cntr::read_from_hdf5_mpi("hdf5_mpi_tstp.h5","G",Gread);
+      REQUIRE(Gread.tstp()==tstp);
+      for(int i=0;i<npoints;i++){
+        if(Gread.rank_owns(i)) err+=distance_norm2(tstp,Gread.G(i),Gvec[i]);
+      }
+    }
+    MPI_Allreduce(MPI_IN_PLACE,&err,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+    REQUIRE(err==0.0);
+  }
+
+  SECTION("herm_matrix collection"){
+    double err=0.0;
+    std::vector<int> tid_map(npoints);
+    std::vector<GREEN> Gk(npoints),Gr;
+    for(int i=0;i<npoints;i++){
+      tid_map[i]=(i*ntasks)/npoints;
+      if(tid_map[i]==taskid) Gk[i]=Gvec[i];
+    }
+    cntr::write_to_hdf5_mpi("hdf5_mpi_k.h5","Gk",Gk,tid_map);
+    cntr::read_from_hdf5_mpi("hdf5_mpi_k.h5","Gk",Gr,tid_map);
+    for(int i=0;i<npoints;i++){
+      if(tid_map[i]==taskid){
+        for(int tstp=-1;tstp<=nt;tstp++) err+=distance_norm2(tstp,Gr[i],Gvec[i]);
+      }
+    }
+    // every entry is in the shared file
+    if(taskid==0){
+      for(int i=0;i<npoints;i++){
+        std::vector<double> buf(2*(ntau+1)*size*size),ref(2*(ntau+1)*size*size);
+        hid_t file_id=read_hdf5_file("hdf5_mpi_k.h5");
+        hid_t data_id=H5Dopen(file_id,"Gk/mat",H5P_DEFAULT);
+        hid_t file_space=H5Dget_space(data_id);
+        hsize_t start[4]={(hsize_t)i,0,0,0},count[4]={1,(hsize_t)ntau+1,(hsize_t)size,(hsize_t)size};
+        H5Sselect_hyperslab(file_space,H5S_SELECT_SET,start,NULL,count,NULL);
+        hid_t mem_space=H5Screate_simple(4,count,NULL);
+        hid_t type_id=H5Tcreate(H5T_COMPOUND,sizeof(double)*2);
+        H5Tinsert(type_id,"r",0,H5T_NATIVE_DOUBLE);
+        H5Tinsert(type_id,"i",sizeof(double),H5T_NATIVE_DOUBLE);
+        H5Dread(data_id,type_id,mem_space,file_space,H5P_DEFAULT,&buf[0]);
+        H5Tclose(type_id);
+        H5Sclose(mem_space);
+        H5Sclose(file_space);
+        H5Dclose(data_id);
+        close_hdf5_file(file_id);
+        memcpy(&ref[0],Gvec[i].matptr(0),ref.size()*sizeof(double));
+        for(size_t j=0;j<buf.size();j++) err+=fabs(buf[j]-ref[j]);
+      }
+    }
+    MPI_Allreduce(MPI_IN_PLACE,&err,1,MPI_DOUBLE,MPI_SUM,MPI_COMM_WORLD);
+    REQUIRE(err==0.0);
+  }
+}
+
+#endif
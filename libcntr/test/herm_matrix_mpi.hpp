@@ -81,5 +81,20 @@ TEST_CASE("herm_matrix MPI","[herm_matrix_mpi]"){
   }
 
      
+
+  SECTION("broadcast in single precision"){
+    double err_loc=0.0;
+    double eps_float=1e-5;
+    GREEN G(nt,ntau,size,-1);
+    GREEN G_ref(nt,ntau,size,-1);
+    cntr::green_from_H(G_ref,mu,h1,beta,dt);
+    if(taskid == master) G=G_ref;
+
+    for(int tstp=-1; tstp<=nt; tstp++){
+      G.Bcast_timestep(tstp, master, CNTR_WIRE_FLOAT);
+      err_loc += cntr::distance_norm2(tstp,G,G_ref);
+    }
+    REQUIRE(err_loc/(nt+2)<eps_float);
+  }
 }
 
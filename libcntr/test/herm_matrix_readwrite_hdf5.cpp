@@ -78,6 +78,229 @@ TEST_CASE("read/write (hdf5)","[herm_matrix_read_write_hdf5]"){
   }
   
   
+  SECTION("read/write (compressed)"){
+    double err=0.0;
+    set_hdf5_storage_policy(hdf5_storage_compressed(6));
+    G1.write_to_hdf5("herm_matrix_hdf5_compressed.h5","testgroup");
+    set_hdf5_storage_policy(hdf5_storage_contiguous());
+    G2.read_from_hdf5("herm_matrix_hdf5_compressed.h5","testgroup");
+    for(int tstp=-1; tstp<=nt; tstp++){
+      err += cntr::distance_norm2(tstp,G1,G2);
+    }
+    REQUIRE(err==0.0);
+    // chunked and compressed on disk
+    hid_t file_id = read_hdf5_file("herm_matrix_hdf5_compressed.h5");
+    hid_t data_id = H5Dopen(file_id, "testgroup/tv", H5P_DEFAULT);
+    hid_t plist_id = H5Dget_create_plist(data_id);
+    hsize_t chunk[3];
+    REQUIRE(H5Pget_layout(plist_id) == H5D_CHUNKED);
+    H5Pget_chunk(plist_id, 3, chunk);
+    REQUIRE(chunk[0] == (hsize_t)(ntau+1));
+    REQUIRE(H5Dget_storage_size(data_id) < (hsize_t)((nt+1)*(ntau+1)*size*size*16));
+    H5Pclose(plist_id);
+    H5Dclose(data_id);
+    close_hdf5_file(file_id);
+  }
+
+  SECTION("read/write (lossy)"){
+    double tol=1e-8;
+    double err=0.0;
+    set_hdf5_storage_policy(hdf5_storage_compressed(6,tol));
+    G1.write_to_hdf5("herm_matrix_hdf5_compressed.h5","testgroup");
+    set_hdf5_storage_policy(hdf5_storage_contiguous());
+    G2.read_from_hdf5("herm_matrix_hdf5_compressed.h5","testgroup");
+    for(int tstp=-1; tstp<=nt; tstp++){
+      cdmatrix g1,g2;
+      for(int j=0; j<=tstp; j++){
+        G1.get_ret(tstp,j,g1);
+        G2.get_ret(tstp,j,g2);
+        err = std::max(err, (g1-g2).cwiseAbs().maxCoeff());
+      }
+    }
+    REQUIRE(err<=tol*std::sqrt(2.0));
+    REQUIRE(err>0.0);
+  }
+
+  SECTION("read/write (streaming)"){
+    int nt1=37;
+    double err=0.0;
+    CFUNC f1(nt,size),f2;
+    for(int tstp=-1; tstp<=nt; tstp++){
+      cdmatrix g;
+      G1.get_les(tstp<0 ? 0 : tstp,tstp<0 ? 0 : tstp,g);
+      f1.set_value(tstp,g);
+    }
+    set_hdf5_storage_policy(hdf5_storage_compressed(6));
+    {
+      cntr::hdf5_timestep_writer<double> writer("herm_matrix_hdf5_stream.h5");
+      writer.add("G",G1);
+      writer.add("f",f1);
+      for(int tstp=-1; tstp<=nt1; tstp++) writer.write_timestep(tstp);
+      // the file is consistent after each timestep
+      G2.read_from_hdf5("herm_matrix_hdf5_stream.h5","G");
+      REQUIRE(G2.nt()==nt1);
+      for(int tstp=-1; tstp<=nt1; tstp++){
+        err += cntr::distance_norm2(tstp,G1,G2);
+      }
+      REQUIRE(err==0.0);
+      for(int tstp=nt1+1; tstp<=nt; tstp++) writer.write_timestep(tstp);
+    }
+    set_hdf5_storage_policy(hdf5_storage_contiguous());
+    G2.read_from_hdf5("herm_matrix_hdf5_stream.h5","G");
+    f2.read_from_hdf5("herm_matrix_hdf5_stream.h5","f");
+    REQUIRE(G2.nt()==nt);
+    REQUIRE(f2.nt()==nt);
+    for(int tstp=-1; tstp<=nt; tstp++){
+      cdmatrix g1,g2;
+      f1.get_value(tstp,g1);
+      f2.get_value(tstp,g2);
+      err += cntr::distance_norm2(tstp,G1,G2) + (g1-g2).norm();
+    }
+    REQUIRE(err==0.0);
+  }
+
+  SECTION("read/write (partial)"){
+    double err=0.0;
+    set_hdf5_storage_policy(hdf5_storage_compressed(6));
+    G1.write_to_hdf5("herm_matrix_hdf5_compressed.h5","testgroup");
+    set_hdf5_storage_policy(hdf5_storage_contiguous());
+    // single timesteps
+    GREEN_TSTP A;
+    for(int tstp=-1; tstp<=nt; tstp+=7){
+      cntr::read_timestep_from_hdf5(tstp,A,"herm_matrix_hdf5_compressed.h5","testgroup");
+      REQUIRE(A.tstp()==tstp);
+      G2.set_timestep(tstp,A);
+      err += cntr::distance_norm2(tstp,G1,G2);
+    }
+    REQUIRE(err==0.0);
+    // single component: the others are left unchanged
+    G2.clear();
+    cntr::read_component_from_hdf5("tv",G2,"herm_matrix_hdf5_compressed.h5","testgroup");
+    for(int tstp=0; tstp<=nt; tstp++){
+      cdmatrix g1,g2;
+      for(int m=0; m<=ntau; m++){
+        G1.get_tv(tstp,m,g1);
+        G2.get_tv(tstp,m,g2);
+        err += (g1-g2).norm();
+      }
+      G2.get_ret(tstp,0,g2);
+      err += g2.norm();
+    }
+    REQUIRE(err==0.0);
+    // single orbital element
+    GREEN E1(nt,ntau,1,-1),E2;
+    E1.set_matrixelement(0,0,G1,1,0);
+    cntr::read_element_from_hdf5(1,0,E2,"herm_matrix_hdf5_compressed.h5","testgroup");
+    REQUIRE(E2.size1()==1);
+    for(int tstp=-1; tstp<=nt; tstp++){
+      err += cntr::distance_norm2(tstp,E1,E2);
+    }
+    REQUIRE(err==0.0);
+  }
+
+  SECTION("read (on demand)"){
+    double err=0.0;
+    G1.write_to_hdf5("herm_matrix_hdf5.h5","testgroup");
+    {
+      // a tiny cache: only the most recent chunks are kept
+      cntr::herm_matrix_hdf5_view<double> V("herm_matrix_hdf5.h5","testgroup",4,1);
+      REQUIRE(V.nt()==nt);
+      REQUIRE(V.size2()==size);
+      for(int t=0; t<=nt; t+=3){
+        for(int tp=0; tp<=nt; tp+=5){
+          cdmatrix g1,g2;
+          G1.get_les(t,tp,g1);
+          V.get_les(t,tp,g2);
+          err += (g1-g2).norm();
+          G1.get_ret(t,tp,g1);
+          V.get_ret(t,tp,g2);
+          err += (g1-g2).norm();
+          G1.get_gtr(t,tp,g1);
+          V.get_gtr(t,tp,g2);
+          err += (g1-g2).norm();
+        }
+        for(int m=0; m<=ntau; m+=4){
+          cdmatrix g1,g2;
+          G1.get_tv(t,m,g1);
+          V.get_tv(t,m,g2);
+          err += (g1-g2).norm();
+        }
+      }
+      for(int tstp=-1; tstp<=nt; tstp++){
+        cdmatrix rho1(size,size),rho2(size,size);
+        G1.density_matrix(tstp,rho1);
+        V.density_matrix(tstp,rho2);
+        err += (rho1-rho2).norm();
+        err += cntr::distance_norm2(tstp,V,G1);
+      }
+      REQUIRE(err==0.0);
+      REQUIRE(V.cache_used_bytes()<=4*(nt+1)*(ntau+1)*size*size*sizeof(cdouble));
+    }
+    {
+      // generic routines run on the stored data
+      cntr::herm_matrix_hdf5_view<double> V("herm_matrix_hdf5.h5","testgroup");
+      GREEN C1(nt,ntau,size,1),C2(nt,ntau,size,1);
+      for(int tstp=-1; tstp<=nt; tstp+=9){
+        cntr::Bubble1(tstp,C1,G1,G1);
+        cntr::Bubble1(tstp,C2,V,V);
+        err += cntr::distance_norm2(tstp,C1,C2);
+      }
+      REQUIRE(err==0.0);
+      V.get_data(G2);
+      for(int tstp=-1; tstp<=nt; tstp++){
+        err += cntr::distance_norm2(tstp,G1,G2);
+      }
+      REQUIRE(err==0.0);
+      // each chunk is read once
+      size_t reads=V.chunk_reads();
+      for(int tstp=-1; tstp<=nt; tstp+=9) V.density_matrix(tstp);
+      REQUIRE(V.chunk_reads()==reads);
+    }
+  }
+
+#if __cplusplus >= 201103L
+  SECTION("read/write (async)"){
+    double err=0.0;
+    GREEN G3(G1);
+    CFUNC f1(nt,size),f2;
+    f1.set_zero();
+    {
+      // room for about two timesteps: exercises back-pressure
+      cntr::hdf5_async_writer<double> writer(2*(2*nt+ntau+4)*size*size*sizeof(cdouble));
+      writer.open("herm_matrix_hdf5_async.h5");
+      writer.add("G",G3);
+      writer.add("f",f1);
+      for(int tstp=-1; tstp<=nt; tstp++){
+        cdmatrix g;
+        G1.get_les(tstp<0 ? 0 : tstp,tstp<0 ? 0 : tstp,g);
+        f1.set_value(tstp,g);
+        writer.write_timestep(tstp);
+        REQUIRE(writer.pending_bytes()<=writer.max_bytes());
+      }
+      // snapshots: the objects may be modified right after the call
+      writer.write_to_hdf5("herm_matrix_hdf5_async_snapshot.h5","G",G3);
+      writer.write_to_hdf5_slices("herm_matrix_hdf5_async_slices.h5","G",G3,10);
+      G3.set_timestep_zero(nt);
+      writer.fence();
+      REQUIRE(writer.pending_bytes()==0);
+      writer.close();
+    }
+    G2.read_from_hdf5("herm_matrix_hdf5_async.h5","G");
+    f2.read_from_hdf5("herm_matrix_hdf5_async.h5","f");
+    for(int tstp=-1; tstp<=nt; tstp++){
+      cdmatrix g1,g2;
+      f1.get_value(tstp,g1);
+      f2.get_value(tstp,g2);
+      err += cntr::distance_norm2(tstp,G1,G2) + (g1-g2).norm();
+    }
+    G2.read_from_hdf5("herm_matrix_hdf5_async_snapshot.h5","G");
+    for(int tstp=-1; tstp<=nt; tstp++){
+      err += cntr::distance_norm2(tstp,G1,G2);
+    }
+    REQUIRE(err==0.0);
+  }
+#endif
+
 }
 
 #endif
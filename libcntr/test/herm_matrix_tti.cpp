@@ -0,0 +1,138 @@
+#include "catch.hpp"
+#include "cntr.hpp"
+
+#define GREEN cntr::herm_matrix<double>
+#define GREEN_TTI cntr::herm_matrix_tti<double>
+#define CPLX std::complex<double>
+#define CFUNC cntr::function<double>
+
+// maximal deviation of the retarded and left-mixing components of G at time step n
+// from the time-translation invariant G1
+static void tti_deviation(int n, GREEN &G, GREEN_TTI &G1, double &err_ret, double &err_tv,
+                          double &err_les){
+	cdmatrix a,b;
+	err_ret=0.0;
+	err_tv=0.0;
+	err_les=0.0;
+	for(int j=0;j<=n;j++){
+		G.get_ret(n,j,a);
+		G1.get_ret(n,j,b);
+		err_ret=std::max(err_ret,(a-b).norm());
+		G.get_les(j,n,a);
+		G1.get_les(j,n,b);
+		err_les=std::max(err_les,(a-b).norm());
+	}
+	for(int i=0;i<=n;i++){
+		for(int m=0;m<=G.ntau();m++){
+			G.get_tv(i,m,a);
+			G1.get_tv(i,m,b);
+			err_tv=std::max(err_tv,(a-b).norm());
+		}
+	}
+	for(int m=0;m<=G.ntau();m++){
+		G.get_mat(m,a);
+		G1.get_mat(m,b);
+		err_tv=std::max(err_tv,(a-b).norm());
+	}
+}
+
+TEST_CASE("Time-translation invariant herm_matrix","[herm_matrix_tti]"){
+	int nt=150,ntau=100,size=2,k=5;
+	double beta=5.0,h=0.02,mu=0.1,lam=0.5;
+	// ret, tv and mat agree with the two-time solvers up to roundoff; les is obtained from tv
+	// (set_les_from_tv) and differs from the two-time les by the discretization error
+	double eps=1e-11,eps_les=1e-8,err_ret,err_tv,err_les;
+	CPLX ii(0.0,1.0);
+	cdmatrix H(size,size),Hbath(size,size);
+	H << -1.0, 0.3*ii, -0.3*ii, 0.5;
+	Hbath << 1.5, 0.2, 0.2, -0.7;
+	CFUNC Hfunc(nt,size);
+	Hfunc.set_constant(H);
+	// self-energy of a bath, time-translation invariant
+	GREEN Sigma(nt,ntau,size,-1);
+	cntr::green_from_H(Sigma,mu,Hbath,beta,h);
+	for(int tstp=-1;tstp<=nt;tstp++) Sigma.smul(tstp,lam*lam);
+	GREEN_TTI Sigma1(nt,ntau,size,-1);
+	Sigma1.set_from(Sigma);
+
+	SECTION("conversion"){
+		GREEN S(nt,ntau,size,-1);
+		Sigma1.get_data(S);
+		tti_deviation(nt,S,Sigma1,err_ret,err_tv,err_les);
+		REQUIRE(err_ret+err_tv+err_les==0.0);
+		for(int tstp=-1;tstp<=nt;tstp++){
+			REQUIRE(cntr::distance_norm2(tstp,S,Sigma)<eps);
+			REQUIRE(std::abs(Sigma1.density_matrix(tstp)-Sigma.density_matrix(tstp))<eps);
+		}
+	}
+
+	SECTION("relaxed product"){
+		// c_t = sum_{q<t} x_q s_{t-q}, with blocks above CNTR_TTI_FFT_MIN
+		int n=300;
+		std::vector<CPLX> s((n+1)*size*size),x((n+1)*2*size*size);
+		for(int i=0;i<(int)s.size();i++) s[i]=CPLX(cos(0.1*i),sin(0.37*i));
+		for(int i=0;i<(int)x.size();i++) x[i]=CPLX(sin(0.2*i),cos(0.03*i*i));
+		cntr::tti_relaxed_product<double> P(size,2,n,s.data(),true);
+		double err=0.0;
+		for(int t=0;t<=n;t++){
+			for(int ch=0;ch<2;ch++){
+				Eigen::Map<cdmatrix> c(P.acc(t)+ch*size*size,size,size);
+				cdmatrix c1=cdmatrix::Zero(size,size);
+				for(int q=0;q<t;q++){
+					Eigen::Map<cdmatrix> xq(&x[(q*2+ch)*size*size],size,size);
+					Eigen::Map<cdmatrix> sd(&s[(t-q)*size*size],size,size);
+					c1+=xq*sd; // column-major maps: transposed product
+				}
+				err=std::max(err,(c-c1).norm());
+			}
+			P.push(t,&x[t*2*size*size],size*size);
+		}
+		REQUIRE(err<1e-10);
+	}
+
+	SECTION("dyson"){
+		GREEN G(nt,ntau,size,-1);
+		GREEN_TTI G1(nt,ntau,size,-1);
+		cntr::dyson(G,mu,Hfunc,Sigma,beta,h,k);
+		cntr::dyson_tti(G1,mu,H,Sigma1,beta,h,k);
+		tti_deviation(nt,G,G1,err_ret,err_tv,err_les);
+		REQUIRE(err_ret<eps);
+		REQUIRE(err_tv<eps);
+		REQUIRE(err_les<eps_les);
+	}
+
+	SECTION("vie2"){
+		// G=(1-G0*Sigma)^{-1}*G0 is the hermitian solution of the Dyson equation
+		GREEN G(nt,ntau,size,-1),Q(nt,ntau,size,-1),F(nt,ntau,size,-1),Fcc(nt,ntau,size,-1);
+		GREEN_TTI G1(nt,ntau,size,-1),Q1(nt,ntau,size,-1),F1(nt,ntau,size,-1),Fcc1(nt,ntau,size,-1);
+		cntr::green_from_H(Q,mu,H,beta,h);
+		cntr::convolution(F,Q,Q,Sigma,Sigma,beta,h,k);
+		cntr::convolution(Fcc,Sigma,Sigma,Q,Q,beta,h,k);
+		for(int tstp=-1;tstp<=nt;tstp++){
+			F.smul(tstp,-1.0);
+			Fcc.smul(tstp,-1.0);
+		}
+		Q1.set_from(Q);
+		F1.set_from(F);
+		Fcc1.set_from(Fcc);
+		cntr::vie2(G,F,Fcc,Q,beta,h,k);
+		cntr::vie2_tti(G1,F1,Fcc1,Q1,beta,h,k);
+		tti_deviation(nt,G,G1,err_ret,err_tv,err_les);
+		REQUIRE(err_ret<eps);
+		REQUIRE(err_tv<eps);
+		REQUIRE(err_les<eps_les);
+	}
+
+	SECTION("convolution"){
+		GREEN G(nt,ntau,size,-1),C(nt,ntau,size,-1);
+		GREEN_TTI G1(nt,ntau,size,-1),C1(nt,ntau,size,-1);
+		cntr::green_from_H(G,mu,H,beta,h);
+		G1.set_from(G);
+		cntr::convolution(C,G,G,Sigma,Sigma,beta,h,k);
+		cntr::convolution_tti(C1,G1,G1,Sigma1,Sigma1,beta,h,k);
+		tti_deviation(nt,C,C1,err_ret,err_tv,err_les);
+		REQUIRE(err_ret<eps);
+		REQUIRE(err_tv<eps);
+		REQUIRE(err_les<eps_les);
+	}
+}
@@ -0,0 +1,136 @@
+#include "catch.hpp"
+#include "cntr.hpp"
+
+#define GREEN cntr::herm_matrix<double>
+#define GREEN_TSTP cntr::herm_matrix_timestep<double>
+#define DIST_TIMESTEP cntr::distributed_timestep_array<double>
+
+// Two-band model without inversion symmetry (G(k) != G(-k)), momentum kk of block k
+static void lattice_convolution_hk(cdmatrix &hk,std::vector<double> &kk,int sig){
+	std::complex<double> ii(0.0,1.0);
+	double c=0.0,s=0.0;
+	for(size_t d=0;d<kk.size();d++){
+		c+=cos(kk[d]);
+		s+=sin(kk[d]+0.3*d);
+	}
+	hk.resize(2,2);
+	if(sig==FERMION){
+		hk(0,0)=-c+0.4*s;
+		hk(1,1)=0.5+0.3*c;
+		hk(0,1)=0.3*exp(ii*(kk[0]+0.2));
+	}else{
+		// positive spectrum for bosons
+		hk(0,0)=2.0+0.3*c+0.2*s;
+		hk(1,1)=2.5-0.2*s;
+		hk(0,1)=0.1*exp(ii*kk[0]);
+	}
+	hk(1,0)=conj(hk(0,1));
+}
+
+static void lattice_convolution_init(std::vector<GREEN> &Gk,std::vector<int> &dims,std::vector<int> &origin,
+	int nt,int ntau,int sig,double beta,double h){
+	int nk=Gk.size(),nd=dims.size();
+	for(int k=0;k<nk;k++){
+		std::vector<double> kk(nd);
+		int rest=k,stride=nk;
+		for(int d=0;d<nd;d++){
+			stride/=dims[d];
+			kk[d]=2.0*CNTR_PI*(rest/stride-origin[d])/dims[d];
+			rest%=stride;
+		}
+		cdmatrix hk;
+		lattice_convolution_hk(hk,kk,sig);
+		Gk[k]=GREEN(nt,ntau,2,sig);
+		cntr::green_from_H(Gk[k],0.0,hk,beta,h);
+	}
+}
+
+TEST_CASE("lattice convolution by FFT","[lattice_convolution]"){
+	int nt=6;
+	int ntau=31;
+	double beta=4.0;
+	double h=0.05;
+	double eps=1e-10;
+
+	SECTION("fft_plan"){
+		// radix-2 and Bluestein lengths against the naive sum
+		std::complex<double> ii(0.0,1.0);
+		for(int n=1;n<=13;n++){
+			cntr::fft_plan<double> plan(n);
+			std::vector<std::complex<double> > x(n),y(n);
+			for(int j=0;j<n;j++) x[j]=std::complex<double>(cos(1.3*j*j+0.1),sin(0.7*j));
+			for(int sign=-1;sign<=1;sign+=2){
+				y=x;
+				plan.transform(&y[0],sign);
+				double err=0.0;
+				for(int m=0;m<n;m++){
+					std::complex<double> ref=0.0;
+					for(int j=0;j<n;j++) ref+=exp((double)sign*ii*2.0*CNTR_PI*(double)(j*m)/(double)n)*x[j];
+					err+=abs(ref-y[m]);
+				}
+				REQUIRE(err<eps);
+			}
+		}
+	}
+
+	std::vector<std::vector<int> > alldims,allorigins;
+	alldims.push_back(std::vector<int>(1,7));
+	allorigins.push_back(std::vector<int>(1,3));
+	alldims.push_back(std::vector<int>(2,4));
+	alldims.back()[1]=3;
+	allorigins.push_back(std::vector<int>(2,0));
+	allorigins.back()[0]=2;
+
+	for(size_t il=0;il<alldims.size();il++){
+		std::vector<int> dims=alldims[il],origin=allorigins[il];
+		cntr::lattice_convolution<double> conv(dims,origin);
+		int nk=conv.nk();
+		std::vector<GREEN> Gk(nk),Wk(nk);
+		lattice_convolution_init(Gk,dims,origin,nt,ntau,FERMION,beta,h);
+		lattice_convolution_init(Wk,dims,origin,nt,ntau,BOSON,beta,h);
+		DIST_TIMESTEP G(nk,nt,ntau,2,FERMION,false);
+		DIST_TIMESTEP W(nk,nt,ntau,2,BOSON,false);
+		DIST_TIMESTEP S(nk,nt,ntau,2,FERMION,false);
+		DIST_TIMESTEP P(nk,nt,ntau,2,BOSON,false);
+
+		for(int tstp=-1;tstp<=nt;tstp+=3){
+			G.reset_tstp(tstp);
+			W.reset_tstp(tstp);
+			S.reset_tstp(tstp);
+			P.reset_tstp(tstp);
+			for(int k=0;k<nk;k++){
+				G.G(k).get_data(Gk[k]);
+				W.G(k).get_data(Wk[k]);
+			}
+			conv.Bubble2(tstp,S,G,W);
+			conv.Bubble1(tstp,P,G,G,-1.0);
+
+			double errS=0.0,errP=0.0;
+			for(int k=0;k<nk;k++){
+				GREEN_TSTP sref(tstp,ntau,2,FERMION),pref(tstp,ntau,2,BOSON);
+				GREEN_TSTP stmp(tstp,ntau,2,FERMION),ptmp(tstp,ntau,2,BOSON);
+				sref.clear();
+				pref.clear();
+				for(int q=0;q<nk;q++){
+					int kq=conv.add_kpoints(k,1,q,-1);
+					stmp.clear();
+					ptmp.clear();
+					for(int i1=0;i1<2;i1++){
+						for(int i2=0;i2<2;i2++){
+							cntr::Bubble2(tstp,stmp,i1,i2,G.G(kq),G.G(kq),i1,i2,W.G(q),W.G(q),i1,i2);
+							// polarization P(k) = -1/N sum_q i G(q-k;t,t') G(q;t',t)
+							int qk=conv.add_kpoints(q,1,k,-1);
+							cntr::Bubble1(tstp,ptmp,i1,i2,G.G(qk),G.G(qk),i1,i2,G.G(q),G.G(q),i1,i2);
+						}
+					}
+					sref.incr_timestep(tstp,stmp,1.0/nk);
+					pref.incr_timestep(tstp,ptmp,-1.0/nk);
+				}
+				errS+=cntr::distance_norm2(tstp,S.G(k),sref);
+				errP+=cntr::distance_norm2(tstp,P.G(k),pref);
+			}
+			REQUIRE(errS<eps);
+			REQUIRE(errP<eps);
+		}
+	}
+}
@@ -0,0 +1,77 @@
+#include "cntr.hpp"
+
+#define GREEN cntr::herm_matrix<double>
+#define DIST_TIMESTEP cntr::distributed_timestep_array<double>
+
+TEST_CASE("Distributed lattice convolution","[lattice_convolution_mpi]"){
+  int ntasks,taskid;
+  int nt=5, ntau=20, size=2;
+  double beta=4.0, h=0.05;
+  double eps=1e-10;
+  std::complex<double> I(0.0,1.0);
+
+  MPI_Comm_size(MPI_COMM_WORLD, &ntasks);
+  MPI_Comm_rank(MPI_COMM_WORLD, &taskid);
+
+  std::vector<int> dims(2),origin(2);
+  dims[0]=5; dims[1]=4;
+  origin[0]=2; origin[1]=0;
+  cntr::lattice_convolution<double> conv(dims,origin);
+  int nk=conv.nk();
+
+  // propagators on all ranks, without inversion symmetry
+  std::vector<GREEN> Gk(nk),Wk(nk);
+  for(int k=0;k<nk;k++){
+    double kx=2.0*CNTR_PI*(k/dims[1]-origin[0])/dims[0];
+    double ky=2.0*CNTR_PI*(k%dims[1]-origin[1])/dims[1];
+    cdmatrix hk(size,size),wk(size,size);
+    hk(0,0)=-cos(kx)-cos(ky)+0.3*sin(kx+0.5*ky);
+    hk(1,1)=0.4-0.2*cos(kx);
+    hk(0,1)=0.2*exp(I*ky);
+    hk(1,0)=conj(hk(0,1));
+    wk(0,0)=2.0+0.3*sin(kx);
+    wk(1,1)=1.5+0.2*cos(ky);
+    wk(0,1)=0.1*exp(I*kx);
+    wk(1,0)=conj(wk(0,1));
+    Gk[k]=GREEN(nt,ntau,size,FERMION);
+    Wk[k]=GREEN(nt,ntau,size,BOSON);
+    cntr::green_from_H(Gk[k],0.0,hk,beta,h);
+    cntr::green_from_H(Wk[k],0.0,wk,beta,h);
+  }
+
+  DIST_TIMESTEP G(nk,nt,ntau,size,FERMION,true),W(nk,nt,ntau,size,BOSON,true);
+  DIST_TIMESTEP S(nk,nt,ntau,size,FERMION,true),P(nk,nt,ntau,size,BOSON,true);
+  // serial reference
+  DIST_TIMESTEP Gs(nk,nt,ntau,size,FERMION,false),Ws(nk,nt,ntau,size,BOSON,false);
+  DIST_TIMESTEP Ss(nk,nt,ntau,size,FERMION,false),Ps(nk,nt,ntau,size,BOSON,false);
+
+  SECTION("Bubble1 and Bubble2 with distributed momenta"){
+    double errS=0.0,errP=0.0;
+    for(int tstp=-1;tstp<=nt;tstp++){
+      G.reset_tstp(tstp); W.reset_tstp(tstp); S.reset_tstp(tstp); P.reset_tstp(tstp);
+      Gs.reset_tstp(tstp); Ws.reset_tstp(tstp); Ss.reset_tstp(tstp); Ps.reset_tstp(tstp);
+      G.clear(); W.clear();
+      for(int k=0;k<nk;k++){
+        Gs.G(k).get_data(Gk[k]);
+        Ws.G(k).get_data(Wk[k]);
+        // only the owned blocks are set
+        if(G.rank_owns(k)){
+          G.G(k).get_data(Gk[k]);
+          W.G(k).get_data(Wk[k]);
+        }
+      }
+      conv.Bubble2(tstp,Ss,Gs,Ws);
+      conv.Bubble1(tstp,Ps,Gs,Gs,-1.0);
+      conv.Bubble2(tstp,S,G,W);
+      conv.Bubble1(tstp,P,G,G,-1.0);
+      S.mpi_bcast_all();
+      P.mpi_bcast_all();
+      for(int k=0;k<nk;k++){
+        errS+=cntr::distance_norm2(tstp,S.G(k),Ss.G(k));
+        errP+=cntr::distance_norm2(tstp,P.G(k),Ps.G(k));
+      }
+    }
+    REQUIRE(errS<eps);
+    REQUIRE(errP<eps);
+  }
+}
@@ -103,4 +103,13 @@ TEST_CASE("Matsubara Dyson equation","[Matsubara Dyson equation]"){
     REQUIRE(err<tol_tight);
   }
 
+  SECTION("FFT"){
+    CFUNC H(-1,1);
+    H.set_value(-1,h1x1);
+    cntr::dyson_mat(G_approx, Sigma, mu, H, integration::I<double>(SolverOrder),
+  		    beta, CNTR_MAT_FFT);
+    err = cntr::distance_norm2(-1,G_exact,G_approx);
+    REQUIRE(err<tol_tight);
+  }
+
 }
@@ -0,0 +1,121 @@
+#include "catch.hpp"
+#include "cntr.hpp"
+#include <chrono>
+
+#define GREEN cntr::herm_matrix<double>
+#define CPLX std::complex<double>
+#define CFUNC cntr::function<double>
+
+// maximal deviation of the Matsubara components
+static double mat_deviation(GREEN &A, GREEN &B){
+	cdmatrix a,b;
+	double err=0.0;
+	for(int m=0;m<=A.ntau();m++){
+		A.get_mat(m,a);
+		B.get_mat(m,b);
+		err=std::max(err,(a-b).norm());
+	}
+	return err;
+}
+
+// upper left size1 x size1 block of Gfull
+static void system_block(GREEN &G, GREEN &Gfull){
+	for(int i=0;i<G.size1();i++)
+		for(int j=0;j<G.size1();j++)
+			G.set_matrixelement(-1,i,j,Gfull,i,j);
+}
+
+TEST_CASE("Matsubara FFT","[matsubara_fft]"){
+	int nt=-1,size=2,es=size*size;
+	double beta=20.0,h=0.02,lam=1.0;
+	cdmatrix H(size,size),Hbath(size,size),Hfull(2*size,2*size);
+	H << -3.0, 0.5, 0.5, 2.5;
+	Hbath << 4.0, 0.3, 0.3, -3.5;
+	// G is the system block of the Green's function of the full Hamiltonian
+	Hfull.setZero();
+	Hfull.block(0,0,size,size)=H;
+	Hfull.block(size,size,size,size)=Hbath;
+	Hfull.block(0,size,size,size)=lam*cdmatrix::Identity(size,size);
+	Hfull.block(size,0,size,size)=lam*cdmatrix::Identity(size,size);
+	CFUNC Hfunc(nt,size);
+	Hfunc.set_constant(H);
+
+	SECTION("transform"){
+		int ntau=512;
+		double mu=0.2;
+		GREEN G0(nt,ntau,size,FERMION),G(nt,ntau,size,FERMION);
+		cntr::green_from_H(G0,mu,H,beta,h);
+		cntr::matsubara_fft<double> plan(ntau,beta,FERMION,size);
+		std::vector<CPLX> fw(ntau*es),mom(plan.order()*es);
+		plan.to_frequency(G0.matptr(0),fw.data(),mom.data());
+		// G0(iw)=(iw+mu-H)^{-1}, moments (H-mu)^{j-1}
+		double err=0.0,errmom=0.0;
+		cdmatrix A=H-mu*cdmatrix::Identity(size,size),Aj=cdmatrix::Identity(size,size);
+		for(int m=0;m<ntau;m++){
+			cdmatrix g=(CPLX(0.0,plan.omega(m))*cdmatrix::Identity(size,size)-A).inverse();
+			err=std::max(err,(g-Eigen::Map<cdmatrix>(&fw[m*es],size,size).transpose()).norm());
+		}
+		for(int j=0;j<plan.order();j++){
+			errmom=std::max(errmom,(Aj-Eigen::Map<cdmatrix>(&mom[j*es],size,size).transpose()).norm()/Aj.norm());
+			Aj=A*Aj;
+		}
+		REQUIRE(err<1e-10);
+		REQUIRE(errmom<1e-2);
+		// back to imaginary time
+		plan.to_tau(fw.data(),mom.data(),plan.order(),G.matptr(0));
+		REQUIRE(mat_deviation(G,G0)<1e-10);
+	}
+
+	SECTION("dyson"){
+		int ntau[2]={512,600};
+		for(int i=0;i<2;i++){
+			for(int sig=-1;sig<=1;sig+=2){
+				// for bosons, mu is below the spectrum
+				double mu=(sig==FERMION ? 0.2 : -6.0);
+				GREEN G(nt,ntau[i],size,sig),Sigma(nt,ntau[i],size,sig),Gex(nt,ntau[i],size,sig);
+				GREEN Gfull(nt,ntau[i],2*size,sig);
+				cntr::green_from_H(Sigma,mu,Hbath,beta,h);
+				Sigma.smul(-1,lam*lam);
+				cntr::green_from_H(Gfull,mu,Hfull,beta,h);
+				system_block(Gex,Gfull);
+				cntr::dyson_mat_fft(G,Sigma,mu,Hfunc,beta);
+				REQUIRE(mat_deviation(G,Gex)<1e-8);
+			}
+		}
+	}
+}
+
+// Hidden benchmark (run with: runtest "[.benchmark]"). Solves the Dyson equation at
+// ntau=4096 with CNTR_MAT_FIXPOINT and CNTR_MAT_FFT and reports the timings.
+TEST_CASE("Matsubara FFT large ntau benchmark","[.benchmark]"){
+	// one level coupled to one bath level, to keep the O(ntau^2) fixpoint affordable
+	int nt=-1,ntau=4096;
+	double beta=20.0,h=0.02,lam=1.0,mu=0.2;
+	std::chrono::high_resolution_clock::time_point t0,t1;
+	cdmatrix h1(1,1),hbath(1,1),h2(2,2);
+	h1(0,0)=-3.0;
+	hbath(0,0)=4.0;
+	h2 << -3.0, lam, lam, 4.0;
+	CFUNC h1func(nt,1);
+	h1func.set_constant(h1);
+	GREEN G(nt,ntau,1,FERMION),G1(nt,ntau,1,FERMION),Sigma(nt,ntau,1,FERMION);
+	GREEN Gex(nt,ntau,1,FERMION),Gfull(nt,ntau,2,FERMION);
+	cntr::green_from_H(Sigma,mu,hbath,beta,h);
+	Sigma.smul(-1,lam*lam);
+	cntr::green_from_H(Gfull,mu,h2,beta,h);
+	system_block(Gex,Gfull);
+	t0=std::chrono::high_resolution_clock::now();
+	cntr::dyson_mat(G1,mu,h1func,Sigma,beta,MAX_SOLVE_ORDER,CNTR_MAT_FIXPOINT);
+	t1=std::chrono::high_resolution_clock::now();
+	double time_fixpoint=std::chrono::duration<double>(t1-t0).count();
+	t0=std::chrono::high_resolution_clock::now();
+	cntr::dyson_mat(G,mu,h1func,Sigma,beta,MAX_SOLVE_ORDER,CNTR_MAT_FFT);
+	t1=std::chrono::high_resolution_clock::now();
+	double time_fft=std::chrono::duration<double>(t1-t0).count();
+	double err_fixpoint=mat_deviation(G1,Gex),err_fft=mat_deviation(G,Gex);
+	// timings are reported, not asserted
+	WARN("ntau=" << ntau << ": CNTR_MAT_FIXPOINT " << time_fixpoint << "s, error " << err_fixpoint
+		<< "; CNTR_MAT_FFT " << time_fft << "s, error " << err_fft);
+	REQUIRE(err_fixpoint<1e-8);
+	REQUIRE(err_fft<1e-8);
+}
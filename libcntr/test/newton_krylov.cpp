@@ -0,0 +1,63 @@
+#include "catch.hpp"
+#include "cntr.hpp"
+
+#define GREEN cntr::herm_matrix<double>
+#define CFUNC cntr::function<double>
+
+TEST_CASE("Newton-Krylov Matsubara solver","[newton_krylov]"){
+	int nt=-1,ntau=400,size=2,SolveOrder=5;
+	double beta=50.0,mu=0.0,J=1.0,tol=1e-10;
+	cdmatrix H(size,size);
+	H << -0.2, 0.3, 0.3, 0.2;
+	CFUNC Hfunc(nt,size);
+	Hfunc.set_constant(H);
+	// Bethe lattice: Sigma=J^2 G
+	int nsigma=0;
+	std::function<void(GREEN &, GREEN &)> sigma=[&](GREEN &G, GREEN &Sigma){
+		Sigma.set_timestep(-1,G);
+		Sigma.smul(-1,J*J);
+		nsigma++;
+	};
+	GREEN G(nt,ntau,size,FERMION),Sigma(nt,ntau,size,FERMION),G1(nt,ntau,size,FERMION);
+	GREEN Gtemp(nt,ntau,size,FERMION);
+
+	// fixed-point iteration
+	cntr::green_from_H(G1,mu,H,beta,0.1);
+	int iter_fixpoint;
+	for(iter_fixpoint=1;iter_fixpoint<=5000;iter_fixpoint++){
+		Gtemp.set_timestep(-1,G1);
+		sigma(G1,Sigma);
+		cntr::dyson_mat(G1,mu,Hfunc,Sigma,beta,SolveOrder,CNTR_MAT_FFT);
+		if(cntr::distance_norm2(-1,G1,Gtemp)<tol) break;
+	}
+
+	// Newton-Krylov from the same initial guess
+	cntr::green_from_H(G,mu,H,beta,0.1);
+	nsigma=0;
+	double err=cntr::dyson_mat_newton_krylov(G,Sigma,mu,Hfunc,sigma,beta,tol,20,SolveOrder,
+		CNTR_MAT_FFT);
+	REQUIRE(err<tol);
+	REQUIRE(nsigma<iter_fixpoint/5);
+	REQUIRE(cntr::distance_norm2(-1,G,G1)<1e-7);
+	// Sigma is the self-energy of the solution
+	Gtemp.set_timestep(-1,G);
+	cntr::dyson_mat(Gtemp,mu,Hfunc,Sigma,beta,SolveOrder,CNTR_MAT_FFT);
+	REQUIRE(cntr::distance_norm2(-1,G,Gtemp)<1e-12);
+
+	// a functional that changes between calls has no root: the failed step is rejected,
+	// and the error is reported
+	std::function<void(GREEN &, GREEN &)> sigma_noisy=[&](GREEN &G, GREEN &Sigma){
+		sigma(G,Sigma);
+		Sigma.smul(-1,(nsigma%2 ? 1.01 : 0.99));
+	};
+	cntr::green_from_H(G,mu,H,beta,0.1);
+	nsigma=0;
+	err=cntr::dyson_mat_newton_krylov(G,Sigma,mu,Hfunc,sigma_noisy,beta,tol,20,SolveOrder,
+		CNTR_MAT_FFT);
+	REQUIRE(err>tol);
+	// stopped in the first Newton step: residual, Krylov vectors, line search, restore
+	REQUIRE(nsigma<=CNTR_NEWTON_KRYLOV_DIM+10);
+	Gtemp.set_timestep(-1,G);
+	cntr::dyson_mat(Gtemp,mu,Hfunc,Sigma,beta,SolveOrder,CNTR_MAT_FFT);
+	REQUIRE(cntr::distance_norm2(-1,G,Gtemp)<1e-12);
+}
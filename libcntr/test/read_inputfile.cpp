@@ -0,0 +1,78 @@
+#include "catch.hpp"
+#include "cntr.hpp"
+#include "utils/read_inputfile.hpp"
+
+TEST_CASE("input file registry","[read_inputfile]"){
+	char flin[]="read_inputfile.inp";
+	{
+		std::ofstream out(flin);
+		out << "# test input" << std::endl;
+		out << "__Nt=  100" << std::endl;
+		out << "__dNt=  7 # comment" << std::endl;
+		out << "__h=0.01" << std::endl;
+		out << "__flag=  true" << std::endl;
+		out << "__z=  1.5 -2.0" << std::endl;
+		out << "__vec=  1.0 2.0 3.0" << std::endl;
+		out << "__Nt=  200" << std::endl;
+		out << "__unused=  1" << std::endl;
+	}
+	{
+		std::ofstream out("read_inputfile_field.txt");
+		for(int t=-1;t<=4;t++) out << 0.5*t << std::endl;
+	}
+	std::ofstream out(flin,std::ios::app);
+	out << "__field=  --read_inputfile_field.txt" << std::endl;
+	out.close();
+	inputfile_registry::clear_cache();
+
+	SECTION("typed accessors"){
+		inputfile_registry inp(flin);
+		int nt,dnt;
+		double h;
+		bool flag;
+		cdouble z;
+		dvector v;
+		std::vector<double> field,c;
+		inp.get("__Nt=",nt);
+		inp.get("__dNt=",dnt);
+		inp.get("__h=",h);
+		inp.get("__flag=",flag);
+		inp.get("__z=",z);
+		inp.get("__vec=",v,3);
+		inp.get_tvector("__field=",field,4);
+		inp.get_tvector("__h=",c,4);
+		REQUIRE(nt==100);
+		REQUIRE(dnt==7);
+		REQUIRE(h==0.01);
+		REQUIRE(flag);
+		REQUIRE(z==cdouble(1.5,-2.0));
+		REQUIRE(v(2)==3.0);
+		REQUIRE(field.size()==6);
+		REQUIRE(field[5]==2.0);
+		REQUIRE(c[0]==0.01);
+		// flags that are not keys are found as substrings
+		inp.get("Nt=",nt);
+		REQUIRE(nt==100);
+		// validation
+		int x=-1;
+		REQUIRE(!inp.get_optional("__missing=",x));
+		REQUIRE(x==-1);
+		REQUIRE_THROWS(inp.get("__missing=",x));
+		REQUIRE(inp.duplicate_keys().size()==1);
+		REQUIRE(inp.unused_keys().size()==1);
+		REQUIRE(inp.unused_keys()[0]=="__unused=");
+	}
+
+	SECTION("find_param"){
+		int nt;
+		double h;
+		std::vector<double> field;
+		find_param(flin,"__Nt=",nt);
+		find_param(flin,"__h=",h);
+		find_param_tvector(flin,"__field=",field,4);
+		REQUIRE(nt==100);
+		REQUIRE(h==0.01);
+		REQUIRE(field[0]==-0.5);
+		REQUIRE_THROWS(find_param(flin,"__missing=",nt));
+	}
+}
@@ -6,6 +6,10 @@
 #include "distributed_array_mpi.hpp"
 #include "distributed_timestep_array_mpi.hpp"
 #include "reduce_timestep.hpp"
+#include "allreduce_timestep.hpp"
+#include "lattice_convolution_mpi.hpp"
+#include "convolution_vie2_mpi.hpp"
+#include "hdf5_mpi.hpp"
 
 int main(int argc, char *argv[]) {
     int ierr;
@@ -0,0 +1,122 @@
+#include "catch.hpp"
+#include "cntr.hpp"
+
+#define GREEN cntr::herm_matrix<double>
+#define GREEN_TSTP cntr::herm_matrix_timestep<double>
+#define CFUNC cntr::function<double>
+
+TEST_CASE("binary snapshot","[snapshot]"){
+	int nt=30;
+	int ntau=40;
+	int size=2;
+	double beta=5.0;
+	double h=0.02;
+	double mu=0.1;
+	std::complex<double> I(0.0,1.0);
+	cdmatrix h0(2,2);
+	h0(0,0)=-0.4;
+	h0(1,1)=0.6;
+	h0(0,1)=0.2*I;
+	h0(1,0)=-0.2*I;
+	GREEN G1(nt,ntau,size,FERMION);
+	cntr::green_from_H(G1,mu,h0,beta,h);
+
+	SECTION("herm_matrix"){
+		double err=0.0;
+		GREEN G2;
+		cntr::write_snapshot("snapshot_G.bin",G1);
+		cntr::read_snapshot("snapshot_G.bin",G2);
+		REQUIRE(G2.nt()==nt);
+		REQUIRE(G2.sig()==FERMION);
+		for(int tstp=-1;tstp<=nt;tstp++) err+=cntr::distance_norm2(tstp,G1,G2);
+		REQUIRE(err==0.0);
+
+		// zero-copy views of the mapped file
+		cntr::snapshot<double> s("snapshot_G.bin");
+		REQUIRE(s.kind()==CNTR_SNAPSHOT_HERM_MATRIX);
+		REQUIRE(s.size2()==size);
+		for(int tstp=-1;tstp<=nt;tstp++){
+			cntr::herm_matrix_timestep_view<double> v;
+			s.get_timestep(tstp,v);
+			if(tstp==-1) REQUIRE((size_t)v.matptr(0)%CNTR_SNAPSHOT_ALIGN==0);
+			if(tstp==0) REQUIRE((size_t)v.retptr(0)%CNTR_SNAPSHOT_ALIGN==0);
+			err+=cntr::distance_norm2(tstp,v,G1);
+		}
+		REQUIRE(err==0.0);
+	}
+
+	SECTION("herm_matrix_timestep and function"){
+		double err=0.0;
+		int tstp=17;
+		GREEN_TSTP A,B;
+		G1.get_timestep(tstp,A);
+		cntr::write_snapshot("snapshot_tstp.bin",A);
+		cntr::read_snapshot("snapshot_tstp.bin",B);
+		REQUIRE(B.tstp()==tstp);
+		err+=cntr::distance_norm2(tstp,A,B);
+		cntr::snapshot<double> s("snapshot_tstp.bin");
+		cntr::herm_matrix_timestep_view<double> v;
+		s.get_timestep(tstp,v);
+		err+=cntr::distance_norm2(tstp,v,A);
+		REQUIRE(err==0.0);
+
+		CFUNC f1(nt,size),f2;
+		for(int t=-1;t<=nt;t++){
+			cdmatrix g;
+			G1.get_les(t<0 ? 0 : t,t<0 ? 0 : t,g);
+			f1.set_value(t,g);
+		}
+		cntr::write_snapshot("snapshot_f.bin",f1);
+		cntr::read_snapshot("snapshot_f.bin",f2);
+		cntr::snapshot<double> sf("snapshot_f.bin",false);
+		REQUIRE(sf.verify());
+		for(int t=-1;t<=nt;t++){
+			cdmatrix g1,g2;
+			f1.get_value(t,g1);
+			f2.get_value(t,g2);
+			err+=(g1-g2).norm()+std::abs(*sf.ptr(t)-*f1.ptr(t));
+		}
+		REQUIRE(err==0.0);
+	}
+
+	SECTION("checksum"){
+		cntr::write_snapshot("snapshot_G.bin",G1);
+		{
+			std::fstream file("snapshot_G.bin",std::ios::in|std::ios::out|std::ios::binary);
+			file.seekp(-8,std::ios::end);
+			double x=1.0;
+			file.write((const char *)&x,sizeof(x));
+		}
+		cntr::snapshot<double> s("snapshot_G.bin",false);
+		REQUIRE(!s.verify());
+		REQUIRE_THROWS_AS(cntr::snapshot<double>("snapshot_G.bin"),std::runtime_error);
+	}
+
+	SECTION("errors"){
+		GREEN G2;
+		cntr::snapshot<double> s;
+		REQUIRE_THROWS_AS(s.open("snapshot_missing.bin"),std::runtime_error);
+		REQUIRE(!s.is_open());
+		REQUIRE_THROWS_AS(cntr::write_snapshot("snapshot_missing/G.bin",G1),std::runtime_error);
+		// truncated file
+		cntr::write_snapshot("snapshot_G.bin",G1);
+		{
+			std::ifstream in("snapshot_G.bin",std::ios::binary);
+			std::vector<char> buf(4096);
+			in.read(&buf[0],buf.size());
+			std::ofstream out("snapshot_G.bin",std::ios::binary|std::ios::trunc);
+			out.write(&buf[0],buf.size());
+		}
+		REQUIRE_THROWS_AS(s.open("snapshot_G.bin",false),std::runtime_error);
+		REQUIRE(!s.is_open());
+		// wrong scalar type
+		cntr::write_snapshot("snapshot_G.bin",G1);
+		REQUIRE_THROWS_AS(cntr::snapshot<float>("snapshot_G.bin"),std::runtime_error);
+		// not a snapshot
+		{
+			std::ofstream out("snapshot_G.bin",std::ios::trunc);
+			for(int i=0;i<100;i++) out << "not a snapshot file" << std::endl;
+		}
+		REQUIRE_THROWS_AS(cntr::read_snapshot("snapshot_G.bin",G2),std::runtime_error);
+	}
+}
@@ -0,0 +1,142 @@
+#include "catch.hpp"
+#include "cntr.hpp"
+
+#define GREEN cntr::herm_matrix<double>
+#define CPLX std::complex<double>
+#define CFUNC cntr::function<double>
+
+// maximal deviation of the Matsubara and the left-mixing components
+static double mat_deviation(GREEN &A, GREEN &B){
+	cdmatrix a,b;
+	double err=0.0;
+	for(int m=0;m<=A.ntau();m++){
+		A.get_mat(m,a);
+		B.get_mat(m,b);
+		err=std::max(err,(a-b).norm());
+	}
+	return err;
+}
+static double tv_deviation(int n, GREEN &A, GREEN &B){
+	cdmatrix a,b;
+	double err=0.0;
+	for(int m=0;m<=A.ntau();m++){
+		A.get_tv(n,m,a);
+		B.get_tv(n,m,b);
+		err=std::max(err,(a-b).norm());
+	}
+	return err;
+}
+
+// upper left size1 x size1 block of Gfull
+static void system_block(GREEN &G, GREEN &Gfull){
+	for(int tstp=-1;tstp<=G.nt();tstp++)
+		for(int i=0;i<G.size1();i++)
+			for(int j=0;j<G.size1();j++)
+				G.set_matrixelement(tstp,i,j,Gfull,i,j);
+}
+
+TEST_CASE("Non-uniform tau grid","[tau_grid]"){
+	int nt=30,ntau=80,size=2,k=5;
+	double beta=20.0,h=0.02,mu=0.2,lam=1.0,c=2.0;
+	cdmatrix H(size,size),Hbath(size,size),Hfull(2*size,2*size);
+	H << -3.0, 0.5, 0.5, 2.5;
+	Hbath << 4.0, 0.3, 0.3, -3.5;
+	// G is the system block of the Green's function of the full Hamiltonian
+	Hfull.setZero();
+	Hfull.block(0,0,size,size)=H;
+	Hfull.block(size,size,size,size)=Hbath;
+	Hfull.block(0,size,size,size)=lam*cdmatrix::Identity(size,size);
+	Hfull.block(size,0,size,size)=lam*cdmatrix::Identity(size,size);
+	CFUNC Hfunc(nt,size);
+	Hfunc.set_constant(H);
+	cntr::tau_grid<double> grid(ntau,beta,CNTR_TAU_TANH,c),ugrid(ntau,beta);
+	GREEN G0(nt,ntau,size,FERMION),Sigma(nt,ntau,size,FERMION),Gex(nt,ntau,size,FERMION);
+	GREEN Gfull(nt,ntau,2*size,FERMION);
+	cntr::green_from_H(G0,mu,H,grid,h);
+	cntr::green_from_H(Sigma,mu,Hbath,grid,h);
+	for(int tstp=-1;tstp<=nt;tstp++) Sigma.smul(tstp,lam*lam);
+	cntr::green_from_H(Gfull,mu,Hfull,grid,h);
+	system_block(Gex,Gfull);
+
+	SECTION("grid"){
+		double err=0.0,sum=0.0;
+		for(int m=0;m<=ntau;m++){
+			err=std::max(err,std::abs(ugrid.tau(m)-m*beta/ntau));
+			err=std::max(err,std::abs(grid.tau(ntau-m)-(beta-grid.tau(m))));
+			err=std::max(err,std::abs(grid.index(grid.tau(m))-m));
+			if(m>0) REQUIRE(grid.tau(m)>grid.tau(m-1));
+			sum+=grid.weight(m,k)*exp(-4.0*grid.tau(m));
+		}
+		REQUIRE(err<1e-10);
+		REQUIRE(std::abs(sum-(1.0-exp(-4.0*beta))/4.0)<1e-7);
+		// interpolation between the grid points
+		std::vector<CPLX> f(ntau+1);
+		CPLX val;
+		for(int m=0;m<=ntau;m++) f[m]=exp(-4.0*grid.tau(m));
+		err=0.0;
+		for(int i=0;i<=200;i++){
+			double tau=0.005*i*beta;
+			grid.interpolate(1,tau,f.data(),&val,k);
+			err=std::max(err,std::abs(val-exp(-4.0*tau)));
+		}
+		REQUIRE(err<1e-5);
+	}
+
+	SECTION("green_from_H"){
+		GREEN A(nt,ntau,size,FERMION),B(nt,ntau,size,FERMION);
+		cntr::green_from_H(A,mu,H,beta,h);
+		cntr::green_from_H(B,mu,H,ugrid,h);
+		double err=mat_deviation(A,B);
+		for(int n=0;n<=nt;n++) err=std::max(err,tv_deviation(n,A,B));
+		REQUIRE(err<1e-12);
+	}
+
+	SECTION("matsubara"){
+		// the tanh grid is much more accurate than the uniform grid with the same ntau
+		GREEN G(nt,ntau,size,FERMION),G1(nt,ntau,size,FERMION),Sigma1(nt,ntau,size,FERMION);
+		GREEN Gex1(nt,ntau,2*size,FERMION);
+		cntr::dyson_mat_grid(G,mu,Hfunc,Sigma,grid,k);
+		double err=mat_deviation(G,Gex);
+		cntr::green_from_H(Sigma1,mu,Hbath,beta,h);
+		Sigma1.smul(-1,lam*lam);
+		cntr::green_from_H(Gex1,mu,Hfull,beta,h);
+		system_block(G1,Gex1);
+		cntr::dyson_mat_grid(G,mu,Hfunc,Sigma1,ugrid,k);
+		double err_uniform=mat_deviation(G,G1);
+		REQUIRE(err<1e-6);
+		REQUIRE(err<0.01*err_uniform);
+		// G+F*G=Q with F=-G0*Sigma, Q=G0
+		GREEN F(nt,ntau,size,FERMION);
+		cntr::convolution_mat_grid(F,G0,Sigma,grid,k);
+		F.smul(-1,-1.0);
+		cntr::vie2_mat_grid(G,F,G0,grid,k);
+		REQUIRE(mat_deviation(G,Gex)<1e-6);
+	}
+
+	SECTION("left-mixing"){
+		GREEN G(nt,ntau,size,FERMION),F(nt,ntau,size,FERMION),Fcc(nt,ntau,size,FERMION);
+		double err=0.0;
+		// Dyson equation
+		cntr::dyson_mat_grid(G,mu,Hfunc,Sigma,grid,k);
+		cntr::dyson_start_tv_grid(G,mu,Hfunc,Sigma,grid,h,k);
+		for(int n=k+1;n<=nt;n++) cntr::dyson_timestep_tv_grid(n,G,mu,Hfunc,Sigma,grid,h,k);
+		for(int n=0;n<=nt;n++) err=std::max(err,tv_deviation(n,G,Gex));
+		REQUIRE(err<1e-5);
+		// VIE2 with F=-G0*Sigma: retarded components from the uniform routines
+		cntr::convolution(F,G0,G0,Sigma,Sigma,beta,h,k);
+		cntr::convolution(Fcc,Sigma,Sigma,G0,G0,beta,h,k);
+		cntr::convolution_mat_grid(F,G0,Sigma,grid,k);
+		for(int n=0;n<=nt;n++) cntr::convolution_timestep_tv_grid(n,F,G0,G0,Sigma,Sigma,grid,h,k);
+		for(int tstp=-1;tstp<=nt;tstp++){
+			F.smul(tstp,-1.0);
+			Fcc.smul(tstp,-1.0);
+		}
+		G.clear();
+		cntr::vie2_mat_grid(G,F,G0,grid,k);
+		cntr::vie2_start_tv_grid(G,F,Fcc,G0,grid,h,k);
+		for(int n=k+1;n<=nt;n++) cntr::vie2_timestep_tv_grid(n,G,F,Fcc,G0,grid,h,k);
+		err=0.0;
+		for(int n=0;n<=nt;n++) err=std::max(err,tv_deviation(n,G,Gex));
+		REQUIRE(err<1e-5);
+	}
+}
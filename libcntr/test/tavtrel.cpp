@@ -0,0 +1,88 @@
+#include "catch.hpp"
+#include "cntr.hpp"
+
+#define GREEN cntr::herm_matrix<double>
+
+TEST_CASE("tav/trel transforms","[tavtrel]"){
+	int nt=40;
+	int ntau=30;
+	int size=2;
+	int es=size*size;
+	double beta=5.0;
+	double h=0.02;
+	double mu=0.1;
+	std::complex<double> I(0.0,1.0);
+	cdmatrix h0(2,2);
+	h0(0,0)=-0.4;
+	h0(1,1)=0.6;
+	h0(0,1)=0.2*I;
+	h0(1,0)=-0.2*I;
+	GREEN G(nt,ntau,size,FERMION);
+	cntr::green_from_H(G,mu,h0,beta,h);
+	std::vector<cdouble> les((nt+1)*es),gtr((nt+1)*es);
+
+	SECTION("agrees with get_les/get_gtr"){
+		double err=0.0;
+		for(int tav=0;tav<=nt;tav++){
+			cntr::get_tavtrel(tav,G,les.data(),gtr.data());
+			for(int r=0;r<=cntr::tavtrel_length(tav,nt);r++){
+				cdmatrix g1,g2;
+				G.get_les(tav+r,tav-r,g1);
+				G.get_gtr(tav+r,tav-r,g2);
+				for(int i=0;i<es;i++){
+					err+=std::abs(les[r*es+i]-g1(i/size,i%size))+std::abs(gtr[r*es+i]-g2(i/size,i%size));
+				}
+			}
+		}
+		REQUIRE(err==0.0);
+		for(int tp=0;tp<=nt;tp+=3){
+			cntr::get_fixed_tp(tp,G,les.data(),gtr.data());
+			for(int t=0;t<=nt;t++){
+				cdmatrix g1,g2;
+				G.get_les(t,tp,g1);
+				G.get_gtr(t,tp,g2);
+				for(int i=0;i<es;i++){
+					err+=std::abs(les[t*es+i]-g1(i/size,i%size))+std::abs(gtr[t*es+i]-g2(i/size,i%size));
+				}
+			}
+		}
+		REQUIRE(err==0.0);
+		cntr::get_equal_time(G,les.data(),gtr.data());
+		for(int t=0;t<=nt;t++){
+			cdmatrix g1,g2;
+			G.get_les(t,t,g1);
+			G.get_gtr(t,t,g2);
+			for(int i=0;i<es;i++){
+				err+=std::abs(les[t*es+i]-g1(i/size,i%size))+std::abs(gtr[t*es+i]-g2(i/size,i%size));
+			}
+		}
+		REQUIRE(err==0.0);
+	}
+
+#if CNTR_USE_HDF5 == 1
+	SECTION("hdf5"){
+		double err=0.0;
+		int dt=3;
+		G.write_to_hdf5_tavtrel("tavtrel.h5","G",dt);
+		cntr::write_fixed_tp_to_hdf5("tavtrel_fixed_tp.h5","G",G,dt);
+		hid_t file_id=read_hdf5_file("tavtrel.h5");
+		hid_t file_id_tp=read_hdf5_file("tavtrel_fixed_tp.h5");
+		for(int t=0;t<=nt;t+=dt){
+			char name[100];
+			int len=cntr::tavtrel_length(t,nt);
+			std::vector<cdouble> buf((nt+1)*es);
+			cntr::get_tavtrel(t,G,les.data(),gtr.data());
+			std::sprintf(name,"G/gtr/%d",t);
+			read_primitive_type_array(file_id,name,(len+1)*es,buf.data());
+			for(int i=0;i<(len+1)*es;i++) err+=std::abs(buf[i]-gtr[i]);
+			cntr::get_fixed_tp(t,G,les.data(),gtr.data());
+			std::sprintf(name,"G/les/%d",t);
+			read_primitive_type_array(file_id_tp,name,(nt+1)*es,buf.data());
+			for(int i=0;i<(nt+1)*es;i++) err+=std::abs(buf[i]-les[i]);
+		}
+		close_hdf5_file(file_id);
+		close_hdf5_file(file_id_tp);
+		REQUIRE(err==0.0);
+	}
+#endif
+}
@@ -0,0 +1,104 @@
+#include "catch.hpp"
+#include "cntr.hpp"
+
+#define GREEN cntr::herm_matrix<double>
+
+TEST_CASE("Wigner transforms","[wigner]"){
+	int nt=400;
+	int ntau=50;
+	int size=2;
+	int es=size*size;
+	int nw=61;
+	double beta=5.0;
+	double h=0.01;
+	double mu=0.1;
+	double wmin=-3.0,wmax=3.0,dw=(wmax-wmin)/(nw-1);
+	std::complex<double> I(0.0,1.0);
+	cdmatrix h0(2,2);
+	h0(0,0)=-0.4;
+	h0(1,1)=0.6;
+	h0(0,1)=0.2*I;
+	h0(1,0)=-0.2*I;
+	GREEN G(nt,ntau,size,FERMION);
+	cntr::green_from_H(G,mu,h0,beta,h);
+	std::vector<int> tav;
+	tav.push_back(0);
+	tav.push_back(3);
+	tav.push_back(37);
+	tav.push_back(200);
+	tav.push_back(317);
+	tav.push_back(400);
+	int ntav=tav.size();
+	std::vector<cdouble> ret(ntav*nw*es),les(ntav*nw*es);
+
+	SECTION("equilibrium"){
+		// G^R(t)=-i e^{-i(H-mu)t} and G^<(t)=i f(H-mu) e^{-i(H-mu)t}: integrals over [0,L]
+		Eigen::SelfAdjointEigenSolver<cdmatrix> eig(h0-mu*cdmatrix::Identity(size,size));
+		double err=0.0,err_short=0.0;
+		cntr::wigner_transform(G,h,tav,wmin,wmax,nw,ret.data(),les.data());
+		for(int i=0;i<ntav;i++){
+			int len=cntr::tavtrel_length(tav[i],nt);
+			double L=2.0*h*len;
+			// short lines use the trapezoidal rule
+			double &e_i=(len<CNTR_WIGNER_MIN_CUBIC ? err_short : err);
+			for(int k=0;k<nw;k++){
+				double w=wmin+k*dw;
+				cdmatrix gr=cdmatrix::Zero(size,size),f=cdmatrix::Zero(size,size);
+				for(int n=0;n<size;n++){
+					double d=w-eig.eigenvalues()(n);
+					cdmatrix p=eig.eigenvectors().col(n)*eig.eigenvectors().col(n).adjoint();
+					cdouble x=(std::abs(d)>1e-12 ? (std::exp(I*d*L)-1.0)/d : I*L);
+					gr-=p*x;
+					f+=p*x*cntr::fermi(beta,eig.eigenvalues()(n));
+				}
+				cdmatrix gl=f-f.adjoint();
+				for(int e=0;e<es;e++){
+					e_i=std::max(e_i,std::abs(ret[(i*nw+k)*es+e]-gr(e/size,e%size)));
+					e_i=std::max(e_i,std::abs(les[(i*nw+k)*es+e]-gl(e/size,e%size)));
+				}
+			}
+		}
+		REQUIRE(err<1e-8);
+		REQUIRE(err_short<1e-3);
+	}
+
+	SECTION("window"){
+		// compare to the cubically corrected DFT at each frequency
+		double width=0.5,err=0.0;
+		std::vector<cdouble> fles((nt+1)*es),fgtr((nt+1)*es),c(nt+1);
+		cntr::wigner_transform(G,h,tav,wmin,wmax,nw,ret.data(),(cdouble*)NULL,CNTR_WINDOW_GAUSS,width);
+		for(int i=0;i<ntav;i++){
+			int n=cntr::tavtrel_length(tav[i],nt);
+			if(n%2!=0 || n<=16) continue;
+			cntr::get_tavtrel(tav[i],G,fles.data(),fgtr.data());
+			for(int k=0;k<nw;k++){
+				fourier::dft_cubic_weights(wmin+k*dw,n,0.0,2.0*h*n,c.data());
+				for(int e=0;e<es;e++){
+					cdouble x=0.0;
+					for(int r=0;r<=n;r++){
+						double t=2.0*h*r;
+						x+=c[r]*exp(-0.5*t*t/(width*width))*(fgtr[r*es+e]-fles[r*es+e]);
+					}
+					err=std::max(err,std::abs(ret[(i*nw+k)*es+e]-x));
+				}
+			}
+		}
+		REQUIRE(err<1e-10);
+	}
+
+#if CNTR_USE_HDF5 == 1
+	SECTION("hdf5"){
+		double err=0.0;
+		std::vector<cdouble> buf(ntav*nw*es);
+		cntr::wigner_transform(G,h,tav,wmin,wmax,nw,ret.data(),les.data(),CNTR_WINDOW_HANN,0.0);
+		cntr::write_wigner_to_hdf5("wigner.h5","G",G,h,tav,wmin,wmax,nw,CNTR_WINDOW_HANN,0.0);
+		hid_t file_id=read_hdf5_file("wigner.h5");
+		read_primitive_type_array(file_id,"G/ret",ntav*nw*es,buf.data());
+		for(int i=0;i<ntav*nw*es;i++) err+=std::abs(buf[i]-ret[i]);
+		read_primitive_type_array(file_id,"G/les",ntav*nw*es,buf.data());
+		for(int i=0;i<ntav*nw*es;i++) err+=std::abs(buf[i]-les[i]);
+		close_hdf5_file(file_id);
+		REQUIRE(err==0.0);
+	}
+#endif
+}